@@ -0,0 +1,1096 @@
+/*
+* bench.c - CS50 Tiny Search Engine (TSE) benchmark suite
+*
+* Author: Atziri Enriquez
+* Date: 10/14/26
+*
+* Description:
+* Times the hot paths of the search engine on a synthetic collection, and
+* reports each as one line of a tab-separated table, so runs on different
+* commits can be compared (see compare.sh).
+*
+* The collection is generated from a seed: a vocabulary of random words, of
+* 2 to 12 letters, some capitalized, drawn with Zipf's law (the i-th most
+* common word about 1/i as often as the first), so that there are a few
+* very long posting lists and many short ones, as in real text. Each page
+* is HTML with paragraphs, a title and links, appended to a page directory's
+* segments as the crawler saves them (pagedir_openWriter, pagedir_append),
+* compressed with -z as crawler -z compresses them. The queries are drawn
+* the same way.
+*
+* Benchmarks (an op is what ns_per_op is per):
+*   webpage_getNextWord   one word, from a copy of each page (libcs50)
+*   tokenizer_next        one word, from a copy of each page
+*   pagestream_nextMany   one word, as the indexer reads them: through a
+*                         page cursor over the segments, decompressing
+*                         each compressed page with a pagestream_t
+*   normalizeWord         one word lowercased into a new string
+*   normalizeWordInto     one word lowercased into a reused buffer
+*   index_insert          one word of 3 or more letters inserted, building
+*                         the index as the indexer does
+*   index_find            one lookup; half are words of the vocabulary,
+*                         half are not in the index
+*   index_save            one posting, saving the index as text
+*   index_save_binary     one posting, saving the index as binary
+*   index_load            one posting, loading the text index
+*   index_load_binary     one posting, loading the binary index
+*   queryEvaluate_and     one query of 2 to 4 words ANDed together
+*   queryEvaluate_or      one query of 3 to 5 sequences of 1 or 2 words ORed
+*
+* The queries are evaluated by the querier's own queryEvaluate (querier.c
+* is compiled into the suite), over the binary index opened as the querier
+* opens it (indexset_open).
+*
+* Each benchmark runs in a child process of its own, which reads what it
+* needs from the page directory (or the index files saved next to it)
+* before it is timed, and then repeats the timed work until it has taken
+* at least minSeconds. Its peak RSS is therefore its own: what it loaded,
+* plus what the timed work allocated.
+*
+* Usage:
+*   ./tsebench [-p numPages] [-w wordsPerPage] [-v vocabulary] [-q numQueries]
+*              [-s seed] [-t minSeconds] [-l label] [-d directory] [-z] [benchmark...]
+*
+* Defaults: 2000 pages of 400 words, a vocabulary of 20000 words, 2000
+* queries, seed 1, 0.5 seconds, pages not compressed. The collection is written to directory
+* (default: a new one in /tmp, removed afterwards); an existing directory
+* is overwritten. With benchmark names, only those are run.
+*
+* Output (stdout):
+*   # tse-bench label=... pages=... words=... vocabulary=... queries=... seed=... min_seconds=... compressed=...
+*   benchmark<TAB>ops<TAB>seconds<TAB>ops_per_sec<TAB>ns_per_op<TAB>peak_rss_kb
+*   one line per benchmark
+*
+* Exit codes:
+* - 0: Success
+* - 1: Invalid arguments
+* - 2: The collection could not be written, or a benchmark failed.
+*/
+
+#define _POSIX_C_SOURCE 200809L  // mkdtemp, clock_gettime, fork
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "../libcs50/mem.h"
+#include "../libcs50/webpage.h"
+#include "../common/arena.h"
+#include "../common/index.h"
+#include "../common/indexset.h"
+#include "../common/lz.h"
+#include "../common/pagedir.h"
+#include "../common/pagestream.h"
+#include "../common/postings.h"
+#include "../common/tokenizer.h"
+#include "../common/word.h"
+#include "../querier/query.h"
+
+#define MAX_QUERY_WORDS 19    // the most words a generated query has: 5 sequences of "a and b", ORed
+
+// What the suite is run with
+typedef struct benchConfig {
+  int numPages;
+  int wordsPerPage;
+  int vocabulary;
+  int numQueries;
+  uint64_t seed;
+  double minSeconds;
+  const char* label;
+  const char* directory;
+  bool compress;              // compress each page's HTML, as crawler -z does
+} benchConfig_t;
+
+// One page, read back from the page directory
+typedef struct benchPage {
+  char* html;                 // null-terminated copy
+  size_t len;
+} benchPage_t;
+
+// One query, as the tokenized words queryEvaluate takes
+typedef struct benchQuery {
+  char* words[MAX_QUERY_WORDS];
+  int n;
+} benchQuery_t;
+
+// What a benchmark works on; each part is read in the first time it is needed
+typedef struct benchData {
+  const benchConfig_t* config;
+  benchPage_t* pages;
+  int numPages;
+  unsigned long numWords;     // words in all the pages
+  char** vocabulary;          // lowercase, the most common first
+  double* cdf;                // cdf[i]: the probability of a word among the first i+1
+  index_t* index;             // built from the pages
+  unsigned long numPostings;
+  indexset_t* indexes;        // the binary index, opened as the querier does
+  benchQuery_t* andQueries;
+  benchQuery_t* orQueries;
+} benchData_t;
+
+/* One pass of a benchmark: does the work once and returns the seconds the
+ * timed part took, adding the ops it did to *ops */
+typedef double (*benchPass_t)(benchData_t* data, unsigned long* ops);
+
+typedef struct benchmark {
+  const char* name;
+  benchPass_t pass;
+} benchmark_t;
+
+// Function prototypes
+static void parseArgs(int argc, char* argv[], benchConfig_t* config, int* firstBenchmark);
+static bool writeCollection(const benchConfig_t* config);
+static bool writeIndexes(const benchConfig_t* config);
+static void runBenchmark(const benchmark_t* bench, const benchConfig_t* config);
+static void makeVocabulary(benchData_t* data);
+static const char* drawWord(benchData_t* data, uint64_t* state);
+static void needPages(benchData_t* data);
+static void needIndex(benchData_t* data);
+static void needIndexSet(benchData_t* data);
+static void needQueries(benchData_t* data);
+static void freeData(benchData_t* data);
+static void makeQueries(benchData_t* data, benchQuery_t* queries, const bool or, uint64_t* state);
+static char* indexFilename(const benchConfig_t* config, const bool binary);
+static uint64_t nextRandom(uint64_t* state);
+static double secondsSince(const struct timespec* start);
+static void countPosting(void* arg, const char* word, const size_t len, const postings_t* postings);
+
+static double benchGetNextWord(benchData_t* data, unsigned long* ops);
+static double benchTokenizer(benchData_t* data, unsigned long* ops);
+static double benchPageStream(benchData_t* data, unsigned long* ops);
+static double benchNormalizeWord(benchData_t* data, unsigned long* ops);
+static double benchNormalizeWordInto(benchData_t* data, unsigned long* ops);
+static double benchInsert(benchData_t* data, unsigned long* ops);
+static double benchFind(benchData_t* data, unsigned long* ops);
+static double benchSaveText(benchData_t* data, unsigned long* ops);
+static double benchSaveBinary(benchData_t* data, unsigned long* ops);
+static double benchLoadText(benchData_t* data, unsigned long* ops);
+static double benchLoadBinary(benchData_t* data, unsigned long* ops);
+static double benchQueryAnd(benchData_t* data, unsigned long* ops);
+static double benchQueryOr(benchData_t* data, unsigned long* ops);
+static double evaluateQueries(benchData_t* data, benchQuery_t* queries, unsigned long* ops);
+
+static const benchmark_t benchmarks[] = {
+  { "webpage_getNextWord", benchGetNextWord },
+  { "tokenizer_next", benchTokenizer },
+  { "pagestream_nextMany", benchPageStream },
+  { "normalizeWord", benchNormalizeWord },
+  { "normalizeWordInto", benchNormalizeWordInto },
+  { "index_insert", benchInsert },
+  { "index_find", benchFind },
+  { "index_save", benchSaveText },
+  { "index_save_binary", benchSaveBinary },
+  { "index_load", benchLoadText },
+  { "index_load_binary", benchLoadBinary },
+  { "queryEvaluate_and", benchQueryAnd },
+  { "queryEvaluate_or", benchQueryOr },
+};
+static const int numBenchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+// What the timed loops compute is added here, so they are not optimized away
+static volatile unsigned long sink;
+
+/**************** main ****************/
+/**
+ * Generates the collection, then runs the benchmarks, each in a child
+ * process, printing a line for each.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line argument strings.
+ *
+ * Returns: 0 on success, 1 on bad arguments, 2 if anything failed.
+ */
+int main(int argc, char* argv[])
+{
+  benchConfig_t config;
+  int first;
+  parseArgs(argc, argv, &config, &first);
+
+  // Step 1: Write the collection, and the indexes of it the loading and
+  // query benchmarks read
+  char tempDirectory[] = "/tmp/tse-bench.XXXXXX";
+  bool temporary = config.directory == NULL;
+  if (temporary) {
+    if (mkdtemp(tempDirectory) == NULL) {
+      fprintf(stderr, "Error: Could not create a directory in /tmp.\n");
+      exit(2);
+    }
+    config.directory = tempDirectory;
+  } else {
+    mkdir(config.directory, 0755);
+  }
+  if (!writeCollection(&config) || !writeIndexes(&config)) {
+    fprintf(stderr, "Error: Could not write the collection to %s.\n", config.directory);
+    exit(2);
+  }
+
+  // Step 2: Run the benchmarks asked for, or all of them
+  printf("# tse-bench label=%s pages=%d words=%d vocabulary=%d queries=%d seed=%llu min_seconds=%g compressed=%d\n",
+         config.label, config.numPages, config.wordsPerPage, config.vocabulary, config.numQueries,
+         (unsigned long long) config.seed, config.minSeconds, config.compress);
+  printf("benchmark\tops\tseconds\tops_per_sec\tns_per_op\tpeak_rss_kb\n");
+  fflush(stdout);
+  int failed = 0;
+  for (int b = 0; b < numBenchmarks; b++) {
+    bool wanted = first == argc;
+    for (int arg = first; arg < argc; arg++) {
+      wanted = wanted || strcmp(argv[arg], benchmarks[b].name) == 0;
+    }
+    if (!wanted) {
+      continue;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+      runBenchmark(&benchmarks[b], &config);
+      exit(0);
+    }
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      fprintf(stderr, "Error: benchmark %s failed.\n", benchmarks[b].name);
+      failed++;
+    }
+  }
+
+  // Step 3: Remove a temporary collection
+  if (temporary) {
+    char command[sizeof(tempDirectory) + 16];
+    sprintf(command, "rm -rf %s", tempDirectory);
+    if (system(command) != 0) {
+      fprintf(stderr, "Warning: Could not remove %s.\n", tempDirectory);
+    }
+  }
+  return failed > 0 ? 2 : 0;
+}
+
+/**************** parseArgs ****************/
+/**
+ * Parses the command-line arguments.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line argument strings.
+ * @param config Where to store the options, or their defaults.
+ * @param firstBenchmark Where to store the index of the first benchmark name.
+ *
+ * Exits with a usage message on a bad option or benchmark name.
+ */
+static void parseArgs(int argc, char* argv[], benchConfig_t* config, int* firstBenchmark)
+{
+  const char* usage = "Usage: ./tsebench [-p numPages] [-w wordsPerPage] [-v vocabulary] [-q numQueries]"
+                      " [-s seed] [-t minSeconds] [-l label] [-d directory] [-z] [benchmark...]\n";
+  config->numPages = 2000;
+  config->wordsPerPage = 400;
+  config->vocabulary = 20000;
+  config->numQueries = 2000;
+  config->seed = 1;
+  config->minSeconds = 0.5;
+  config->label = "none";
+  config->directory = NULL;
+  config->compress = false;
+
+  int arg = 1;
+  while (arg < argc && argv[arg][0] == '-') {
+    const char* option = argv[arg];
+    if (strcmp(option, "-z") == 0) {
+      config->compress = true;
+      arg++;
+      continue;
+    }
+    if (arg + 1 >= argc || strlen(option) != 2 || strchr("pwvqstld", option[1]) == NULL) {
+      fprintf(stderr, "%s", usage);
+      exit(1);
+    }
+    const char* value = argv[arg + 1];
+    arg += 2;
+    if (option[1] == 'l') {
+      config->label = value;
+      continue;
+    }
+    if (option[1] == 'd') {
+      config->directory = value;
+      continue;
+    }
+
+    char* end;
+    double number = strtod(value, &end);
+    bool ok = *value != '\0' && *end == '\0';
+    switch (option[1]) {
+      case 'p': ok = ok && number >= 1 && number <= 10000000; config->numPages = number; break;
+      case 'w': ok = ok && number >= 1 && number <= 1000000; config->wordsPerPage = number; break;
+      case 'v': ok = ok && number >= 10 && number <= 10000000; config->vocabulary = number; break;
+      case 'q': ok = ok && number >= 1 && number <= 10000000; config->numQueries = number; break;
+      case 's': ok = ok && number >= 0; config->seed = number; break;
+      default: ok = ok && number > 0 && number <= 3600; config->minSeconds = number; break;
+    }
+    if (!ok) {
+      fprintf(stderr, "Error: Bad value for %s: %s\n", option, value);
+      exit(1);
+    }
+  }
+
+  // Every name must be a benchmark's
+  for (int i = arg; i < argc; i++) {
+    bool known = false;
+    for (int b = 0; b < numBenchmarks; b++) {
+      known = known || strcmp(argv[i], benchmarks[b].name) == 0;
+    }
+    if (!known) {
+      fprintf(stderr, "Error: No benchmark named %s; there are:", argv[i]);
+      for (int b = 0; b < numBenchmarks; b++) {
+        fprintf(stderr, " %s", benchmarks[b].name);
+      }
+      fprintf(stderr, "\n");
+      exit(1);
+    }
+  }
+  *firstBenchmark = arg;
+}
+
+/**************** writeCollection ****************/
+/**
+ * Generates the pages and appends them to the page directory's segments,
+ * compressed if config->compress, in a child process so that none of it
+ * stays in the suite's memory.
+ *
+ * @param config The collection's size, seed and directory.
+ * @return true on success.
+ */
+static bool writeCollection(const benchConfig_t* config)
+{
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    benchData_t data = { config };
+    makeVocabulary(&data);
+    pagewriter_t* writer = NULL;
+    if (!pagedir_init(config->directory)
+        || (writer = pagedir_openWriter(config->directory, config->compress)) == NULL) {
+      exit(1);
+    }
+    uint64_t state = config->seed * 2 + 1;
+    size_t room = (size_t) config->wordsPerPage * 14 + 4096;
+    for (int docID = 1; docID <= config->numPages; docID++) {
+      // The page: a title, paragraphs of about a dozen words, and links
+      char* html = mem_malloc_assert(room, "bench page");
+      size_t len = sprintf(html, "<html><head><title>%s %s</title></head>\n<body>\n<p>",
+                           drawWord(&data, &state), drawWord(&data, &state));
+      for (int w = 0; w < config->wordsPerPage; w++) {
+        const char* word = drawWord(&data, &state);
+        uint64_t r = nextRandom(&state);
+        if (r % 4 == 0) {         // a capitalized word, for normalizeWord to do something
+          len += sprintf(html + len, "%c%s ", word[0] - 'a' + 'A', word + 1);
+        } else {
+          len += sprintf(html + len, "%s ", word);
+        }
+        if (r % 12 == 1) {
+          len += sprintf(html + len, "</p>\n<p>");
+        } else if (r % 50 == 2) {
+          len += sprintf(html + len, "<a href=\"http://bench.example/%d.html\">link</a> ",
+                         (int) (r >> 32) % config->numPages + 1);
+        }
+      }
+      sprintf(html + len, "</p>\n</body></html>\n");
+      char url[64];
+      sprintf(url, "http://bench.example/%d.html", docID);
+      webpage_t* page = webpage_new(mem_assert(strdup(url), "bench url"), 0, html);
+      bool ok = pagedir_append(writer, page) == docID;
+      webpage_delete(page);
+      if (!ok) {
+        pagedir_closeWriter(writer);
+        exit(1);
+      }
+    }
+    freeData(&data);
+    exit(pagedir_closeWriter(writer) ? 0 : 1);
+  }
+  int status;
+  return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**************** writeIndexes ****************/
+/**
+ * Indexes the collection and saves the index next to the page directory,
+ * as text and as binary, in a child process.
+ *
+ * @param config The collection.
+ * @return true on success.
+ */
+static bool writeIndexes(const benchConfig_t* config)
+{
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    benchData_t data = { config };
+    needIndex(&data);
+    for (int binary = 0; binary <= 1; binary++) {
+      char* filename = indexFilename(config, binary);
+      FILE* fp = fopen(filename, binary ? "wb" : "w");
+      if (fp == NULL) {
+        exit(1);
+      }
+      bool ok = true;
+      if (binary) {
+        ok = index_save_binary(data.index, fp);
+      } else {
+        index_save(data.index, fp);
+      }
+      if (fclose(fp) != 0 || !ok) {
+        exit(1);
+      }
+      mem_free(filename);
+    }
+    freeData(&data);
+    exit(0);
+  }
+  int status;
+  return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**************** runBenchmark ****************/
+/**
+ * Runs one benchmark's passes until they have taken minSeconds, and
+ * prints its line. Called in the benchmark's own process.
+ *
+ * @param bench The benchmark.
+ * @param config The collection.
+ */
+static void runBenchmark(const benchmark_t* bench, const benchConfig_t* config)
+{
+  benchData_t data = { config };
+  unsigned long ops = 0;
+  double seconds = 0;
+  do {
+    seconds += bench->pass(&data, &ops);
+  } while (seconds < config->minSeconds);
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);     // ru_maxrss is in kilobytes
+  printf("%s\t%lu\t%.6f\t%.1f\t%.2f\t%ld\n", bench->name, ops, seconds,
+         seconds > 0 ? ops / seconds : 0.0, ops > 0 ? 1e9 * seconds / ops : 0.0, usage.ru_maxrss);
+  fflush(stdout);
+  freeData(&data);
+}
+
+/**************** makeVocabulary ****************/
+/**
+ * Draws the vocabulary, and the cumulative probabilities of its words by
+ * Zipf's law.
+ *
+ * @param data Where to keep them.
+ */
+static void makeVocabulary(benchData_t* data)
+{
+  int v = data->config->vocabulary;
+  uint64_t state = data->config->seed;
+  data->vocabulary = mem_malloc_assert(v * sizeof(char*), "bench vocabulary");
+  data->cdf = mem_malloc_assert(v * sizeof(double), "bench vocabulary");
+  double total = 0;
+  for (int i = 0; i < v; i++) {
+    int len = 2 + nextRandom(&state) % 11;
+    char* word = mem_malloc_assert(len + 1, "bench word");
+    for (int c = 0; c < len; c++) {
+      word[c] = 'a' + nextRandom(&state) % 26;
+    }
+    word[len] = '\0';
+    data->vocabulary[i] = word;
+    total += 1.0 / (i + 1);
+    data->cdf[i] = total;
+  }
+  for (int i = 0; i < v; i++) {
+    data->cdf[i] /= total;
+  }
+}
+
+/**************** drawWord ****************/
+/**
+ * Draws a word of the vocabulary by Zipf's law.
+ *
+ * @param data The vocabulary.
+ * @param state The random number generator's state.
+ * @return The word (lowercase).
+ */
+static const char* drawWord(benchData_t* data, uint64_t* state)
+{
+  double u = (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);   // in [0, 1)
+  int lo = 0, hi = data->config->vocabulary - 1;
+  while (lo < hi) {           // the first word whose cdf exceeds u
+    int mid = lo + (hi - lo) / 2;
+    if (data->cdf[mid] > u) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return data->vocabulary[lo];
+}
+
+/**************** needPages ****************/
+/**
+ * Reads a copy of every page's HTML from the page directory, decompressed
+ * if it was compressed, unless it has been read.
+ *
+ * @param data Where to keep the pages.
+ */
+static void needPages(benchData_t* data)
+{
+  if (data->pages != NULL) {
+    return;
+  }
+  data->pages = mem_calloc_assert(data->config->numPages, sizeof(benchPage_t), "bench pages");
+  pagecursor_t* cursor = pagedir_openCursor(data->config->directory, 1);
+  int docID;
+  pagemap_t map;
+  while (cursor != NULL && data->numPages < data->config->numPages && pagedir_next(cursor, &docID, &map)) {
+    benchPage_t* page = &data->pages[data->numPages++];
+    if (map.compressed) {
+      lzframe_t frame;
+      size_t rawLen = lz_openFrame(&frame, map.html, map.htmlLen);
+      page->html = mem_malloc_assert(rawLen + 1, "bench page");
+      page->len = 0;
+      size_t blockLen;
+      while (lz_nextBlock(&frame, page->html + page->len, &blockLen)) {
+        page->len += blockLen;
+      }
+      if (frame.error || page->len != rawLen) {
+        fprintf(stderr, "Error: corrupt compressed page %d in the benchmark's collection.\n", docID);
+        exit(2);
+      }
+    } else {
+      page->html = mem_malloc_assert(map.htmlLen + 1, "bench page");
+      memcpy(page->html, map.html, map.htmlLen);
+      page->len = map.htmlLen;
+    }
+    page->html[page->len] = '\0';
+
+    tokenizer_t tok;
+    const char* word;
+    size_t len;
+    tokenizer_init(&tok, page->html, page->len);
+    while (tokenizer_next(&tok, &word, &len)) {
+      data->numWords++;
+    }
+  }
+  pagedir_closeCursor(cursor);
+}
+
+/**************** needIndex ****************/
+/**
+ * Builds the index of the pages, as the indexer does, unless it has been built.
+ *
+ * @param data Where to keep the index.
+ */
+static void needIndex(benchData_t* data)
+{
+  if (data->index != NULL) {
+    return;
+  }
+  unsigned long ops = 0;
+  benchInsert(data, &ops);
+}
+
+/**************** needIndexSet ****************/
+/**
+ * Opens the saved binary index as the querier does, unless it is open.
+ *
+ * @param data Where to keep it.
+ */
+static void needIndexSet(benchData_t* data)
+{
+  if (data->indexes != NULL) {
+    return;
+  }
+  char* filename = indexFilename(data->config, true);
+  data->indexes = indexset_open(filename);
+  mem_free(filename);
+  if (data->indexes == NULL) {
+    fprintf(stderr, "Error: Could not open the benchmark's index.\n");
+    exit(2);
+  }
+}
+
+/**************** needQueries ****************/
+/**
+ * Draws the AND-heavy and OR-heavy queries, unless they have been drawn.
+ *
+ * @param data Where to keep them.
+ */
+static void needQueries(benchData_t* data)
+{
+  if (data->andQueries != NULL) {
+    return;
+  }
+  if (data->vocabulary == NULL) {
+    makeVocabulary(data);
+  }
+  uint64_t state = data->config->seed * 3 + 7;
+  data->andQueries = mem_malloc_assert(data->config->numQueries * sizeof(benchQuery_t), "bench queries");
+  data->orQueries = mem_malloc_assert(data->config->numQueries * sizeof(benchQuery_t), "bench queries");
+  makeQueries(data, data->andQueries, false, &state);
+  makeQueries(data, data->orQueries, true, &state);
+}
+
+/**************** freeData ****************/
+/**
+ * Frees whatever parts of a benchmark's data were read in.
+ *
+ * @param data The data.
+ */
+static void freeData(benchData_t* data)
+{
+  for (int i = 0; i < data->numPages; i++) {
+    mem_free(data->pages[i].html);
+  }
+  if (data->pages != NULL) {
+    mem_free(data->pages);
+  }
+  if (data->vocabulary != NULL) {
+    for (int i = 0; i < data->config->vocabulary; i++) {
+      mem_free(data->vocabulary[i]);
+    }
+    mem_free(data->vocabulary);
+    mem_free(data->cdf);
+  }
+  index_delete(data->index);
+  indexset_delete(data->indexes);
+  if (data->andQueries != NULL) {
+    mem_free(data->andQueries);
+    mem_free(data->orQueries);
+  }
+}
+
+/**************** makeQueries ****************/
+/**
+ * Draws queries of words of 3 letters or more, which the index can match.
+ *
+ * @param data The vocabulary.
+ * @param queries Where to store numQueries queries.
+ * @param or Whether to make OR-heavy queries (3 to 5 sequences of 1 or 2
+ *           words) instead of AND-heavy ones (2 to 4 words, with "and"
+ *           between some of them, as users write them).
+ * @param state The random number generator's state.
+ */
+static void makeQueries(benchData_t* data, benchQuery_t* queries, const bool or, uint64_t* state)
+{
+  static char and[] = "and";
+  static char orWord[] = "or";
+  for (int q = 0; q < data->config->numQueries; q++) {
+    benchQuery_t* query = &queries[q];
+    query->n = 0;
+    int numSequences = or ? 3 + nextRandom(state) % 3 : 1;
+    for (int s = 0; s < numSequences; s++) {
+      int numWords = or ? 1 + nextRandom(state) % 2 : 2 + nextRandom(state) % 3;
+      if (s > 0) {
+        query->words[query->n++] = orWord;
+      }
+      for (int w = 0; w < numWords; w++) {
+        const char* word;
+        do {
+          word = drawWord(data, state);
+        } while (strlen(word) < 3);
+        if (w > 0 && nextRandom(state) % 2 == 0) {
+          query->words[query->n++] = and;
+        }
+        query->words[query->n++] = (char*) word;
+      }
+    }
+  }
+}
+
+/**************** indexFilename ****************/
+/**
+ * Returns the name of the saved index, next to the page directory's pages.
+ *
+ * @param config The collection.
+ * @param binary Whether to name the binary index instead of the text one.
+ * @return A new string; the caller must mem_free it.
+ */
+static char* indexFilename(const benchConfig_t* config, const bool binary)
+{
+  char* filename = mem_malloc_assert(strlen(config->directory) + 32, "bench filename");
+  sprintf(filename, "%s/bench.%s", config->directory, binary ? "bindex" : "index");
+  return filename;
+}
+
+/**************** nextRandom ****************/
+/**
+ * Returns the next number of a splitmix64 sequence: fast, deterministic
+ * from its seed on every platform, and good enough to draw words with.
+ *
+ * @param state The generator's state, advanced.
+ * @return A random 64-bit number.
+ */
+static uint64_t nextRandom(uint64_t* state)
+{
+  uint64_t z = (*state += 0x9e3779b97f4a7c15u);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  return z ^ (z >> 31);
+}
+
+/**************** secondsSince ****************/
+/**
+ * Returns the seconds elapsed since a CLOCK_MONOTONIC time.
+ */
+static double secondsSince(const struct timespec* start)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**************** countPosting ****************/
+/**
+ * index_iterate callback: adds a word's number of postings to *arg.
+ */
+static void countPosting(void* arg, const char* word, const size_t len, const postings_t* postings)
+{
+  (void) word;
+  (void) len;
+  *(unsigned long*) arg += postings_size(postings);
+}
+
+/**************** benchGetNextWord ****************/
+static double benchGetNextWord(benchData_t* data, unsigned long* ops)
+{
+  needPages(data);
+
+  // webpage_getNextWord squeezes the page's white space, so it gets copies
+  webpage_t** pages = mem_malloc_assert(data->numPages * sizeof(webpage_t*), "bench pages");
+  for (int i = 0; i < data->numPages; i++) {
+    char* html = mem_malloc_assert(data->pages[i].len + 1, "bench page");
+    memcpy(html, data->pages[i].html, data->pages[i].len + 1);
+    pages[i] = webpage_new(mem_assert(strdup("http://bench.example/"), "bench url"), 0, html);
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < data->numPages; i++) {
+    int pos = 0;
+    char* word;
+    while ((word = webpage_getNextWord(pages[i], &pos)) != NULL) {
+      free(word);
+      (*ops)++;
+    }
+  }
+  double seconds = secondsSince(&start);
+
+  for (int i = 0; i < data->numPages; i++) {
+    webpage_delete(pages[i]);
+  }
+  mem_free(pages);
+  return seconds;
+}
+
+/**************** benchTokenizer ****************/
+static double benchTokenizer(benchData_t* data, unsigned long* ops)
+{
+  needPages(data);
+  size_t totalLen = 0;
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < data->numPages; i++) {
+    tokenizer_t tok;
+    const char* word;
+    size_t len;
+    tokenizer_init(&tok, data->pages[i].html, data->pages[i].len);
+    while (tokenizer_next(&tok, &word, &len)) {
+      totalLen += len;
+      (*ops)++;
+    }
+  }
+  double seconds = secondsSince(&start);
+  sink += totalLen;
+  return seconds;
+}
+
+/**************** benchPageStream ****************/
+static double benchPageStream(benchData_t* data, unsigned long* ops)
+{
+  size_t totalLen = 0;
+  tokenizer_span_t spans[64];
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  pagecursor_t* cursor = pagedir_openCursor(data->config->directory, 1);
+  int docID;
+  pagemap_t map;
+  while (cursor != NULL && pagedir_next(cursor, &docID, &map)) {
+    pagestream_t stream;
+    size_t n;
+    pagestream_open(&stream, &map);
+    while ((n = pagestream_nextMany(&stream, spans, 64)) > 0) {
+      for (size_t i = 0; i < n; i++) {
+        totalLen += spans[i].len;
+      }
+      *ops += n;
+    }
+    if (!pagestream_close(&stream)) {
+      fprintf(stderr, "Error: corrupt compressed page %d in the benchmark's collection.\n", docID);
+      exit(2);
+    }
+  }
+  pagedir_closeCursor(cursor);
+  double seconds = secondsSince(&start);
+  sink += totalLen;
+  return seconds;
+}
+
+/**************** benchNormalizeWord ****************/
+static double benchNormalizeWord(benchData_t* data, unsigned long* ops)
+{
+  needPages(data);
+
+  // The pages' words, null-terminated, as a word list
+  char** words = mem_malloc_assert(data->numWords * sizeof(char*), "bench words");
+  size_t n = 0;
+  for (int i = 0; i < data->numPages; i++) {
+    tokenizer_t tok;
+    const char* word;
+    size_t len;
+    tokenizer_init(&tok, data->pages[i].html, data->pages[i].len);
+    while (tokenizer_next(&tok, &word, &len)) {
+      words[n] = mem_malloc_assert(len + 1, "bench word");
+      memcpy(words[n], word, len);
+      words[n++][len] = '\0';
+    }
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < n; i++) {
+    mem_free(normalizeWord(words[i]));
+  }
+  double seconds = secondsSince(&start);
+  *ops += n;
+
+  for (size_t i = 0; i < n; i++) {
+    mem_free(words[i]);
+  }
+  mem_free(words);
+  return seconds;
+}
+
+/**************** benchNormalizeWordInto ****************/
+static double benchNormalizeWordInto(benchData_t* data, unsigned long* ops)
+{
+  needPages(data);
+  char* buf = NULL;
+  size_t bufSize = 0;
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < data->numPages; i++) {
+    tokenizer_t tok;
+    const char* word;
+    size_t len;
+    tokenizer_init(&tok, data->pages[i].html, data->pages[i].len);
+    while (tokenizer_next(&tok, &word, &len)) {
+      normalizeWordInto(word, len, &buf, &bufSize);
+      (*ops)++;
+    }
+  }
+  double seconds = secondsSince(&start);
+  if (buf != NULL) {
+    mem_free(buf);
+  }
+  return seconds;
+}
+
+/**************** benchInsert ****************/
+static double benchInsert(benchData_t* data, unsigned long* ops)
+{
+  needPages(data);
+
+  // The words the indexer inserts, lowercased, so only the insertions are timed
+  tokenizer_span_t* spans = mem_malloc_assert(data->numWords * sizeof(tokenizer_span_t), "bench words");
+  int* docIDs = mem_malloc_assert(data->numWords * sizeof(int), "bench words");
+  char* text = mem_malloc_assert(data->numWords * 13 + 1, "bench words");
+  size_t n = 0, used = 0;
+  for (int i = 0; i < data->numPages; i++) {
+    tokenizer_t tok;
+    const char* word;
+    size_t len;
+    tokenizer_init(&tok, data->pages[i].html, data->pages[i].len);
+    while (tokenizer_next(&tok, &word, &len)) {
+      if (len >= 3 && len <= 12) {
+        for (size_t c = 0; c < len; c++) {
+          text[used + c] = tolower((unsigned char) word[c]);
+        }
+        spans[n].word = text + used;
+        spans[n].len = len;
+        docIDs[n++] = i + 1;
+        used += len;
+      }
+    }
+  }
+
+  if (data->index != NULL) {
+    index_delete(data->index);
+  }
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  data->index = index_new(500);
+  for (size_t i = 0; i < n; i++) {
+    index_insertn(data->index, spans[i].word, spans[i].len, docIDs[i]);
+  }
+  double seconds = secondsSince(&start);
+  *ops += n;
+
+  data->numPostings = 0;
+  index_iterate(data->index, &data->numPostings, countPosting);
+  mem_free(spans);
+  mem_free(docIDs);
+  mem_free(text);
+  return seconds;
+}
+
+/**************** benchFind ****************/
+static double benchFind(benchData_t* data, unsigned long* ops)
+{
+  needIndex(data);
+  if (data->vocabulary == NULL) {
+    makeVocabulary(data);
+  }
+
+  // Every vocabulary word, each followed by one not in the index
+  int v = data->config->vocabulary;
+  char missing[16];
+  unsigned long found = 0;
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < v; i++) {
+    found += index_find(data->index, data->vocabulary[i]) != NULL;
+    sprintf(missing, "zz%dq", i);
+    found += index_find(data->index, missing) != NULL;
+  }
+  double seconds = secondsSince(&start);
+  *ops += 2 * (unsigned long) v;
+  sink += found;
+  return seconds;
+}
+
+/**************** benchSaveText ****************/
+static double benchSaveText(benchData_t* data, unsigned long* ops)
+{
+  needIndex(data);
+  FILE* fp = tmpfile();
+  mem_assert(fp, "bench: no temporary file");
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  index_save(data->index, fp);
+  fflush(fp);
+  double seconds = secondsSince(&start);
+  fclose(fp);
+  *ops += data->numPostings;
+  return seconds;
+}
+
+/**************** benchSaveBinary ****************/
+static double benchSaveBinary(benchData_t* data, unsigned long* ops)
+{
+  needIndex(data);
+  FILE* fp = tmpfile();
+  mem_assert(fp, "bench: no temporary file");
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (!index_save_binary(data->index, fp) || fflush(fp) != 0) {
+    fprintf(stderr, "Error: Could not save the binary index.\n");
+    exit(2);
+  }
+  double seconds = secondsSince(&start);
+  fclose(fp);
+  *ops += data->numPostings;
+  return seconds;
+}
+
+/**************** benchLoadText ****************/
+static double benchLoadText(benchData_t* data, unsigned long* ops)
+{
+  char* filename = indexFilename(data->config, false);
+  FILE* fp = fopen(filename, "r");
+  mem_free(filename);
+  mem_assert(fp, "bench: no text index");
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  index_t* index = index_load(fp);
+  double seconds = secondsSince(&start);
+  fclose(fp);
+  if (index == NULL) {
+    fprintf(stderr, "Error: Could not load the text index.\n");
+    exit(2);
+  }
+  unsigned long postings = 0;
+  index_iterate(index, &postings, countPosting);
+  index_delete(index);
+  *ops += postings;
+  return seconds;
+}
+
+/**************** benchLoadBinary ****************/
+static double benchLoadBinary(benchData_t* data, unsigned long* ops)
+{
+  char* filename = indexFilename(data->config, true);
+  FILE* fp = fopen(filename, "rb");
+  mem_free(filename);
+  mem_assert(fp, "bench: no binary index");
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  index_t* index = index_load(fp);
+  double seconds = secondsSince(&start);
+  fclose(fp);
+  if (index == NULL) {
+    fprintf(stderr, "Error: Could not load the binary index.\n");
+    exit(2);
+  }
+  unsigned long postings = 0;
+  index_iterate(index, &postings, countPosting);
+  index_delete(index);
+  *ops += postings;
+  return seconds;
+}
+
+/**************** benchQueryAnd ****************/
+static double benchQueryAnd(benchData_t* data, unsigned long* ops)
+{
+  needQueries(data);
+  return evaluateQueries(data, data->andQueries, ops);
+}
+
+/**************** benchQueryOr ****************/
+static double benchQueryOr(benchData_t* data, unsigned long* ops)
+{
+  needQueries(data);
+  return evaluateQueries(data, data->orQueries, ops);
+}
+
+/**************** evaluateQueries ****************/
+/**
+ * Evaluates every query of a workload, as the querier does, resetting
+ * one arena after each as a query session does.
+ *
+ * @param data The index set, opened the first time.
+ * @param queries The workload's numQueries queries.
+ * @param ops Where to add the number of queries.
+ * @return The seconds the evaluations took.
+ */
+static double evaluateQueries(benchData_t* data, benchQuery_t* queries, unsigned long* ops)
+{
+  needIndexSet(data);
+  arena_t* arena = arena_new(65536);
+  unsigned long matches = 0;
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int q = 0; q < data->config->numQueries; q++) {
+    postings_t* result = queryEvaluate(queries[q].words, queries[q].n, data->indexes, arena);
+    matches += postings_size(result);
+    arena_reset(arena);
+  }
+  double seconds = secondsSince(&start);
+  arena_delete(arena);
+  *ops += data->config->numQueries;
+  sink += matches;
+  return seconds;
+}
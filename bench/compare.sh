@@ -0,0 +1,30 @@
+#!/bin/bash
+#
+# compare.sh - compares two reports of the benchmark suite
+#
+# Usage: ./compare.sh before.tsv after.tsv
+#
+# Prints, for each benchmark in both reports, its ns per op in each and
+# their ratio (after / before: below 1 is faster), and its peak RSS in each.
+#
+# Atziri Enriquez
+
+if [ $# -ne 2 ] || [ ! -r "$1" ] || [ ! -r "$2" ]; then
+    echo "Usage: $0 before.tsv after.tsv" >&2
+    exit 1
+fi
+
+label() {
+    sed -n 's/^# tse-bench label=\([^ ]*\).*/\1/p' "$1"
+}
+echo "# before: $(label "$1")  after: $(label "$2")"
+
+# Read before's lines, then print after's benchmarks that are in both
+awk -F'\t' '
+    /^#/ || $1 == "benchmark" { next }
+    FNR == NR { ns[$1] = $5; rss[$1] = $6; next }
+    $1 in ns {
+        ratio = ns[$1] > 0 ? $5 / ns[$1] : 0
+        printf "%-20s %12s %12s %8.3f %12s %12s\n", $1, ns[$1], $5, ratio, rss[$1], $6
+    }
+' "$1" "$2" | (printf "%-20s %12s %12s %8s %12s %12s\n" benchmark ns/op-before ns/op-after ratio rss-before rss-after; cat)
@@ -0,0 +1,117 @@
+/*
+ * arena.c - CS50 Tiny Search Engine (TSE) arena allocator
+ *
+ * see arena.h for more information.
+ *
+ * Blocks are chained newest first; only the newest is allocated from.
+ * A request that does not fit starts a new block at least twice the size
+ * of the last, so a query needs O(log bytes) blocks.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "arena.h"
+#include "../libcs50/mem.h"
+
+/**************** constants ****************/
+#define ALIGNMENT _Alignof(max_align_t)
+static const size_t MIN_BLOCK = 4096;
+
+/**************** local types ****************/
+typedef struct block {
+  struct block* next;       // the block allocated before this one
+  size_t size;              // usable bytes after the header
+  size_t used;
+} block_t;
+
+/* the header is padded so that block memory starts aligned */
+#define HEADER_BYTES ((sizeof(block_t) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+
+typedef struct arena {
+  block_t* blocks;          // newest first
+  size_t blockBytes;        // the size of the first block
+} arena_t;
+
+/**************** local functions ****************/
+static block_t* newBlock(const size_t size, block_t* next);
+
+/**************** arena_new ****************/
+/* see arena.h for description */
+arena_t* arena_new(const size_t blockBytes)
+{
+  arena_t* arena = mem_malloc_assert(sizeof(arena_t), "arena_new");
+  arena->blockBytes = blockBytes < MIN_BLOCK ? MIN_BLOCK : blockBytes;
+  arena->blocks = newBlock(arena->blockBytes, NULL);
+  return arena;
+}
+
+/**************** arena_alloc ****************/
+/* see arena.h for description */
+void* arena_alloc(arena_t* arena, const size_t bytes)
+{
+  if (arena == NULL) {
+    return NULL;
+  }
+  if (bytes > SIZE_MAX / 4) {
+    mem_assert(NULL, "arena_alloc: request too large");   // could never be allocated
+  }
+
+  size_t rounded = bytes == 0 ? ALIGNMENT : (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  block_t* block = arena->blocks;
+  if (block->size - block->used < rounded) {
+    size_t size = 2 * block->size;
+    while (size < rounded) {
+      size *= 2;
+    }
+    block = arena->blocks = newBlock(size, block);
+  }
+
+  void* p = (char*) block + HEADER_BYTES + block->used;
+  block->used += rounded;
+  return p;
+}
+
+/**************** arena_reset ****************/
+/* see arena.h for description */
+void arena_reset(arena_t* arena)
+{
+  if (arena == NULL) {
+    return;
+  }
+
+  // the newest block is the largest; keep it alone
+  block_t* block = arena->blocks->next;
+  while (block != NULL) {
+    block_t* next = block->next;
+    mem_free(block);
+    block = next;
+  }
+  arena->blocks->next = NULL;
+  arena->blocks->used = 0;
+}
+
+/**************** arena_delete ****************/
+/* see arena.h for description */
+void arena_delete(arena_t* arena)
+{
+  if (arena == NULL) {
+    return;
+  }
+  arena_reset(arena);
+  mem_free(arena->blocks);
+  mem_free(arena);
+}
+
+/* Creates an empty block of `size` usable bytes, chained before `next` */
+static block_t* newBlock(const size_t size, block_t* next)
+{
+  block_t* block = mem_malloc_assert(HEADER_BYTES + size, "arena block");
+  block->next = next;
+  block->size = size;
+  block->used = 0;
+  return block;
+}
@@ -0,0 +1,70 @@
+/*
+ * arena.h - CS50 Tiny Search Engine (TSE) arena allocator
+ *
+ * An arena hands out memory by bumping a pointer through large blocks,
+ * and takes it all back at once: there is no per-allocation free. It
+ * suits the querier, whose allocations (the query's words, posting lists
+ * of AND and OR sequences, ranking arrays) all die together when the
+ * query is done, so it can reset one arena per query instead of freeing
+ * each piece.
+ *
+ * Resetting keeps the arena's largest block (blocks grow by doubling), so
+ * a steady stream of similar queries allocates nothing from the heap.
+ *
+ * Functions:
+ *  - `arena_new`: Creates an empty arena.
+ *  - `arena_alloc`: Allocates memory that lives until the next reset.
+ *  - `arena_reset`: Frees everything allocated since the last reset.
+ *  - `arena_delete`: Frees an arena.
+ *
+ * Error Handling:
+ *  - Running out of memory terminates the program via `mem_assert`.
+ *  - An arena is NOT thread-safe; use one per thread.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <stddef.h>
+
+/* The arena; opaque to users of the module */
+typedef struct arena arena_t;
+
+/**
+ * Creates an empty arena.
+ *
+ * @param blockBytes The size of its first block (a minimum applies);
+ *                   later blocks double.
+ * @return Pointer to a new arena.
+ */
+arena_t* arena_new(const size_t blockBytes);
+
+/**
+ * Allocates memory from an arena.
+ *
+ * @param arena The arena.
+ * @param bytes How much memory; 0 gives a valid, distinct pointer.
+ * @return Memory suitably aligned for any type, uninitialized, valid
+ *         until the arena is reset or deleted; NULL if arena is NULL.
+ */
+void* arena_alloc(arena_t* arena, const size_t bytes);
+
+/**
+ * Frees everything allocated from an arena at once, keeping its largest
+ * block for reuse.
+ *
+ * @param arena The arena; NULL is ignored.
+ */
+void arena_reset(arena_t* arena);
+
+/**
+ * Deletes an arena and everything allocated from it.
+ *
+ * @param arena The arena; NULL is ignored.
+ */
+void arena_delete(arena_t* arena);
+
+#endif // __ARENA_H
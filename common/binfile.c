@@ -0,0 +1,58 @@
+/*
+ * binfile.c - CS50 Tiny Search Engine (TSE) binary file helpers
+ *
+ * see binfile.h for more information.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // mmap, fstat
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "binfile.h"
+
+/**************** binfile_map ****************/
+/* see binfile.h for description */
+const void* binfile_map(const char* path, const size_t minSize, size_t* size)
+{
+  if (path == NULL || size == NULL) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
+  }
+  if (!S_ISREG(st.st_mode) || st.st_size == 0 || (size_t) st.st_size < minSize) {
+    close(fd);
+    errno = EINVAL;
+    return NULL;
+  }
+  void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);                  // the mapping keeps the file open
+  if (base == MAP_FAILED) {
+    return NULL;
+  }
+  *size = st.st_size;
+  return base;
+}
+
+/**************** binfile_unmap ****************/
+/* see binfile.h for description */
+void binfile_unmap(const void* base, const size_t size)
+{
+  if (base != NULL) {
+    munmap((void*) base, size);
+  }
+}
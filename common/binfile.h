@@ -0,0 +1,95 @@
+/*
+ * binfile.h - CS50 Tiny Search Engine (TSE) binary file helpers
+ *
+ * What the binary formats (the index, the document table, the impacts
+ * sidecar, the page segments and the LZ frames) share: fixed-width
+ * little-endian integers, and mapping a whole file read-only.
+ *
+ * The integer helpers are inline, since the readers decode with them in
+ * their inner loops. They work a byte at a time, so they need no
+ * alignment and read the same on any host.
+ *
+ * Functions:
+ *  - `binfile_get32`, `binfile_get64`: Read a little-endian integer from memory.
+ *  - `binfile_set32`: Writes a little-endian integer to memory.
+ *  - `binfile_put32`, `binfile_put64`: Write a little-endian integer to a file.
+ *  - `binfile_map`: Maps a whole regular file read-only.
+ *  - `binfile_unmap`: Unmaps it.
+ *
+ * Error Handling:
+ *  - `binfile_put32` and `binfile_put64` return false on a write error.
+ *  - `binfile_map` returns NULL, with errno set, if the file cannot be
+ *    opened or mapped, or is not a regular file of at least the size asked.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __BINFILE_H
+#define __BINFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**************** little-endian integers ****************/
+
+/* Reads a 32-bit little-endian integer */
+static inline uint32_t binfile_get32(const void* src)
+{
+  const uint8_t* p = src;
+  return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+/* Reads a 64-bit little-endian integer */
+static inline uint64_t binfile_get64(const void* src)
+{
+  const uint8_t* p = src;
+  return (uint64_t) binfile_get32(p) | (uint64_t) binfile_get32(p + 4) << 32;
+}
+
+/* Writes a 32-bit little-endian integer to dst[0..3] */
+static inline void binfile_set32(void* dst, const uint32_t value)
+{
+  uint8_t* p = dst;
+  for (int i = 0; i < 4; i++) {
+    p[i] = value >> (8 * i);
+  }
+}
+
+/* Writes a 32-bit little-endian integer to a file; false on error */
+static inline bool binfile_put32(FILE* fp, const uint32_t value)
+{
+  uint8_t b[4];
+  binfile_set32(b, value);
+  return fwrite(b, 1, sizeof(b), fp) == sizeof(b);
+}
+
+/* Writes a 64-bit little-endian integer to a file; false on error */
+static inline bool binfile_put64(FILE* fp, const uint64_t value)
+{
+  return binfile_put32(fp, (uint32_t) value) && binfile_put32(fp, (uint32_t) (value >> 32));
+}
+
+/**************** binfile_map ****************/
+/**
+ * Maps a whole file read-only.
+ *
+ * @param path The file.
+ * @param minSize The fewest bytes it may have, at least 1.
+ * @param size Where to store its length.
+ * @return The mapping, which stays valid until `binfile_unmap`; or NULL
+ *         if the file cannot be opened (errno says why, e.g. ENOENT),
+ *         is not a regular file or is shorter than minSize (errno EINVAL),
+ *         or cannot be mapped.
+ */
+const void* binfile_map(const char* path, const size_t minSize, size_t* size);
+
+/**************** binfile_unmap ****************/
+/**
+ * Unmaps a mapping `binfile_map` returned; size is the length it stored.
+ */
+void binfile_unmap(const void* base, const size_t size);
+
+#endif // __BINFILE_H
@@ -0,0 +1,312 @@
+/*
+ * blockmax.c - CS50 Tiny Search Engine (TSE) impact-ranked query evaluation
+ *
+ * see blockmax.h for more information.
+ *
+ * Each word of a sequence has a cursor with two positions: the posting
+ * the sequence's intersection reached, and, for bounds, the block it last
+ * looked at, which may run ahead of the posting. Both only move forward,
+ * since the documents visited only increase. A sequence's current match
+ * is kept with its score; a sequence that can no longer contribute is
+ * left behind and moved to a candidate only when one needs it.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+#include "blockmax.h"
+#include "../libcs50/mem.h"
+
+/**************** local types ****************/
+typedef struct cursor {
+  const postings_t* postings;
+  const posting_t* entries;
+  size_t size;
+  const uint8_t* impacts;
+  const uint8_t* blockMax;
+  size_t pos;               // the first posting at or after the last target
+  size_t block;             // the block of the last bound
+} cursor_t;
+
+typedef struct sequence {
+  cursor_t* cursors;        // rarest word first
+  int n;
+  int doc;                  // the next match, or INT_MAX once there is none
+  int score;                // the match's score
+  int bound;                // the most any document can score in it
+} sequence_t;
+
+/**************** local functions ****************/
+static size_t evaluate(const impactlist_t lists[], const int ends[], const int numSequences,
+                       const size_t k, ranked_t out[], postings_t* all, arena_t* arena,
+                       blockmax_stats_t* stats);
+static sequence_t* newSequences(const impactlist_t lists[], const int ends[], const int numSequences,
+                                arena_t* arena);
+static void advance(sequence_t* seq, const int target);
+static int sequenceBound(sequence_t* seq, const int docID, int* end);
+static int blockBound(cursor_t* cursor, const int docID, int* end);
+static int blockLast(const cursor_t* cursor, const size_t block);
+static int compareSizes(const void* a, const void* b);
+
+/**************** blockmax_all ****************/
+/* see blockmax.h for description */
+postings_t* blockmax_all(const impactlist_t lists[], const int ends[], const int numSequences,
+                         arena_t* arena)
+{
+  postings_t* all = postings_newIn(0, arena);
+  evaluate(lists, ends, numSequences, 0, NULL, all, arena, NULL);
+  return all;
+}
+
+/**************** blockmax_topk ****************/
+/* see blockmax.h for description */
+size_t blockmax_topk(const impactlist_t lists[], const int ends[], const int numSequences,
+                     const size_t k, ranked_t out[], arena_t* arena, blockmax_stats_t* stats)
+{
+  if (out == NULL || k == 0) {
+    return 0;
+  }
+  return evaluate(lists, ends, numSequences, k, out, NULL, arena, stats);
+}
+
+/* Visits the matching documents in docID order: appending every one to
+ * all, if given; else keeping the best k in out, skipping (see
+ * blockmax.h) once there are k. Returns how many are in out. */
+static size_t evaluate(const impactlist_t lists[], const int ends[], const int numSequences,
+                       const size_t k, ranked_t out[], postings_t* all, arena_t* arena,
+                       blockmax_stats_t* stats)
+{
+  if (lists == NULL || ends == NULL || numSequences <= 0) {
+    return 0;
+  }
+  sequence_t* seqs = newSequences(lists, ends, numSequences, arena);
+
+  // The sequences by increasing bound; the first numLagging, whose bounds
+  // add up to laggingBound, cannot bring in a document on their own
+  int* order = arena_alloc(arena, numSequences * sizeof(int));
+  for (int s = 0; s < numSequences; s++) {
+    order[s] = s;
+    for (int j = s; j > 0 && seqs[order[j]].bound < seqs[order[j - 1]].bound; j--) {
+      int t = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = t;
+    }
+    advance(&seqs[s], 0);
+  }
+  int numLagging = 0;
+  int laggingBound = 0;
+  size_t n = 0;
+  int threshold = -1;       // the k-th best score, once there are k
+
+  for (;;) {
+    // Step 1: The next candidate is the next match of a leading sequence
+    int docID = INT_MAX;
+    for (int i = numLagging; i < numSequences; i++) {
+      docID = seqs[order[i]].doc < docID ? seqs[order[i]].doc : docID;
+    }
+    if (docID == INT_MAX) {
+      break;
+    }
+
+    // Step 2: Skip up to the first block end if no document there can
+    // beat the k-th best
+    if (threshold >= 0) {
+      int bound = 0, end = INT_MAX;
+      for (int s = 0; s < numSequences; s++) {
+        bound += sequenceBound(&seqs[s], docID, &end);
+      }
+      if (bound <= threshold) {
+        if (stats != NULL) {
+          stats->skipped++;
+        }
+        if (end == INT_MAX) {
+          break;
+        }
+        for (int i = numLagging; i < numSequences; i++) {
+          advance(&seqs[order[i]], end + 1);
+        }
+        continue;
+      }
+    }
+
+    // Step 3: Score the candidate, in the lagging sequences only if it
+    // could still beat the k-th best
+    int score = 0;
+    for (int i = numLagging; i < numSequences; i++) {
+      score += seqs[order[i]].doc == docID ? seqs[order[i]].score : 0;
+    }
+    if (threshold < 0 || score + laggingBound > threshold) {
+      for (int i = 0; i < numLagging; i++) {
+        sequence_t* seq = &seqs[order[i]];
+        advance(seq, docID);
+        score += seq->doc == docID ? seq->score : 0;
+      }
+      if (stats != NULL) {
+        stats->scored++;
+      }
+      ranked_t doc = { docID, score };
+      if (all != NULL) {
+        postings_append(all, docID, score);
+      } else if (ranking_push(out, &n, k, &doc) && n == k) {
+        // A better k-th best: more sequences may now lag
+        threshold = out[0].score;
+        while (numLagging < numSequences && laggingBound + seqs[order[numLagging]].bound <= threshold) {
+          laggingBound += seqs[order[numLagging++]].bound;
+        }
+      }
+    }
+
+    // Step 4: Move the leading sequences past the candidate
+    for (int i = numLagging; i < numSequences; i++) {
+      advance(&seqs[order[i]], docID + 1);
+    }
+  }
+
+  ranking_sort(out, n);
+  return n;
+}
+
+/* Creates the sequences, with a cursor per list, rarest list first */
+static sequence_t* newSequences(const impactlist_t lists[], const int ends[], const int numSequences,
+                                arena_t* arena)
+{
+  sequence_t* seqs = arena_alloc(arena, numSequences * sizeof(sequence_t));
+  for (int s = 0; s < numSequences; s++) {
+    int first = s == 0 ? 0 : ends[s - 1];
+    sequence_t* seq = &seqs[s];
+    seq->n = ends[s] - first;
+    seq->cursors = arena_alloc(arena, (seq->n > 0 ? seq->n : 1) * sizeof(cursor_t));
+    seq->doc = seq->n > 0 ? -1 : INT_MAX;
+    seq->score = 0;
+    seq->bound = 0;
+    for (int j = 0; j < seq->n; j++) {
+      const impactlist_t* list = &lists[first + j];
+      cursor_t* cursor = &seq->cursors[j];
+      cursor->postings = list->postings;
+      cursor->entries = postings_entries(list->postings);
+      cursor->size = postings_size(list->postings);
+      cursor->impacts = list->impacts;
+      cursor->blockMax = list->blockMax;
+      cursor->pos = 0;
+      cursor->block = 0;
+      seq->bound += list->maxImpact;
+    }
+    qsort(seq->cursors, seq->n, sizeof(cursor_t), compareSizes);
+  }
+  return seqs;
+}
+
+/* Moves a sequence to its first match at or after target: each word's
+ * cursor gallops to the latest docID any of them has reached, until they
+ * all agree */
+static void advance(sequence_t* seq, const int target)
+{
+  if (seq->doc >= target) {
+    return;
+  }
+  int docID = target;
+  for (int i = 0; i < seq->n; ) {
+    cursor_t* cursor = &seq->cursors[i];
+    cursor->pos = postings_seek(cursor->postings, cursor->pos, docID);
+    if (cursor->pos == cursor->size) {
+      seq->doc = INT_MAX;     // a word has run out
+      return;
+    }
+    if (cursor->entries[cursor->pos].docID > docID) {
+      docID = cursor->entries[cursor->pos].docID;
+      i = i == 0 ? 1 : 0;     // the others must catch up
+    } else {
+      i++;
+    }
+  }
+
+  seq->doc = docID;
+  seq->score = 0;
+  for (int i = 0; i < seq->n; i++) {
+    seq->score += seq->cursors[i].impacts[seq->cursors[i].pos];
+  }
+}
+
+/* Returns the most a document from docID up to *end can score in a
+ * sequence, lowering *end to where the bound stops holding; 0 (leaving
+ * *end) once the sequence has no match left */
+static int sequenceBound(sequence_t* seq, const int docID, int* end)
+{
+  if (seq->doc == INT_MAX) {
+    return 0;
+  }
+  int bound = 0, seqEnd = INT_MAX;
+  for (int i = 0; i < seq->n; i++) {
+    int impact = blockBound(&seq->cursors[i], docID, &seqEnd);
+    if (impact < 0) {
+      seq->doc = INT_MAX;     // no posting left at docID or later
+      return 0;
+    }
+    bound += impact;
+  }
+  *end = seqEnd < *end ? seqEnd : *end;
+  return bound;
+}
+
+/* Returns the largest impact of the block of a word's list that holds its
+ * first posting at or after docID, lowering *end to that block's last
+ * docID; -1 if there is no such posting */
+static int blockBound(cursor_t* cursor, const int docID, int* end)
+{
+  size_t numBlocks = (cursor->size + IMPACTS_BLOCK - 1) / IMPACTS_BLOCK;
+  size_t block = cursor->pos / IMPACTS_BLOCK;
+  block = block > cursor->block ? block : cursor->block;
+  if (block >= numBlocks) {
+    return -1;
+  }
+
+  // Gallop over the blocks' last docIDs, then binary-search the last step
+  if (blockLast(cursor, block) < docID) {
+    size_t lo = block, step = 1;      // blockLast(lo) < docID
+    size_t hi = lo + step;
+    while (hi < numBlocks && blockLast(cursor, hi) < docID) {
+      lo = hi;
+      step *= 2;
+      hi = lo + step;
+    }
+    if (hi >= numBlocks) {
+      if (blockLast(cursor, numBlocks - 1) < docID) {
+        return -1;
+      }
+      hi = numBlocks - 1;
+    }
+    while (hi - lo > 1) {             // blockLast(hi) >= docID
+      size_t mid = lo + (hi - lo) / 2;
+      if (blockLast(cursor, mid) < docID) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    block = hi;
+  }
+
+  cursor->block = block;
+  int last = blockLast(cursor, block);
+  *end = last < *end ? last : *end;
+  return cursor->blockMax[block];
+}
+
+/* Returns the last docID of a block */
+static int blockLast(const cursor_t* cursor, const size_t block)
+{
+  size_t last = (block + 1) * IMPACTS_BLOCK;
+  return cursor->entries[(last < cursor->size ? last : cursor->size) - 1].docID;
+}
+
+/* qsort comparator: cursors by increasing list size */
+static int compareSizes(const void* a, const void* b)
+{
+  size_t sizeA = ((const cursor_t*) a)->size;
+  size_t sizeB = ((const cursor_t*) b)->size;
+  return (sizeA > sizeB) - (sizeA < sizeB);
+}
@@ -0,0 +1,77 @@
+/*
+ * blockmax.h - CS50 Tiny Search Engine (TSE) impact-ranked query evaluation
+ *
+ * Evaluates a query, an OR of AND sequences of words, over the words'
+ * impact lists (see impacts.h): a document matches a sequence if it has
+ * every one of the sequence's words, and its score is the sum, over the
+ * sequences it matches, of its impacts for their words.
+ *
+ * Documents are visited in docID order, each sequence intersecting its
+ * lists by galloping the longer ones to the rarest word's documents.
+ * `blockmax_topk` then skips what cannot reach the top k, in two ways:
+ *
+ *  - max-score: once k documents are kept, the sequences whose largest
+ *    possible scores add up to no more than the k-th best score cannot
+ *    bring a new document in on their own; candidates come only from the
+ *    other sequences, and these are checked only for the candidates;
+ *  - block-max: before scoring a candidate, the largest impacts of the
+ *    blocks it falls in bound the score of every document up to the end
+ *    of the first of those blocks; if the bound is no better than the
+ *    k-th best, the whole range is skipped without decoding a posting.
+ *
+ * The top k are exactly those of ranking every match, ties by docID.
+ *
+ * Functions:
+ *  - `blockmax_all`: Scores every matching document.
+ *  - `blockmax_topk`: Finds the k best documents, with early termination.
+ *
+ * Error Handling:
+ *  - Running out of memory terminates the program via `mem_assert`.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __BLOCKMAX_H
+#define __BLOCKMAX_H
+
+#include <stddef.h>
+#include "arena.h"
+#include "impacts.h"
+#include "postings.h"
+#include "ranking.h"
+
+/* How much work an evaluation did, for comparing it with another */
+typedef struct blockmax_stats {
+  unsigned long scored;     // documents whose score was computed
+  unsigned long skipped;    // blocks of documents skipped on their bound
+} blockmax_stats_t;
+
+/**
+ * Scores every document matching a query.
+ *
+ * @param lists Every sequence's impact lists, one sequence after another.
+ * @param ends ends[s] is one past the last list of sequence s, so
+ *             sequence s has lists ends[s-1] (0 for s = 0) to ends[s] - 1.
+ * @param numSequences The number of sequences.
+ * @param arena Where to allocate the result and temporaries.
+ * @return The matches, in docID order, with their scores as counts.
+ */
+postings_t* blockmax_all(const impactlist_t lists[], const int ends[], const int numSequences,
+                         arena_t* arena);
+
+/**
+ * Finds the k best documents matching a query, skipping the documents
+ * and blocks that cannot be among them.
+ *
+ * @param lists, ends, numSequences The query, as for `blockmax_all`.
+ * @param k The most documents to return.
+ * @param out Array of at least k elements, filled best first.
+ * @param arena Where to allocate temporaries.
+ * @param stats Where to add counts of the work done; may be NULL.
+ * @return The number of documents stored in out (at most k).
+ */
+size_t blockmax_topk(const impactlist_t lists[], const int ends[], const int numSequences,
+                     const size_t k, ranked_t out[], arena_t* arena, blockmax_stats_t* stats);
+
+#endif // __BLOCKMAX_H
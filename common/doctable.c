@@ -0,0 +1,292 @@
+/*
+ * doctable.c - CS50 Tiny Search Engine (TSE) document metadata table
+ *
+ * see doctable.h for more information.
+ *
+ * A writable table is an array of entries indexed by docID, each owning a
+ * copy of its URL, grown by doubling. A mapped table keeps only pointers
+ * into the mapping; doctable_get reads its fixed-size entry directly.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "doctable.h"
+#include "binfile.h"
+#include "../libcs50/mem.h"
+
+/**************** file-local global variables ****************/
+static const char DOCTABLE_MAGIC[8] = { 'T', 'S', 'E', 'D', 'O', 'C', 'T', 'B' };
+static const uint32_t DOCTABLE_VERSION = 2;
+#define HEADER_BYTES 32       // magic, version, numEntries, urlBytes, firstDoc, reserved
+#define V1_HEADER_BYTES 24    // magic, version, numEntries, urlBytes
+#define ENTRY_BYTES 16        // urlOffset, urlLength, depth, length
+
+/**************** local types ****************/
+typedef struct docentry {
+  char* url;                // NULL if there is no such document
+  size_t urlLen;
+  int depth;
+  int length;
+} docentry_t;
+
+typedef struct doctable {
+  docentry_t* entries;      // writable table: entries[docID]
+  int numEntries;           // one more than the largest docID set
+  int capacity;
+  const void* base;         // mapped table: the mapping, else NULL
+  size_t size;
+  const uint8_t* mapEntries;   // the entry of docID mapFirst, then the following ones
+  const char* mapUrls;
+  uint64_t urlBytes;
+  int mapFirst;
+} doctable_t;
+
+/**************** local functions ****************/
+
+/**************** doctable_new ****************/
+/* see doctable.h for description */
+doctable_t* doctable_new(void)
+{
+  doctable_t* table = mem_calloc_assert(1, sizeof(doctable_t), "doctable_new");
+  return table;
+}
+
+/**************** doctable_set ****************/
+/* see doctable.h for description */
+bool doctable_set(doctable_t* table, const int docID, const char* url, const size_t urlLen,
+                  const int depth, const int length)
+{
+  if (table == NULL || table->base != NULL || docID < 0 || docID == INT_MAX
+      || url == NULL || urlLen == 0 || urlLen > UINT32_MAX) {
+    return false;
+  }
+
+  // grow the array to hold docID, zeroing the new entries
+  if (docID >= table->capacity) {
+    int capacity = table->capacity == 0 ? 64 : table->capacity;
+    while (capacity <= docID) {
+      capacity = capacity > INT_MAX / 2 ? INT_MAX : 2 * capacity;
+    }
+    docentry_t* bigger = mem_calloc_assert(capacity, sizeof(docentry_t), "doctable entries");
+    if (table->entries != NULL) {
+      memcpy(bigger, table->entries, table->numEntries * sizeof(docentry_t));
+      mem_free(table->entries);
+    }
+    table->entries = bigger;
+    table->capacity = capacity;
+  }
+
+  docentry_t* entry = &table->entries[docID];
+  if (entry->url != NULL) {
+    mem_free(entry->url);
+  }
+  entry->url = mem_malloc_assert(urlLen, "doctable url");
+  memcpy(entry->url, url, urlLen);
+  entry->urlLen = urlLen;
+  entry->depth = depth;
+  entry->length = length;
+  if (docID >= table->numEntries) {
+    table->numEntries = docID + 1;
+  }
+  return true;
+}
+
+/**************** doctable_merge ****************/
+/* see doctable.h for description */
+void doctable_merge(doctable_t* dest, doctable_t* src)
+{
+  if (dest == NULL || src == NULL || dest == src || dest->base != NULL || src->base != NULL) {
+    return;
+  }
+  for (int docID = 0; docID < src->numEntries; docID++) {
+    docentry_t* entry = &src->entries[docID];
+    if (entry->url != NULL) {
+      doctable_set(dest, docID, entry->url, entry->urlLen, entry->depth, entry->length);
+      mem_free(entry->url);
+      entry->url = NULL;
+    }
+  }
+  src->numEntries = 0;
+}
+
+/**************** doctable_save ****************/
+/* see doctable.h for description */
+bool doctable_save(doctable_t* table, FILE* fp)
+{
+  if (table == NULL || fp == NULL) {
+    return false;
+  }
+
+  // entries start at the first document, not at docID 0
+  int numEntries = doctable_size(table);
+  int firstDoc = doctable_firstDoc(table);
+  docinfo_t info;
+  uint64_t urlBytes = 0;
+  for (int docID = firstDoc; docID < numEntries; docID++) {
+    if (doctable_get(table, docID, &info)) {
+      urlBytes += info.urlLen;
+    }
+  }
+  if (urlBytes > UINT32_MAX) {
+    return false;             // offsets would not fit
+  }
+
+  bool ok = fwrite(DOCTABLE_MAGIC, 1, sizeof(DOCTABLE_MAGIC), fp) == sizeof(DOCTABLE_MAGIC)
+    && binfile_put32(fp, DOCTABLE_VERSION) && binfile_put32(fp, numEntries - firstDoc) && binfile_put64(fp, urlBytes)
+    && binfile_put32(fp, firstDoc) && binfile_put32(fp, 0);
+
+  uint32_t offset = 0;
+  for (int docID = firstDoc; ok && docID < numEntries; docID++) {
+    if (doctable_get(table, docID, &info)) {
+      ok = binfile_put32(fp, offset) && binfile_put32(fp, info.urlLen)
+        && binfile_put32(fp, (uint32_t) info.depth) && binfile_put32(fp, (uint32_t) info.length);
+      offset += info.urlLen;
+    } else {
+      ok = binfile_put32(fp, 0) && binfile_put32(fp, 0) && binfile_put32(fp, 0) && binfile_put32(fp, 0);
+    }
+  }
+  for (int docID = firstDoc; ok && docID < numEntries; docID++) {
+    if (doctable_get(table, docID, &info)) {
+      ok = fwrite(info.url, 1, info.urlLen, fp) == info.urlLen;
+    }
+  }
+  return ok && !ferror(fp);
+}
+
+/**************** doctable_map ****************/
+/* see doctable.h for description */
+doctable_t* doctable_map(const char* filename)
+{
+  if (filename == NULL) {
+    return NULL;
+  }
+
+  size_t size;
+  const void* base = binfile_map(filename, V1_HEADER_BYTES, &size);
+  if (base == NULL) {
+    return NULL;
+  }
+
+  // the entries and URLs must exactly fill the rest of the file
+  const uint8_t* data = base;
+  uint32_t version = binfile_get32(data + 8);
+  size_t headerBytes = version == 1 ? V1_HEADER_BYTES : HEADER_BYTES;
+  uint32_t numEntries = binfile_get32(data + 12);
+  uint64_t urlBytes = binfile_get64(data + 16);
+  uint32_t firstDoc = version == 1 || size < HEADER_BYTES ? 0 : binfile_get32(data + 24);
+  if (memcmp(data, DOCTABLE_MAGIC, sizeof(DOCTABLE_MAGIC)) != 0
+      || (version != 1 && version != DOCTABLE_VERSION) || size < headerBytes
+      || numEntries > INT_MAX || firstDoc > INT_MAX - numEntries
+      || urlBytes > size - headerBytes
+      || (uint64_t) numEntries * ENTRY_BYTES != size - headerBytes - urlBytes) {
+    binfile_unmap(base, size);
+    return NULL;
+  }
+
+  doctable_t* table = doctable_new();
+  table->numEntries = firstDoc + numEntries;
+  table->mapFirst = firstDoc;
+  table->base = base;
+  table->size = size;
+  table->mapEntries = data + headerBytes;
+  table->mapUrls = (const char*) table->mapEntries + (size_t) numEntries * ENTRY_BYTES;
+  table->urlBytes = urlBytes;
+  return table;
+}
+
+/**************** doctable_filename ****************/
+/* see doctable.h for description */
+char* doctable_filename(const char* indexFilename)
+{
+  if (indexFilename == NULL) {
+    return NULL;
+  }
+  char* filename = mem_malloc_assert(strlen(indexFilename) + strlen(".docs") + 1, "doctable_filename");
+  sprintf(filename, "%s.docs", indexFilename);
+  return filename;
+}
+
+/**************** doctable_get ****************/
+/* see doctable.h for description */
+bool doctable_get(doctable_t* table, const int docID, docinfo_t* info)
+{
+  if (table == NULL || info == NULL || docID < 0 || docID >= table->numEntries) {
+    return false;
+  }
+
+  if (table->base == NULL) {
+    docentry_t* entry = &table->entries[docID];
+    if (entry->url == NULL) {
+      return false;
+    }
+    info->url = entry->url;
+    info->urlLen = entry->urlLen;
+    info->depth = entry->depth;
+    info->length = entry->length;
+    return true;
+  }
+
+  // a mapped entry is checked against the URL section on every lookup
+  if (docID < table->mapFirst) {
+    return false;
+  }
+  const uint8_t* p = table->mapEntries + (size_t) (docID - table->mapFirst) * ENTRY_BYTES;
+  uint32_t offset = binfile_get32(p), urlLen = binfile_get32(p + 4);
+  if (urlLen == 0 || (uint64_t) offset + urlLen > table->urlBytes) {
+    return false;
+  }
+  info->url = table->mapUrls + offset;
+  info->urlLen = urlLen;
+  info->depth = (int32_t) binfile_get32(p + 8);
+  info->length = (int32_t) binfile_get32(p + 12);
+  return true;
+}
+
+/**************** doctable_size ****************/
+/* see doctable.h for description */
+int doctable_size(doctable_t* table)
+{
+  return table == NULL ? 0 : table->numEntries;
+}
+
+/**************** doctable_firstDoc ****************/
+/* see doctable.h for description */
+int doctable_firstDoc(doctable_t* table)
+{
+  if (table == NULL) {
+    return 0;
+  }
+  docinfo_t info;
+  int docID = table->mapFirst;
+  while (docID < table->numEntries && !doctable_get(table, docID, &info)) {
+    docID++;
+  }
+  return docID;
+}
+
+/**************** doctable_delete ****************/
+/* see doctable.h for description */
+void doctable_delete(doctable_t* table)
+{
+  if (table == NULL) {
+    return;
+  }
+  if (table->base != NULL) {
+    binfile_unmap(table->base, table->size);
+  }
+  for (int docID = 0; table->base == NULL && docID < table->numEntries; docID++) {
+    if (table->entries[docID].url != NULL) {
+      mem_free(table->entries[docID].url);
+    }
+  }
+  if (table->entries != NULL) {
+    mem_free(table->entries);
+  }
+  mem_free(table);
+}
@@ -0,0 +1,157 @@
+/*
+ * doctable.h - CS50 Tiny Search Engine (TSE) document metadata table
+ *
+ * A doctable maps each docID to what the querier needs to show a result
+ * without opening the document's file: its URL, its crawl depth, and its
+ * length (the number of words the indexer indexed from it).
+ *
+ * The indexer builds a table in memory alongside the index and saves it
+ * next to the index file (see `doctable_filename`). The querier maps the
+ * saved table read-only, so a lookup is an array access into the mapping.
+ *
+ * The saved format is little-endian:
+ *
+ *   header   "TSEDOCTB", uint32 version (2), uint32 numEntries,
+ *            uint64 urlBytes, uint32 firstDoc, uint32 reserved (0)
+ *   entries  numEntries 16-byte entries, the entry for docID d at index
+ *            d - firstDoc:
+ *            uint32 urlOffset, uint32 urlLength, int32 depth, uint32 length
+ *   urls     the URLs, concatenated without separators
+ *
+ * An entry with urlLength 0 is a docID with no document. firstDoc is the
+ * smallest docID with a document, so the table of an index segment that
+ * covers only new documents (see indexset.h) is no larger than they are.
+ * Version 1 tables, which have no firstDoc (their header ends after
+ * urlBytes) and start at docID 0, are still read.
+ *
+ * Functions:
+ *  - `doctable_new`: Creates an empty, writable table.
+ *  - `doctable_set`: Records one document's metadata.
+ *  - `doctable_merge`: Moves another table's documents into this one.
+ *  - `doctable_save`: Writes the table to a file.
+ *  - `doctable_map`: Maps a saved table read-only.
+ *  - `doctable_filename`: Returns the table filename for an index filename.
+ *  - `doctable_get`: Looks up one document.
+ *  - `doctable_size`: Returns one more than the largest docID.
+ *  - `doctable_firstDoc`: Returns the smallest docID with a document.
+ *  - `doctable_delete`: Frees (or unmaps) a table.
+ *
+ * Error Handling:
+ *  - Functions return NULL or false on bad arguments or bad files;
+ *    running out of memory terminates the program via `mem_assert`.
+ *  - A table is NOT thread-safe while being written; a mapped table may
+ *    be read from any number of threads.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __DOCTABLE_H
+#define __DOCTABLE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* The document table; opaque to users of the module */
+typedef struct doctable doctable_t;
+
+/* One document's metadata, as returned by `doctable_get`.
+ * The url is NOT null-terminated; use urlLen (e.g. printf "%.*s").
+ */
+typedef struct docinfo {
+  const char* url;
+  size_t urlLen;
+  int depth;
+  int length;           // words indexed from the document
+} docinfo_t;
+
+/**
+ * Creates a new, empty, writable table.
+ *
+ * @return Pointer to a new `doctable_t`, or NULL on failure.
+ */
+doctable_t* doctable_new(void);
+
+/**
+ * Records (or replaces) a document's metadata; the URL is copied.
+ *
+ * @param table A writable table.
+ * @param docID The document ID (>= 0).
+ * @param url The document's URL; need not be null-terminated.
+ * @param urlLen The length of the URL (> 0).
+ * @param depth The document's crawl depth.
+ * @param length The number of words indexed from the document.
+ * @return true on success, false on bad arguments or a mapped table.
+ */
+bool doctable_set(doctable_t* table, const int docID, const char* url, const size_t urlLen,
+                  const int depth, const int length);
+
+/**
+ * Moves every document of src into dest, replacing any with the same
+ * docID; src is left empty. This is how the tables built by parallel
+ * indexer threads are combined.
+ *
+ * @param dest A writable table.
+ * @param src A writable table.
+ */
+void doctable_merge(doctable_t* dest, doctable_t* src);
+
+/**
+ * Writes a table to a file in the format described above.
+ *
+ * @param table The table.
+ * @param fp File pointer to write to (opened for writing, ideally "wb").
+ * @return true on success, false on NULL arguments or a write error.
+ */
+bool doctable_save(doctable_t* table, FILE* fp);
+
+/**
+ * Maps a saved table read-only. Only the header is checked here, so this
+ * takes the same time however many documents there are.
+ *
+ * @param filename Path of the table file.
+ * @return Pointer to the mapped table, or NULL if the file cannot be
+ *         mapped or is not a table of a known version.
+ */
+doctable_t* doctable_map(const char* filename);
+
+/**
+ * Returns the name of the document table saved next to an index file:
+ * the index filename with ".docs" appended.
+ *
+ * @param indexFilename The index filename.
+ * @return A new string, which the caller must free; NULL if indexFilename is NULL.
+ */
+char* doctable_filename(const char* indexFilename);
+
+/**
+ * Looks up a document.
+ *
+ * @param table The table.
+ * @param docID The document ID.
+ * @param info Where to store the document's metadata; its url points into
+ *             the table and is valid until the table is deleted or changed.
+ * @return true if the table has the document, else false.
+ */
+bool doctable_get(doctable_t* table, const int docID, docinfo_t* info);
+
+/**
+ * Returns one more than the largest docID the table has room for (0 if NULL).
+ */
+int doctable_size(doctable_t* table);
+
+/**
+ * Returns the smallest docID the table has a document for, or
+ * doctable_size() if it has none (0 if NULL).
+ */
+int doctable_firstDoc(doctable_t* table);
+
+/**
+ * Deletes a table, freeing it or, if mapped, unmapping it.
+ *
+ * @param table The table; NULL is ignored.
+ */
+void doctable_delete(doctable_t* table);
+
+#endif // __DOCTABLE_H
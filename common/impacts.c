@@ -0,0 +1,415 @@
+/*
+ * impacts.c - CS50 Tiny Search Engine (TSE) precomputed impact scores
+ *
+ * see impacts.h for more information.
+ *
+ * The table is written in one pass once every word's size is known: the
+ * offsets come from the names' lengths and the posting counts, so only
+ * one word's impacts are buffered at a time. When no scale is given, the
+ * scores are computed twice, once to find the largest.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "impacts.h"
+#include "binfile.h"
+#include "../libcs50/mem.h"
+
+/**************** file-local global variables ****************/
+static const char IMPACTS_MAGIC[8] = { 'T', 'S', 'E', 'I', 'M', 'P', 'C', 'T' };
+static const uint32_t IMPACTS_VERSION = 1;
+#define HEADER_BYTES 48       // magic, version, block size, three counts, scale, reserved
+#define TERM_BYTES 8          // one entry of the term table
+static const double K1 = 1.2;
+static const double B = 0.75;
+
+/**************** local types ****************/
+typedef struct impacts {
+  const void* base;         // the mapping, and its size
+  size_t size;
+  const uint8_t* table;     // numTerms + 1 entries
+  const char* names;
+  const uint8_t* data;
+  uint64_t numTerms;
+  uint32_t namesLen;
+  uint32_t dataLen;
+  double scale;
+} impacts_t;
+
+/* One word while sorting the dictionary */
+typedef struct term {
+  const char* word;
+  size_t len;
+  const postings_t* postings;
+  int df;                   // documents containing it in the whole collection
+} term_t;
+
+/* The words gathered by collectTerm */
+typedef struct termlist {
+  term_t* terms;
+  size_t n;
+  size_t capacity;
+} termlist_t;
+
+/**************** local functions ****************/
+static void collectTerm(void* arg, const char* word, const size_t len, const postings_t* postings);
+static int compareTerms(const void* a, const void* b);
+static int compareWords(const char* a, const size_t aLen, const char* b, const size_t bLen);
+static void gatherTerms(index_t* index, const impacts_stats_t* stats, termlist_t* list);
+static void otherDocs(const impacts_stats_t* stats, termlist_t* list);
+static double maxScore(const termlist_t* list, doctable_t* docs, const impacts_stats_t* stats);
+static double score(const term_t* term, const posting_t* posting, doctable_t* docs,
+                    const impacts_stats_t* stats);
+static size_t numBlocks(const size_t size);
+
+/**************** impacts_addDocs ****************/
+/* see impacts.h for description */
+void impacts_addDocs(impacts_stats_t* stats, doctable_t* docs)
+{
+  if (stats == NULL || docs == NULL) {
+    return;
+  }
+  docinfo_t info;
+  for (int docID = doctable_firstDoc(docs); docID < doctable_size(docs); docID++) {
+    if (doctable_get(docs, docID, &info)) {
+      stats->numDocs++;
+      stats->totalLength += info.length;
+    }
+  }
+}
+
+/**************** impacts_save ****************/
+/* see impacts.h for description */
+bool impacts_save(index_t* index, doctable_t* docs, const impacts_stats_t* stats, FILE* fp)
+{
+  if (index == NULL || docs == NULL || stats == NULL || fp == NULL
+      || stats->numDocs <= 0 || stats->totalLength <= 0) {
+    return false;
+  }
+
+  // Step 1: Gather the words, in dictionary order, with their frequencies
+  termlist_t list = { NULL, 0, 0 };
+  gatherTerms(index, stats, &list);
+
+  // Step 2: Pick the scale that maps the largest score to 255, unless given
+  double scale = stats->scale;
+  if (scale <= 0) {
+    double max = maxScore(&list, docs, stats);
+    scale = max > 0 ? max / 255 : 1;
+  }
+  uint32_t micros = scale * 1e6 + 0.5;
+  micros = micros > 0 ? micros : 1;
+  scale = micros / 1e6;                 // what readers will see
+
+  // Step 3: Lay out the sections, then write the header and term table
+  uint64_t namesLen = 0, dataLen = 0;
+  for (size_t i = 0; i < list.n; i++) {
+    size_t size = postings_size(list.terms[i].postings);
+    namesLen += list.terms[i].len;
+    dataLen += 4 + numBlocks(size) + size;
+  }
+  bool ok = namesLen <= UINT32_MAX && dataLen <= UINT32_MAX
+    && fwrite(IMPACTS_MAGIC, 1, sizeof(IMPACTS_MAGIC), fp) == sizeof(IMPACTS_MAGIC)
+    && binfile_put32(fp, IMPACTS_VERSION) && binfile_put32(fp, IMPACTS_BLOCK)
+    && binfile_put64(fp, list.n) && binfile_put64(fp, namesLen) && binfile_put64(fp, dataLen)
+    && binfile_put32(fp, micros) && binfile_put32(fp, 0);
+  uint32_t nameOffset = 0, dataOffset = 0;
+  for (size_t i = 0; ok && i <= list.n; i++) {
+    ok = binfile_put32(fp, nameOffset) && binfile_put32(fp, dataOffset);
+    if (i < list.n) {
+      size_t size = postings_size(list.terms[i].postings);
+      nameOffset += list.terms[i].len;
+      dataOffset += 4 + numBlocks(size) + size;
+    }
+  }
+  for (size_t i = 0; ok && i < list.n; i++) {
+    ok = fwrite(list.terms[i].word, 1, list.terms[i].len, fp) == list.terms[i].len;
+  }
+
+  // Step 4: Write each word's block maxima and impacts
+  uint8_t* buf = NULL;
+  size_t bufSize = 0;
+  for (size_t i = 0; ok && i < list.n; i++) {
+    const posting_t* entries = postings_entries(list.terms[i].postings);
+    size_t size = postings_size(list.terms[i].postings);
+    size_t blocks = numBlocks(size);
+    if (blocks + size > bufSize) {
+      if (buf != NULL) {
+        mem_free(buf);
+      }
+      bufSize = 2 * (blocks + size);
+      buf = mem_malloc_assert(bufSize, "impacts_save");
+    }
+    memset(buf, 0, blocks);
+    for (size_t j = 0; j < size; j++) {
+      long impact = lround(score(&list.terms[i], &entries[j], docs, stats) / scale);
+      impact = impact < 1 ? 1 : impact > 255 ? 255 : impact;
+      buf[blocks + j] = impact;
+      if (impact > buf[j / IMPACTS_BLOCK]) {
+        buf[j / IMPACTS_BLOCK] = impact;
+      }
+    }
+    ok = binfile_put32(fp, size) && fwrite(buf, 1, blocks + size, fp) == blocks + size;
+  }
+
+  if (buf != NULL) {
+    mem_free(buf);
+  }
+  if (list.terms != NULL) {
+    mem_free(list.terms);
+  }
+  return ok;
+}
+
+/**************** impacts_maxScore ****************/
+/* see impacts.h for description */
+double impacts_maxScore(index_t* index, doctable_t* docs, const impacts_stats_t* stats)
+{
+  if (index == NULL || docs == NULL || stats == NULL
+      || stats->numDocs <= 0 || stats->totalLength <= 0) {
+    return 0;
+  }
+  termlist_t list = { NULL, 0, 0 };
+  gatherTerms(index, stats, &list);
+  double max = maxScore(&list, docs, stats);
+  if (list.terms != NULL) {
+    mem_free(list.terms);
+  }
+  return max;
+}
+
+/**************** impacts_map ****************/
+/* see impacts.h for description */
+impacts_t* impacts_map(const char* filename)
+{
+  if (filename == NULL) {
+    return NULL;
+  }
+
+  size_t size;
+  const void* base = binfile_map(filename, HEADER_BYTES, &size);
+  if (base == NULL) {
+    return NULL;
+  }
+
+  // the term table, names and data must exactly fill the rest of the file
+  const uint8_t* data = base;
+  uint64_t numTerms = binfile_get64(data + 16);
+  uint64_t namesLen = binfile_get64(data + 24);
+  uint64_t dataLen = binfile_get64(data + 32);
+  uint64_t room = size - HEADER_BYTES;
+  if (memcmp(data, IMPACTS_MAGIC, sizeof(IMPACTS_MAGIC)) != 0
+      || binfile_get32(data + 8) != IMPACTS_VERSION || binfile_get32(data + 12) != IMPACTS_BLOCK
+      || binfile_get32(data + 40) == 0 || numTerms >= room / TERM_BYTES
+      || namesLen > room - (numTerms + 1) * TERM_BYTES
+      || dataLen != room - (numTerms + 1) * TERM_BYTES - namesLen
+      || binfile_get32(data + HEADER_BYTES + numTerms * TERM_BYTES) != namesLen
+      || binfile_get32(data + HEADER_BYTES + numTerms * TERM_BYTES + 4) != dataLen) {
+    binfile_unmap(base, size);
+    return NULL;
+  }
+
+  impacts_t* table = mem_malloc_assert(sizeof(impacts_t), "impacts_map");
+  table->base = base;
+  table->size = size;
+  table->table = data + HEADER_BYTES;
+  table->names = (const char*) table->table + (numTerms + 1) * TERM_BYTES;
+  table->data = (const uint8_t*) table->names + namesLen;
+  table->numTerms = numTerms;
+  table->namesLen = namesLen;
+  table->dataLen = dataLen;
+  table->scale = binfile_get32(data + 40) / 1e6;
+  return table;
+}
+
+/**************** impacts_filename ****************/
+/* see impacts.h for description */
+char* impacts_filename(const char* indexFilename)
+{
+  if (indexFilename == NULL) {
+    return NULL;
+  }
+  char* filename = mem_malloc_assert(strlen(indexFilename) + strlen(".impacts") + 1, "impacts_filename");
+  sprintf(filename, "%s.impacts", indexFilename);
+  return filename;
+}
+
+/**************** impacts_find ****************/
+/* see impacts.h for description */
+bool impacts_find(impacts_t* table, const char* word, size_t* size,
+                  const uint8_t** impacts, const uint8_t** blockMax)
+{
+  if (table == NULL || word == NULL || size == NULL || impacts == NULL || blockMax == NULL) {
+    return false;
+  }
+
+  // Binary-search the sorted term table
+  size_t len = strlen(word);
+  uint64_t lo = 0, hi = table->numTerms;
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    const uint8_t* entry = table->table + mid * TERM_BYTES;
+    uint32_t nameStart = binfile_get32(entry), nameEnd = binfile_get32(entry + TERM_BYTES);
+    if (nameStart > nameEnd || nameEnd > table->namesLen) {
+      return false;
+    }
+    int cmp = compareWords(word, len, table->names + nameStart, nameEnd - nameStart);
+    if (cmp < 0) {
+      hi = mid;
+      continue;
+    }
+    if (cmp > 0) {
+      lo = mid + 1;
+      continue;
+    }
+
+    // Found: its data must hold exactly its block maxima and impacts
+    uint32_t start = binfile_get32(entry + 4), stop = binfile_get32(entry + TERM_BYTES + 4);
+    if (start > stop || stop > table->dataLen || stop - start < 4) {
+      return false;
+    }
+    const uint8_t* p = table->data + start;
+    uint32_t n = binfile_get32(p);
+    if ((uint64_t) stop - start != 4 + numBlocks(n) + (uint64_t) n) {
+      return false;
+    }
+    *size = n;
+    *blockMax = p + 4;
+    *impacts = p + 4 + numBlocks(n);
+    return true;
+  }
+  return false;
+}
+
+/**************** impacts_scale ****************/
+/* see impacts.h for description */
+double impacts_scale(impacts_t* table)
+{
+  return table == NULL ? 0 : table->scale;
+}
+
+/**************** impacts_delete ****************/
+/* see impacts.h for description */
+void impacts_delete(impacts_t* table)
+{
+  if (table != NULL) {
+    binfile_unmap(table->base, table->size);
+    mem_free(table);
+  }
+}
+
+/* Adds one word to the list of words being scored, growing it */
+static void collectTerm(void* arg, const char* word, const size_t len, const postings_t* postings)
+{
+  termlist_t* list = arg;
+  if (list->n == list->capacity) {
+    size_t capacity = list->capacity == 0 ? 1024 : 2 * list->capacity;
+    term_t* bigger = mem_malloc_assert(capacity * sizeof(term_t), "impacts terms");
+    if (list->terms != NULL) {
+      memcpy(bigger, list->terms, list->n * sizeof(term_t));
+      mem_free(list->terms);
+    }
+    list->terms = bigger;
+    list->capacity = capacity;
+  }
+  term_t* term = &list->terms[list->n++];
+  term->word = word;
+  term->len = len;
+  term->postings = postings;
+  term->df = postings_size(postings);
+}
+
+/* qsort comparator: dictionary (strcmp) order of the words */
+static int compareTerms(const void* a, const void* b)
+{
+  const term_t* termA = a;
+  const term_t* termB = b;
+  return compareWords(termA->word, termA->len, termB->word, termB->len);
+}
+
+/* Compares two words in strcmp order: the common prefix, then the
+ * shorter is first */
+static int compareWords(const char* a, const size_t aLen, const char* b, const size_t bLen)
+{
+  int cmp = memcmp(a, b, aLen < bLen ? aLen : bLen);
+  return cmp != 0 ? cmp : (aLen > bLen) - (aLen < bLen);
+}
+
+/* Fills a list with an index's words, in dictionary order, and their
+ * document frequencies in the whole collection */
+static void gatherTerms(index_t* index, const impacts_stats_t* stats, termlist_t* list)
+{
+  index_iterate(index, list, collectTerm);
+  if (list->n > 0) {
+    qsort(list->terms, list->n, sizeof(term_t), compareTerms);
+  }
+  otherDocs(stats, list);
+}
+
+/* Adds to each word's document frequency the documents outside the
+ * index that contain it, asking for each word null-terminated */
+static void otherDocs(const impacts_stats_t* stats, termlist_t* list)
+{
+  if (stats->otherDocs == NULL) {
+    return;
+  }
+  char* word = NULL;
+  size_t room = 0;
+  for (size_t i = 0; i < list->n; i++) {
+    term_t* term = &list->terms[i];
+    if (term->len + 1 > room) {
+      if (word != NULL) {
+        mem_free(word);
+      }
+      room = 2 * (term->len + 1);
+      word = mem_malloc_assert(room, "impacts word");
+    }
+    memcpy(word, term->word, term->len);
+    word[term->len] = '\0';
+    term->df += (*stats->otherDocs)(stats->arg, word);
+  }
+  if (word != NULL) {
+    mem_free(word);
+  }
+}
+
+/* Returns the largest BM25 score of any posting of the list's words */
+static double maxScore(const termlist_t* list, doctable_t* docs, const impacts_stats_t* stats)
+{
+  double max = 0;
+  for (size_t i = 0; i < list->n; i++) {
+    const posting_t* entries = postings_entries(list->terms[i].postings);
+    for (size_t j = 0; j < postings_size(list->terms[i].postings); j++) {
+      double s = score(&list->terms[i], &entries[j], docs, stats);
+      max = s > max ? s : max;
+    }
+  }
+  return max;
+}
+
+/* Returns a posting's BM25 score (see impacts.h) */
+static double score(const term_t* term, const posting_t* posting, doctable_t* docs,
+                    const impacts_stats_t* stats)
+{
+  double n = stats->numDocs;
+  double df = term->df < n ? term->df : n;
+  double idf = log(1 + (n - df + 0.5) / (df + 0.5));
+
+  docinfo_t info;
+  double avgLength = (double) stats->totalLength / stats->numDocs;
+  double length = doctable_get(docs, posting->docID, &info) ? info.length : avgLength;
+  double tf = posting->count;
+  return idf * tf * (K1 + 1) / (tf + K1 * (1 - B + B * length / avgLength));
+}
+
+/* Returns the number of blocks of a list of size postings */
+static size_t numBlocks(const size_t size)
+{
+  return (size + IMPACTS_BLOCK - 1) / IMPACTS_BLOCK;
+}
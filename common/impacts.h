@@ -0,0 +1,170 @@
+/*
+ * impacts.h - CS50 Tiny Search Engine (TSE) precomputed impact scores
+ *
+ * An impact table holds, for every posting of an index, the posting's
+ * BM25 score quantized to one byte: its impact. The querier's BM25
+ * ranking adds up impacts instead of raw counts, and, since it knows the
+ * largest impact of each block of postings, can skip whole blocks that
+ * could not raise a document into the top k (see blockmax.h).
+ *
+ * A posting (docID d, count tf) of a word found in df of the N documents,
+ * where d has length dl (words indexed, from the document table) and the
+ * average length is avgdl, scores
+ *
+ *   idf * tf * (k1 + 1) / (tf + k1 * (1 - b + b * dl / avgdl)),
+ *   idf = ln(1 + (N - df + 0.5) / (df + 0.5)),  k1 = 1.2, b = 0.75
+ *
+ * and its impact is that score divided by the table's scale, rounded, and
+ * kept between 1 and 255. A table built for a whole index picks the scale
+ * that maps its largest score to 255; a table built for an index segment
+ * (see indexset.h) reuses the main table's scale, so that impacts from
+ * different segments add up alike; so does each shard of an index split
+ * by the indexer's -s, whose table is as the whole index's would be.
+ *
+ * The indexer saves the table next to the index file (see
+ * `impacts_filename`); the querier maps it read-only. The file format is
+ * little-endian:
+ *
+ *   header     "TSEIMPCT", uint32 version (1), uint32 block size (64),
+ *              uint64 numTerms, uint64 namesBytes, uint64 dataBytes,
+ *              uint32 scale in millionths, uint32 reserved (0)
+ *   term table numTerms + 1 entries, one per word in strcmp order:
+ *              uint32 nameOffset, uint32 dataOffset
+ *   names      the words, concatenated without separators
+ *   data       per word, uint32 size (its number of postings), then one
+ *              maximum per block of 64 postings, then size impacts, in
+ *              the docID order of the word's posting list
+ *
+ * As in the binary index, offsets are relative to their section and the
+ * last entry of the term table marks the end of both sections.
+ *
+ * Functions:
+ *  - `impacts_addDocs`: Adds a document table's documents to the statistics.
+ *  - `impacts_save`: Computes and writes an index's impacts.
+ *  - `impacts_maxScore`: Returns the largest score of an index's postings.
+ *  - `impacts_map`: Maps a saved table read-only.
+ *  - `impacts_filename`: Returns the table filename for an index filename.
+ *  - `impacts_find`: Looks up a word's impacts.
+ *  - `impacts_scale`: Returns a table's scale.
+ *  - `impacts_delete`: Unmaps a table.
+ *
+ * Error Handling:
+ *  - Functions return NULL, false or 0 on bad arguments or bad files;
+ *    running out of memory terminates the program via `mem_assert`.
+ *  - A mapped table may be read from any number of threads.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __IMPACTS_H
+#define __IMPACTS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "doctable.h"
+#include "index.h"
+#include "postings.h"
+
+/* Postings per block; each block's largest impact is kept */
+#define IMPACTS_BLOCK 64
+
+/* A mapped impact table; opaque to users of the module */
+typedef struct impacts impacts_t;
+
+/* What a word's BM25 scores depend on besides its postings */
+typedef struct impacts_stats {
+  int numDocs;              // N: the documents of the whole collection
+  long totalLength;         // their lengths, summed; avgdl = totalLength / N
+  double scale;             // score per impact unit, or 0 to pick one
+  // how many documents outside the index being scored contain a word
+  // (as for a segment, whose collection includes the documents before
+  // it); NULL if there are none
+  int (*otherDocs)(void* arg, const char* word);
+  void* arg;
+} impacts_stats_t;
+
+/* A word's posting list with its impacts, as the querier ranks it */
+typedef struct impactlist {
+  const postings_t* postings;   // the word's (docID, count) pairs
+  const uint8_t* impacts;       // one per posting, in the same order
+  const uint8_t* blockMax;      // the largest impact of each block
+  int maxImpact;                // the largest impact of all
+} impactlist_t;
+
+/**
+ * Adds the documents of a table (and their lengths) to the statistics.
+ *
+ * @param stats The statistics; start from all zeros.
+ * @param docs The table; may be mapped; NULL adds nothing.
+ */
+void impacts_addDocs(impacts_stats_t* stats, doctable_t* docs);
+
+/**
+ * Computes every posting's impact and writes the impact table.
+ *
+ * @param index The index.
+ * @param docs The index's document table, for the documents' lengths.
+ * @param stats The collection's statistics.
+ * @param fp File pointer to write to (opened for writing, ideally "wb").
+ * @return true on success; false on NULL arguments, empty statistics,
+ *         or a write error.
+ */
+bool impacts_save(index_t* index, doctable_t* docs, const impacts_stats_t* stats, FILE* fp);
+
+/**
+ * Returns the largest score of any posting of an index, from which
+ * `impacts_save` picks its scale when none is given (it is 255 times the
+ * scale): this lets tables for parts of a collection share the scale of
+ * the whole.
+ *
+ * @param index The index.
+ * @param docs The index's document table.
+ * @param stats The collection's statistics; the scale is ignored.
+ * @return The score; 0 on NULL arguments or empty statistics.
+ */
+double impacts_maxScore(index_t* index, doctable_t* docs, const impacts_stats_t* stats);
+
+/**
+ * Maps a saved impact table read-only.
+ *
+ * @param filename The table's file (see `impacts_filename`).
+ * @return Pointer to the mapped table, or NULL if the file cannot be
+ *         mapped or is not an impact table of a known version.
+ */
+impacts_t* impacts_map(const char* filename);
+
+/**
+ * Returns the name of the impact table saved with an index file:
+ * indexFilename with ".impacts" appended. The caller must free it.
+ */
+char* impacts_filename(const char* indexFilename);
+
+/**
+ * Looks up a word's impacts.
+ *
+ * @param table The table.
+ * @param word The word.
+ * @param size Where to store its number of postings.
+ * @param impacts Where to store its impacts, one per posting.
+ * @param blockMax Where to store the largest impact of each block.
+ * @return true if the table has the word (and its entry is sound).
+ */
+bool impacts_find(impacts_t* table, const char* word, size_t* size,
+                  const uint8_t** impacts, const uint8_t** blockMax);
+
+/**
+ * Returns the score one impact unit stands for (0 if table is NULL).
+ */
+double impacts_scale(impacts_t* table);
+
+/**
+ * Unmaps an impact table.
+ *
+ * @param table The table; NULL is ignored.
+ */
+void impacts_delete(impacts_t* table);
+
+#endif // __IMPACTS_H
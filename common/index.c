@@ -3,9 +3,11 @@
 *
 * This file implements the Index module for the Tiny Search Engine (TSE).
 * The index maps words to document frequency counts, allowing efficient lookups
-* for querying. It is implemented as a wrapper around a `hashtable_t`, where
-* each word maps to a `counters_t` object that tracks occurrences of the word
-* in different documents.
+* for querying. A `termdict_t` gives each word a dense term ID, and the
+* index keeps a flat array, indexed by term ID, of `postings_t` lists
+* (sorted (docID, count) pairs) that track occurrences of the word in
+* different documents. A mapped index needs no dictionary: a word's term
+* ID is its position in the file's sorted term table.
 *
 * Functions:
 *     index_new(num_slots)
@@ -14,17 +16,35 @@
 *     index_insert(index, word, docID)
 *         Adds a word to the index, incrementing its count for the given docID.
 *
+*     index_insertn(index, word, len, docID)
+*         Like index_insert, for a word given as a pointer and length.
+*
 *     index_set(index, word, docID, count)
 *         Explicitly sets the count of a word for a given docID.
 *
 *     index_save(index, fp)
 *         Saves the index structure to a file.
 *
+*     index_save_binary(index, fp)
+*         Saves the index structure to a file in the binary format.
+*
 *     index_load(fp)
-*         Loads an index structure from a file.
+*         Loads an index structure from a file, in either format.
+*
+*     index_load_binary(fp)
+*         Loads an index structure from a binary-format file.
+*
+*     index_map(filename)
+*         Maps a binary-format file as a read-only index, decoding lazily.
+*
+*     index_merge(dest, src)
+*         Adds all of one index's counts into another.
+*
+*     index_iterate(index, arg, itemfunc)
+*         Calls a function on every word and its posting list.
 *
 *     index_find(index, word)
-*         Retrieves the counters object associated with a word.
+*         Retrieves the posting list associated with a word.
 *
 *     index_delete(index)
 *         Frees all memory allocated for the index.
@@ -42,34 +62,102 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
 #include "index.h"
-#include "../libcs50/hashtable.h"
-#include "../libcs50/counters.h"
+#include "binfile.h"
+#include "termdict.h"
+#include "postings.h"
+#include "stats.h"
 #include "../libcs50/mem.h"
 #include "../libcs50/file.h" 
 
 typedef struct index {
-  hashtable_t* ht;  // Wrapper around hashtable, mapping words → (docID, count)
+  termdict_t* dict;     // words → dense term IDs; NULL for a mapped index
+  postings_t** lists;   // posting lists by term ID; for a mapped index, by
+                        // term-table position, each NULL until decoded
+  size_t numLists;      // term IDs in use, and room in lists
+  size_t capacity;
+  struct binary* map;   // for an index from index_map, its sections; else NULL
+  const void* base;     // the mapping, and its size
+  size_t size;
+  pthread_mutex_t lock;   // for a mapped index, guards its cache of decoded lists
 } index_t;
 
+/******************** BINARY FORMAT ********************/
+/* See index_save_binary in index.h for the layout; all integers are
+ * little-endian regardless of the host.
+ */
+static const char BINARY_MAGIC[8] = { 'T', 'S', 'E', 'I', 'N', 'D', 'E', 'X' };
+static const uint32_t BINARY_VERSION = 1;
+#define HEADER_BYTES 40       // magic, version, reserved, three counts
+#define TERM_BYTES 8          // one entry of the term table
+
+/* A growable byte buffer for building the binary file */
+struct bytebuf {
+  uint8_t* data;
+  size_t len;
+  size_t cap;
+};
+
+/* One term while sorting the dictionary */
+typedef struct term {
+  const char* word;
+  size_t len;
+  postings_t* postings;
+} term_t;
+
+/* The sections of a binary index, in memory or mapped */
+typedef struct binary {
+  const uint8_t* table;       // numTerms + 1 entries
+  const char* names;
+  const uint8_t* postings;
+  uint64_t numTerms;
+  uint32_t namesLen;
+  uint32_t postingsLen;
+} binary_t;
+
 /******************** FUNCTION PROTOTYPES ********************/
 /******************** INDEX FUNCTIONS ********************/
 index_t* index_new(const int num_slots);
 void index_insert(index_t* index, const char* word, const int docID);
+void index_insertn(index_t* index, const char* word, const size_t len, const int docID);
 void index_set(index_t* index, const char* word, const int docID, const int count);
 void index_save(index_t* index, FILE* fp);
+bool index_save_binary(index_t* index, FILE* fp);
 index_t* index_load(FILE* fp);
+index_t* index_load_binary(FILE* fp);
+index_t* index_map(const char* filename);
+void index_merge(index_t* dest, index_t* src);
+void index_iterate(index_t* index, void* arg,
+                   void (*itemfunc)(void* arg, const char* word, const size_t len,
+                                    const postings_t* postings));
 void index_delete(index_t* index);
-counters_t* index_find(index_t* index, const char* word);
+postings_t* index_find(index_t* index, const char* word);
 /******************** HELPER FUNCTIONS ********************/
-static void save_index_word(void* arg, const char* key, void* item);
+static postings_t* term_postings(index_t* index, const char* word, const size_t len);
+static const char* term_word(index_t* index, const uint32_t id, size_t* len);
 static void save_index_counts(void* arg, const int docID, const int count);
-static void delete_counters(void* item);
+static void merge_index_count(void* arg, const int docID, const int count);
+static int compare_words(const char* a, const size_t aLen, const char* b, const size_t bLen);
+static int compare_terms(const void* a, const void* b);
+static void buf_put(struct bytebuf* buf, const void* data, const size_t len);
+static void buf_put32(struct bytebuf* buf, const uint32_t value);
+static void buf_put64(struct bytebuf* buf, const uint64_t value);
+static void buf_putVarint(struct bytebuf* buf, uint32_t value);
+static bool getVarint(const uint8_t** p, const uint8_t* end, uint32_t* value);
+static bool binary_parse(const uint8_t* data, const size_t size, binary_t* bin);
+static bool binary_term(const binary_t* bin, const uint64_t i, const char** name, size_t* nameLen,
+                        const uint8_t** p, const uint8_t** end);
+static postings_t* binary_postings(const uint8_t* p, const uint8_t* end);
+static bool binary_search(const binary_t* bin, const char* word, uint64_t* i);
+static void map_fill(index_t* index);
 
 /**
  * Creates a new index structure.
  * 
- * @param num_slots Number of slots in the hashtable.
+ * @param num_slots Expected number of words; the dictionary grows beyond it as needed.
  * @return Pointer to the new index structure, or NULL if allocation fails.
  */
 index_t* index_new(const int num_slots)
@@ -80,11 +168,23 @@ index_t* index_new(const int num_slots)
   // Ensure memory was allocated successfully
   mem_assert(index, "Error: Could not allocate memory for index.\n");
 
-  // Create a new hashtable with the specified number of slots
-  index->ht = hashtable_new(num_slots);
+  // Create a term dictionary, and a list array, sized for the expected number of words
+  index->capacity = num_slots > 16 ? num_slots : 16;
+  index->dict = termdict_new(num_slots > 0 ? num_slots : 0);
+  index->lists = mem_malloc(index->capacity * sizeof(postings_t*));
+  index->numLists = 0;
+  index->map = NULL;
+  index->base = NULL;
+  index->size = 0;
+  pthread_mutex_init(&index->lock, NULL);
   
-  // If hashtable creation fails, clean up and return NULL
-  if (index->ht == NULL) {
+  // If either allocation fails, clean up and return NULL
+  if (index->dict == NULL || index->lists == NULL) {
+    termdict_delete(index->dict);
+    if (index->lists != NULL) {
+      mem_free(index->lists);
+    }
+    pthread_mutex_destroy(&index->lock);
     mem_free(index);  // Free the allocated index structure
     return NULL;  // Indicate failure
   }
@@ -107,18 +207,31 @@ void index_insert(index_t* index, const char* word, const int docID)
     return;  // Invalid input, do nothing
   }
 
-  // Look up the word in the index's hashtable
-  counters_t* ctrs = hashtable_find(index->ht, word);
+  index_insertn(index, word, strlen(word), docID);
+}
 
-  // If the word is not already in the index, create a new counters structure
-  if (ctrs == NULL) {
-    ctrs = counters_new();  // Allocate a new counter set
-    mem_assert(ctrs, "Failed to allocate memory for counters in index_insert");  // Ensure allocation succeeded
-    hashtable_insert(index->ht, word, ctrs);  // Insert the new counter set into the hashtable
+/**
+ * Inserts a length-delimited word and document ID into the index.
+ * One dictionary probe both finds the word's term ID and, if it is new,
+ * adds it.
+ * 
+ * @param index Pointer to the index structure.
+ * @param word First character of the word (need not be null-terminated).
+ * @param len Number of characters in the word.
+ * @param docID Document ID associated with the word.
+ */
+void index_insertn(index_t* index, const char* word, const size_t len, const int docID)
+{
+  // Defensive check: ensure valid input (and a writable index)
+  if (index == NULL || index->map != NULL || word == NULL || docID < 0) {
+    return;  // Invalid input, do nothing
   }
 
-  // Increment the count for the given document ID
-  counters_add(ctrs, docID);
+  // Increment the count for the given document ID in the word's list (an
+  // append, when documents are indexed in increasing docID order)
+  STATS_START(start);
+  postings_add(term_postings(index, word, len), docID);
+  STATS_STOP(STATS_INDEX_INSERT, start);
 }
 
 /**
@@ -131,27 +244,53 @@ void index_insert(index_t* index, const char* word, const int docID)
  */
 void index_set(index_t* index, const char* word, const int docID, const int count)
 {
-  // Defensive check: ensure valid input
-  if (index == NULL || word == NULL || docID < 0 || count < 0) {
+  // Defensive check: ensure valid input (and a writable index)
+  if (index == NULL || index->map != NULL || word == NULL || docID < 0 || count < 0) {
     return;  // Invalid input, do nothing
   }
 
-  // Look up the word in the index's hashtable
-  counters_t* ctrs = hashtable_find(index->ht, word);
+  // Set/update the count for the given document ID
+  postings_set(term_postings(index, word, strlen(word)), docID, count);
+}
 
-  // If the word is not already in the index, create a new counters structure
-  if (ctrs == NULL) {
-    ctrs = counters_new();  // Allocate a new counter set
-    mem_assert(ctrs, "Failed to allocate memory for counters in index_set");  // Ensure allocation succeeded
-    hashtable_insert(index->ht, word, ctrs);  // Insert the new counter set into the hashtable
+/* Returns the posting list of a word in a writable index, giving the word
+ * the next term ID and an empty list if it is new */
+static postings_t* term_postings(index_t* index, const char* word, const size_t len)
+{
+  uint32_t id = termdict_add(index->dict, word, len);
+  if (id < index->numLists) {
+    return index->lists[id];
   }
 
-  // Set/update the count for the given document ID
-  counters_set(ctrs, docID, count);
+  // A new word: its ID is the next one, so its list goes at the end
+  if (index->numLists == index->capacity) {
+    size_t capacity = 2 * index->capacity;
+    postings_t** lists = mem_malloc_assert(capacity * sizeof(postings_t*), "index lists");
+    memcpy(lists, index->lists, index->numLists * sizeof(postings_t*));
+    mem_free(index->lists);
+    index->lists = lists;
+    index->capacity = capacity;
+  }
+  postings_t* postings = postings_new();
+  mem_assert(postings, "Failed to allocate memory for postings in index");
+  index->lists[index->numLists++] = postings;
+  return postings;
+}
+
+/* Returns the word with a term ID, which in a mapped index is not
+ * null-terminated, and its length; NULL if its table entry is corrupt */
+static const char* term_word(index_t* index, const uint32_t id, size_t* len)
+{
+  if (index->map == NULL) {
+    return termdict_word(index->dict, id, len);
+  }
+  const char* name;
+  const uint8_t *p, *end;
+  return binary_term(index->map, id, &name, len, &p, &end) ? name : NULL;
 }
 
 /**
- * Saves the index to a file.
+ * Saves the index to a file, one line per word in term-ID order.
  * 
  * @param index Pointer to the index structure.
  * @param fp File pointer to write to.
@@ -161,17 +300,16 @@ void index_save(index_t* index, FILE* fp)
   if (index == NULL || fp == NULL) {
     return;
   }
-  hashtable_iterate(index->ht, fp, save_index_word);
-}
-
-/* Writes a word and its associated document counts to the file */
-static void save_index_word(void* arg, const char* key, void* item)
-{
-  FILE* fp = arg;
-  counters_t* ctrs = item;
-  fprintf(fp, "%s", key);
-  counters_iterate(ctrs, fp, save_index_counts);  // Nested _iterate method
-  fprintf(fp, "\n");
+  map_fill(index);
+  for (uint32_t id = 0; id < index->numLists; id++) {
+    size_t len;
+    const char* word = term_word(index, id, &len);
+    if (word != NULL && index->lists[id] != NULL) {
+      fwrite(word, 1, len, fp);
+      postings_iterate(index->lists[id], fp, save_index_counts);  // Nested _iterate method
+      fprintf(fp, "\n");
+    }
+  }
 }
 
 /* Writes each (docID, count) pair for a given word */
@@ -182,7 +320,100 @@ static void save_index_counts(void* arg, const int docID, const int count)
 }
 
 /**
- * Loads an index from a file.
+ * Saves the index to a file in the binary format.
+ * 
+ * @param index Pointer to the index structure.
+ * @param fp File pointer to write to (opened for writing).
+ * @return true on success, false on NULL arguments or a write error.
+ */
+bool index_save_binary(index_t* index, FILE* fp)
+{
+  if (index == NULL || fp == NULL) {
+    return false;
+  }
+  map_fill(index);
+
+  // Step 1: Gather the terms and sort them into dictionary order
+  term_t* terms = mem_calloc_assert(index->numLists > 0 ? index->numLists : 1, sizeof(term_t), "index_save_binary");
+  size_t numTerms = 0;
+  for (uint32_t id = 0; id < index->numLists; id++) {
+    term_t* term = &terms[numTerms];
+    if ((term->word = term_word(index, id, &term->len)) != NULL && index->lists[id] != NULL) {
+      term->postings = index->lists[id];
+      numTerms++;
+    }
+  }
+  qsort(terms, numTerms, sizeof(term_t), compare_terms);
+
+  // Step 2: Encode the term table, names and postings
+  struct bytebuf table = { NULL, 0, 0 };
+  struct bytebuf names = { NULL, 0, 0 };
+  struct bytebuf postings = { NULL, 0, 0 };
+  for (size_t i = 0; i < numTerms; i++) {
+    size_t df = postings_size(terms[i].postings);
+    const posting_t* entries = postings_entries(terms[i].postings);
+
+    buf_put32(&table, names.len);
+    buf_put32(&table, postings.len);
+    buf_put(&names, terms[i].word, terms[i].len);
+
+    buf_putVarint(&postings, df);
+    int prev = 0;
+    for (size_t j = 0; j < df; j++) {
+      buf_putVarint(&postings, entries[j].docID - prev);   // gap from previous docID
+      buf_putVarint(&postings, entries[j].count);
+      prev = entries[j].docID;
+    }
+  }
+  buf_put32(&table, names.len);       // the end marker
+  buf_put32(&table, postings.len);
+
+  // Step 3: Write the header, then the three sections
+  struct bytebuf header = { NULL, 0, 0 };
+  buf_put(&header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  buf_put32(&header, BINARY_VERSION);
+  buf_put32(&header, 0);
+  buf_put64(&header, numTerms);
+  buf_put64(&header, names.len);
+  buf_put64(&header, postings.len);
+
+  // Offsets in the table are 32 bits
+  bool ok = names.len <= UINT32_MAX && postings.len <= UINT32_MAX
+         && fwrite(header.data, 1, header.len, fp) == header.len
+         && fwrite(table.data, 1, table.len, fp) == table.len
+         && fwrite(names.data, 1, names.len, fp) == names.len
+         && fwrite(postings.data, 1, postings.len, fp) == postings.len;
+
+  // Free the buffers (any may be empty, hence NULL)
+  struct bytebuf* bufs[] = { &header, &table, &names, &postings };
+  for (int i = 0; i < 4; i++) {
+    if (bufs[i]->data != NULL) {
+      mem_free(bufs[i]->data);
+    }
+  }
+  mem_free(terms);
+  return ok;
+}
+
+/* Compares two words in strcmp order: the common prefix, then the
+ * shorter is first */
+static int compare_words(const char* a, const size_t aLen, const char* b, const size_t bLen)
+{
+  int cmp = memcmp(a, b, aLen < bLen ? aLen : bLen);
+  return cmp != 0 ? cmp : (aLen > bLen) - (aLen < bLen);
+}
+
+/* qsort comparator: dictionary (strcmp) order of the words */
+static int compare_terms(const void* a, const void* b)
+{
+  const term_t* termA = a;
+  const term_t* termB = b;
+  return compare_words(termA->word, termA->len, termB->word, termB->len);
+}
+
+/**
+ * Loads an index from a file, in either format: a file that begins with
+ * the binary magic is read by `index_load_binary`, any other as text.
  * 
  * @param fp File pointer to read from.
  * @return Pointer to the loaded index structure, or NULL on failure.
@@ -194,7 +425,15 @@ index_t* index_load(FILE* fp)
     return NULL;  // Return NULL if file is not open or invalid
   }
 
-  // Create a new index structure with allocated slots in hashtable
+  // Check for the binary format's magic number
+  char magic[sizeof(BINARY_MAGIC)];
+  size_t got = fread(magic, 1, sizeof(magic), fp);
+  rewind(fp);
+  if (got == sizeof(magic) && memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0) {
+    return index_load_binary(fp);
+  }
+
+  // Create a new index structure sized for one word per line
   index_t* index = index_new(file_numLines(fp));
   
   // Ensure index was successfully created
@@ -204,7 +443,7 @@ index_t* index_load(FILE* fp)
   int docID, count;  // Variables to store document ID and count
 
   // Read words from the file one at a time
-  while (fscanf(fp, "%s", word) == 1) {  
+  while (fscanf(fp, "%255s", word) == 1) {  
     // For each word, read its associated docID and count pairs
     while (fscanf(fp, "%d %d", &docID, &count) == 2) {  
       // Insert the word and its corresponding docID-count pair into the index
@@ -216,6 +455,163 @@ index_t* index_load(FILE* fp)
   return index;
 }
 
+/**
+ * Loads an index from a binary-format file.
+ * The whole file is read with one bulk read, and every posting list is
+ * decoded in docID order by appending; the words get term IDs in
+ * dictionary order, as in the file's term table.
+ * 
+ * @param fp File pointer to read from, positioned at the start of the index.
+ * @return Pointer to the loaded index structure, or NULL if the file is
+ *         not a binary index of a known version, or is truncated or corrupt.
+ */
+index_t* index_load_binary(FILE* fp)
+{
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  size_t size;
+  uint8_t* data = (uint8_t*) file_readFileLen(fp, &size);
+  if (data == NULL) {
+    return NULL;
+  }
+
+  // Step 1: Check the header and that the sections fit in the file
+  binary_t bin;
+  if (!binary_parse(data, size, &bin)) {
+    free(data);
+    return NULL;
+  }
+
+  // Step 2: Insert every term with its decoded posting list
+  index_t* index = index_new(bin.numTerms);
+  mem_assert(index, "Error: Failed to create index.\n");
+  bool ok = true;
+  for (uint64_t i = 0; ok && i < bin.numTerms; i++) {
+    const char* name;
+    size_t nameLen;
+    const uint8_t *p, *end;
+    if (!binary_term(&bin, i, &name, &nameLen, &p, &end)) {
+      ok = false;
+      break;
+    }
+
+    postings_t* postings = term_postings(index, name, nameLen);
+    if (index->numLists != i + 1) {
+      ok = false;             // a word listed twice
+      break;
+    }
+    postings_t* decoded = binary_postings(p, end);
+    ok = decoded != NULL;
+    if (ok) {
+      postings_delete(postings);
+      index->lists[i] = decoded;
+    }
+  }
+  free(data);
+
+  if (!ok) {
+    index_delete(index);
+    return NULL;
+  }
+  return index;
+}
+
+/**
+ * Maps a binary-format index file into memory, read-only.
+ * Only the header is checked here; a word's term ID is its position in
+ * the term table, which index_find binary-searches, and a posting list is
+ * decoded the first time its word is looked up, into the (initially
+ * empty) array of lists by term ID.
+ * 
+ * @param filename Path of the index file.
+ * @return Pointer to the mapped index, or NULL if the file cannot be
+ *         opened or mapped, or is not a binary index of a known version.
+ */
+index_t* index_map(const char* filename)
+{
+  if (filename == NULL) {
+    return NULL;
+  }
+
+  size_t size;
+  const void* base = binfile_map(filename, HEADER_BYTES, &size);
+  if (base == NULL) {
+    return NULL;
+  }
+
+  binary_t bin;
+  if (!binary_parse(base, size, &bin)) {
+    binfile_unmap(base, size);
+    return NULL;
+  }
+  index_t* index = mem_malloc_assert(sizeof(index_t), "index_map");
+  index->dict = NULL;
+  index->numLists = index->capacity = bin.numTerms;
+  index->lists = mem_calloc_assert(bin.numTerms > 0 ? bin.numTerms : 1, sizeof(postings_t*), "index_map");
+  index->map = mem_malloc_assert(sizeof(binary_t), "index_map");
+  *index->map = bin;
+  index->base = base;
+  index->size = size;
+  pthread_mutex_init(&index->lock, NULL);
+  return index;
+}
+
+/**
+ * Adds every (word, docID, count) of one index into another. Each of
+ * src's term IDs is translated into dest's with one dictionary lookup.
+ * 
+ * @param dest Pointer to the index to add to.
+ * @param src Pointer to the index to add from (unchanged).
+ */
+void index_merge(index_t* dest, index_t* src)
+{
+  if (dest == NULL || src == NULL || dest == src || dest->map != NULL) {
+    return;
+  }
+  map_fill(src);
+  for (uint32_t id = 0; id < src->numLists; id++) {
+    size_t len;
+    const char* word = term_word(src, id, &len);
+    if (word != NULL && src->lists[id] != NULL) {
+      postings_iterate(src->lists[id], term_postings(dest, word, len), merge_index_count);
+    }
+  }
+}
+
+/* Sets one (docID, count) pair in the destination posting list; when
+ * src's documents all follow dest's, every call is an append */
+static void merge_index_count(void* arg, const int docID, const int count)
+{
+  postings_set(arg, docID, count);
+}
+
+/**
+ * Calls a function on every word of the index and its posting list, in
+ * term-ID order; a mapped index's lists are decoded first.
+ * 
+ * @param index Pointer to the index structure.
+ * @param arg Passed along to itemfunc.
+ * @param itemfunc Called with each word, its length, and its list.
+ */
+void index_iterate(index_t* index, void* arg,
+                   void (*itemfunc)(void* arg, const char* word, const size_t len,
+                                    const postings_t* postings))
+{
+  if (index == NULL || itemfunc == NULL) {
+    return;
+  }
+  map_fill(index);
+  for (uint32_t id = 0; id < index->numLists; id++) {
+    size_t len;
+    const char* word = term_word(index, id, &len);
+    if (word != NULL && index->lists[id] != NULL) {
+      (*itemfunc)(arg, word, len, index->lists[id]);
+    }
+  }
+}
+
 /**
  * Deletes the index and frees all allocated memory.
  * 
@@ -224,29 +620,252 @@ index_t* index_load(FILE* fp)
 void index_delete(index_t* index)
 {
   if (index != NULL) {
-    hashtable_delete(index->ht, delete_counters);
+    for (size_t id = 0; id < index->numLists; id++) {
+      postings_delete(index->lists[id]);
+    }
+    mem_free(index->lists);
+    termdict_delete(index->dict);
+    if (index->map != NULL) {
+      mem_free(index->map);
+      binfile_unmap(index->base, index->size);
+    }
+    pthread_mutex_destroy(&index->lock);
     mem_free(index);
   }
 }
 
-/* Frees the memory allocated for a counters object */
-static void delete_counters(void* item)
-{
-  counters_t* ctrs = item;
-  counters_delete(ctrs);
-}
-
 /**
- * Finds the counters object associated with a word.
+ * Finds the posting list associated with a word.
+ * In a mapped index, the word's term ID is found in the mapped term table,
+ * and a list not yet looked up is decoded and cached for next time.
  * 
  * @param index Pointer to the index structure.
  * @param word Word to find.
- * @return Pointer to the counters object, or NULL if the word is not found.
+ * @return Pointer to the posting list, or NULL if the word is not found
+ *         (or, in a mapped index, if its posting list is corrupt).
  */
-counters_t* index_find(index_t* index, const char* word) 
+postings_t* index_find(index_t* index, const char* word) 
 {
   if (index == NULL || word == NULL) {
     return NULL;
   }
-  return hashtable_find(index->ht, word);
-}
\ No newline at end of file
+  uint32_t id;
+  if (index->map == NULL) {
+    return termdict_find(index->dict, word, strlen(word), &id) ? index->lists[id] : NULL;
+  }
+
+  uint64_t i;
+  if (!binary_search(index->map, word, &i)) {
+    return NULL;
+  }
+
+  // A mapped index's cache may be filled by several threads at once
+  pthread_mutex_lock(&index->lock);
+  postings_t* postings = index->lists[i];
+  pthread_mutex_unlock(&index->lock);
+  if (postings != NULL) {
+    return postings;
+  }
+
+  // Decode outside the lock; if another thread got there first, use its list
+  const char* name;
+  size_t nameLen;
+  const uint8_t *p, *end;
+  if (!binary_term(index->map, i, &name, &nameLen, &p, &end)
+      || (postings = binary_postings(p, end)) == NULL) {
+    return NULL;
+  }
+  pthread_mutex_lock(&index->lock);
+  if (index->lists[i] == NULL) {
+    index->lists[i] = postings;
+  } else {
+    postings_delete(postings);
+    postings = index->lists[i];
+  }
+  pthread_mutex_unlock(&index->lock);
+  return postings;
+}
+
+/* Decodes, into the cache, every word of a mapped index not yet looked
+ * up, so the whole index can be walked like a loaded one */
+static void map_fill(index_t* index)
+{
+  if (index->map == NULL) {
+    return;
+  }
+  for (uint64_t i = 0; i < index->map->numTerms; i++) {
+    const char* name;
+    size_t nameLen;
+    const uint8_t *p, *end;
+    if (index->lists[i] == NULL && binary_term(index->map, i, &name, &nameLen, &p, &end)
+        && (index->lists[i] = binary_postings(p, end)) == NULL) {
+      index->lists[i] = postings_new();          // corrupt: keep the word, empty
+      mem_assert(index->lists[i], "Failed to allocate memory for postings in map_fill");
+    }
+  }
+}
+
+/* Checks the header of a binary index of size bytes at data, and that its
+ * sections exactly fill the rest; fills in *bin with where they are */
+static bool binary_parse(const uint8_t* data, const size_t size, binary_t* bin)
+{
+  if (size < HEADER_BYTES || memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0
+      || binfile_get32(data + 8) != BINARY_VERSION) {
+    return false;
+  }
+  uint64_t numTerms = binfile_get64(data + 16);
+  uint64_t namesLen = binfile_get64(data + 24);
+  uint64_t postingsLen = binfile_get64(data + 32);
+  uint64_t room = size - HEADER_BYTES;
+  if (numTerms >= room / TERM_BYTES || namesLen > room - (numTerms + 1) * TERM_BYTES
+      || postingsLen != room - (numTerms + 1) * TERM_BYTES - namesLen) {
+    return false;
+  }
+
+  bin->table = data + HEADER_BYTES;
+  bin->names = (const char*) bin->table + (numTerms + 1) * TERM_BYTES;
+  bin->postings = (const uint8_t*) bin->names + namesLen;
+  bin->numTerms = numTerms;
+  bin->namesLen = namesLen;
+  bin->postingsLen = postingsLen;
+
+  // The end marker must close both sections (and so fit in 32 bits)
+  const uint8_t* marker = bin->table + numTerms * TERM_BYTES;
+  return binfile_get32(marker) == namesLen && binfile_get32(marker + 4) == postingsLen;
+}
+
+/* Finds term i's name and the bounds of its encoded postings; a term's
+ * name and postings run up to where the next term's begin.
+ * Returns false if the offsets are out of order or out of bounds. */
+static bool binary_term(const binary_t* bin, const uint64_t i, const char** name, size_t* nameLen,
+                        const uint8_t** p, const uint8_t** end)
+{
+  const uint8_t* entry = bin->table + i * TERM_BYTES;
+  uint32_t nameStart = binfile_get32(entry), nameEnd = binfile_get32(entry + TERM_BYTES);
+  uint32_t start = binfile_get32(entry + 4), stop = binfile_get32(entry + TERM_BYTES + 4);
+  if (nameStart > nameEnd || nameEnd > bin->namesLen || start > stop || stop > bin->postingsLen) {
+    return false;
+  }
+  *name = bin->names + nameStart;
+  *nameLen = nameEnd - nameStart;
+  *p = bin->postings + start;
+  *end = bin->postings + stop;
+  return true;
+}
+
+/* Decodes one encoded posting list, which must fill p..end exactly.
+ * Returns a new postings_t, or NULL if the encoding is corrupt. */
+static postings_t* binary_postings(const uint8_t* p, const uint8_t* end)
+{
+  postings_t* list = postings_new();
+  mem_assert(list, "Failed to allocate memory for postings in binary_postings");
+
+  uint32_t df, docID = 0;
+  bool ok = getVarint(&p, end, &df);
+  for (uint32_t j = 0; ok && j < df; j++) {
+    uint32_t gap, count;
+    ok = getVarint(&p, end, &gap) && getVarint(&p, end, &count)
+         && gap > 0 && docID + gap <= INT_MAX && count <= INT_MAX
+         && postings_append(list, docID += gap, count);
+  }
+  if (!ok || p != end) {
+    postings_delete(list);
+    return NULL;
+  }
+  return list;
+}
+
+/* Binary-searches the sorted term table for word, setting *i to its
+ * entry; returns false if it is absent (or the table is corrupt) */
+static bool binary_search(const binary_t* bin, const char* word, uint64_t* i)
+{
+  size_t len = strlen(word);
+  uint64_t lo = 0, hi = bin->numTerms;
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    const char* name;
+    size_t nameLen;
+    const uint8_t *p, *end;
+    if (!binary_term(bin, mid, &name, &nameLen, &p, &end)) {
+      return false;
+    }
+
+    int cmp = compare_words(word, len, name, nameLen);
+    if (cmp == 0) {
+      *i = mid;
+      return true;
+    }
+    if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return false;
+}
+/* Appends len bytes to a byte buffer, doubling it as needed */
+static void buf_put(struct bytebuf* buf, const void* data, const size_t len)
+{
+  if (buf->len + len > buf->cap) {
+    size_t cap = buf->cap == 0 ? 4096 : 2 * buf->cap;
+    while (cap < buf->len + len) {
+      cap *= 2;
+    }
+    uint8_t* bigger = mem_malloc_assert(cap, "index byte buffer");
+    if (buf->data != NULL) {
+      memcpy(bigger, buf->data, buf->len);
+      mem_free(buf->data);
+    }
+    buf->data = bigger;
+    buf->cap = cap;
+  }
+  memcpy(buf->data + buf->len, data, len);
+  buf->len += len;
+}
+
+/* Appends a 32-bit little-endian integer */
+static void buf_put32(struct bytebuf* buf, const uint32_t value)
+{
+  uint8_t b[4];
+  binfile_set32(b, value);
+  buf_put(buf, b, sizeof(b));
+}
+
+/* Appends a 64-bit little-endian integer */
+static void buf_put64(struct bytebuf* buf, const uint64_t value)
+{
+  uint8_t b[8];
+  binfile_set32(b, (uint32_t) value);
+  binfile_set32(b + 4, (uint32_t) (value >> 32));
+  buf_put(buf, b, sizeof(b));
+}
+
+/* Appends an unsigned varint: 7 bits per byte, low bits first, with the
+ * high bit set on every byte but the last */
+static void buf_putVarint(struct bytebuf* buf, uint32_t value)
+{
+  uint8_t b[5];
+  int n = 0;
+  while (value >= 0x80) {
+    b[n++] = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+  b[n++] = value;
+  buf_put(buf, b, n);
+}
+
+/* Reads a varint at *p (not past end) into *value and advances *p;
+ * returns false if it is truncated or too long */
+static bool getVarint(const uint8_t** p, const uint8_t* end, uint32_t* value)
+{
+  uint32_t v = 0;
+  for (int shift = 0; shift < 35 && *p < end; shift += 7) {
+    uint8_t b = *(*p)++;
+    v |= (uint32_t) (b & 0x7f) << shift;
+    if ((b & 0x80) == 0) {
+      *value = v;
+      return true;
+    }
+  }
+  return false;
+}
@@ -2,15 +2,22 @@
  * index.h - CS50 Tiny Search Engine (TSE) Index Module
  *
  * This module provides an interface for managing an index structure that maps words
- * to document ID counts. The index is implemented as a wrapper around a `hashtable_t`,
- * where each word is mapped to a `counters_t` object storing document frequency counts.
+ * to document ID counts. Each word has a dense term ID from a `termdict_t` (see
+ * termdict.h), and the index keeps, in a flat array indexed by term ID, each word's
+ * `postings_t` list (see postings.h) of its (docID, count) pairs, sorted by docID.
  *
  * Functions:
  *  - `index_new`: Creates a new index structure.
  *  - `index_insert`: Inserts or updates a word-document count mapping.
- *  - `index_get`: Retrieves the counters associated with a word.
+ *  - `index_insertn`: Like `index_insert`, for a length-delimited word.
+ *  - `index_find`: Retrieves the posting list associated with a word.
  *  - `index_save`: Writes the index structure to a file.
- *  - `index_load`: Loads an index structure from a file.
+ *  - `index_save_binary`: Writes the index structure in the binary format.
+ *  - `index_load`: Loads an index structure from a file, in either format.
+ *  - `index_load_binary`: Loads an index structure from a binary-format file.
+ *  - `index_map`: Maps a binary-format file as a read-only index.
+ *  - `index_merge`: Adds one index's counts into another.
+ *  - `index_iterate`: Calls a function on every word and its posting list.
  *  - `index_delete`: Frees all allocated memory for the index.
  *
  * Assumptions:
@@ -30,8 +37,8 @@
 #define __INDEX_H
 
 #include <stdio.h>
-#include "../libcs50/hashtable.h"
-#include "../libcs50/counters.h"
+#include <stdbool.h>
+#include "postings.h"
 
 /******************** STRUCTURES ********************/
 
@@ -41,9 +48,10 @@ typedef struct index index_t;
 /******************** FUNCTION PROTOTYPES ********************/
 
 /**
- * Creates a new index with a specified number of slots.
+ * Creates a new, empty index.
  * 
- * @param num_slots Number of slots in the hashtable.
+ * @param num_slots Expected number of words; only a sizing hint, since
+ *                  the index grows as words are added.
  * @return Pointer to a new `index_t` or NULL on failure.
  */
 index_t* index_new(const int num_slots);
@@ -58,6 +66,18 @@ index_t* index_new(const int num_slots);
  */
 void index_insert(index_t* index, const char* word, const int docID);
 
+/**
+ * Like `index_insert`, but the word is given as a pointer and a length and
+ * need not be null-terminated, so a tokenizer's span can be inserted as is.
+ * The index copies the word only when it is new to the index.
+ *
+ * @param index Pointer to the index.
+ * @param word The first character of the word.
+ * @param len The number of characters in the word.
+ * @param docID The document ID where the word appears.
+ */
+void index_insertn(index_t* index, const char* word, const size_t len, const int docID);
+
 /**
  * Sets the count for a specific word in a document.
  * If the word is not in the index, it will be added.
@@ -80,14 +100,95 @@ void index_set(index_t* index, const char* word, const int docID, const int coun
 void index_save(index_t* index, FILE* fp);
 
 /**
- * Loads an index from a file.
- * The file should be formatted as described in `index_save()`.
+ * Saves the index to a file in the binary format, which is smaller than
+ * the text format and much faster to load. All integers are little-endian:
  *
- * @param fp File pointer to read from.
+ *   header     "TSEINDEX", uint32 version (1), uint32 reserved (0),
+ *              uint64 numTerms, uint64 namesBytes, uint64 postingsBytes
+ *   term table numTerms + 1 entries, one per word in strcmp order:
+ *              uint32 nameOffset, uint32 postingsOffset
+ *   names      the words, concatenated without separators
+ *   postings   per word, the number of documents, then that many
+ *              (docID gap, count) pairs; a gap is the difference from
+ *              the previous docID, or from 0 for the first
+ *
+ * Offsets are relative to the start of their section. A word's name and
+ * postings end where the next entry's begin; the last entry marks the end
+ * of both sections. Postings numbers are unsigned varints: 7 bits per
+ * byte, low bits first, with the high bit set on all but the last byte.
+ *
+ * @param index Pointer to the index.
+ * @param fp File pointer to write to (opened for writing, ideally "wb").
+ * @return true on success, false on NULL arguments or a write error.
+ */
+bool index_save_binary(index_t* index, FILE* fp);
+
+/**
+ * Loads an index from a file in either format: the binary format of
+ * `index_save_binary()` is recognized by its magic number; anything else
+ * is read as the text format of `index_save()`.
+ *
+ * @param fp File pointer to read from; it must be seekable.
  * @return Pointer to a newly allocated index, or NULL on failure.
  */
 index_t* index_load(FILE* fp);
 
+/**
+ * Loads an index from a file in the binary format of `index_save_binary()`.
+ *
+ * @param fp File pointer to read from.
+ * @return Pointer to a newly allocated index, or NULL if the file is not
+ *         a binary index of a known version, or is truncated or corrupt.
+ */
+index_t* index_load_binary(FILE* fp);
+
+/**
+ * Maps a binary-format index file (see `index_save_binary()`) into memory
+ * as a read-only index. Nothing is decoded up front, so this takes the
+ * same time whatever the size of the index: `index_find` binary-searches
+ * the mapped term table and decodes a word's posting list on its first
+ * lookup, keeping it for later lookups. The file's pages are read on
+ * demand and shared, through the page cache, by every process mapping it.
+ *
+ * A mapped index supports `index_find`, `index_save`, `index_save_binary`,
+ * being the source of `index_merge`, and `index_delete` (which unmaps it);
+ * `index_insert`, `index_insertn`, `index_set` and merging into it are
+ * ignored. `index_find` may be called on one mapped index from several
+ * threads at once: its cache of decoded lists is guarded by a lock.
+ *
+ * @param filename Path of the index file; it should not change while mapped.
+ * @return Pointer to the mapped index, or NULL if the file cannot be
+ *         mapped or is not a binary index (e.g. a text index) of a known
+ *         version; a caller can then fall back to `index_load`.
+ */
+index_t* index_map(const char* filename);
+
+/**
+ * Adds every (word, docID, count) of `src` into `dest`. This is how the
+ * partial indexes built by parallel indexer threads are combined.
+ * Counts for a (word, docID) already in `dest` are replaced, so the
+ * indexes should cover disjoint sets of documents; merging partials in
+ * increasing docID order keeps each word's documents in that order.
+ *
+ * @param dest The index to add to.
+ * @param src The index to add from; it is not modified.
+ */
+void index_merge(index_t* dest, index_t* src);
+
+/**
+ * Calls itemfunc(arg, word, len, postings) for every word, in term-ID
+ * order: the order words were first added, or for a mapped index (whose
+ * lists are all decoded first) dictionary order. The word is not
+ * necessarily null-terminated. The index must not change meanwhile.
+ *
+ * @param index The index; NULL does nothing.
+ * @param arg Arbitrary pointer passed along to itemfunc.
+ * @param itemfunc Function to call; NULL does nothing.
+ */
+void index_iterate(index_t* index, void* arg,
+                   void (*itemfunc)(void* arg, const char* word, const size_t len,
+                                    const postings_t* postings));
+
 /**
  * Deletes an index and frees all associated memory.
  *
@@ -96,13 +197,15 @@ index_t* index_load(FILE* fp);
 void index_delete(index_t* index);
 
 /**
- * Finds the counters object for a given word in the index.
+ * Finds the posting list for a given word in the index.
+ * Several threads may look up words at once, as long as none of them
+ * changes the index meanwhile.
  *
  * @param index Pointer to the index.
  * @param word The word to search for.
- * @return Pointer to the `counters_t` structure containing document IDs and counts,
+ * @return Pointer to the `postings_t` list of document IDs and counts,
  *         or NULL if the word is not found.
  */
-counters_t* index_find(index_t* index, const char* word);
+postings_t* index_find(index_t* index, const char* word);
 
 #endif // __INDEX_H
\ No newline at end of file
@@ -0,0 +1,544 @@
+/*
+ * indexset.c - CS50 Tiny Search Engine (TSE) segmented index
+ *
+ * see indexset.h for more information.
+ *
+ * The set is an array of segments, the main index first, each an index
+ * with the range of docIDs its table covers. A word in one segment is
+ * that segment's list; in several, the lists are united in the caller's
+ * arena, which for disjoint, ordered docIDs is a concatenation; so are
+ * its impacts, whose block maxima are then recomputed, since the blocks
+ * of the concatenated list straddle the segments' own.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // stat's st_mtim
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "indexset.h"
+#include "impacts.h"
+#include "../libcs50/mem.h"
+
+/**************** local types ****************/
+typedef struct segment {
+  index_t* index;
+  doctable_t* docs;         // NULL only for a main index saved without one
+  impacts_t* impacts;       // NULL for an index saved without impacts
+  bool binary;              // the index file is in the binary format
+} segment_t;
+
+typedef struct indexset {
+  segment_t* segments;      // segments[0] is the main index
+  int count;
+  int capacity;
+  int lastDoc;              // the high-water mark, or -1 if unknown
+} indexset_t;
+
+/**************** local functions ****************/
+static bool openSegment(const char* filename, segment_t* segment);
+static void addOpened(indexset_t* set, const segment_t* segment);
+static char* segmentFilename(const char* indexFilename, const int n);
+static char* tmpFilename(const char* filename);
+static bool writeIndex(index_t* index, const char* filename, const bool binary);
+static bool writeDocs(doctable_t* docs, const char* filename);
+static bool writeImpacts(index_t* index, doctable_t* docs, const impacts_stats_t* stats,
+                         const char* filename);
+static int otherDocs(void* arg, const char* word);
+static void copyDocs(doctable_t* dest, doctable_t* src);
+static uint64_t fileVersion(const char* filename, bool* exists);
+
+/**************** indexset_open ****************/
+/* see indexset.h for description */
+indexset_t* indexset_open(const char* indexFilename)
+{
+  if (indexFilename == NULL) {
+    return NULL;
+  }
+  segment_t main;
+  if (!openSegment(indexFilename, &main)) {
+    return NULL;
+  }
+
+  indexset_t* set = mem_calloc_assert(1, sizeof(indexset_t), "indexset_open");
+  addOpened(set, &main);
+  set->lastDoc = main.docs == NULL ? -1 : doctable_size(main.docs) - 1;
+  int covered = set->lastDoc < 0 ? 0 : set->lastDoc;
+
+  // Add each segment whose documents follow those before it
+  for (int n = 1; ; n++) {
+    char* filename = segmentFilename(indexFilename, n);
+    segment_t segment;
+    bool exists = true;
+    fileVersion(filename, &exists);
+    bool opened = exists && openSegment(filename, &segment);
+    mem_free(filename);
+    if (!exists) {
+      break;
+    }
+    if (!opened) {
+      continue;
+    }
+    if (segment.docs == NULL || doctable_firstDoc(segment.docs) <= covered) {
+      index_delete(segment.index);       // already compacted into the main index
+      doctable_delete(segment.docs);
+      impacts_delete(segment.impacts);
+      continue;
+    }
+    addOpened(set, &segment);
+    covered = doctable_size(segment.docs) - 1;
+    if (set->lastDoc >= 0) {
+      set->lastDoc = covered;
+    }
+  }
+  return set;
+}
+
+/**************** indexset_find ****************/
+/* see indexset.h for description */
+postings_t* indexset_find(indexset_t* set, const char* word, arena_t* arena)
+{
+  if (set == NULL || word == NULL) {
+    return NULL;
+  }
+  postings_t* found = NULL;
+  for (int i = 0; i < set->count; i++) {
+    postings_t* postings = index_find(set->segments[i].index, word);
+    if (postings == NULL) {
+      continue;
+    }
+    found = found == NULL ? postings : postings_union(found, postings, arena);
+  }
+  return found;
+}
+
+/**************** indexset_findImpacts ****************/
+/* see indexset.h for description */
+bool indexset_findImpacts(indexset_t* set, const char* word, arena_t* arena, impactlist_t* list)
+{
+  if (set == NULL || word == NULL || list == NULL) {
+    return false;
+  }
+
+  // Every segment with the word must have its impacts, one per posting
+  int found = 0;
+  size_t total = 0;
+  for (int i = 0; i < set->count; i++) {
+    postings_t* postings = index_find(set->segments[i].index, word);
+    size_t size;
+    const uint8_t* impacts;
+    const uint8_t* blockMax;
+    if (postings == NULL) {
+      continue;
+    }
+    if (!impacts_find(set->segments[i].impacts, word, &size, &impacts, &blockMax)
+        || size != postings_size(postings)) {
+      return false;
+    }
+    if (found++ == 0) {
+      list->postings = postings;
+      list->impacts = impacts;
+      list->blockMax = blockMax;
+    }
+    total += size;
+  }
+  if (found == 0) {
+    return false;
+  }
+
+  // In several segments: concatenate, then find the new blocks' maxima
+  if (found > 1) {
+    postings_t* postings = NULL;
+    uint8_t* impacts = arena_alloc(arena, total);
+    size_t numBlocks = (total + IMPACTS_BLOCK - 1) / IMPACTS_BLOCK;
+    uint8_t* blockMax = arena_alloc(arena, numBlocks);
+    size_t n = 0;
+    for (int i = 0; i < set->count; i++) {
+      postings_t* segmentPostings = index_find(set->segments[i].index, word);
+      size_t size;
+      const uint8_t* segmentImpacts;
+      const uint8_t* segmentMax;
+      if (segmentPostings != NULL
+          && impacts_find(set->segments[i].impacts, word, &size, &segmentImpacts, &segmentMax)) {
+        postings = postings == NULL ? segmentPostings : postings_union(postings, segmentPostings, arena);
+        memcpy(&impacts[n], segmentImpacts, size);
+        n += size;
+      }
+    }
+    memset(blockMax, 0, numBlocks);
+    for (size_t j = 0; j < total; j++) {
+      if (impacts[j] > blockMax[j / IMPACTS_BLOCK]) {
+        blockMax[j / IMPACTS_BLOCK] = impacts[j];
+      }
+    }
+    list->postings = postings;
+    list->impacts = impacts;
+    list->blockMax = blockMax;
+  }
+
+  list->maxImpact = 0;
+  for (size_t b = 0; b < (total + IMPACTS_BLOCK - 1) / IMPACTS_BLOCK; b++) {
+    list->maxImpact = list->blockMax[b] > list->maxImpact ? list->blockMax[b] : list->maxImpact;
+  }
+  return true;
+}
+
+/**************** indexset_hasImpacts ****************/
+/* see indexset.h for description */
+bool indexset_hasImpacts(indexset_t* set)
+{
+  if (set == NULL) {
+    return false;
+  }
+  for (int i = 0; i < set->count; i++) {
+    if (set->segments[i].impacts == NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**************** indexset_df ****************/
+/* see indexset.h for description */
+int indexset_df(indexset_t* set, const char* word)
+{
+  if (set == NULL || word == NULL) {
+    return 0;
+  }
+  int df = 0;
+  for (int i = 0; i < set->count; i++) {
+    postings_t* postings = index_find(set->segments[i].index, word);
+    df += postings == NULL ? 0 : postings_size(postings);
+  }
+  return df;
+}
+
+/**************** indexset_getDoc ****************/
+/* see indexset.h for description */
+bool indexset_getDoc(indexset_t* set, const int docID, docinfo_t* info)
+{
+  if (set == NULL) {
+    return false;
+  }
+  for (int i = 0; i < set->count; i++) {
+    if (doctable_get(set->segments[i].docs, docID, info)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************** indexset_lastDoc ****************/
+/* see indexset.h for description */
+int indexset_lastDoc(indexset_t* set)
+{
+  return set == NULL ? -1 : set->lastDoc;
+}
+
+/**************** indexset_numSegments ****************/
+/* see indexset.h for description */
+int indexset_numSegments(indexset_t* set)
+{
+  return set == NULL ? 0 : set->count - 1;
+}
+
+/**************** indexset_version ****************/
+/* see indexset.h for description */
+uint64_t indexset_version(const char* indexFilename)
+{
+  if (indexFilename == NULL) {
+    return 0;
+  }
+  bool exists;
+  uint64_t version = fileVersion(indexFilename, &exists);
+  if (!exists) {
+    return 0;
+  }
+  for (int n = 1; ; n++) {
+    char* filename = segmentFilename(indexFilename, n);
+    uint64_t segmentVersion = fileVersion(filename, &exists);
+    mem_free(filename);
+    if (!exists) {
+      break;
+    }
+    version = (version ^ segmentVersion) * 0x100000001b3u + n;
+  }
+  return version == 0 ? 1 : version;
+}
+
+/**************** indexset_addSegment ****************/
+/* see indexset.h for description */
+int indexset_addSegment(const char* indexFilename, index_t* index, doctable_t* docs)
+{
+  if (indexFilename == NULL || index == NULL || docs == NULL) {
+    return 0;
+  }
+
+  // The next number after the last segment
+  int n = 1;
+  for (bool exists = true; ; n++) {
+    char* filename = segmentFilename(indexFilename, n);
+    fileVersion(filename, &exists);
+    mem_free(filename);
+    if (!exists) {
+      break;
+    }
+  }
+
+  // Its impacts are scored against the whole collection, on the main
+  // table's scale; without a main table, the segment gets none either
+  indexset_t* set = indexset_open(indexFilename);
+  impacts_stats_t stats = { 0, 0, 0, otherDocs, set };
+  if (set != NULL && set->segments[0].impacts != NULL) {
+    for (int i = 0; i < set->count; i++) {
+      impacts_addDocs(&stats, set->segments[i].docs);
+    }
+    impacts_addDocs(&stats, docs);
+    stats.scale = impacts_scale(set->segments[0].impacts);
+  }
+
+  // The table and impacts first: the segment exists once its index is
+  // renamed into place
+  char* filename = segmentFilename(indexFilename, n);
+  char* docsFilename = doctable_filename(filename);
+  char* impactsFilename = impacts_filename(filename);
+  char* tmp = tmpFilename(filename);
+  bool ok = writeDocs(docs, docsFilename)
+    && (stats.totalLength == 0 || writeImpacts(index, docs, &stats, impactsFilename))
+    && writeIndex(index, tmp, true) && rename(tmp, filename) == 0;
+  if (!ok) {
+    remove(tmp);
+    remove(docsFilename);
+    remove(impactsFilename);
+  }
+  indexset_delete(set);
+  mem_free(tmp);
+  mem_free(impactsFilename);
+  mem_free(docsFilename);
+  mem_free(filename);
+  return ok ? n : 0;
+}
+
+/**************** indexset_compact ****************/
+/* see indexset.h for description */
+int indexset_compact(const char* indexFilename)
+{
+  indexset_t* set = indexset_open(indexFilename);
+  if (set == NULL) {
+    return -1;
+  }
+
+  // Concatenate the segments' lists, in docID order, into one index
+  int merged = set->count - 1;
+  bool ok = true;
+  if (merged > 0) {
+    index_t* index = index_new(500);
+    doctable_t* docs = doctable_new();
+    mem_assert(index, "Out of memory: Failed to allocate compacted index");
+    for (int i = 0; i < set->count; i++) {
+      index_merge(index, set->segments[i].index);
+      copyDocs(docs, set->segments[i].docs);
+    }
+
+    // Score the merged index afresh, on its own scale
+    impacts_stats_t stats = { 0, 0, 0, NULL, NULL };
+    impacts_addDocs(&stats, docs);
+
+    // Write all three, then rename them, the table first and the index last
+    char* docsFilename = doctable_filename(indexFilename);
+    char* impactsFilename = impacts_filename(indexFilename);
+    char* tmpDocs = tmpFilename(docsFilename);
+    char* tmpImpacts = tmpFilename(impactsFilename);
+    char* tmp = tmpFilename(indexFilename);
+    // (without documents there is nothing to score, and an old table goes)
+    bool scored = stats.totalLength > 0;
+    if (!scored) {
+      remove(impactsFilename);
+    }
+    ok = writeDocs(docs, tmpDocs) && writeIndex(index, tmp, set->segments[0].binary)
+      && (!scored || writeImpacts(index, docs, &stats, tmpImpacts))
+      && rename(tmpDocs, docsFilename) == 0
+      && (!scored || rename(tmpImpacts, impactsFilename) == 0)
+      && rename(tmp, indexFilename) == 0;
+    if (!ok) {
+      remove(tmpDocs);
+      remove(tmpImpacts);
+      remove(tmp);
+    }
+    mem_free(tmp);
+    mem_free(tmpImpacts);
+    mem_free(tmpDocs);
+    mem_free(impactsFilename);
+    mem_free(docsFilename);
+    index_delete(index);
+    doctable_delete(docs);
+  }
+  indexset_delete(set);
+
+  // Remove every segment, including any left over from an earlier compaction
+  for (int n = 1; ok; n++) {
+    char* filename = segmentFilename(indexFilename, n);
+    char* docsFilename = doctable_filename(filename);
+    char* impactsFilename = impacts_filename(filename);
+    bool removed = remove(filename) == 0;
+    remove(docsFilename);
+    remove(impactsFilename);
+    mem_free(impactsFilename);
+    mem_free(docsFilename);
+    mem_free(filename);
+    if (!removed) {
+      break;
+    }
+  }
+  return ok ? merged : -1;
+}
+
+/**************** indexset_delete ****************/
+/* see indexset.h for description */
+void indexset_delete(indexset_t* set)
+{
+  if (set == NULL) {
+    return;
+  }
+  for (int i = 0; i < set->count; i++) {
+    index_delete(set->segments[i].index);
+    doctable_delete(set->segments[i].docs);
+    impacts_delete(set->segments[i].impacts);
+  }
+  mem_free(set->segments);
+  mem_free(set);
+}
+
+/* Maps (or, if it is a text index, loads) an index file and maps its
+ * document table and impacts; false if the index cannot be read */
+static bool openSegment(const char* filename, segment_t* segment)
+{
+  segment->index = index_map(filename);
+  segment->binary = segment->index != NULL;
+  if (segment->index == NULL) {
+    FILE* fp = fopen(filename, "r");
+    if (fp == NULL) {
+      return false;
+    }
+    segment->index = index_load(fp);
+    fclose(fp);
+    if (segment->index == NULL) {
+      return false;
+    }
+  }
+  char* docsFilename = doctable_filename(filename);
+  segment->docs = doctable_map(docsFilename);
+  mem_free(docsFilename);
+  char* impactsFilename = impacts_filename(filename);
+  segment->impacts = impacts_map(impactsFilename);
+  mem_free(impactsFilename);
+  return true;
+}
+
+/* Appends an opened segment to the set, growing its array */
+static void addOpened(indexset_t* set, const segment_t* segment)
+{
+  if (set->count == set->capacity) {
+    int capacity = set->capacity == 0 ? 4 : 2 * set->capacity;
+    segment_t* bigger = mem_malloc_assert(capacity * sizeof(segment_t), "indexset segments");
+    if (set->segments != NULL) {
+      memcpy(bigger, set->segments, set->count * sizeof(segment_t));
+      mem_free(set->segments);
+    }
+    set->segments = bigger;
+    set->capacity = capacity;
+  }
+  set->segments[set->count++] = *segment;
+}
+
+/* Returns the malloc'd filename of segment n: indexFilename.n */
+static char* segmentFilename(const char* indexFilename, const int n)
+{
+  char* filename = mem_malloc_assert(strlen(indexFilename) + 13, "indexset filename");
+  sprintf(filename, "%s.%d", indexFilename, n);
+  return filename;
+}
+
+/* Returns the malloc'd temporary name a file is written under */
+static char* tmpFilename(const char* filename)
+{
+  char* tmp = mem_malloc_assert(strlen(filename) + strlen(".tmp") + 1, "indexset filename");
+  sprintf(tmp, "%s.tmp", filename);
+  return tmp;
+}
+
+/* Writes an index to a file, in the binary or text format */
+static bool writeIndex(index_t* index, const char* filename, const bool binary)
+{
+  FILE* fp = fopen(filename, binary ? "wb" : "w");
+  bool ok = fp != NULL;
+  if (ok && binary) {
+    ok = index_save_binary(index, fp);
+  } else if (ok) {
+    index_save(index, fp);
+    ok = !ferror(fp);
+  }
+  if (fp != NULL && fclose(fp) != 0) {
+    ok = false;
+  }
+  return ok;
+}
+
+/* Writes a document table to a file */
+static bool writeDocs(doctable_t* docs, const char* filename)
+{
+  FILE* fp = fopen(filename, "wb");
+  bool ok = fp != NULL && doctable_save(docs, fp);
+  if (fp != NULL && fclose(fp) != 0) {
+    ok = false;
+  }
+  return ok;
+}
+
+/* Computes and writes an index's impacts to a file */
+static bool writeImpacts(index_t* index, doctable_t* docs, const impacts_stats_t* stats,
+                         const char* filename)
+{
+  FILE* fp = fopen(filename, "wb");
+  bool ok = fp != NULL && impacts_save(index, docs, stats, fp);
+  if (fp != NULL && fclose(fp) != 0) {
+    ok = false;
+  }
+  return ok;
+}
+
+/* impacts_stats_t callback: a word's documents in the set (the arg) */
+static int otherDocs(void* arg, const char* word)
+{
+  return indexset_df(arg, word);
+}
+
+/* Copies every document of src (which may be mapped, or NULL) into dest */
+static void copyDocs(doctable_t* dest, doctable_t* src)
+{
+  docinfo_t info;
+  for (int docID = doctable_firstDoc(src); docID < doctable_size(src); docID++) {
+    if (doctable_get(src, docID, &info)) {
+      doctable_set(dest, docID, info.url, info.urlLen, info.depth, info.length);
+    }
+  }
+}
+
+/* Combines a file's modification time, size and inode; *exists tells
+ * whether there is such a file */
+static uint64_t fileVersion(const char* filename, bool* exists)
+{
+  struct stat st;
+  *exists = stat(filename, &st) == 0;
+  if (!*exists) {
+    return 0;
+  }
+  uint64_t version = (uint64_t) st.st_mtim.tv_sec * 1000000000u + st.st_mtim.tv_nsec;
+  version ^= (uint64_t) st.st_size * 0x9e3779b97f4a7c15u;
+  version ^= (uint64_t) st.st_ino << 32 | (uint64_t) st.st_ino >> 32;
+  return version;
+}
@@ -0,0 +1,176 @@
+/*
+ * indexset.h - CS50 Tiny Search Engine (TSE) segmented index
+ *
+ * An index set is an index file together with the segments added to it
+ * since it was built. `indexer -u` indexes only the pages past the set's
+ * high-water mark (the largest docID in any of its document tables) into
+ * a new, small segment, so refreshing the index costs what the new pages
+ * cost, not the whole corpus. `indexer -m` compacts: it merges every
+ * segment into the main index and removes them.
+ *
+ * Segment n (1, 2, ...) of index file F is the binary index F.n, with its
+ * document table F.n.docs (see doctable.h) and impacts F.n.impacts (see
+ * impacts.h), covering docIDs above those of F and of F.1 to F.(n-1). A
+ * segment's table and impacts are written before its index, and every
+ * file is written under a temporary name and renamed into place, so a
+ * reader never sees a half-written segment. Segments are
+ * found by probing F.1, F.2, ... up to the first missing one.
+ *
+ * Since the segments' docIDs follow each other, a word's documents in the
+ * whole set are its documents in F, then in F.1, and so on: lists are
+ * concatenated, never merged. A segment whose documents do not follow the
+ * ones before it was already merged into F by a compaction that has not
+ * yet removed it, and is skipped.
+ *
+ * A segment's impacts are scored against the whole set, on the main
+ * index's scale, so that they add up with the main index's; compacting
+ * scores the merged index afresh.
+ *
+ * Functions:
+ *  - `indexset_open`: Opens an index file and its segments.
+ *  - `indexset_find`: Returns a word's posting list across all segments.
+ *  - `indexset_findImpacts`: Returns a word's impact list across all segments.
+ *  - `indexset_hasImpacts`: Tells whether every segment has impacts.
+ *  - `indexset_df`: Returns the number of documents containing a word.
+ *  - `indexset_getDoc`: Looks up a document in the segments' tables.
+ *  - `indexset_lastDoc`: Returns the high-water mark.
+ *  - `indexset_numSegments`: Returns the number of segments opened.
+ *  - `indexset_version`: Identifies the current contents of the files.
+ *  - `indexset_addSegment`: Saves a new segment.
+ *  - `indexset_compact`: Merges the segments into the main index.
+ *  - `indexset_delete`: Closes an index set.
+ *
+ * Error Handling:
+ *  - Functions return NULL, false or 0 on bad arguments or I/O errors;
+ *    running out of memory terminates the program via `mem_assert`.
+ *  - An open set is read-only and may be searched from any number of
+ *    threads at once. Adding a segment while compacting is not supported.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __INDEXSET_H
+#define __INDEXSET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "arena.h"
+#include "doctable.h"
+#include "impacts.h"
+#include "index.h"
+#include "postings.h"
+
+/* An open index set; opaque to users of the module */
+typedef struct indexset indexset_t;
+
+/**
+ * Opens an index file, in either format (see index.h), with its document
+ * table if it has one, and its segments. Binary files are mapped.
+ *
+ * @param indexFilename The main index file.
+ * @return Pointer to the set, or NULL if the main index cannot be loaded.
+ */
+indexset_t* indexset_open(const char* indexFilename);
+
+/**
+ * Finds a word's posting list across the set.
+ *
+ * @param set The set.
+ * @param word The word.
+ * @param arena Where to build the list if the word is in several
+ *              segments; a list found in just one is returned as is.
+ * @return The list, valid until the set is deleted or the arena reset;
+ *         NULL if the word is in no segment.
+ */
+postings_t* indexset_find(indexset_t* set, const char* word, arena_t* arena);
+
+/**
+ * Finds a word's impact list across the set.
+ *
+ * @param set The set.
+ * @param word The word.
+ * @param arena Where to build the list if the word is in several
+ *              segments, as for `indexset_find`.
+ * @param list Where to store the list, valid as for `indexset_find`.
+ * @return true if the word is in a segment and every segment with the
+ *         word has its impacts; else false.
+ */
+bool indexset_findImpacts(indexset_t* set, const char* word, arena_t* arena, impactlist_t* list);
+
+/**
+ * Tells whether every segment of the set, the main index included, was
+ * saved with its impacts, so that the set can be ranked by BM25.
+ */
+bool indexset_hasImpacts(indexset_t* set);
+
+/**
+ * Returns the number of documents of the set containing a word.
+ */
+int indexset_df(indexset_t* set, const char* word);
+
+/**
+ * Looks up a document in the document tables of the set.
+ *
+ * @param set The set.
+ * @param docID The document ID.
+ * @param info Where to store the document's metadata (see doctable_get).
+ * @return true if a table has the document, else false.
+ */
+bool indexset_getDoc(indexset_t* set, const int docID, docinfo_t* info);
+
+/**
+ * Returns the high-water mark: the largest docID in the set's document
+ * tables (0 if they are empty), or -1 if the main index has no document
+ * table, so that which pages it covers is unknown.
+ */
+int indexset_lastDoc(indexset_t* set);
+
+/**
+ * Returns the number of segments opened, not counting the main index.
+ */
+int indexset_numSegments(indexset_t* set);
+
+/**
+ * Identifies the current contents of an index file and its segments,
+ * combining each file's modification time, size and inode, so that it
+ * changes whenever the indexer writes, replaces, adds or removes one.
+ *
+ * @param indexFilename The main index file.
+ * @return The version, or 0 if the main index cannot be examined.
+ */
+uint64_t indexset_version(const char* indexFilename);
+
+/**
+ * Saves an index and its document table as the next segment of an index
+ * file, with its impacts if the main index has them. The documents must
+ * all come after the set's high-water mark.
+ *
+ * @param indexFilename The main index file.
+ * @param index The segment's index.
+ * @param docs The segment's document table.
+ * @return The new segment's number, or 0 on a write error.
+ */
+int indexset_addSegment(const char* indexFilename, index_t* index, doctable_t* docs);
+
+/**
+ * Merges every segment of an index file into it, then removes them. The
+ * main index keeps its format; the merged index, table and impacts are
+ * written under temporary names and renamed over the old ones, the index
+ * last.
+ *
+ * @param indexFilename The main index file.
+ * @return The number of segments merged, or -1 if the index cannot be
+ *         opened or the merged files cannot be written (the files are
+ *         then as they were).
+ */
+int indexset_compact(const char* indexFilename);
+
+/**
+ * Closes an index set, freeing or unmapping every index and table.
+ *
+ * @param set The set; NULL is ignored.
+ */
+void indexset_delete(indexset_t* set);
+
+#endif // __INDEXSET_H
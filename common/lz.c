@@ -0,0 +1,272 @@
+/*
+ * lz.c - CS50 Tiny Search Engine (TSE) page compression
+ *
+ * see lz.h for more information.
+ *
+ * The compressor is greedy: it hashes the 4 bytes at each position into
+ * a table of the last position they were seen at, and on a hit extends
+ * the match as far as it goes. After 64 misses in a row it starts
+ * skipping ahead, so incompressible data passes through quickly. As the
+ * LZ4 format requires, the last 5 bytes of a block are always literals
+ * and no match starts within its last 12.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "lz.h"
+#include "binfile.h"
+
+/**************** constants ****************/
+#define MIN_MATCH 4             // shortest match encoded
+#define LAST_LITERALS 5         // bytes at the end of a block that are always literals
+#define MF_LIMIT 12             // no match starts this close to the end of a block
+#define HASH_LOG 13             // the match finder's table has 2^HASH_LOG entries
+static const uint32_t STORED = 0x80000000u;   // block prefix flag: not compressed
+
+/**************** local functions ****************/
+static size_t compressBlock(const unsigned char* src, const size_t n, unsigned char* dst);
+static bool decompressBlock(const unsigned char* src, const size_t n, unsigned char* dst, const size_t rawLen);
+static unsigned char* putLength(unsigned char* op, size_t len);
+static bool getLength(const unsigned char* src, const size_t n, size_t* ip, size_t* len);
+static inline uint32_t read32(const unsigned char* p);
+
+/**************** lz_frameBound ****************/
+/* see lz.h for description */
+size_t lz_frameBound(const size_t n)
+{
+  // a block that does not compress can grow by 1/255 and a few bytes
+  // before it is stored instead, so room for that is needed in between
+  size_t blocks = (n + LZ_BLOCK - 1) / LZ_BLOCK;
+  return 4 + n + n / 255 + blocks * 20;
+}
+
+/**************** lz_encodeFrame ****************/
+/* see lz.h for description */
+size_t lz_encodeFrame(const char* src, const size_t n, char* dst)
+{
+  unsigned char* op = (unsigned char*) dst;
+  binfile_set32(op, n);
+  op += 4;
+
+  for (size_t at = 0; at < n; at += LZ_BLOCK) {
+    size_t len = n - at < LZ_BLOCK ? n - at : LZ_BLOCK;
+    size_t packed = compressBlock((const unsigned char*) src + at, len, op + 4);
+    if (packed >= len) {
+      memcpy(op + 4, src + at, len);     // store it; compression gained nothing
+      binfile_set32(op, len | STORED);
+      packed = len;
+    } else {
+      binfile_set32(op, packed);
+    }
+    op += 4 + packed;
+  }
+  return op - (unsigned char*) dst;
+}
+
+/**************** lz_openFrame ****************/
+/* see lz.h for description */
+size_t lz_openFrame(lzframe_t* frame, const char* data, const size_t size)
+{
+  if (frame == NULL) {
+    return 0;
+  }
+  frame->data = (const unsigned char*) data;
+  frame->size = size;
+  frame->pos = 4;
+  frame->rawLeft = 0;
+  frame->error = data == NULL || size < 4;
+  if (!frame->error) {
+    frame->rawLeft = binfile_get32(frame->data);
+  }
+  return frame->rawLeft;
+}
+
+/**************** lz_nextBlock ****************/
+/* see lz.h for description */
+bool lz_nextBlock(lzframe_t* frame, char* dst, size_t* len)
+{
+  if (frame == NULL || dst == NULL || len == NULL || frame->error) {
+    return false;
+  }
+  if (frame->rawLeft == 0) {
+    frame->error = frame->pos != frame->size;   // trailing bytes
+    return false;
+  }
+  if (frame->size - frame->pos < 4) {
+    frame->error = true;
+    return false;
+  }
+
+  uint32_t prefix = binfile_get32(frame->data + frame->pos);
+  size_t packed = prefix & ~STORED;
+  size_t expect = frame->rawLeft < LZ_BLOCK ? frame->rawLeft : LZ_BLOCK;
+  const unsigned char* block = frame->data + frame->pos + 4;
+  if (packed > frame->size - frame->pos - 4) {
+    frame->error = true;
+  } else if (prefix & STORED) {
+    frame->error = packed != expect;
+    if (!frame->error) {
+      memcpy(dst, block, packed);
+    }
+  } else {
+    frame->error = !decompressBlock(block, packed, (unsigned char*) dst, expect);
+  }
+  if (frame->error) {
+    return false;
+  }
+
+  frame->pos += 4 + packed;
+  frame->rawLeft -= expect;
+  *len = expect;
+  return true;
+}
+
+/* Compresses the n bytes of src (n <= LZ_BLOCK) into dst, which has
+ * room for n + n/255 + 16 bytes; returns the compressed length */
+static size_t compressBlock(const unsigned char* src, const size_t n, unsigned char* dst)
+{
+  unsigned char* op = dst;
+  size_t anchor = 0;              // start of the literals not yet written
+
+  if (n > MF_LIMIT) {
+    uint16_t table[1 << HASH_LOG];   // positions fit: n <= 65536
+    memset(table, 0, sizeof(table));
+    const size_t matchLimit = n - LAST_LITERALS;
+    unsigned misses = 0;
+
+    for (size_t ip = 1; ip < n - MF_LIMIT; ) {
+      uint32_t seq = read32(src + ip);
+      uint32_t h = (seq * 2654435761u) >> (32 - HASH_LOG);
+      size_t ref = table[h];
+      table[h] = ip;
+      if (ref >= ip || read32(src + ref) != seq) {
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+
+      size_t len = MIN_MATCH;
+      while (ip + len < matchLimit && src[ref + len] == src[ip + len]) {
+        len++;
+      }
+
+      // one sequence: token, literal length, literals, offset, match length
+      size_t litLen = ip - anchor, matchLen = len - MIN_MATCH;
+      unsigned char* token = op++;
+      *token = (litLen < 15 ? litLen : 15) << 4 | (matchLen < 15 ? matchLen : 15);
+      op = putLength(op, litLen);
+      memcpy(op, src + anchor, litLen);
+      op += litLen;
+      *op++ = (ip - ref) & 0xff;
+      *op++ = (ip - ref) >> 8;
+      op = putLength(op, matchLen);
+
+      ip += len;
+      anchor = ip;
+      misses = 0;
+    }
+  }
+
+  // the last sequence is literals only
+  size_t litLen = n - anchor;
+  *op++ = (litLen < 15 ? litLen : 15) << 4;
+  op = putLength(op, litLen);
+  memcpy(op, src + anchor, litLen);
+  return op + litLen - dst;
+}
+
+/* Decompresses the n bytes of src into exactly rawLen bytes of dst;
+ * false if src is not a valid block of that length */
+static bool decompressBlock(const unsigned char* src, const size_t n, unsigned char* dst, const size_t rawLen)
+{
+  size_t ip = 0, op = 0;
+  while (ip < n) {
+    unsigned token = src[ip++];
+    size_t litLen = token >> 4;
+
+    if (litLen < 15 && n - ip >= 16 + 2 && rawLen - op >= 16) {
+      // short literals, with room to spare on both sides: one fixed-size
+      // copy, and more input follows, so this is not the last sequence
+      memcpy(dst + op, src + ip, 16);
+      ip += litLen;
+      op += litLen;
+    } else {
+      if (!getLength(src, n, &ip, &litLen) || litLen > n - ip || litLen > rawLen - op) {
+        return false;
+      }
+      memcpy(dst + op, src + ip, litLen);
+      ip += litLen;
+      op += litLen;
+      if (ip == n) {
+        return op == rawLen;    // the last sequence has no match
+      }
+    }
+
+    if (n - ip < 2) {
+      return false;
+    }
+    size_t offset = src[ip] | (size_t) src[ip + 1] << 8;
+    ip += 2;
+    size_t matchLen = token & 15;
+    if (offset == 0 || offset > op || !getLength(src, n, &ip, &matchLen)
+        || matchLen + MIN_MATCH > rawLen - op) {
+      return false;
+    }
+    matchLen += MIN_MATCH;
+
+    // a match may overlap the bytes it produces, so copy forwards; in
+    // 8-byte steps each step reads only bytes already written if offset >= 8
+    if (offset >= 8 && rawLen - op >= matchLen + 8) {
+      for (size_t i = 0; i < matchLen; i += 8) {
+        memcpy(dst + op + i, dst + op - offset + i, 8);
+      }
+    } else {
+      for (size_t i = 0; i < matchLen; i++) {
+        dst[op + i] = dst[op - offset + i];
+      }
+    }
+    op += matchLen;
+  }
+  return false;                 // empty input, or it ended after a match
+}
+
+/* Writes the rest of a length whose 4-bit token field holds 15 */
+static unsigned char* putLength(unsigned char* op, size_t len)
+{
+  if (len < 15) {
+    return op;
+  }
+  for (len -= 15; len >= 255; len -= 255) {
+    *op++ = 255;
+  }
+  *op++ = len;
+  return op;
+}
+
+/* Reads the rest of a length whose 4-bit token field is *len, if 15 */
+static bool getLength(const unsigned char* src, const size_t n, size_t* ip, size_t* len)
+{
+  if (*len != 15) {
+    return true;
+  }
+  unsigned char b;
+  do {
+    if (*ip >= n || *len > LZ_BLOCK) {
+      return false;
+    }
+    b = src[(*ip)++];
+    *len += b;
+  } while (b == 255);
+  return true;
+}
+
+/* Reads 4 bytes; the byte order is the host's, as only equality matters */
+static inline uint32_t read32(const unsigned char* p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
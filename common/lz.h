@@ -0,0 +1,86 @@
+/*
+ * lz.h - CS50 Tiny Search Engine (TSE) page compression
+ *
+ * A small LZ77 codec for page HTML, using the LZ4 block format: each
+ * sequence is a token byte, literals, a 2-byte offset back into the
+ * output and a match length. It compresses HTML two to four times and
+ * decompresses with nothing but byte copies.
+ *
+ * A frame holds a whole document: its length (4 bytes, little-endian),
+ * then the document cut into LZ_BLOCK-byte blocks, each compressed on its
+ * own and prefixed by a 4-byte word: the block's byte count, with the top
+ * bit set if it is stored uncompressed (when compression would not save
+ * anything). A reader can therefore decompress a frame one block at a
+ * time into a small buffer, without ever holding the whole document.
+ *
+ * Functions:
+ *  - `lz_frameBound`: The most bytes a frame of a given document can take.
+ *  - `lz_encodeFrame`: Compresses a document into a frame.
+ *  - `lz_openFrame`: Starts reading a frame.
+ *  - `lz_nextBlock`: Decompresses a frame's next block.
+ *
+ * Error Handling:
+ *  - Decoding never reads or writes out of bounds, however corrupt the
+ *    frame; corruption ends the frame and sets its `error` flag.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __LZ_H
+#define __LZ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Bytes of document per block; offsets within a block fit in 2 bytes */
+#define LZ_BLOCK 65536
+
+/* Reading state for one frame; a plain struct so callers can keep it on the stack */
+typedef struct lzframe {
+  const unsigned char* data;   // the frame
+  size_t size;                 // its length
+  size_t pos;                  // offset of the next block's prefix
+  size_t rawLeft;              // document bytes not yet decompressed
+  bool error;                  // set once corruption is found
+} lzframe_t;
+
+/**
+ * Returns the most bytes `lz_encodeFrame` can write for an n-byte document.
+ */
+size_t lz_frameBound(const size_t n);
+
+/**
+ * Compresses a document into a frame.
+ *
+ * @param src The document.
+ * @param n Its length, at most 2^31 - 1 bytes.
+ * @param dst Where to write the frame; at least lz_frameBound(n) bytes.
+ * @return The frame's length.
+ */
+size_t lz_encodeFrame(const char* src, const size_t n, char* dst);
+
+/**
+ * Starts reading a frame.
+ *
+ * @param frame The state to initialize.
+ * @param data The frame; it must stay valid while it is read.
+ * @param size The frame's length.
+ * @return The document's length, or 0 with frame->error set if the frame
+ *         is too short to hold one.
+ */
+size_t lz_openFrame(lzframe_t* frame, const char* data, const size_t size);
+
+/**
+ * Decompresses a frame's next block.
+ *
+ * @param frame The frame.
+ * @param dst Where to write the block: room for LZ_BLOCK bytes, or for
+ *            frame->rawLeft if fewer are left.
+ * @param len Where to store the number of bytes written.
+ * @return true if a block was written; false at the end of the frame or
+ *         on corruption (then frame->error is set).
+ */
+bool lz_nextBlock(lzframe_t* frame, char* dst, size_t* len);
+
+#endif // __LZ_H
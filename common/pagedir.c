@@ -9,6 +9,24 @@
  *  - `pagedir_save`: Saves a webpage to a uniquely named file in the page directory.
  *  - `pagedir_validate`: Checks whether a given directory is a valid crawler-produced directory.
  *  - `pagedir_load`: Loads a webpage from a saved file in the page directory.
+ *  - `pagedir_map`: Maps a saved webpage file into memory without copying it.
+ *  - `pagedir_unmap`: Releases a mapping made by `pagedir_map`.
+ *  - `pagedir_numDocs`: Counts the documents in a page directory.
+ *  - `pagedir_openWriter`, `pagedir_append`, `pagedir_closeWriter`: Write pages as segments.
+ *  - `pagedir_resumeWriter`, `pagedir_flushWriter`, `pagedir_writtenDocs`: Resume and sync them.
+ *  - `pagedir_openCursor`, `pagedir_next`, `pagedir_closeCursor`: Read a directory's pages in order.
+ *
+ * Segment layout (all integers little-endian):
+ *  - pages.NNNN.seg: a 16-byte header (magic "\x7fSEG", version, segment
+ *    number, 0), then records: magic "\x7fREC", docID, depth, URL length,
+ *    HTML length (4 bytes each), the URL, and the HTML (no terminators);
+ *    a record with magic "\x7fRLZ" holds the HTML as a compressed frame
+ *    (see lz.h) instead, and its HTML length is the frame's.
+ *  - pages.idx: a 16-byte header (magic "TSEPGIDX", version, 0), then one
+ *    16-byte entry per docID 1, 2, 3, ...: segment number, record length,
+ *    and the record's 8-byte offset in its segment.
+ * Both magics start with 0x7f, which no URL does, so `pagedir_load` can
+ * tell a segment from a page file by its first byte.
  *
  * Assumptions:
  *  - The provided directory exists before calling `pagedir_init`.
@@ -25,12 +43,23 @@
  * Date: 2/19/25
  */
 
+ #define _POSIX_C_SOURCE 200809L  // stat, truncate, fsync, posix_madvise
  #include <stdio.h>
  #include <stdlib.h>
  #include <string.h>
  #include <stdbool.h>
+ #include <stdint.h>
+ #include <limits.h>
+ #include <errno.h>
+ #include <pthread.h>
+ #include <unistd.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
  #include "../libcs50/webpage.h"
  #include "pagedir.h"
+ #include "binfile.h"
+ #include "lz.h"
+ #include "stats.h"
  #include "../libcs50/file.h"
  #include "../libcs50/mem.h" // Defensive programming helpers
 
@@ -39,6 +68,68 @@
   void pagedir_save(const webpage_t* page, const char* pageDirectory, int docID);
   bool pagedir_validate(const char* pageDirectory);
   webpage_t* pagedir_load(FILE* fp);
+  bool pagedir_map(const char* filename, pagemap_t* map);
+  void pagedir_unmap(pagemap_t* map);
+  int pagedir_numDocs(const char* pageDirectory);
+  pagewriter_t* pagedir_openWriter(const char* pageDirectory, const bool compress);
+  int pagedir_append(pagewriter_t* writer, const webpage_t* page);
+  bool pagedir_closeWriter(pagewriter_t* writer);
+  pagewriter_t* pagedir_resumeWriter(const char* pageDirectory, const bool compress, const int numDocs);
+  bool pagedir_flushWriter(pagewriter_t* writer);
+  int pagedir_writtenDocs(pagewriter_t* writer);
+  pagecursor_t* pagedir_openCursor(const char* pageDirectory, const int firstDoc);
+  bool pagedir_next(pagecursor_t* cursor, int* docID, pagemap_t* page);
+  void pagedir_closeCursor(pagecursor_t* cursor);
+
+  /**************** segment format ****************/
+  static const char SEGMENT_MAGIC[4] = { 0x7f, 'S', 'E', 'G' };
+  static const char RECORD_MAGIC[4] = { 0x7f, 'R', 'E', 'C' };
+  static const char LZ_RECORD_MAGIC[4] = { 0x7f, 'R', 'L', 'Z' };
+  static const char INDEX_MAGIC[8] = { 'T', 'S', 'E', 'P', 'G', 'I', 'D', 'X' };
+  static const uint32_t SEGMENT_VERSION = 1;
+  #define SEGMENT_HEADER 16       // magic, version, segment number, 0
+  #define RECORD_HEADER 20        // magic, docID, depth, URL length, HTML length
+  #define INDEX_HEADER 16         // magic, version, 0
+  #define INDEX_ENTRY 16          // segment number, record length, offset
+  #define MAX_FIELD (1u << 30)    // longest URL or HTML a reader accepts
+
+  /**************** local types ****************/
+  typedef struct pagewriter {
+      char* pageDirectory;
+      FILE* segment;              // the segment being written
+      int segmentNum;
+      uint64_t offset;            // bytes written to it so far
+      FILE* index;                // pages.idx
+      int numDocs;                // docIDs handed out
+      bool compress;              // whether records hold compressed HTML
+      bool ok;                    // false after any write error
+      pthread_mutex_t lock;       // guards all of the above
+  } pagewriter_t;
+
+  typedef struct pagecursor {
+      char* pageDirectory;
+      int nextDoc;                // files: the next docID to open
+      pagemap_t file;             // files: the page file now mapped
+      bool segmented;
+      int segmentNum;             // segments: the segment now mapped, if any
+      const unsigned char* data;
+      size_t size;
+      size_t pos;                 // the next record's offset in it
+  } pagecursor_t;
+
+  /**************** local functions ****************/
+  static char* segmentPath(const char* pageDirectory, const int segmentNum);
+  static char* indexPath(const char* pageDirectory);
+  static pagewriter_t* newWriter(const char* pageDirectory, const bool compress);
+  static void removeSegmentsAfter(const char* pageDirectory, const int segmentNum);
+  static bool startSegment(pagewriter_t* writer);
+  static bool mapSegment(pagecursor_t* cursor, const int segmentNum);
+  static void unmapSegment(pagecursor_t* cursor);
+  static void savePage(const webpage_t* page, const char* pageDirectory, int docID);
+  static webpage_t* loadPage(FILE* fp);
+  static webpage_t* loadRecord(FILE* fp);
+  static int appendPage(pagewriter_t* writer, const webpage_t* page);
+  static bool nextPage(pagecursor_t* cursor, int* docID, pagemap_t* page);
 
  /* ************** pagedir_init ************** */
 /*
@@ -103,6 +194,13 @@ bool pagedir_init(const char* pageDirectory) {
 * - docID: A unique document ID assigned to the webpage.
 */
 void pagedir_save(const webpage_t* page, const char* pageDirectory, int docID) {
+    STATS_START(start);
+    savePage(page, pageDirectory, docID);
+    STATS_STOP(STATS_PAGE_SAVE, start);
+}
+
+/* Does the work of pagedir_save, which times it */
+static void savePage(const webpage_t* page, const char* pageDirectory, int docID) {
     if (page == NULL || pageDirectory == NULL || docID < 0) {
         fprintf(stderr, "Error: invalid arguments to pagedir_save\n");
         return;
@@ -183,8 +281,22 @@ bool pagedir_validate(const char* pageDirectory) {
     if (crawlerFile == NULL) {
         return false; // Not a valid crawler directory
     }
-
     fclose(crawlerFile);
+
+    // Pages written as segments need a readable offset index
+    char* idxPath = indexPath(pageDirectory);
+    FILE* idx = fopen(idxPath, "r");
+    mem_free(idxPath);
+    if (idx != NULL) {
+        char magic[sizeof(INDEX_MAGIC)];
+        bool valid = fread(magic, 1, sizeof(magic), idx) == sizeof(magic)
+            && memcmp(magic, INDEX_MAGIC, sizeof(magic)) == 0;
+        fclose(idx);
+        if (!valid) {
+            fprintf(stderr, "Error: %s/pages.idx is not a page index\n", pageDirectory);
+            return false;
+        }
+    }
     return true;
 }
 
@@ -192,7 +304,7 @@ bool pagedir_validate(const char* pageDirectory) {
 /*
  * Loads a webpage from a file in the pageDirectory.
  *
- * The function reads:
+ * A segment's next record is read by `loadRecord`; otherwise the function reads:
  *   - The URL from the first line.
  *   - The depth from the second line.
  *   - The HTML content from the remaining lines.
@@ -205,10 +317,28 @@ bool pagedir_validate(const char* pageDirectory) {
  *   - NULL if the file is invalid or an error occurs.
  */
 webpage_t* pagedir_load(FILE* fp) {
+    STATS_START(start);
+    webpage_t* page = loadPage(fp);
+    STATS_STOP(STATS_PAGE_LOAD, start);
+    return page;
+}
+
+/* Does the work of pagedir_load, which times it */
+static webpage_t* loadPage(FILE* fp) {
     if (fp == NULL) {
         return NULL;
     }
 
+    // A segment (or a record in one) starts with 0x7f, a page file with its URL
+    int c = getc(fp);
+    if (c == RECORD_MAGIC[0]) {
+        return loadRecord(fp);
+    }
+    if (c == EOF) {
+        return NULL;
+    }
+    ungetc(c, fp);
+
     // Read the URL
     char* url = file_readLine(fp);
     if (url == NULL) {
@@ -235,4 +365,707 @@ webpage_t* pagedir_load(FILE* fp) {
     // Create a new webpage structure
     webpage_t* page = webpage_new(url, depth, html);
     return page;
-}
\ No newline at end of file
+}
+
+/* ************** pagedir_map ************** */
+/*
+ * pagedir_map - Maps a webpage file into memory without copying it.
+ *
+ * The file is mapped read-only and the URL, depth and HTML are located
+ * in place: the URL is the first line, the depth the second, and the
+ * HTML everything after it, just as `pagedir_load` reads them.
+ *
+ * Parameters:
+ *   - filename: Path of the webpage file.
+ *   - map: Where to store the mapping and its views.
+ *
+ * Returns:
+ *   - true on success; the caller must later call `pagedir_unmap`.
+ *   - false if the file cannot be opened (errno ENOENT if it does not
+ *     exist), cannot be mapped, or lacks the URL and depth lines.
+ */
+bool pagedir_map(const char* filename, pagemap_t* map) {
+    if (filename == NULL || map == NULL) {
+        return false;
+    }
+    memset(map, 0, sizeof(*map));
+
+    size_t size;
+    const void* base = binfile_map(filename, 1, &size);
+    if (base == NULL) {
+        return false; // errno says why; EINVAL for an empty file, which has no URL
+    }
+    posix_madvise((void*) base, size, POSIX_MADV_SEQUENTIAL);
+
+    const char* data = base;
+    const char* end = data + size;
+
+    // The URL is the first line
+    const char* nl = memchr(data, '\n', size);
+    if (nl == NULL) {
+        binfile_unmap(base, size);
+        errno = EINVAL;
+        return false; // Unable to read the depth
+    }
+    map->url = data;
+    map->urlLen = nl - data;
+
+    // The depth is the second line (a missing final newline is fine)
+    const char* p = nl + 1;
+    if (p == end) {
+        binfile_unmap(base, size);
+        errno = EINVAL;
+        return false; // Unable to read the depth
+    }
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+') {
+        p++;
+    }
+    int depth = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (depth > (INT_MAX - (*p - '0')) / 10) {
+            binfile_unmap(base, size);
+            errno = EINVAL;
+            return false; // Unable to read the depth: it overflows an int
+        }
+        depth = 10 * depth + (*p++ - '0');
+    }
+    map->depth = negative ? -depth : depth;
+
+    // The HTML is everything after the depth line
+    nl = memchr(p, '\n', end - p);
+    map->html = (nl == NULL) ? end : nl + 1;
+    map->htmlLen = end - map->html;
+
+    map->compressed = false;
+    map->base = base;
+    map->size = size;
+    return true;
+}
+
+/* ************** pagedir_unmap ************** */
+/*
+ * pagedir_unmap - Releases a mapping made by `pagedir_map`.
+ *
+ * Parameters:
+ *   - map: The mapping; NULL, or one already unmapped, is ignored.
+ */
+void pagedir_unmap(pagemap_t* map) {
+    if (map != NULL && map->base != NULL) {
+        binfile_unmap(map->base, map->size);
+        memset(map, 0, sizeof(*map));
+    }
+}
+
+/* ************** pagedir_numDocs ************** */
+/*
+ * pagedir_numDocs - Counts the documents in a page directory.
+ *
+ * Documents are numbered 1, 2, 3, ...; the count stops at the first
+ * number with no file, just as the indexer's scan does. A directory of
+ * segments has one offset index entry per document.
+ *
+ * Parameters:
+ *   - pageDirectory: The directory to count.
+ *
+ * Returns:
+ *   - The number of documents, or 0 if pageDirectory is NULL.
+ */
+int pagedir_numDocs(const char* pageDirectory) {
+    if (pageDirectory == NULL) {
+        return 0;
+    }
+
+    // With segments, every entry of the offset index is a document
+    char* idxPath = indexPath(pageDirectory);
+    struct stat st;
+    int found = stat(idxPath, &st);
+    mem_free(idxPath);
+    if (found == 0) {
+        off_t entries = st.st_size < INDEX_HEADER ? 0 : (st.st_size - INDEX_HEADER) / INDEX_ENTRY;
+        return entries > INT_MAX ? INT_MAX : (int) entries;
+    }
+
+    size_t size = strlen(pageDirectory) + 12;
+    char* filepath = mem_malloc(size);
+    if (filepath == NULL) {
+        return 0;
+    }
+
+    int numDocs = 0;
+    while (1) {
+        snprintf(filepath, size, "%s/%d", pageDirectory, numDocs + 1);
+        if (stat(filepath, &st) != 0) {
+            break; // Stop at the first missing document ID
+        }
+        numDocs++;
+    }
+
+    mem_free(filepath);
+    return numDocs;
+}
+
+/* ************** pagedir_openWriter ************** */
+/*
+ * pagedir_openWriter - Starts writing pages as segments.
+ *
+ * Creates the first segment and an empty offset index, and removes any
+ * later segments left by an earlier crawl, so readers never see them.
+ *
+ * Parameters:
+ *   - pageDirectory: An initialized page directory.
+ *   - compress: Whether to compress each page's HTML.
+ *
+ * Returns:
+ *   - A new writer, or NULL if the files cannot be created.
+ */
+pagewriter_t* pagedir_openWriter(const char* pageDirectory, const bool compress) {
+    if (pageDirectory == NULL) {
+        fprintf(stderr, "Error: pageDirectory argument is NULL\n");
+        return NULL;
+    }
+
+    pagewriter_t* writer = newWriter(pageDirectory, compress);
+
+    // Remove the segments of an earlier crawl beyond the first
+    removeSegmentsAfter(pageDirectory, 0);
+
+    char* path = indexPath(pageDirectory);
+    writer->index = fopen(path, "wb");
+    mem_free(path);
+    if (writer->index == NULL || !startSegment(writer)
+        || fwrite(INDEX_MAGIC, 1, sizeof(INDEX_MAGIC), writer->index) != sizeof(INDEX_MAGIC)
+        || !binfile_put32(writer->index, SEGMENT_VERSION) || !binfile_put32(writer->index, 0)) {
+        fprintf(stderr, "Error: cannot create page segments in directory %s\n", pageDirectory);
+        writer->ok = false;
+        pagedir_closeWriter(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+/* ************** pagedir_append ************** */
+/*
+ * pagedir_append - Appends a webpage as the next document.
+ *
+ * The record goes at the end of the current segment, which is closed
+ * first if full, and its location at the end of the offset index. The
+ * lock is held throughout, so docIDs, records and index entries are all
+ * in the same order; compression happens before it is taken, so threads
+ * compress their pages in parallel.
+ *
+ * Parameters:
+ *   - writer: The writer.
+ *   - page: The fetched webpage.
+ *
+ * Returns:
+ *   - The page's docID, or -1 on bad arguments or a write error.
+ */
+int pagedir_append(pagewriter_t* writer, const webpage_t* page) {
+    STATS_START(start);
+    int docID = appendPage(writer, page);
+    STATS_STOP(STATS_PAGE_SAVE, start);
+    return docID;
+}
+
+/* Does the work of pagedir_append, which times it */
+static int appendPage(pagewriter_t* writer, const webpage_t* page) {
+    if (writer == NULL || page == NULL) {
+        fprintf(stderr, "Error: invalid arguments to pagedir_append\n");
+        return -1;
+    }
+    const char* url = webpage_getURL(page);
+    const char* html = webpage_getHTML(page);
+    if (url == NULL || html == NULL) {
+        fprintf(stderr, "Error: invalid webpage contents\n");
+        return -1;
+    }
+    size_t urlLen = strlen(url), htmlLen = strlen(html);
+    if (urlLen > MAX_FIELD || htmlLen > MAX_FIELD) {
+        fprintf(stderr, "Error: webpage too large to save: %s\n", url);
+        return -1;
+    }
+
+    // With compression, the record holds a frame in place of the HTML
+    const char* magic = RECORD_MAGIC;
+    char* frame = NULL;
+    if (writer->compress) {
+        frame = mem_malloc_assert(lz_frameBound(htmlLen), "pagedir_append");
+        htmlLen = lz_encodeFrame(html, htmlLen, frame);
+        html = frame;
+        magic = LZ_RECORD_MAGIC;
+        if (htmlLen > MAX_FIELD) {
+            mem_free(frame);
+            fprintf(stderr, "Error: webpage too large to save: %s\n", url);
+            return -1;
+        }
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    if (writer->ok && writer->offset >= PAGEDIR_SEGMENT_BYTES) {
+        writer->ok = fclose(writer->segment) == 0;
+        writer->segment = NULL;
+        writer->segmentNum++;
+        writer->ok = writer->ok && startSegment(writer);
+    }
+    int docID = writer->numDocs + 1;
+    uint32_t recordLen = RECORD_HEADER + urlLen + htmlLen;
+    writer->ok = writer->ok
+        && fwrite(magic, 1, sizeof(RECORD_MAGIC), writer->segment) == sizeof(RECORD_MAGIC)
+        && binfile_put32(writer->segment, docID) && binfile_put32(writer->segment, webpage_getDepth(page))
+        && binfile_put32(writer->segment, urlLen) && binfile_put32(writer->segment, htmlLen)
+        && fwrite(url, 1, urlLen, writer->segment) == urlLen
+        && fwrite(html, 1, htmlLen, writer->segment) == htmlLen
+        && binfile_put32(writer->index, writer->segmentNum) && binfile_put32(writer->index, recordLen)
+        && binfile_put64(writer->index, writer->offset);
+    if (writer->ok) {
+        writer->offset += recordLen;
+        writer->numDocs = docID;
+    } else {
+        docID = -1;
+    }
+    pthread_mutex_unlock(&writer->lock);
+    if (frame != NULL) {
+        mem_free(frame);
+    }
+
+    if (docID < 0) {
+        fprintf(stderr, "Error: cannot save webpage %s\n", url);
+    }
+    return docID;
+}
+
+/* ************** pagedir_resumeWriter ************** */
+/*
+ * pagedir_resumeWriter - Continues writing segments after the first numDocs pages.
+ *
+ * The offset index gives where page numDocs ends; its segment is cut
+ * there, later segments are removed, the index is cut to numDocs entries,
+ * and both are opened for appending.
+ *
+ * Parameters:
+ *   - pageDirectory: A page directory written by a writer.
+ *   - compress: Whether to compress each page's HTML from now on.
+ *   - numDocs: How many pages to keep.
+ *
+ * Returns:
+ *   - A writer, or NULL if there are fewer pages or the files cannot be written.
+ */
+pagewriter_t* pagedir_resumeWriter(const char* pageDirectory, const bool compress, const int numDocs) {
+    if (pageDirectory == NULL || numDocs < 0) {
+        fprintf(stderr, "Error: invalid arguments to pagedir_resumeWriter\n");
+        return NULL;
+    }
+    if (numDocs == 0) {
+        return pagedir_openWriter(pageDirectory, compress);
+    }
+
+    // Find where the last page kept ends
+    char* idxPath = indexPath(pageDirectory);
+    FILE* idx = fopen(idxPath, "rb");
+    char magic[sizeof(INDEX_MAGIC)];
+    unsigned char entry[INDEX_ENTRY];
+    bool found = idx != NULL
+        && fread(magic, 1, sizeof(magic), idx) == sizeof(magic)
+        && memcmp(magic, INDEX_MAGIC, sizeof(magic)) == 0
+        && fseek(idx, INDEX_HEADER + (long) (numDocs - 1) * INDEX_ENTRY, SEEK_SET) == 0
+        && fread(entry, 1, sizeof(entry), idx) == sizeof(entry);
+    if (idx != NULL) {
+        fclose(idx);
+    }
+    uint32_t segmentNum = found ? binfile_get32(entry) : 0;
+    uint64_t end = found ? binfile_get64(entry + 8) + binfile_get32(entry + 4) : 0;
+    char* segPath = segmentPath(pageDirectory, found && segmentNum <= INT_MAX ? (int) segmentNum : 0);
+    struct stat st;
+    if (!found || segmentNum > INT_MAX || stat(segPath, &st) != 0 || (uint64_t) st.st_size < end) {
+        fprintf(stderr, "Error: %s holds fewer than %d pages\n", pageDirectory, numDocs);
+        mem_free(idxPath);
+        mem_free(segPath);
+        return NULL;
+    }
+
+    // Drop whatever was written after it, and append from there
+    pagewriter_t* writer = newWriter(pageDirectory, compress);
+    writer->segmentNum = segmentNum;
+    writer->offset = end;
+    writer->numDocs = numDocs;
+    removeSegmentsAfter(pageDirectory, segmentNum);
+    if (truncate(segPath, end) != 0
+        || truncate(idxPath, INDEX_HEADER + (off_t) numDocs * INDEX_ENTRY) != 0
+        || (writer->segment = fopen(segPath, "ab")) == NULL
+        || (writer->index = fopen(idxPath, "ab")) == NULL) {
+        fprintf(stderr, "Error: cannot resume page segments in directory %s\n", pageDirectory);
+        writer->ok = false;
+        pagedir_closeWriter(writer);
+        writer = NULL;
+    }
+    mem_free(idxPath);
+    mem_free(segPath);
+    return writer;
+}
+
+/* ************** pagedir_flushWriter ************** */
+/*
+ * pagedir_flushWriter - Flushes and fsyncs the segment and offset index.
+ *
+ * Parameters:
+ *   - writer: The writer.
+ *
+ * Returns:
+ *   - true on success, false after any write error.
+ */
+bool pagedir_flushWriter(pagewriter_t* writer) {
+    if (writer == NULL) {
+        return false;
+    }
+    pthread_mutex_lock(&writer->lock);
+    writer->ok = writer->ok
+        && fflush(writer->segment) == 0 && fflush(writer->index) == 0
+        && fsync(fileno(writer->segment)) == 0 && fsync(fileno(writer->index)) == 0;
+    bool ok = writer->ok;
+    pthread_mutex_unlock(&writer->lock);
+    return ok;
+}
+
+/* ************** pagedir_writtenDocs ************** */
+/*
+ * pagedir_writtenDocs - Returns the last docID a writer handed out.
+ */
+int pagedir_writtenDocs(pagewriter_t* writer) {
+    if (writer == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&writer->lock);
+    int numDocs = writer->numDocs;
+    pthread_mutex_unlock(&writer->lock);
+    return numDocs;
+}
+
+/* ************** pagedir_closeWriter ************** */
+/*
+ * pagedir_closeWriter - Flushes and closes the segment and offset index.
+ *
+ * Parameters:
+ *   - writer: The writer; NULL is ignored.
+ *
+ * Returns:
+ *   - true if every page was written, false after any write error.
+ */
+bool pagedir_closeWriter(pagewriter_t* writer) {
+    if (writer == NULL) {
+        return false;
+    }
+    bool ok = writer->ok;
+    if (writer->segment != NULL && fclose(writer->segment) != 0) {
+        ok = false;
+    }
+    if (writer->index != NULL && fclose(writer->index) != 0) {
+        ok = false;
+    }
+    pthread_mutex_destroy(&writer->lock);
+    mem_free(writer->pageDirectory);
+    mem_free(writer);
+    return ok;
+}
+
+/* ************** pagedir_openCursor ************** */
+/*
+ * pagedir_openCursor - Starts reading a page directory's pages at a docID.
+ *
+ * A directory with an offset index is read as segments, from the record
+ * the index gives for firstDoc (or the start, for docID 1); any other is
+ * read one page file at a time.
+ *
+ * Parameters:
+ *   - pageDirectory: The page directory.
+ *   - firstDoc: The first docID to read.
+ *
+ * Returns:
+ *   - A new cursor, or NULL on bad arguments.
+ */
+pagecursor_t* pagedir_openCursor(const char* pageDirectory, const int firstDoc) {
+    if (pageDirectory == NULL || firstDoc < 1) {
+        fprintf(stderr, "Error: invalid arguments to pagedir_openCursor\n");
+        return NULL;
+    }
+
+    pagecursor_t* cursor = mem_calloc_assert(1, sizeof(pagecursor_t), "pagedir_openCursor");
+    cursor->pageDirectory = mem_malloc_assert(strlen(pageDirectory) + 1, "pagedir_openCursor");
+    strcpy(cursor->pageDirectory, pageDirectory);
+    cursor->nextDoc = firstDoc;
+    cursor->segmentNum = -1;
+
+    char* path = indexPath(pageDirectory);
+    FILE* idx = fopen(path, "rb");
+    mem_free(path);
+    if (idx == NULL) {
+        return cursor;            // page files
+    }
+    cursor->segmented = true;
+
+    // Find where firstDoc's record starts; past the index there are none
+    unsigned char entry[INDEX_ENTRY];
+    int segmentNum = 0;
+    uint64_t offset = SEGMENT_HEADER;
+    if (firstDoc > 1) {
+        segmentNum = -1;
+        if (fseek(idx, INDEX_HEADER + (long) (firstDoc - 1) * INDEX_ENTRY, SEEK_SET) == 0
+            && fread(entry, 1, sizeof(entry), idx) == sizeof(entry) && binfile_get32(entry) <= INT_MAX) {
+            segmentNum = binfile_get32(entry);
+            offset = binfile_get64(entry + 8);
+        }
+    }
+    fclose(idx);
+    if (segmentNum >= 0 && mapSegment(cursor, segmentNum) && offset <= cursor->size) {
+        cursor->pos = offset;
+    } else {
+        unmapSegment(cursor);
+    }
+    return cursor;
+}
+
+/* ************** pagedir_next ************** */
+/*
+ * pagedir_next - Reads the next page.
+ *
+ * Parameters:
+ *   - cursor: The cursor.
+ *   - docID: Where to store the page's docID.
+ *   - page: Where to store the page's views, valid until the next call.
+ *
+ * Returns:
+ *   - true if a page was read, false at the end.
+ */
+bool pagedir_next(pagecursor_t* cursor, int* docID, pagemap_t* page) {
+    STATS_START(start);
+    bool found = nextPage(cursor, docID, page);
+    STATS_STOP(STATS_PAGE_LOAD, start);
+    return found;
+}
+
+/* Does the work of pagedir_next, which times it */
+static bool nextPage(pagecursor_t* cursor, int* docID, pagemap_t* page) {
+    if (cursor == NULL || docID == NULL || page == NULL) {
+        return false;
+    }
+    memset(page, 0, sizeof(*page));
+
+    if (!cursor->segmented) {
+        pagedir_unmap(&cursor->file);
+        size_t size = strlen(cursor->pageDirectory) + 12;
+        char* filepath = mem_malloc_assert(size, "pagedir_next");
+        while (cursor->nextDoc < INT_MAX) {
+            snprintf(filepath, size, "%s/%d", cursor->pageDirectory, cursor->nextDoc++);
+            if (pagedir_map(filepath, &cursor->file)) {
+                mem_free(filepath);
+                *docID = cursor->nextDoc - 1;
+                *page = cursor->file;
+                page->base = NULL;      // the mapping is the cursor's
+                page->size = 0;
+                return true;
+            }
+            if (errno == ENOENT) {
+                break;                  // Stop at the first missing document ID
+            }
+        }
+        mem_free(filepath);
+        return false;
+    }
+
+    while (cursor->data != NULL) {
+        // At the end of a segment, go on to the next, if there is one
+        if (cursor->pos == cursor->size) {
+            if (!mapSegment(cursor, cursor->segmentNum + 1)) {
+                unmapSegment(cursor);
+                return false;
+            }
+            cursor->pos = SEGMENT_HEADER;
+            continue;
+        }
+
+        const unsigned char* rec = cursor->data + cursor->pos;
+        size_t left = cursor->size - cursor->pos;
+        uint32_t urlLen = left < RECORD_HEADER ? 0 : binfile_get32(rec + 12);
+        uint32_t htmlLen = left < RECORD_HEADER ? 0 : binfile_get32(rec + 16);
+        bool compressed = left >= RECORD_HEADER
+            && memcmp(rec, LZ_RECORD_MAGIC, sizeof(LZ_RECORD_MAGIC)) == 0;
+        if (left < RECORD_HEADER
+            || (!compressed && memcmp(rec, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0)
+            || binfile_get32(rec + 4) > INT_MAX || urlLen > MAX_FIELD || htmlLen > MAX_FIELD
+            || RECORD_HEADER + (uint64_t) urlLen + htmlLen > left) {
+            fprintf(stderr, "Error: corrupt record in page segment %d of %s\n",
+                    cursor->segmentNum, cursor->pageDirectory);
+            cursor->pos = cursor->size;   // give up on the rest of this segment
+            continue;
+        }
+
+        *docID = binfile_get32(rec + 4);
+        page->depth = (int32_t) binfile_get32(rec + 8);
+        page->url = (const char*) rec + RECORD_HEADER;
+        page->urlLen = urlLen;
+        page->html = page->url + urlLen;
+        page->htmlLen = htmlLen;
+        page->compressed = compressed;
+        cursor->pos += RECORD_HEADER + urlLen + htmlLen;
+        return true;
+    }
+    return false;
+}
+
+/* ************** pagedir_closeCursor ************** */
+/*
+ * pagedir_closeCursor - Frees a cursor and releases its mapping.
+ *
+ * Parameters:
+ *   - cursor: The cursor; NULL is ignored.
+ */
+void pagedir_closeCursor(pagecursor_t* cursor) {
+    if (cursor == NULL) {
+        return;
+    }
+    pagedir_unmap(&cursor->file);
+    unmapSegment(cursor);
+    mem_free(cursor->pageDirectory);
+    mem_free(cursor);
+}
+
+/* Returns the path of a segment, which the caller must mem_free */
+static char* segmentPath(const char* pageDirectory, const int segmentNum) {
+    size_t size = strlen(pageDirectory) + 32;
+    char* path = mem_malloc_assert(size, "segment path");
+    snprintf(path, size, "%s/pages.%04d.seg", pageDirectory, segmentNum);
+    return path;
+}
+
+/* Returns the path of the offset index, which the caller must mem_free */
+static char* indexPath(const char* pageDirectory) {
+    size_t size = strlen(pageDirectory) + strlen("/pages.idx") + 1;
+    char* path = mem_malloc_assert(size, "page index path");
+    snprintf(path, size, "%s/pages.idx", pageDirectory);
+    return path;
+}
+
+/* Creates a writer with no files open, for pagedir_openWriter and pagedir_resumeWriter */
+static pagewriter_t* newWriter(const char* pageDirectory, const bool compress) {
+    pagewriter_t* writer = mem_calloc_assert(1, sizeof(pagewriter_t), "pagedir writer");
+    writer->pageDirectory = mem_malloc_assert(strlen(pageDirectory) + 1, "pagedir writer");
+    strcpy(writer->pageDirectory, pageDirectory);
+    writer->ok = true;
+    writer->compress = compress;
+    pthread_mutex_init(&writer->lock, NULL);
+    return writer;
+}
+
+/* Removes the segments numbered after segmentNum, up to the first missing one */
+static void removeSegmentsAfter(const char* pageDirectory, const int segmentNum) {
+    for (int n = segmentNum + 1; ; n++) {
+        char* path = segmentPath(pageDirectory, n);
+        int removed = remove(path);
+        mem_free(path);
+        if (removed != 0) {
+            break;
+        }
+    }
+}
+
+/* Creates the writer's segment numbered segmentNum and writes its header */
+static bool startSegment(pagewriter_t* writer) {
+    char* path = segmentPath(writer->pageDirectory, writer->segmentNum);
+    writer->segment = fopen(path, "wb");
+    mem_free(path);
+    writer->offset = SEGMENT_HEADER;
+    return writer->segment != NULL
+        && fwrite(SEGMENT_MAGIC, 1, sizeof(SEGMENT_MAGIC), writer->segment) == sizeof(SEGMENT_MAGIC)
+        && binfile_put32(writer->segment, SEGMENT_VERSION) && binfile_put32(writer->segment, writer->segmentNum)
+        && binfile_put32(writer->segment, 0);
+}
+
+/* Maps the cursor's segment numbered segmentNum in place of the last one;
+ * false if it does not exist or is not a segment */
+static bool mapSegment(pagecursor_t* cursor, const int segmentNum) {
+    unmapSegment(cursor);
+    char* path = segmentPath(cursor->pageDirectory, segmentNum);
+    size_t size;
+    const void* base = binfile_map(path, SEGMENT_HEADER, &size);
+    mem_free(path);
+    if (base == NULL) {
+        return false;
+    }
+    if (memcmp(base, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0
+        || binfile_get32((const unsigned char*) base + 4) != SEGMENT_VERSION) {
+        binfile_unmap(base, size);
+        return false;
+    }
+    posix_madvise((void*) base, size, POSIX_MADV_SEQUENTIAL);
+    cursor->data = base;
+    cursor->size = size;
+    cursor->segmentNum = segmentNum;
+    cursor->pos = SEGMENT_HEADER;
+    return true;
+}
+
+/* Releases the cursor's segment mapping, if any */
+static void unmapSegment(pagecursor_t* cursor) {
+    if (cursor->data != NULL) {
+        binfile_unmap(cursor->data, cursor->size);
+        cursor->data = NULL;
+        cursor->size = 0;
+        cursor->pos = 0;
+    }
+}
+
+/* Reads a segment record from fp, whose first byte (0x7f) was just read;
+ * a segment header, at the start of the segment, is skipped first, and
+ * the HTML of a compressed record is decompressed */
+static webpage_t* loadRecord(FILE* fp) {
+    unsigned char header[RECORD_HEADER];
+    if (fread(header + 1, 1, 3, fp) != 3) {
+        return NULL;
+    }
+    if (memcmp(header + 1, SEGMENT_MAGIC + 1, 3) == 0) {
+        unsigned char skip[SEGMENT_HEADER - 4];
+        if (fread(skip, 1, sizeof(skip), fp) != sizeof(skip) || fread(header, 1, 4, fp) != 4
+            || header[0] != (unsigned char) RECORD_MAGIC[0]) {
+            return NULL;            // An empty segment, or not one at all
+        }
+    }
+    bool compressed = memcmp(header + 1, LZ_RECORD_MAGIC + 1, 3) == 0;
+    if ((!compressed && memcmp(header + 1, RECORD_MAGIC + 1, 3) != 0)
+        || fread(header + 4, 1, RECORD_HEADER - 4, fp) != RECORD_HEADER - 4) {
+        return NULL;
+    }
+
+    int depth = (int32_t) binfile_get32(header + 8);
+    uint32_t urlLen = binfile_get32(header + 12), htmlLen = binfile_get32(header + 16);
+    if (urlLen == 0 || urlLen > MAX_FIELD || htmlLen > MAX_FIELD || depth < 0) {
+        return NULL;
+    }
+    char* url = malloc(urlLen + 1);   // webpage_delete frees these with free()
+    char* html = malloc(htmlLen + 1);
+    if (url == NULL || html == NULL || fread(url, 1, urlLen, fp) != urlLen
+        || fread(html, 1, htmlLen, fp) != htmlLen) {
+        free(url);
+        free(html);
+        return NULL;
+    }
+    url[urlLen] = '\0';
+    html[htmlLen] = '\0';
+    if (compressed) {
+        // html holds the frame; decompress it block by block into a new one
+        lzframe_t frame;
+        size_t rawLen = lz_openFrame(&frame, html, htmlLen), at = 0, got;
+        char* raw = rawLen > MAX_FIELD ? NULL : malloc(rawLen + 1);
+        while (raw != NULL && lz_nextBlock(&frame, raw + at, &got)) {
+            at += got;
+        }
+        free(html);
+        if (raw == NULL || frame.error) {
+            free(url);
+            free(raw);
+            return NULL;
+        }
+        raw[rawLen] = '\0';
+        html = raw;
+    }
+    return webpage_new(url, depth, html);
+}
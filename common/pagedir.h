@@ -4,15 +4,39 @@
  * This module provides an interface for managing the page directory in the Tiny Search Engine.
  * It allows for initializing, validating, saving, and loading webpage files.
  *
+ * A page directory holds its pages in one of two layouts:
+ *  - files: one file per page, `pageDirectory/<docID>`, holding the URL,
+ *    depth and HTML as lines (written by `pagedir_save`);
+ *  - segments: append-only files `pageDirectory/pages.NNNN.seg` of up to
+ *    PAGEDIR_SEGMENT_BYTES each, holding length-prefixed (docID, depth,
+ *    URL, HTML) records in docID order, plus an offset index
+ *    `pageDirectory/pages.idx` giving each docID's segment and offset
+ *    (written by a `pagewriter_t`). A crawl of millions of pages then
+ *    makes a few hundred files, not millions. A writer may compress each
+ *    page's HTML (see lz.h); such records have their own magic number, so
+ *    a directory can mix compressed and plain records.
+ * Readers accept either: `pagedir_load` reads a page file or the next
+ * record of a segment, and a `pagecursor_t` walks the pages of either
+ * layout in docID order.
+ *
  * Functions:
  *  - `pagedir_init`: Initializes a directory for storing crawler output by creating a `.crawler` marker file.
  *  - `pagedir_save`: Saves a webpage to a uniquely named file in the page directory.
  *  - `pagedir_validate`: Checks whether a given directory is a valid crawler-produced directory.
  *  - `pagedir_load`: Loads a webpage from a saved file in the page directory.
+ *  - `pagedir_map`: Maps a saved webpage file into memory without copying it.
+ *  - `pagedir_unmap`: Releases a mapping made by `pagedir_map`.
+ *  - `pagedir_numDocs`: Counts the documents in a page directory.
+ *  - `pagedir_openWriter`, `pagedir_append`, `pagedir_closeWriter`:
+ *    Write pages as segments, handing out docIDs.
+ *  - `pagedir_resumeWriter`, `pagedir_flushWriter`, `pagedir_writtenDocs`:
+ *    Continue an interrupted crawl's segments; make them durable.
+ *  - `pagedir_openCursor`, `pagedir_next`, `pagedir_closeCursor`:
+ *    Read the pages of a directory in order, from a given docID.
  *
  * Assumptions:
  *  - The provided directory exists before calling `pagedir_init`.
- *  - The page directory contains sequentially named files (`1, 2, 3, ...`).
+ *  - The page directory's docIDs are sequential (`1, 2, 3, ...`).
  *  - Webpage files follow the specified format required by the Indexer and Querier.
  *
  * Error Handling:
@@ -30,7 +54,14 @@
  
  #include <stdio.h>
  #include <stdbool.h>
+ #include <stddef.h>
  #include "../libcs50/webpage.h"  // Needed for webpage_t type
+
+/* A segment is closed, and the next one started, once it reaches this
+ * size; define it when compiling pagedir.c to change it */
+#ifndef PAGEDIR_SEGMENT_BYTES
+#define PAGEDIR_SEGMENT_BYTES (64u << 20)
+#endif
  
  /**
   * Initializes a page directory by creating a `.crawler` file.
@@ -63,15 +94,162 @@ bool pagedir_validate(const char* pageDirectory);
 /**
  * Loads a webpage from an open file in the page directory.
  * 
- * This function reads:
+ * For a page file, this function reads:
  *  - The URL from the first line.
  *  - The depth from the second line.
  *  - The HTML content from the remaining lines.
+ * For a segment, it reads the next record (skipping the segment's header
+ * at the start of the file), decompressing the HTML of a compressed one,
+ * so calling it repeatedly reads every page of the segment in order.
  * 
- * @param fp The file pointer to an open webpage file.
+ * @param fp The file pointer to an open webpage file or segment.
  * @return A `webpage_t*` structure containing the loaded webpage,
- *         or NULL if an error occurs.
+ *         or NULL if an error occurs (or a segment has no more records).
  */
 webpage_t* pagedir_load(FILE* fp);
+
+/* A saved webpage file mapped read-only into memory; see `pagedir_map`.
+ * The url and html fields point into the mapping and are NOT
+ * null-terminated; use their lengths.
+ */
+typedef struct pagemap {
+  const char* url;      // first line of the file
+  size_t urlLen;
+  int depth;            // second line of the file
+  const char* html;     // the rest of the file
+  size_t htmlLen;
+  bool compressed;      // html is a compressed frame (see lz.h), read it with a pagestream_t
+  const void* base;     // the mapping itself, for pagedir_unmap
+  size_t size;
+} pagemap_t;
+
+/**
+ * Maps a webpage file into memory and locates its URL, depth and HTML,
+ * without reading or copying the file. The views are the same as the
+ * strings `pagedir_load` would return, and can be walked directly with
+ * a `tokenizer_t`.
+ *
+ * @param filename Path of the webpage file, e.g. "pageDirectory/3".
+ * @param map Where to store the mapping.
+ * @return true on success. On failure returns false and leaves nothing
+ *         mapped; errno is ENOENT if the file does not exist.
+ */
+bool pagedir_map(const char* filename, pagemap_t* map);
+
+/**
+ * Unmaps a webpage mapped by `pagedir_map`; its views become invalid.
+ *
+ * @param map The mapping; NULL, or one already unmapped, is ignored.
+ */
+void pagedir_unmap(pagemap_t* map);
+
+/**
+ * Counts the documents in a page directory: the number of files 1, 2, 3, ...
+ * present before the first missing number (only the names are checked),
+ * or, for segments, the number of entries in the offset index.
+ *
+ * @param pageDirectory The directory to count.
+ * @return The number of documents (0 if none, or if pageDirectory is NULL).
+ */
+int pagedir_numDocs(const char* pageDirectory);
+
+/* Writes pages as segments; opaque to users of the module */
+typedef struct pagewriter pagewriter_t;
+
+/**
+ * Starts writing a page directory's pages as segments, replacing any
+ * segments and offset index already there.
+ *
+ * @param pageDirectory An initialized page directory.
+ * @param compress Whether to compress each page's HTML.
+ * @return A new writer, or NULL (after an error message) if the first
+ *         segment or the offset index cannot be created.
+ */
+pagewriter_t* pagedir_openWriter(const char* pageDirectory, const bool compress);
+
+/**
+ * Continues writing a page directory's segments after its first numDocs
+ * pages, as when resuming a crawl: anything written after them (by a run
+ * that went on past its last checkpoint) is truncated away, and the next
+ * page appended gets docID numDocs + 1.
+ *
+ * @param pageDirectory A page directory written by a `pagewriter_t`.
+ * @param compress Whether to compress each page's HTML from now on.
+ * @param numDocs How many pages to keep (0 starts over).
+ * @return A writer, or NULL (after an error message) if the directory
+ *         holds fewer than numDocs pages or cannot be written.
+ */
+pagewriter_t* pagedir_resumeWriter(const char* pageDirectory, const bool compress, const int numDocs);
+
+/**
+ * Appends a webpage as the next document. Thread-safe: docIDs are handed
+ * out 1, 2, 3, ... in the order pages are appended.
+ *
+ * @param writer The writer.
+ * @param page The fetched webpage (URL, depth and HTML).
+ * @return The page's docID, or -1 on bad arguments or a write error.
+ */
+int pagedir_append(pagewriter_t* writer, const webpage_t* page);
+
+/**
+ * Makes every page appended so far durable: flushes the segment and the
+ * offset index and fsyncs them. Call it when no append is in progress.
+ *
+ * @param writer The writer.
+ * @return true on success, false after any write error.
+ */
+bool pagedir_flushWriter(pagewriter_t* writer);
+
+/**
+ * Returns the number of pages a writer holds: the last docID handed out.
+ *
+ * @param writer The writer; NULL gives 0.
+ */
+int pagedir_writtenDocs(pagewriter_t* writer);
+
+/**
+ * Finishes writing: flushes and closes the segment and offset index.
+ *
+ * @param writer The writer; NULL is ignored.
+ * @return true if every page was written, false after any write error.
+ */
+bool pagedir_closeWriter(pagewriter_t* writer);
+
+/* Reads a page directory's pages in order; opaque to users of the module */
+typedef struct pagecursor pagecursor_t;
+
+/**
+ * Starts reading a page directory's pages, in either layout, at a docID.
+ *
+ * @param pageDirectory The page directory.
+ * @param firstDoc The first docID to read (>= 1).
+ * @return A new cursor, or NULL on bad arguments.
+ */
+pagecursor_t* pagedir_openCursor(const char* pageDirectory, const int firstDoc);
+
+/**
+ * Reads the next page. The views in `page` are those `pagedir_map`
+ * gives (except that the HTML of a compressed record is left compressed,
+ * with page->compressed set), but belong to the cursor: they stay valid until the next call
+ * or `pagedir_closeCursor`, and must not be passed to `pagedir_unmap`.
+ * Segments are mapped, and page files opened, one at a time.
+ *
+ * As the indexer always has, reading stops at the first missing docID,
+ * and skips a page file that cannot be read or parsed; a corrupt
+ * segment record ends that segment (with a message to stderr).
+ *
+ * @param cursor The cursor.
+ * @param docID Where to store the page's docID.
+ * @param page Where to store the page's views.
+ * @return true if a page was read, false at the end.
+ */
+bool pagedir_next(pagecursor_t* cursor, int* docID, pagemap_t* page);
+
+/**
+ * Frees a cursor, releasing its mapping.
+ *
+ * @param cursor The cursor; NULL is ignored.
+ */
+void pagedir_closeCursor(pagecursor_t* cursor);
  
  #endif // __PAGEDIR_H
\ No newline at end of file
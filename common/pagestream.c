@@ -0,0 +1,169 @@
+/*
+ * pagestream.c - CS50 Tiny Search Engine (TSE) streaming page words
+ *
+ * see pagestream.h for more information.
+ *
+ * Each window is tokenized with a plain tokenizer_t. That finds the same
+ * words as tokenizing the whole HTML as long as the window starts where
+ * the whole-HTML scan is outside any word or tag, and every word it hands
+ * out ends before the window does. So a word that runs to the end of a
+ * window is held back, and the next window starts with it; once a window
+ * is used up, the next starts at a tag left open at its end, if any (the
+ * bytes after the last word are all outside words, so the tags there are
+ * easy to follow). The carried bytes are moved to the front of the
+ * window and the next block is decompressed after them.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pagestream.h"
+#include "../libcs50/mem.h"
+
+/**************** local functions ****************/
+static bool nextWindow(pagestream_t* stream);
+static size_t resumePoint(const char* window, size_t from, const size_t len);
+
+/**************** pagestream_open ****************/
+/* see pagestream.h for description */
+void pagestream_open(pagestream_t* stream, const pagemap_t* page)
+{
+  if (stream == NULL) {
+    return;
+  }
+  memset(stream, 0, sizeof(*stream));
+  if (page == NULL) {
+    stream->final = true;
+    tokenizer_init(&stream->tok, NULL, 0);
+    return;
+  }
+
+  if (!page->compressed) {
+    // plain HTML is tokenized where it is, as a single window
+    tokenizer_init(&stream->tok, page->html, page->htmlLen);
+    stream->final = true;
+    return;
+  }
+
+  lz_openFrame(&stream->frame, page->html, page->htmlLen);
+  stream->cap = 2 * LZ_BLOCK;
+  stream->window = mem_malloc_assert(stream->cap, "pagestream window");
+  stream->refill = true;
+}
+
+/**************** pagestream_nextMany ****************/
+/* see pagestream.h for description */
+size_t pagestream_nextMany(pagestream_t* stream, tokenizer_span_t spans[], const size_t max)
+{
+  if (stream == NULL || spans == NULL || max == 0) {
+    return 0;
+  }
+
+  while (true) {
+    if (stream->refill && !nextWindow(stream)) {
+      return 0;
+    }
+    size_t n = tokenizer_nextMany(&stream->tok, spans, max);
+    if (stream->final) {
+      return n;
+    }
+
+    // more HTML follows this window: a word reaching its end may go on
+    const char* end = stream->window + stream->len;
+    if (n > 0 && spans[n - 1].word + spans[n - 1].len == end) {
+      n--;
+      stream->resume = spans[n].word - stream->window;
+      stream->refill = true;
+    } else {
+      if (n > 0) {
+        stream->wordEnd = spans[n - 1].word + spans[n - 1].len - stream->window;
+      }
+      if (n < max) {
+        stream->resume = resumePoint(stream->window, stream->wordEnd, stream->len);
+        stream->refill = true;
+      }
+    }
+    if (n > 0) {
+      return n;
+    }
+  }
+}
+
+/**************** pagestream_close ****************/
+/* see pagestream.h for description */
+bool pagestream_close(pagestream_t* stream)
+{
+  if (stream == NULL) {
+    return false;
+  }
+  if (stream->window != NULL) {
+    mem_free(stream->window);
+    stream->window = NULL;
+  }
+  return !stream->frame.error;
+}
+
+/* Starts the next window: the bytes from stream->resume on, followed by
+ * the next decompressed block; false if the last window is done */
+static bool nextWindow(pagestream_t* stream)
+{
+  if (stream->final) {
+    return false;
+  }
+
+  size_t carry = stream->len - stream->resume;
+  memmove(stream->window, stream->window + stream->resume, carry);
+  if (stream->cap - carry < LZ_BLOCK) {
+    // a long word or an open tag: grow the window to hold it and a block
+    size_t cap = 2 * stream->cap;
+    char* window = mem_malloc_assert(cap, "pagestream window");
+    memcpy(window, stream->window, carry);
+    mem_free(stream->window);
+    stream->window = window;
+    stream->cap = cap;
+  }
+
+  size_t got = 0;
+  if (!lz_nextBlock(&stream->frame, stream->window + carry, &got)) {
+    stream->final = true;       // corrupt; tokenize what is left
+  } else {
+    // the HTML ends at a null byte, as a C string would
+    const char* nul = memchr(stream->window + carry, '\0', got);
+    if (nul != NULL) {
+      got = nul - (stream->window + carry);
+      stream->final = true;
+    }
+  }
+  if (stream->frame.rawLeft == 0) {
+    stream->final = true;
+  }
+
+  stream->len = carry + got;
+  stream->resume = 0;
+  stream->wordEnd = 0;
+  stream->refill = false;
+  tokenizer_init(&stream->tok, stream->window, stream->len);
+  return true;
+}
+
+/* Returns where the next window must start, given that the tokenizer has
+ * used up window[0..len) and handed out no word past `from`: at a tag
+ * still open at the end, or else at len */
+static size_t resumePoint(const char* window, size_t from, const size_t len)
+{
+  while (from < len) {
+    const char* open = memchr(window + from, '<', len - from);
+    if (open == NULL) {
+      return len;
+    }
+    const char* close = memchr(open + 1, '>', window + len - (open + 1));
+    if (close == NULL) {
+      return open - window;
+    }
+    from = close + 1 - window;
+  }
+  return len;
+}
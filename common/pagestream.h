@@ -0,0 +1,72 @@
+/*
+ * pagestream.h - CS50 Tiny Search Engine (TSE) streaming page words
+ *
+ * A page stream hands out the words of a page's HTML, whether the HTML
+ * is plain (a `pagedir_map` mapping, or an uncompressed segment record)
+ * or a compressed frame (see lz.h). A compressed page is decompressed one
+ * block at a time into a small window that is tokenized in place, so the
+ * whole page is never materialized: only a word or tag that crosses a
+ * block boundary is carried over into the next window.
+ *
+ * The words are exactly those a `tokenizer_t` finds in the plain HTML.
+ *
+ * Functions:
+ *  - `pagestream_open`: Starts reading a page's words.
+ *  - `pagestream_nextMany`: Returns up to a given number of next words.
+ *  - `pagestream_close`: Frees the stream's window; reports corruption.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __PAGESTREAM_H
+#define __PAGESTREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "lz.h"
+#include "pagedir.h"
+#include "tokenizer.h"
+
+/* Stream state; a plain struct so callers can keep it on the stack */
+typedef struct pagestream {
+  tokenizer_t tok;      // over the window, or over the plain HTML
+  lzframe_t frame;      // the compressed HTML, if it is compressed
+  char* window;         // decompressed bytes being tokenized
+  size_t cap;           // the window's capacity
+  size_t len;           // bytes in the window
+  size_t wordEnd;       // offset just past the last word handed out from the window
+  size_t resume;        // offset the next window starts from, once tok is used up
+  bool refill;          // tok is used up; move on to the next window
+  bool final;           // the window holds the end of the HTML
+} pagestream_t;
+
+/**
+ * Starts reading a page's words.
+ *
+ * @param stream The stream to initialize.
+ * @param page The page; its views must stay valid while the stream is used.
+ */
+void pagestream_open(pagestream_t* stream, const pagemap_t* page);
+
+/**
+ * Finds the next words in bulk, filling spans[0..n-1].
+ *
+ * @param stream The stream.
+ * @param spans Where to store the words, as spans that stay valid until
+ *              the next call.
+ * @param max The capacity of spans.
+ * @return n, the number of words found; 0 only at the end of the page.
+ */
+size_t pagestream_nextMany(pagestream_t* stream, tokenizer_span_t spans[], const size_t max);
+
+/**
+ * Ends a stream, freeing its window.
+ *
+ * @param stream The stream.
+ * @return true, or false if the compressed HTML proved corrupt, in which
+ *         case the words handed out were those before the corruption.
+ */
+bool pagestream_close(pagestream_t* stream);
+
+#endif // __PAGESTREAM_H
@@ -0,0 +1,404 @@
+/*
+ * postings.c - CS50 Tiny Search Engine (TSE) posting lists
+ *
+ * see postings.h for more information.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "postings.h"
+#include "../libcs50/mem.h"
+
+/**************** constants ****************/
+static const size_t MIN_CAPACITY = 4;
+
+/**************** local types ****************/
+typedef struct postings {
+  posting_t* entries;       // sorted by docID, no duplicates
+  size_t size;              // entries in use
+  size_t capacity;          // entries allocated
+  arena_t* arena;           // where the list lives, or NULL for the heap
+} postings_t;
+
+/**************** local functions ****************/
+static postings_t* newWithCapacity(const size_t capacity, arena_t* arena);
+static void reserve(postings_t* postings, const size_t capacity);
+static size_t lowerBound(const postings_t* postings, size_t lo, size_t hi, const int docID);
+static posting_t* insertAt(postings_t* postings, const size_t pos, const int docID);
+
+/**************** postings_new ****************/
+/* see postings.h for description */
+postings_t* postings_new(void)
+{
+  return newWithCapacity(MIN_CAPACITY, NULL);
+}
+
+/**************** postings_copy ****************/
+/* see postings.h for description */
+postings_t* postings_copy(const postings_t* postings)
+{
+  if (postings == NULL) {
+    return NULL;
+  }
+
+  postings_t* copy = newWithCapacity(postings->size, NULL);
+  if (copy != NULL) {
+    memcpy(copy->entries, postings->entries, postings->size * sizeof(posting_t));
+    copy->size = postings->size;
+  }
+  return copy;
+}
+
+/**************** postings_newIn ****************/
+/* see postings.h for description */
+postings_t* postings_newIn(const size_t capacity, arena_t* arena)
+{
+  return newWithCapacity(capacity, arena);
+}
+
+/**************** postings_add ****************/
+/* see postings.h for description */
+int postings_add(postings_t* postings, const int docID)
+{
+  if (postings == NULL || docID < 0) {
+    return 0;
+  }
+
+  size_t n = postings->size;
+  if (n > 0 && postings->entries[n - 1].docID == docID) {
+    return ++postings->entries[n - 1].count;      // same document again
+  }
+  if (n == 0 || postings->entries[n - 1].docID < docID) {
+    return ++insertAt(postings, n, docID)->count; // append fast path
+  }
+
+  size_t pos = lowerBound(postings, 0, n, docID);
+  if (postings->entries[pos].docID != docID) {
+    insertAt(postings, pos, docID);
+  }
+  return ++postings->entries[pos].count;
+}
+
+/**************** postings_set ****************/
+/* see postings.h for description */
+bool postings_set(postings_t* postings, const int docID, const int count)
+{
+  if (postings == NULL || docID < 0 || count < 0) {
+    return false;
+  }
+
+  size_t n = postings->size;
+  size_t pos = (n == 0 || postings->entries[n - 1].docID < docID)
+               ? n : lowerBound(postings, 0, n, docID);
+  if (pos == n || postings->entries[pos].docID != docID) {
+    insertAt(postings, pos, docID);
+  }
+  postings->entries[pos].count = count;
+  return true;
+}
+
+/**************** postings_append ****************/
+/* see postings.h for description */
+bool postings_append(postings_t* postings, const int docID, const int count)
+{
+  if (postings == NULL || docID < 0 || count < 0) {
+    return false;
+  }
+  size_t n = postings->size;
+  if (n > 0 && postings->entries[n - 1].docID >= docID) {
+    return false;             // out of order
+  }
+
+  insertAt(postings, n, docID)->count = count;
+  return true;
+}
+
+/**************** postings_get ****************/
+/* see postings.h for description */
+int postings_get(const postings_t* postings, const int docID)
+{
+  if (postings == NULL || docID < 0) {
+    return 0;
+  }
+
+  size_t pos = lowerBound(postings, 0, postings->size, docID);
+  if (pos < postings->size && postings->entries[pos].docID == docID) {
+    return postings->entries[pos].count;
+  }
+  return 0;
+}
+
+/**************** postings_seek ****************/
+/* see postings.h for description */
+size_t postings_seek(const postings_t* postings, const size_t from, const int docID)
+{
+  if (postings == NULL || from >= postings->size) {
+    return postings == NULL ? 0 : postings->size;
+  }
+
+  // gallop: find a gap (lo, hi] known to hold the answer
+  const posting_t* e = postings->entries;
+  size_t n = postings->size;
+  if (e[from].docID >= docID) {
+    return from;
+  }
+  size_t lo = from;           // e[lo].docID < docID
+  size_t step = 1;
+  while (lo + step < n && e[lo + step].docID < docID) {
+    lo += step;
+    step *= 2;
+  }
+  size_t hi = (lo + step < n) ? lo + step : n;
+  return lowerBound(postings, lo + 1, hi, docID);
+}
+
+/**************** postings_size ****************/
+/* see postings.h for description */
+size_t postings_size(const postings_t* postings)
+{
+  return postings == NULL ? 0 : postings->size;
+}
+
+/**************** postings_entries ****************/
+/* see postings.h for description */
+const posting_t* postings_entries(const postings_t* postings)
+{
+  return postings == NULL ? NULL : postings->entries;
+}
+
+/**************** postings_iterate ****************/
+/* see postings.h for description */
+void postings_iterate(const postings_t* postings, void* arg,
+                      void (*itemfunc)(void* arg, const int docID, const int count))
+{
+  if (postings == NULL || itemfunc == NULL) {
+    return;
+  }
+
+  for (size_t i = 0; i < postings->size; i++) {
+    (*itemfunc)(arg, postings->entries[i].docID, postings->entries[i].count);
+  }
+}
+
+/**************** postings_intersect ****************/
+/* see postings.h for description.
+ * Walks the shorter list and gallops through the longer one, so an AND
+ * of a rare word with a common one costs O(short * log(long / short)).
+ */
+postings_t* postings_intersect(const postings_t* a, const postings_t* b, arena_t* arena)
+{
+  if (a == NULL || b == NULL) {
+    return NULL;
+  }
+  if (a->size > b->size) {
+    const postings_t* t = a;
+    a = b;
+    b = t;
+  }
+
+  postings_t* result = newWithCapacity(a->size, arena);
+  if (result == NULL) {
+    return NULL;
+  }
+
+  size_t j = 0;
+  for (size_t i = 0; i < a->size && j < b->size; i++) {
+    j = postings_seek(b, j, a->entries[i].docID);
+    if (j < b->size && b->entries[j].docID == a->entries[i].docID) {
+      int ca = a->entries[i].count;
+      int cb = b->entries[j].count;
+      posting_t* p = &result->entries[result->size++];
+      p->docID = a->entries[i].docID;
+      p->count = ca < cb ? ca : cb;
+    }
+  }
+  return result;
+}
+
+/**************** postings_intersectAll ****************/
+/* see postings.h for description.
+ * A leapfrog join: when list k's next docID is past the candidate, that
+ * docID becomes the new target, and lists[0] gallops up to it.
+ */
+postings_t* postings_intersectAll(const postings_t* const lists[], const size_t n, arena_t* arena)
+{
+  if (lists == NULL || n == 0) {
+    return NULL;
+  }
+  for (size_t k = 0; k < n; k++) {
+    if (lists[k] == NULL) {
+      return NULL;
+    }
+  }
+
+  const postings_t* first = lists[0];
+  postings_t* result = newWithCapacity(first->size, arena);
+  if (result == NULL) {
+    return NULL;
+  }
+  size_t* pos = arena != NULL ? arena_alloc(arena, n * sizeof(size_t))
+                              : mem_malloc_assert(n * sizeof(size_t), "postings_intersectAll");
+  memset(pos, 0, n * sizeof(size_t));
+
+  size_t i = 0;
+  while (i < first->size) {
+    int docID = first->entries[i].docID;
+    int count = first->entries[i].count;
+    int next = docID;                 // the smallest docID that could match
+    size_t k;
+    for (k = 1; k < n; k++) {
+      pos[k] = postings_seek(lists[k], pos[k], docID);
+      if (pos[k] == lists[k]->size) {
+        break;                        // list k is used up: no more matches
+      }
+      const posting_t* p = &lists[k]->entries[pos[k]];
+      if (p->docID != docID) {
+        next = p->docID;
+        break;
+      }
+      if (p->count < count) {
+        count = p->count;
+      }
+    }
+
+    if (k < n && pos[k] == lists[k]->size) {
+      break;
+    }
+    if (k == n) {
+      posting_t* p = &result->entries[result->size++];
+      p->docID = docID;
+      p->count = count;
+      i++;
+    } else {
+      i = postings_seek(first, i + 1, next);
+    }
+  }
+
+  if (arena == NULL) {
+    mem_free(pos);
+  }
+  return result;
+}
+
+/**************** postings_union ****************/
+/* see postings.h for description */
+postings_t* postings_union(const postings_t* a, const postings_t* b, arena_t* arena)
+{
+  if (a == NULL || b == NULL) {
+    return NULL;
+  }
+
+  postings_t* result = newWithCapacity(a->size + b->size, arena);
+  if (result == NULL) {
+    return NULL;
+  }
+
+  size_t i = 0, j = 0;
+  while (i < a->size || j < b->size) {
+    posting_t* p = &result->entries[result->size++];
+    if (j == b->size || (i < a->size && a->entries[i].docID < b->entries[j].docID)) {
+      *p = a->entries[i++];
+    } else if (i == a->size || b->entries[j].docID < a->entries[i].docID) {
+      *p = b->entries[j++];
+    } else {
+      p->docID = a->entries[i].docID;
+      p->count = a->entries[i++].count + b->entries[j++].count;
+    }
+  }
+  return result;
+}
+
+/**************** postings_delete ****************/
+/* see postings.h for description */
+void postings_delete(postings_t* postings)
+{
+  if (postings != NULL && postings->arena == NULL) {
+    mem_free(postings->entries);
+    mem_free(postings);
+  }
+}
+
+/* Creates an empty list with room for at least `capacity` pairs,
+ * in the arena if there is one */
+static postings_t* newWithCapacity(const size_t capacity, arena_t* arena)
+{
+  if (arena != NULL) {
+    postings_t* postings = arena_alloc(arena, sizeof(postings_t));
+    postings->capacity = capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+    postings->entries = arena_alloc(arena, postings->capacity * sizeof(posting_t));
+    postings->size = 0;
+    postings->arena = arena;
+    return postings;
+  }
+
+  postings_t* postings = mem_malloc(sizeof(postings_t));
+  if (postings == NULL) {
+    return NULL;
+  }
+
+  postings->capacity = capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+  postings->entries = mem_malloc(postings->capacity * sizeof(posting_t));
+  if (postings->entries == NULL) {
+    mem_free(postings);
+    return NULL;
+  }
+  postings->size = 0;
+  postings->arena = NULL;
+  return postings;
+}
+
+/* Makes room for at least `capacity` pairs, doubling as needed */
+static void reserve(postings_t* postings, const size_t capacity)
+{
+  if (capacity <= postings->capacity) {
+    return;
+  }
+
+  size_t newCapacity = 2 * postings->capacity;
+  while (newCapacity < capacity) {
+    newCapacity *= 2;
+  }
+  posting_t* entries;
+  if (postings->arena != NULL) {
+    // the old array is reclaimed when the arena is reset
+    entries = arena_alloc(postings->arena, newCapacity * sizeof(posting_t));
+  } else {
+    entries = mem_malloc_assert(newCapacity * sizeof(posting_t), "postings");
+  }
+  memcpy(entries, postings->entries, postings->size * sizeof(posting_t));
+  if (postings->arena == NULL) {
+    mem_free(postings->entries);
+  }
+  postings->entries = entries;
+  postings->capacity = newCapacity;
+}
+
+/* Returns the first position in [lo, hi) whose docID is >= docID, or hi */
+static size_t lowerBound(const postings_t* postings, size_t lo, size_t hi, const int docID)
+{
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (postings->entries[mid].docID < docID) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/* Inserts (docID, 0) at pos, shifting later pairs up; returns it */
+static posting_t* insertAt(postings_t* postings, const size_t pos, const int docID)
+{
+  reserve(postings, postings->size + 1);
+  posting_t* p = &postings->entries[pos];
+  memmove(p + 1, p, (postings->size - pos) * sizeof(posting_t));
+  p->docID = docID;
+  p->count = 0;
+  postings->size++;
+  return p;
+}
@@ -0,0 +1,198 @@
+/*
+ * postings.h - CS50 Tiny Search Engine (TSE) posting lists
+ *
+ * A posting list holds, for one word, the (docID, count) pairs of the
+ * documents containing it. It replaces libcs50's `counters_t` in the index:
+ * instead of one heap node per pair in an unsorted linked list, the pairs
+ * live in a single array sorted by docID that doubles as it fills.
+ *
+ *  - Adding a docID at or past the end of the list (the indexer's case,
+ *    since it visits documents in increasing order) is O(1) amortized.
+ *  - Looking up a docID is a binary search; `postings_seek` gallops forward
+ *    from a position, which makes merging a short list into a long one cheap.
+ *  - Intersection and union walk both sorted lists once.
+ *
+ * Functions:
+ *  - `postings_new`, `postings_copy`, `postings_newIn`: Create a list.
+ *  - `postings_add`: Increments a docID's count (from 0 if absent).
+ *  - `postings_set`: Sets a docID's count.
+ *  - `postings_append`: Adds a pair past the end of the list (no search).
+ *  - `postings_get`: Returns a docID's count (0 if absent).
+ *  - `postings_seek`: Finds the first position at or after `from` with docID >= a target.
+ *  - `postings_size`, `postings_entries`: Give direct read access to the array.
+ *  - `postings_iterate`: Calls a function on every (docID, count), in docID order.
+ *  - `postings_intersect`, `postings_union`: Query set operations.
+ *  - `postings_intersectAll`: Intersects many lists at once, rarest first.
+ *  - `postings_delete`: Frees a list.
+ *
+ * The set operations can build their result in an arena (see arena.h)
+ * instead of the heap; such a list lives until the arena is reset, and
+ * deleting it does nothing.
+ *
+ * Error Handling:
+ *  - Creators return NULL on allocation failure; running out of memory
+ *    while growing a list terminates the program via `mem_assert`.
+ *  - docIDs and counts must be non-negative; calls that break this do nothing.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __POSTINGS_H
+#define __POSTINGS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "arena.h"
+
+/* One (docID, count) pair */
+typedef struct posting {
+  int docID;
+  int count;
+} posting_t;
+
+/* A posting list; opaque to users of the module */
+typedef struct postings postings_t;
+
+/**
+ * Creates a new, empty posting list.
+ *
+ * @return Pointer to a new `postings_t`, or NULL on failure.
+ */
+postings_t* postings_new(void);
+
+/**
+ * Creates a copy of a posting list.
+ *
+ * @param postings The list to copy; NULL gives NULL.
+ * @return Pointer to a new `postings_t`, or NULL on failure.
+ */
+postings_t* postings_copy(const postings_t* postings);
+
+/**
+ * Creates a new, empty posting list in an arena, for a result built by
+ * appending, such as a ranked query's scores.
+ *
+ * @param capacity About how many pairs it will hold; it grows past that.
+ * @param arena Where to allocate the list, or NULL for the heap.
+ * @return Pointer to a new `postings_t`, or NULL on failure.
+ */
+postings_t* postings_newIn(const size_t capacity, arena_t* arena);
+
+/**
+ * Increments the count of a docID, adding it with count 1 if absent.
+ *
+ * @param postings The list.
+ * @param docID The document ID (>= 0).
+ * @return The new count, or 0 on bad arguments.
+ */
+int postings_add(postings_t* postings, const int docID);
+
+/**
+ * Sets the count of a docID, adding it if absent.
+ *
+ * @param postings The list.
+ * @param docID The document ID (>= 0).
+ * @param count The count (>= 0).
+ * @return true on success; false on bad arguments.
+ */
+bool postings_set(postings_t* postings, const int docID, const int count);
+
+/**
+ * Appends a (docID, count) pair whose docID is larger than every docID
+ * already in the list; the fast path for building a list in order, as
+ * when decoding a saved index.
+ *
+ * @param postings The list.
+ * @param docID The document ID; must exceed the list's last docID.
+ * @param count The count (>= 0).
+ * @return true on success; false (list unchanged) if out of order or bad arguments.
+ */
+bool postings_append(postings_t* postings, const int docID, const int count);
+
+/**
+ * Returns the count of a docID (binary search).
+ *
+ * @param postings The list.
+ * @param docID The document ID.
+ * @return Its count, or 0 if absent or on bad arguments.
+ */
+int postings_get(const postings_t* postings, const int docID);
+
+/**
+ * Galloping search: returns the smallest position i >= from whose docID
+ * is >= the target, or postings_size() if there is none. Probing grows
+ * 1, 2, 4, ... past `from` and then binary-searches the last gap, so the
+ * cost is logarithmic in the distance moved rather than in the list size.
+ *
+ * @param postings The list.
+ * @param from The position to start from.
+ * @param docID The target document ID.
+ */
+size_t postings_seek(const postings_t* postings, const size_t from, const int docID);
+
+/**
+ * Returns the number of docIDs in the list (0 if NULL).
+ */
+size_t postings_size(const postings_t* postings);
+
+/**
+ * Returns the list's pairs, sorted by docID; there are postings_size()
+ * of them. The array is valid until the list is next changed.
+ */
+const posting_t* postings_entries(const postings_t* postings);
+
+/**
+ * Calls itemfunc(arg, docID, count) for each pair, in increasing docID
+ * order (with the same signature as `counters_iterate`'s itemfunc).
+ *
+ * @param postings The list; NULL does nothing.
+ * @param arg Arbitrary pointer passed along to itemfunc.
+ * @param itemfunc Function to call; NULL does nothing.
+ */
+void postings_iterate(const postings_t* postings, void* arg,
+                      void (*itemfunc)(void* arg, const int docID, const int count));
+
+/**
+ * Returns a new list of the docIDs in both a and b, each with the
+ * smaller of its two counts (a query's "AND").
+ *
+ * @param arena Where to allocate the new list, or NULL for the heap.
+ * @return The new list, or NULL if a or b is NULL or on failure.
+ */
+postings_t* postings_intersect(const postings_t* a, const postings_t* b, arena_t* arena);
+
+/**
+ * Returns a new list of the docIDs in every one of n lists, each with the
+ * minimum of its counts: the "AND" of a whole sequence of query words.
+ *
+ * Candidates come from lists[0], and every other list is galloped forward
+ * to each candidate; the intersection stops as soon as any list runs out.
+ * It is fastest when lists[0] is the shortest and the rest are in
+ * increasing order of size, since a candidate missing from lists[1] is
+ * then dropped without touching the longer lists.
+ *
+ * @param lists The lists; none may be NULL.
+ * @param n The number of lists (at least 1).
+ * @param arena Where to allocate the new list, or NULL for the heap.
+ * @return The new list, or NULL if the arguments are invalid or on failure.
+ */
+postings_t* postings_intersectAll(const postings_t* const lists[], const size_t n, arena_t* arena);
+
+/**
+ * Returns a new list of the docIDs in a or b, each with the sum of
+ * its counts (a query's "OR").
+ *
+ * @param arena Where to allocate the new list, or NULL for the heap.
+ * @return The new list, or NULL if a or b is NULL or on failure.
+ */
+postings_t* postings_union(const postings_t* a, const postings_t* b, arena_t* arena);
+
+/**
+ * Deletes a posting list.
+ *
+ * @param postings The list; NULL, or a list in an arena, is ignored.
+ */
+void postings_delete(postings_t* postings);
+
+#endif // __POSTINGS_H
@@ -0,0 +1,284 @@
+/*
+ * querycache.c - CS50 Tiny Search Engine (TSE) cache of ranked query results
+ *
+ * see querycache.h for more information.
+ *
+ * Entries are chained in a hash table of buckets that doubles when the
+ * entries outnumber the buckets, and are also linked in a list from most
+ * to least recently used; eviction removes from the list's tail. Each
+ * entry is one allocation holding the entry, its ranking, and its key.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "querycache.h"
+#include "../libcs50/mem.h"
+
+/**************** local types ****************/
+typedef struct entry {
+  struct entry* next;       // next in the same bucket
+  struct entry* newer;      // neighbours in recency order
+  struct entry* older;
+  uint32_t hash;
+  size_t bytes;             // the entry's whole allocation
+  size_t n;                 // documents in the ranking
+  ranked_t* docs;           // the ranking, inside this allocation
+  char* key;                // the key, inside this allocation
+} entry_t;
+
+typedef struct querycache {
+  entry_t** buckets;
+  size_t numBuckets;
+  entry_t* newest;          // most recently used
+  entry_t* oldest;          // least recently used; evicted first
+  size_t maxBytes;
+  uint64_t version;         // the index version of every cached ranking
+  querycache_stats_t stats;
+} querycache_t;
+
+/**************** local functions ****************/
+static uint32_t hashKey(const char* key);
+static size_t entryBytes(const char* key, const size_t n);
+static entry_t* find(querycache_t* cache, const char* key, const uint32_t hash);
+static void checkVersion(querycache_t* cache, const uint64_t version);
+static void unlinkEntry(querycache_t* cache, entry_t* entry);
+static void pushNewest(querycache_t* cache, entry_t* entry);
+static void removeEntry(querycache_t* cache, entry_t* entry);
+static void grow(querycache_t* cache);
+
+/**************** querycache_new ****************/
+/* see querycache.h for description */
+querycache_t* querycache_new(const size_t maxBytes)
+{
+  if (maxBytes == 0) {
+    return NULL;
+  }
+
+  querycache_t* cache = mem_calloc_assert(1, sizeof(querycache_t), "querycache_new");
+  cache->numBuckets = 64;
+  cache->buckets = mem_calloc_assert(cache->numBuckets, sizeof(entry_t*), "querycache buckets");
+  cache->maxBytes = maxBytes;
+  return cache;
+}
+
+/**************** querycache_get ****************/
+/* see querycache.h for description */
+bool querycache_get(querycache_t* cache, const char* key, const uint64_t version,
+                    ranked_t** docs, size_t* n, arena_t* arena)
+{
+  if (cache == NULL || key == NULL || docs == NULL || n == NULL) {
+    return false;
+  }
+  checkVersion(cache, version);
+
+  entry_t* entry = find(cache, key, hashKey(key));
+  if (entry == NULL) {
+    cache->stats.misses++;
+    return false;
+  }
+  cache->stats.hits++;
+
+  // a hit becomes the most recently used
+  unlinkEntry(cache, entry);
+  pushNewest(cache, entry);
+
+  *n = entry->n;
+  *docs = NULL;
+  if (entry->n > 0) {
+    size_t bytes = entry->n * sizeof(ranked_t);
+    *docs = arena != NULL ? arena_alloc(arena, bytes) : mem_malloc_assert(bytes, "querycache_get");
+    memcpy(*docs, entry->docs, entry->n * sizeof(ranked_t));
+  }
+  return true;
+}
+
+/**************** querycache_put ****************/
+/* see querycache.h for description */
+bool querycache_put(querycache_t* cache, const char* key, const uint64_t version,
+                    const ranked_t docs[], const size_t n)
+{
+  if (cache == NULL || key == NULL || (docs == NULL && n > 0) || !querycache_fits(cache, key, n)) {
+    return false;
+  }
+  checkVersion(cache, version);
+
+  uint32_t hash = hashKey(key);
+  entry_t* old = find(cache, key, hash);
+  if (old != NULL) {
+    removeEntry(cache, old);
+  }
+
+  // evict the least recently used until the new entry fits
+  size_t bytes = entryBytes(key, n);
+  while (cache->stats.bytes + bytes > cache->maxBytes) {
+    removeEntry(cache, cache->oldest);
+    cache->stats.evictions++;
+  }
+
+  // one allocation: the entry, then its ranking, then its key
+  entry_t* entry = mem_malloc_assert(bytes, "querycache entry");
+  entry->hash = hash;
+  entry->bytes = bytes;
+  entry->n = n;
+  entry->docs = (ranked_t*) (entry + 1);
+  entry->key = (char*) (entry->docs + n);
+  if (n > 0) {
+    memcpy(entry->docs, docs, n * sizeof(ranked_t));
+  }
+  strcpy(entry->key, key);
+
+  entry_t** bucket = &cache->buckets[hash & (cache->numBuckets - 1)];
+  entry->next = *bucket;
+  *bucket = entry;
+  pushNewest(cache, entry);
+  cache->stats.entries++;
+  cache->stats.bytes += bytes;
+
+  if (cache->stats.entries > cache->numBuckets) {
+    grow(cache);
+  }
+  return true;
+}
+
+/**************** querycache_fits ****************/
+/* see querycache.h for description */
+bool querycache_fits(querycache_t* cache, const char* key, const size_t n)
+{
+  if (cache == NULL || key == NULL || n > (SIZE_MAX - sizeof(entry_t)) / (2 * sizeof(ranked_t))) {
+    return false;
+  }
+  return entryBytes(key, n) <= cache->maxBytes;
+}
+
+/**************** querycache_stats ****************/
+/* see querycache.h for description */
+void querycache_stats(querycache_t* cache, querycache_stats_t* stats)
+{
+  if (cache != NULL && stats != NULL) {
+    *stats = cache->stats;
+  }
+}
+
+/**************** querycache_delete ****************/
+/* see querycache.h for description */
+void querycache_delete(querycache_t* cache)
+{
+  if (cache == NULL) {
+    return;
+  }
+  while (cache->oldest != NULL) {
+    removeEntry(cache, cache->oldest);
+  }
+  mem_free(cache->buckets);
+  mem_free(cache);
+}
+
+/* Hashes a key (FNV-1a, then mixed so the low bits pick buckets well) */
+static uint32_t hashKey(const char* key)
+{
+  uint32_t h = 2166136261u;                 // FNV offset basis
+  for (const char* p = key; *p != '\0'; p++) {
+    h ^= (unsigned char) *p;
+    h *= 16777619u;                         // FNV prime
+  }
+  h ^= h >> 16;
+  h *= 0x7feb352du;
+  h ^= h >> 15;
+  h *= 0x846ca68bu;
+  h ^= h >> 16;
+  return h;
+}
+
+/* Returns the size of the allocation for an entry of key with n documents */
+static size_t entryBytes(const char* key, const size_t n)
+{
+  return sizeof(entry_t) + n * sizeof(ranked_t) + strlen(key) + 1;
+}
+
+/* Returns the entry for key, or NULL */
+static entry_t* find(querycache_t* cache, const char* key, const uint32_t hash)
+{
+  for (entry_t* e = cache->buckets[hash & (cache->numBuckets - 1)]; e != NULL; e = e->next) {
+    if (e->hash == hash && strcmp(e->key, key) == 0) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+/* Empties the cache if its rankings belong to another index version */
+static void checkVersion(querycache_t* cache, const uint64_t version)
+{
+  if (version != cache->version) {
+    while (cache->oldest != NULL) {
+      removeEntry(cache, cache->oldest);
+    }
+    cache->version = version;
+  }
+}
+
+/* Takes an entry out of the recency list */
+static void unlinkEntry(querycache_t* cache, entry_t* entry)
+{
+  if (entry->newer != NULL) {
+    entry->newer->older = entry->older;
+  } else {
+    cache->newest = entry->older;
+  }
+  if (entry->older != NULL) {
+    entry->older->newer = entry->newer;
+  } else {
+    cache->oldest = entry->newer;
+  }
+}
+
+/* Puts an entry at the newest end of the recency list */
+static void pushNewest(querycache_t* cache, entry_t* entry)
+{
+  entry->newer = NULL;
+  entry->older = cache->newest;
+  if (cache->newest != NULL) {
+    cache->newest->newer = entry;
+  } else {
+    cache->oldest = entry;
+  }
+  cache->newest = entry;
+}
+
+/* Removes an entry from its bucket and the recency list, and frees it */
+static void removeEntry(querycache_t* cache, entry_t* entry)
+{
+  entry_t** link = &cache->buckets[entry->hash & (cache->numBuckets - 1)];
+  while (*link != entry) {
+    link = &(*link)->next;
+  }
+  *link = entry->next;
+  unlinkEntry(cache, entry);
+  cache->stats.entries--;
+  cache->stats.bytes -= entry->bytes;
+  mem_free(entry);
+}
+
+/* Doubles the number of buckets, rechaining every entry */
+static void grow(querycache_t* cache)
+{
+  size_t numBuckets = 2 * cache->numBuckets;
+  entry_t** buckets = mem_calloc_assert(numBuckets, sizeof(entry_t*), "querycache buckets");
+  for (size_t i = 0; i < cache->numBuckets; i++) {
+    entry_t* e = cache->buckets[i];
+    while (e != NULL) {
+      entry_t* next = e->next;
+      entry_t** bucket = &buckets[e->hash & (numBuckets - 1)];
+      e->next = *bucket;
+      *bucket = e;
+      e = next;
+    }
+  }
+  mem_free(cache->buckets);
+  cache->buckets = buckets;
+  cache->numBuckets = numBuckets;
+}
@@ -0,0 +1,110 @@
+/*
+ * querycache.h - CS50 Tiny Search Engine (TSE) cache of ranked query results
+ *
+ * A query cache maps a canonical query string to the query's complete
+ * ranking (best first), so a repeated query skips evaluation and ranking
+ * altogether. The cache holds at most a fixed number of bytes (keys,
+ * rankings and bookkeeping); when a new ranking does not fit, the least
+ * recently used rankings are evicted until it does.
+ *
+ * Every lookup and insertion names the version of the index the ranking
+ * was computed from. The first call with a different version empties the
+ * cache, so a reloaded index never serves stale results.
+ *
+ * Functions:
+ *  - `querycache_new`: Creates an empty cache of a given size.
+ *  - `querycache_get`: Looks up a query's ranking.
+ *  - `querycache_put`: Stores a query's ranking.
+ *  - `querycache_fits`: Tells whether a ranking of n documents could be stored.
+ *  - `querycache_stats`: Reports hits, misses, evictions and usage.
+ *  - `querycache_delete`: Frees a cache.
+ *
+ * Error Handling:
+ *  - Running out of memory terminates the program via `mem_assert`.
+ *  - A cache is NOT thread-safe; callers sharing one must lock around it.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __QUERYCACHE_H
+#define __QUERYCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ranking.h"
+#include "arena.h"
+
+/* The cache; opaque to users of the module */
+typedef struct querycache querycache_t;
+
+/* The cache's counters, as reported by `querycache_stats` */
+typedef struct querycache_stats {
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+  size_t entries;             // rankings now cached
+  size_t bytes;               // bytes now used, at most maxBytes
+} querycache_stats_t;
+
+/**
+ * Creates an empty cache.
+ *
+ * @param maxBytes The most memory the cache may use (> 0).
+ * @return Pointer to a new cache, or NULL if maxBytes is 0.
+ */
+querycache_t* querycache_new(const size_t maxBytes);
+
+/**
+ * Looks up a query's ranking, making it the most recently used.
+ *
+ * @param cache The cache.
+ * @param key The canonical query string.
+ * @param version The version of the index in use.
+ * @param docs Where to store a copy of the ranking, best first; NULL if
+ *             the ranking is empty.
+ * @param n Where to store the number of documents in the ranking.
+ * @param arena Where to allocate the copy, or NULL for the heap (the
+ *              caller must then mem_free it).
+ * @return true on a hit, false on a miss (docs and n are untouched).
+ */
+bool querycache_get(querycache_t* cache, const char* key, const uint64_t version,
+                    ranked_t** docs, size_t* n, arena_t* arena);
+
+/**
+ * Stores (a copy of) a query's ranking, replacing any ranking for the same
+ * query and evicting least recently used rankings to make room.
+ *
+ * @param cache The cache.
+ * @param key The canonical query string.
+ * @param version The version of the index the ranking was computed from.
+ * @param docs The ranking, best first; may be NULL if n is 0.
+ * @param n The number of documents in the ranking.
+ * @return true if stored, false if it could never fit (nothing is evicted).
+ */
+bool querycache_put(querycache_t* cache, const char* key, const uint64_t version,
+                    const ranked_t docs[], const size_t n);
+
+/**
+ * Tells whether a ranking of n documents for key is small enough to cache,
+ * so callers can avoid computing a full ranking that would not be kept.
+ */
+bool querycache_fits(querycache_t* cache, const char* key, const size_t n);
+
+/**
+ * Reports the cache's counters.
+ *
+ * @param cache The cache.
+ * @param stats Where to store them.
+ */
+void querycache_stats(querycache_t* cache, querycache_stats_t* stats);
+
+/**
+ * Deletes a cache and every ranking in it.
+ *
+ * @param cache The cache; NULL is ignored.
+ */
+void querycache_delete(querycache_t* cache);
+
+#endif // __QUERYCACHE_H
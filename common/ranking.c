@@ -0,0 +1,180 @@
+/*
+ * ranking.c - CS50 Tiny Search Engine (TSE) top-k ranking of query results
+ *
+ * see ranking.h for more information.
+ *
+ * The heap is a min-heap on rank: its root is the worst of the documents
+ * kept so far, so a new document either loses to the root (O(1)) or
+ * replaces it (O(log k)). A cursor pages by remembering the last document
+ * it returned and selecting, each time, the best k that rank after it.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "ranking.h"
+#include "../libcs50/mem.h"
+
+/**************** local types ****************/
+typedef struct rankcursor {
+  const postings_t* result;
+  bool started;             // false until a document has been returned
+  ranked_t last;            // the last document returned
+} rankcursor_t;
+
+/**************** local functions ****************/
+static size_t selectAfter(const postings_t* result, const ranked_t* after, const size_t k, ranked_t out[]);
+static bool better(const ranked_t* a, const ranked_t* b);
+static void siftDown(ranked_t heap[], const size_t n, size_t i);
+static void siftUp(ranked_t heap[], size_t i);
+
+/**************** ranking_topk ****************/
+/* see ranking.h for description */
+size_t ranking_topk(const postings_t* result, const size_t k, ranked_t out[])
+{
+  if (out == NULL) {
+    return 0;
+  }
+  return selectAfter(result, NULL, k, out);
+}
+
+/**************** rankcursor_new ****************/
+/* see ranking.h for description */
+rankcursor_t* rankcursor_new(const postings_t* result)
+{
+  if (result == NULL) {
+    return NULL;
+  }
+
+  rankcursor_t* cursor = mem_malloc_assert(sizeof(rankcursor_t), "rankcursor_new");
+  cursor->result = result;
+  cursor->started = false;
+  return cursor;
+}
+
+/**************** rankcursor_next ****************/
+/* see ranking.h for description */
+size_t rankcursor_next(rankcursor_t* cursor, const size_t k, ranked_t out[])
+{
+  if (cursor == NULL || out == NULL) {
+    return 0;
+  }
+
+  size_t n = selectAfter(cursor->result, cursor->started ? &cursor->last : NULL, k, out);
+  if (n > 0) {
+    cursor->last = out[n - 1];
+    cursor->started = true;
+  }
+  return n;
+}
+
+/**************** rankcursor_delete ****************/
+/* see ranking.h for description */
+void rankcursor_delete(rankcursor_t* cursor)
+{
+  if (cursor != NULL) {
+    mem_free(cursor);
+  }
+}
+
+/* Selects the k best documents of result that rank after *after (all of
+ * them if after is NULL) into out[], best first; returns how many */
+static size_t selectAfter(const postings_t* result, const ranked_t* after, const size_t k, ranked_t out[])
+{
+  const posting_t* entries = postings_entries(result);
+  size_t size = postings_size(result);
+  size_t n = 0;
+
+  // Step 1: Keep the best k in a min-heap (root = worst kept) in out[]
+  for (size_t i = 0; i < size && k > 0; i++) {
+    ranked_t doc = { entries[i].docID, entries[i].count };
+    if (after == NULL || better(after, &doc)) {
+      ranking_push(out, &n, k, &doc);
+    }
+  }
+
+  // Step 2: Sort them best first
+  ranking_sort(out, n);
+  return n;
+}
+
+/**************** ranking_push ****************/
+/* see ranking.h for description */
+bool ranking_push(ranked_t heap[], size_t* n, const size_t k, const ranked_t* doc)
+{
+  if (doc->score <= 0) {
+    return false;
+  }
+  if (*n < k) {
+    heap[*n] = *doc;
+    siftUp(heap, (*n)++);
+    return true;
+  }
+  if (k > 0 && better(doc, &heap[0])) {
+    heap[0] = *doc;
+    siftDown(heap, *n, 0);
+    return true;
+  }
+  return false;
+}
+
+/**************** ranking_sort ****************/
+/* see ranking.h for description */
+void ranking_sort(ranked_t heap[], const size_t n)
+{
+  // Heapsort in place; repeatedly moving the worst to the end leaves
+  // heap[] best first
+  for (size_t end = n; end > 1; end--) {
+    ranked_t worst = heap[0];
+    heap[0] = heap[end - 1];
+    heap[end - 1] = worst;
+    siftDown(heap, end - 1, 0);
+  }
+}
+
+/* Returns true if a ranks before b: a higher score, or the same score
+ * and a lower docID */
+static bool better(const ranked_t* a, const ranked_t* b)
+{
+  return a->score > b->score || (a->score == b->score && a->docID < b->docID);
+}
+
+/* Moves heap[i] down until neither child is worse than it */
+static void siftDown(ranked_t heap[], const size_t n, size_t i)
+{
+  for (;;) {
+    size_t worst = i;
+    size_t left = 2 * i + 1, right = left + 1;
+    if (left < n && better(&heap[worst], &heap[left])) {
+      worst = left;
+    }
+    if (right < n && better(&heap[worst], &heap[right])) {
+      worst = right;
+    }
+    if (worst == i) {
+      return;
+    }
+    ranked_t t = heap[i];
+    heap[i] = heap[worst];
+    heap[worst] = t;
+    i = worst;
+  }
+}
+
+/* Moves heap[i] up while it is worse than its parent */
+static void siftUp(ranked_t heap[], size_t i)
+{
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (!better(&heap[parent], &heap[i])) {
+      return;
+    }
+    ranked_t t = heap[i];
+    heap[i] = heap[parent];
+    heap[parent] = t;
+    i = parent;
+  }
+}
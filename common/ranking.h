@@ -0,0 +1,105 @@
+/*
+ * ranking.h - CS50 Tiny Search Engine (TSE) top-k ranking of query results
+ *
+ * A query's result is a `postings_t` whose counts are document scores.
+ * Ranking orders documents by decreasing score, ties by increasing docID.
+ * Rather than sorting every matching document, this module keeps only the
+ * best k in a bounded min-heap, so a broad query costs O(n log k) to rank
+ * and O(k) memory, however many documents match.
+ *
+ * Functions:
+ *  - `ranking_topk`: Finds the k best-ranked documents of a result.
+ *  - `rankcursor_new`: Creates a cursor over a result, for paging.
+ *  - `rankcursor_next`: Returns the next page of ranked documents.
+ *  - `rankcursor_delete`: Frees a cursor.
+ *  - `ranking_push`, `ranking_sort`: Keep the best k of documents scored
+ *    one at a time, for a caller that ranks without building a result.
+ *
+ * Assumptions:
+ *  - Documents with a score of 0 do not match, and are never ranked.
+ *
+ * Error Handling:
+ *  - Running out of memory terminates the program via `mem_assert`.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __RANKING_H
+#define __RANKING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "postings.h"
+
+/* One ranked document */
+typedef struct ranked {
+  int docID;
+  int score;
+} ranked_t;
+
+/* A cursor that hands out a result's documents a page at a time;
+ * opaque to users of the module */
+typedef struct rankcursor rankcursor_t;
+
+/**
+ * Finds the k best-ranked documents of a result.
+ *
+ * @param result The query result; NULL is treated as empty.
+ * @param k The most documents to return.
+ * @param out Array of at least k elements, filled best first.
+ * @return The number of documents stored in out (at most k).
+ */
+size_t ranking_topk(const postings_t* result, const size_t k, ranked_t out[]);
+
+/**
+ * Creates a cursor positioned before the best-ranked document.
+ * The cursor remembers only the last document it returned, not the
+ * ranking, so it costs O(1) memory between pages.
+ *
+ * @param result The query result; it must outlive the cursor, unchanged.
+ * @return Pointer to a new cursor, or NULL on NULL result.
+ */
+rankcursor_t* rankcursor_new(const postings_t* result);
+
+/**
+ * Returns the next page: the (up to) k best-ranked documents that come
+ * after every document the cursor has already returned. Each page costs
+ * O(n log k) for a result of n documents.
+ *
+ * @param cursor The cursor.
+ * @param k The most documents to return.
+ * @param out Array of at least k elements, filled best first.
+ * @return The number of documents stored in out; 0 once all are returned.
+ */
+size_t rankcursor_next(rankcursor_t* cursor, const size_t k, ranked_t out[]);
+
+/**
+ * Deletes a cursor (but not its result).
+ *
+ * @param cursor The cursor; NULL is ignored.
+ */
+void rankcursor_delete(rankcursor_t* cursor);
+
+/**
+ * Offers a document to a bounded heap of the best k documents offered so
+ * far. The heap's root, heap[0], is the worst of them, so once the heap
+ * is full a document needs to rank before heap[0] to get in.
+ *
+ * @param heap Array of at least k elements.
+ * @param n The number of documents in the heap; updated.
+ * @param k The most documents to keep (> 0).
+ * @param doc The document; a score of 0 or less is never kept.
+ * @return true if the document was kept.
+ */
+bool ranking_push(ranked_t heap[], size_t* n, const size_t k, const ranked_t* doc);
+
+/**
+ * Sorts a heap filled by `ranking_push` in place, best first.
+ *
+ * @param heap The heap.
+ * @param n The number of documents in it.
+ */
+void ranking_sort(ranked_t heap[], const size_t n);
+
+#endif // __RANKING_H
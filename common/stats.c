@@ -0,0 +1,227 @@
+/*
+ * stats.c - CS50 Tiny Search Engine (TSE) runtime timers and counters
+ *
+ * see stats.h for more information.
+ *
+ * A duration v goes in bucket v if it is under 4 ns; otherwise, for v
+ * with its highest bit at position e, in bucket 4 * (e - 1) plus v's next
+ * two bits, so each power of two is split into four equal buckets. All
+ * the fields are relaxed atomics: a reader may see a timer's count and
+ * histogram a few durations apart, which a summary can afford.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "stats.h"
+
+/**************** constants ****************/
+#define NUM_BUCKETS 252           // 4 below 4 ns, then 4 for each bit position 2..63
+
+static const char* const timerNames[STATS_NUM_TIMERS] = {
+  "webpage_fetch", "politeness_wait", "page_save", "page_load",
+  "index_page", "index_insert", "query_evaluate", "print_results",
+};
+static const char* const counterNames[STATS_NUM_COUNTERS] = {
+  "fetch_bytes", "fetch_failures",
+};
+
+/**************** local types ****************/
+typedef struct probe {
+  atomic_ullong count;
+  atomic_ullong total;            // nanoseconds
+  atomic_ullong max;
+  atomic_ullong buckets[NUM_BUCKETS];
+} probe_t;
+
+/**************** global variables ****************/
+bool stats_recording = false;
+
+/**************** file-local global variables ****************/
+static probe_t timers[STATS_NUM_TIMERS];
+static atomic_ullong counters[STATS_NUM_COUNTERS];
+
+/**************** local functions ****************/
+static int bucketOf(const uint64_t ns);
+static uint64_t bucketMiddle(const int b);
+static uint64_t percentile(const probe_t* timer, const uint64_t count, const int percent, const uint64_t max);
+#ifndef NOSTATS
+static void printAtExit(void);
+#endif
+
+/**************** stats_enable ****************/
+/* see stats.h for description */
+bool stats_enable(void)
+{
+#ifndef NOSTATS
+  if (!stats_recording) {
+    stats_recording = true;
+    atexit(printAtExit);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**************** stats_now ****************/
+/* see stats.h for description */
+uint64_t stats_now(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/**************** stats_record ****************/
+/* see stats.h for description */
+void stats_record(const stats_timer_t timer, const uint64_t ns)
+{
+  if (timer < 0 || timer >= STATS_NUM_TIMERS) {
+    return;
+  }
+  probe_t* t = &timers[timer];
+  atomic_fetch_add_explicit(&t->count, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&t->total, ns, memory_order_relaxed);
+  atomic_fetch_add_explicit(&t->buckets[bucketOf(ns)], 1, memory_order_relaxed);
+  unsigned long long max = atomic_load_explicit(&t->max, memory_order_relaxed);
+  while (ns > max && !atomic_compare_exchange_weak_explicit(&t->max, &max, ns, memory_order_relaxed,
+                                                            memory_order_relaxed)) {
+    // max now holds the latest maximum; try again if ns still beats it
+  }
+}
+
+/**************** stats_count ****************/
+/* see stats.h for description */
+void stats_count(const stats_counter_t counter, const uint64_t n)
+{
+  if (counter >= 0 && counter < STATS_NUM_COUNTERS) {
+    atomic_fetch_add_explicit(&counters[counter], n, memory_order_relaxed);
+  }
+}
+
+/**************** stats_summary ****************/
+/* see stats.h for description */
+void stats_summary(const stats_timer_t timer, stats_summary_t* summary)
+{
+  if (summary == NULL) {
+    return;
+  }
+  summary->count = summary->total = summary->p50 = summary->p90 = summary->p99 = summary->max = 0;
+  if (timer < 0 || timer >= STATS_NUM_TIMERS) {
+    return;
+  }
+  const probe_t* t = &timers[timer];
+  summary->count = atomic_load_explicit(&t->count, memory_order_relaxed);
+  summary->total = atomic_load_explicit(&t->total, memory_order_relaxed);
+  summary->max = atomic_load_explicit(&t->max, memory_order_relaxed);
+  summary->p50 = percentile(t, summary->count, 50, summary->max);
+  summary->p90 = percentile(t, summary->count, 90, summary->max);
+  summary->p99 = percentile(t, summary->count, 99, summary->max);
+}
+
+/**************** stats_print ****************/
+/* see stats.h for description */
+void stats_print(FILE* fp)
+{
+  if (fp == NULL) {
+    return;
+  }
+  bool header = false;
+  for (int i = 0; i < STATS_NUM_TIMERS; i++) {
+    stats_summary_t s;
+    stats_summary(i, &s);
+    if (s.count > 0 && !header) {
+      fprintf(fp, "Stats: %-16s %10s %12s %12s %12s %12s %12s %12s\n",
+              "timer", "count", "total_ms", "mean_us", "p50_us", "p90_us", "p99_us", "max_us");
+      header = true;
+    }
+    if (s.count > 0) {
+      fprintf(fp, "Stats: %-16s %10llu %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", timerNames[i],
+              (unsigned long long) s.count, s.total / 1e6, s.total / 1e3 / s.count,
+              s.p50 / 1e3, s.p90 / 1e3, s.p99 / 1e3, s.max / 1e3);
+    }
+  }
+  for (int i = 0; i < STATS_NUM_COUNTERS; i++) {
+    unsigned long long n = atomic_load_explicit(&counters[i], memory_order_relaxed);
+    if (n > 0) {
+      fprintf(fp, "Stats: %-16s %10llu\n", counterNames[i], n);
+    }
+  }
+}
+
+/**************** stats_fields ****************/
+/* see stats.h for description */
+void stats_fields(FILE* fp)
+{
+  if (fp == NULL) {
+    return;
+  }
+  for (int i = 0; i < STATS_NUM_TIMERS; i++) {
+    stats_summary_t s;
+    stats_summary(i, &s);
+    if (s.count > 0) {
+      fprintf(fp, "\t%s_count=%llu\t%s_p50_us=%.3f\t%s_p99_us=%.3f\t%s_max_us=%.3f",
+              timerNames[i], (unsigned long long) s.count, timerNames[i], s.p50 / 1e3,
+              timerNames[i], s.p99 / 1e3, timerNames[i], s.max / 1e3);
+    }
+  }
+  for (int i = 0; i < STATS_NUM_COUNTERS; i++) {
+    unsigned long long n = atomic_load_explicit(&counters[i], memory_order_relaxed);
+    if (n > 0) {
+      fprintf(fp, "\t%s=%llu", counterNames[i], n);
+    }
+  }
+}
+
+/* Returns the histogram bucket of a duration */
+static int bucketOf(const uint64_t ns)
+{
+  if (ns < 4) {
+    return ns;
+  }
+  int e = 63 - __builtin_clzll(ns);
+  return 4 * (e - 1) + ((ns >> (e - 2)) & 3);
+}
+
+/* Returns the duration in the middle of a bucket */
+static uint64_t bucketMiddle(const int b)
+{
+  if (b < 4) {
+    return b;
+  }
+  int e = b / 4 + 1;
+  uint64_t width = (uint64_t) 1 << (e - 2);
+  return (4 + b % 4) * width + width / 2;
+}
+
+/* Returns the duration below which percent of a timer's count fall, at most max */
+static uint64_t percentile(const probe_t* timer, const uint64_t count, const int percent, const uint64_t max)
+{
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t rank = (count * percent + 99) / 100;   // the rank-th shortest, from 1
+  uint64_t seen = 0;
+  for (int b = 0; b < NUM_BUCKETS; b++) {
+    seen += atomic_load_explicit(&timer->buckets[b], memory_order_relaxed);
+    if (seen >= rank) {
+      uint64_t middle = bucketMiddle(b);
+      return middle < max ? middle : max;
+    }
+  }
+  return max;
+}
+
+#ifndef NOSTATS
+/* Prints the summary to stderr, when the program exits */
+static void printAtExit(void)
+{
+  stats_print(stderr);
+}
+#endif
@@ -0,0 +1,147 @@
+/*
+ * stats.h - CS50 Tiny Search Engine (TSE) runtime timers and counters
+ *
+ * The crawler, indexer and querier time their main steps -- fetching a
+ * page, waiting for its host, saving and reading pages, indexing a page,
+ * inserting a word, evaluating a query, printing its results -- with
+ * these timers, to tell where a slow crawl or query spends its time. Each
+ * timer keeps the number of times it ran, their total and longest
+ * duration, and a histogram of durations, with four buckets per power of
+ * two of nanoseconds, so percentiles are known to within about 12%.
+ * Counters add up quantities such as the bytes fetched.
+ *
+ * Nothing is recorded until `stats_enable` is called (the programs'
+ * `--stats`); until then a timer costs one test of a flag. Compiled with
+ * -DNOSTATS (`make FLAGS=-DNOSTATS`), the macros below expand to nothing,
+ * and `stats_enable` reports that there is nothing to record.
+ *
+ *   STATS_START(start);                      // declares uint64_t start
+ *   ...the work...
+ *   STATS_STOP(STATS_INDEX_PAGE, start);     // records its duration
+ *   STATS_COUNT(STATS_FETCH_BYTES, len);     // adds to a counter
+ *
+ * Functions:
+ *  - `stats_enable`: Starts recording, and prints a summary at exit.
+ *  - `stats_now`: Returns the monotonic clock, in nanoseconds.
+ *  - `stats_record`: Records one duration of a timer.
+ *  - `stats_count`: Adds to a counter.
+ *  - `stats_summary`: Returns a timer's count, total, percentiles and maximum.
+ *  - `stats_print`: Prints every timer and counter used, as a table.
+ *  - `stats_fields`: Prints them as "\tname=value" fields for a server's STATS line.
+ *
+ * Error Handling:
+ *  - All functions are safe to call from any number of threads; the
+ *    timers and counters are updated atomically.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __STATS_H
+#define __STATS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* The timers */
+typedef enum stats_timer {
+  STATS_WEBPAGE_FETCH,        // crawler: fetching a page
+  STATS_POLITENESS_WAIT,      // crawler: waiting for the page's host's turn
+  STATS_PAGE_SAVE,            // saving a page (pagedir_save, pagedir_append)
+  STATS_PAGE_LOAD,            // reading a page (pagedir_load, pagedir_next)
+  STATS_INDEX_PAGE,           // indexer: indexing a page's words (indexPage)
+  STATS_INDEX_INSERT,         // inserting a word (index_insert, index_insertn)
+  STATS_QUERY_EVALUATE,       // querier: finding a query's matches (queryEvaluate, or by BM25 or the shards)
+  STATS_PRINT_RESULTS,        // querier: ranking and printing them (printRankedResults, printRankedList)
+  STATS_NUM_TIMERS
+} stats_timer_t;
+
+/* The counters */
+typedef enum stats_counter {
+  STATS_FETCH_BYTES,          // crawler: bytes of HTML fetched
+  STATS_FETCH_FAILURES,       // crawler: pages that could not be fetched
+  STATS_NUM_COUNTERS
+} stats_counter_t;
+
+/* A timer's durations, as reported by `stats_summary`, in nanoseconds */
+typedef struct stats_summary {
+  uint64_t count;
+  uint64_t total;
+  uint64_t p50;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t max;
+} stats_summary_t;
+
+/* Whether stats are being recorded; read by the macros, set by `stats_enable` */
+extern bool stats_recording;
+
+#ifndef NOSTATS
+#define STATS_START(start) uint64_t start = stats_recording ? stats_now() : 0
+#define STATS_STOP(timer, start) \
+  do { if (start != 0) stats_record(timer, stats_now() - start); } while (0)
+#define STATS_COUNT(counter, n) \
+  do { if (stats_recording) stats_count(counter, n); } while (0)
+#else
+#define STATS_START(start) ((void) 0)
+#define STATS_STOP(timer, start) ((void) 0)
+#define STATS_COUNT(counter, n) ((void) 0)
+#endif
+
+/**
+ * Starts recording, and arranges for `stats_print(stderr)` when the
+ * program exits. Call it before starting any threads.
+ *
+ * @return true; false (recording nothing) if compiled with -DNOSTATS.
+ */
+bool stats_enable(void);
+
+/**
+ * Returns the time of CLOCK_MONOTONIC, in nanoseconds.
+ */
+uint64_t stats_now(void);
+
+/**
+ * Records one duration of a timer.
+ *
+ * @param timer The timer.
+ * @param ns The duration, in nanoseconds.
+ */
+void stats_record(const stats_timer_t timer, const uint64_t ns);
+
+/**
+ * Adds n to a counter.
+ */
+void stats_count(const stats_counter_t counter, const uint64_t n);
+
+/**
+ * Returns a timer's durations so far.
+ *
+ * @param timer The timer.
+ * @param summary Where to store its count, total, median, 90th and 99th
+ *                percentiles (each the middle of its histogram bucket, at
+ *                most the maximum), and maximum; all 0 if it never ran.
+ */
+void stats_summary(const stats_timer_t timer, stats_summary_t* summary);
+
+/**
+ * Prints a table of every timer that ran -- its count, total in
+ * milliseconds, and mean, percentiles and maximum in microseconds -- and
+ * every counter that is not 0, each line starting "Stats: "; nothing if
+ * none did.
+ *
+ * @param fp Where to print.
+ */
+void stats_print(FILE* fp);
+
+/**
+ * Prints every timer that ran as NAME_count, NAME_p50_us, NAME_p99_us and
+ * NAME_max_us fields, and every counter that is not 0 as a NAME field, each as
+ * "\tname=value", with no newline.
+ *
+ * @param fp Where to print.
+ */
+void stats_fields(FILE* fp);
+
+#endif // __STATS_H
@@ -0,0 +1,252 @@
+/*
+ * termdict.c - CS50 Tiny Search Engine (TSE) term dictionary
+ *
+ * see termdict.h for more information.
+ *
+ * A slot whose hash is 0 is empty, so computed hashes of 0 become 1.
+ * Each word is stored in the arena followed by a null, so `termdict_word`
+ * can hand out ordinary C strings; word i starts at offsets[i] and the
+ * next word at offsets[i + 1], which gives its length without storing it.
+ * Offsets, unlike pointers, stay valid when the arena is reallocated.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "termdict.h"
+#include "../libcs50/mem.h"
+
+/**************** constants ****************/
+static const size_t MIN_SLOTS = 16;          // must be a power of two
+static const size_t MIN_ARENA = 1024;
+static const size_t MIN_TERMS = 16;
+
+/**************** local types ****************/
+typedef struct slot {
+  uint32_t hash;            // full hash of the word; 0 means empty
+  uint32_t id;              // the word's term ID
+} slot_t;
+
+typedef struct termdict {
+  slot_t* slots;            // numSlots slots, a power of two
+  size_t numSlots;
+  uint32_t* offsets;        // count + 1 arena offsets, by term ID
+  size_t count;
+  size_t capacity;          // room in offsets for this many IDs
+  char* arena;              // the words, each followed by a null
+  size_t arenaUsed;
+  size_t arenaSize;
+} termdict_t;
+
+/**************** local functions ****************/
+static uint32_t hashWord(const char* word, const size_t len);
+static slot_t* probe(termdict_t* dict, const char* word, const size_t len, const uint32_t hash);
+static void grow(termdict_t* dict);
+static uint32_t addWord(termdict_t* dict, const char* word, const size_t len);
+
+/**************** termdict_new ****************/
+/* see termdict.h for description */
+termdict_t* termdict_new(const size_t expected)
+{
+  termdict_t* dict = mem_malloc(sizeof(termdict_t));
+  if (dict == NULL) {
+    return NULL;
+  }
+
+  // room for `expected` words without growing
+  size_t numSlots = MIN_SLOTS;
+  while (numSlots / 4 * 3 < expected) {
+    numSlots *= 2;
+  }
+  size_t capacity = expected > MIN_TERMS ? expected : MIN_TERMS;
+  dict->slots = mem_calloc(numSlots, sizeof(slot_t));
+  dict->offsets = mem_malloc((capacity + 1) * sizeof(uint32_t));
+  dict->arenaSize = MIN_ARENA;
+  dict->arena = mem_malloc(dict->arenaSize);
+  if (dict->slots == NULL || dict->offsets == NULL || dict->arena == NULL) {
+    if (dict->slots != NULL) {
+      mem_free(dict->slots);
+    }
+    if (dict->offsets != NULL) {
+      mem_free(dict->offsets);
+    }
+    if (dict->arena != NULL) {
+      mem_free(dict->arena);
+    }
+    mem_free(dict);
+    return NULL;
+  }
+  dict->numSlots = numSlots;
+  dict->offsets[0] = 0;
+  dict->count = 0;
+  dict->capacity = capacity;
+  dict->arenaUsed = 0;
+  return dict;
+}
+
+/**************** termdict_add ****************/
+/* see termdict.h for description */
+uint32_t termdict_add(termdict_t* dict, const char* word, const size_t len)
+{
+  uint32_t hash = hashWord(word, len);
+  slot_t* slot = probe(dict, word, len, hash);
+  if (slot->hash != 0) {
+    return slot->id;          // found
+  }
+
+  // a new word: grow first if this one would make the table 3/4 full
+  if (4 * (dict->count + 1) > 3 * dict->numSlots) {
+    grow(dict);
+    slot = probe(dict, word, len, hash);
+  }
+  slot->id = addWord(dict, word, len);
+  slot->hash = hash;
+  return slot->id;
+}
+
+/**************** termdict_find ****************/
+/* see termdict.h for description */
+bool termdict_find(termdict_t* dict, const char* word, const size_t len, uint32_t* id)
+{
+  if (dict == NULL || word == NULL || id == NULL) {
+    return false;
+  }
+
+  slot_t* slot = probe(dict, word, len, hashWord(word, len));
+  if (slot->hash == 0) {
+    return false;
+  }
+  *id = slot->id;
+  return true;
+}
+
+/**************** termdict_word ****************/
+/* see termdict.h for description */
+const char* termdict_word(termdict_t* dict, const uint32_t id, size_t* len)
+{
+  if (dict == NULL || id >= dict->count) {
+    return NULL;
+  }
+  if (len != NULL) {
+    *len = dict->offsets[id + 1] - dict->offsets[id] - 1;
+  }
+  return &dict->arena[dict->offsets[id]];
+}
+
+/**************** termdict_count ****************/
+/* see termdict.h for description */
+size_t termdict_count(termdict_t* dict)
+{
+  return dict == NULL ? 0 : dict->count;
+}
+
+/**************** termdict_delete ****************/
+/* see termdict.h for description */
+void termdict_delete(termdict_t* dict)
+{
+  if (dict == NULL) {
+    return;
+  }
+  mem_free(dict->slots);
+  mem_free(dict->offsets);
+  mem_free(dict->arena);
+  mem_free(dict);
+}
+
+/* 32-bit FNV-1a over the word, with a final avalanche so the low bits
+ * (which pick the slot) depend on every byte; never returns 0.
+ */
+static uint32_t hashWord(const char* word, const size_t len)
+{
+  uint32_t h = 2166136261u;                 // FNV offset basis
+  for (size_t i = 0; i < len; i++) {
+    h ^= (unsigned char) word[i];
+    h *= 16777619u;                         // FNV prime
+  }
+  h ^= h >> 16;
+  h *= 0x7feb352du;
+  h ^= h >> 15;
+  h *= 0x846ca68bu;
+  h ^= h >> 16;
+
+  return h == 0 ? 1 : h;                    // 0 marks an empty slot
+}
+
+/* Returns the slot holding the word, or the empty slot where it belongs */
+static slot_t* probe(termdict_t* dict, const char* word, const size_t len, const uint32_t hash)
+{
+  size_t mask = dict->numSlots - 1;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+    slot_t* slot = &dict->slots[i];
+    if (slot->hash == 0) {
+      return slot;
+    }
+    if (slot->hash == hash) {
+      uint32_t start = dict->offsets[slot->id];
+      if (dict->offsets[slot->id + 1] - start - 1 == len
+          && memcmp(&dict->arena[start], word, len) == 0) {
+        return slot;
+      }
+    }
+  }
+}
+
+/* Doubles the slot array, placing each slot by its cached hash */
+static void grow(termdict_t* dict)
+{
+  size_t oldSlots = dict->numSlots;
+  slot_t* old = dict->slots;
+
+  dict->numSlots = 2 * oldSlots;
+  dict->slots = mem_calloc_assert(dict->numSlots, sizeof(slot_t), "termdict slots");
+  size_t mask = dict->numSlots - 1;
+
+  for (size_t i = 0; i < oldSlots; i++) {
+    if (old[i].hash != 0) {
+      size_t j = old[i].hash & mask;
+      while (dict->slots[j].hash != 0) {
+        j = (j + 1) & mask;
+      }
+      dict->slots[j] = old[i];
+    }
+  }
+  mem_free(old);
+}
+
+/* Copies a word (plus a null) into the arena and gives it the next
+ * term ID, growing the arena and the offsets as needed; returns the ID */
+static uint32_t addWord(termdict_t* dict, const char* word, const size_t len)
+{
+  if (dict->count == UINT32_MAX || dict->arenaUsed + len + 1 > UINT32_MAX) {
+    mem_assert(NULL, "termdict: too many words");   // IDs and offsets are 32 bits
+  }
+  if (dict->count == dict->capacity) {
+    size_t capacity = 2 * dict->capacity;
+    uint32_t* offsets = mem_malloc_assert((capacity + 1) * sizeof(uint32_t), "termdict offsets");
+    memcpy(offsets, dict->offsets, (dict->count + 1) * sizeof(uint32_t));
+    mem_free(dict->offsets);
+    dict->offsets = offsets;
+    dict->capacity = capacity;
+  }
+  if (dict->arenaUsed + len + 1 > dict->arenaSize) {
+    size_t size = 2 * dict->arenaSize;
+    while (dict->arenaUsed + len + 1 > size) {
+      size *= 2;
+    }
+    char* arena = mem_malloc_assert(size, "termdict arena");
+    memcpy(arena, dict->arena, dict->arenaUsed);
+    mem_free(dict->arena);
+    dict->arena = arena;
+    dict->arenaSize = size;
+  }
+
+  memcpy(&dict->arena[dict->arenaUsed], word, len);
+  dict->arena[dict->arenaUsed + len] = '\0';
+  dict->arenaUsed += len + 1;
+  dict->offsets[++dict->count] = dict->arenaUsed;
+  return dict->count - 1;
+}
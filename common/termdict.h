@@ -0,0 +1,105 @@
+/*
+ * termdict.h - CS50 Tiny Search Engine (TSE) term dictionary
+ *
+ * A term dictionary numbers the distinct words it is given with dense
+ * 32-bit term IDs, 0, 1, 2, ... in the order they are first added, so
+ * that whatever is kept per word (an index's posting lists) can live in a
+ * flat array indexed by term ID instead of behind a pointer in each slot.
+ *
+ *  - the words themselves are interned in one growable arena, packed one
+ *    after another, and located by an array of offsets indexed by term ID;
+ *  - lookups go through open addressing with linear probing in one flat
+ *    slot array, each slot holding a term ID and its word's full 32-bit
+ *    hash, so a probe compares a word's bytes only when the hashes match;
+ *  - the slot array doubles whenever it becomes 3/4 full, re-placing slots
+ *    from their cached hashes without rehashing any word.
+ *
+ * A word's ID never changes once given, so a caller can translate one
+ * dictionary's IDs into another's with one lookup per term, as
+ * `index_merge` does. Words may be given with an explicit length, so they
+ * need not be null-terminated.
+ *
+ * Functions:
+ *  - `termdict_new`: Creates an empty dictionary.
+ *  - `termdict_add`: Returns a word's ID, adding the word if it is new.
+ *  - `termdict_find`: Looks up a word's ID.
+ *  - `termdict_word`: Returns the word with a given ID.
+ *  - `termdict_count`: Returns the number of words, one more than the last ID.
+ *  - `termdict_delete`: Frees the dictionary.
+ *
+ * Error Handling:
+ *  - `termdict_new` returns NULL on allocation failure; running out of
+ *    memory while growing terminates the program via `mem_assert`.
+ *  - Lookups may run in several threads at once, as long as no thread is
+ *    adding words meanwhile.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __TERMDICT_H
+#define __TERMDICT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The dictionary; opaque to users of the module */
+typedef struct termdict termdict_t;
+
+/**
+ * Creates a new, empty dictionary.
+ *
+ * @param expected About how many words will be added; the dictionary
+ *                 grows past it as needed, so this is only a hint.
+ * @return Pointer to a new `termdict_t`, or NULL on failure.
+ */
+termdict_t* termdict_new(const size_t expected);
+
+/**
+ * Returns a word's term ID, adding the word with the next ID (the
+ * current count) if it is not in the dictionary yet. The word is copied.
+ *
+ * @param dict The dictionary; must not be NULL.
+ * @param word The first character of the word (need not be null-terminated).
+ * @param len The word's length.
+ * @return The word's term ID.
+ */
+uint32_t termdict_add(termdict_t* dict, const char* word, const size_t len);
+
+/**
+ * Looks up a word's term ID.
+ *
+ * @param dict The dictionary.
+ * @param word The first character of the word (need not be null-terminated).
+ * @param len The word's length.
+ * @param id Where to store the word's ID, if it is found.
+ * @return true if the word is in the dictionary; false if not, or on NULL args.
+ */
+bool termdict_find(termdict_t* dict, const char* word, const size_t len, uint32_t* id);
+
+/**
+ * Returns the word with a term ID, null-terminated, in the arena; it is
+ * valid only until the next word is added.
+ *
+ * @param dict The dictionary.
+ * @param id A term ID less than `termdict_count(dict)`.
+ * @param len Where to store the word's length; may be NULL.
+ * @return The word, or NULL if there is no such ID.
+ */
+const char* termdict_word(termdict_t* dict, const uint32_t id, size_t* len);
+
+/**
+ * Returns the number of words in the dictionary (0 if NULL); the IDs in
+ * use are 0 up to one less than it.
+ */
+size_t termdict_count(termdict_t* dict);
+
+/**
+ * Deletes the dictionary.
+ *
+ * @param dict The dictionary; NULL is ignored.
+ */
+void termdict_delete(termdict_t* dict);
+
+#endif // __TERMDICT_H
@@ -0,0 +1,319 @@
+/*
+ * tokenizer.c - CS50 Tiny Search Engine (TSE) Word Tokenizer
+ *
+ * see tokenizer.h for more information.
+ *
+ * The two inner loops -- skip to the next letter or '<', and skip to the
+ * end of a word -- classify a whole vector of bytes per step when the
+ * compiler targets AVX2 (32 bytes), SSE2 (16 bytes, always available on
+ * x86-64) or NEON (16 bytes); a scalar loop handles any remaining tail
+ * bytes and other targets. Finding the '>' that closes a tag is left to
+ * memchr, which the C library vectorizes already.
+ *
+ * A byte c is an ASCII letter iff (c | 0x20) is in 'a'..'z'. Vector
+ * units compare bytes as signed, so we add (128 - 'a') to shift 'a'..'z'
+ * onto -128..-103 and test "less than -102"; every other byte value
+ * lands at or above -102.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#include "tokenizer.h"
+
+// Whether blockMasks has a vector implementation for this target; without
+// one, classifying 64-byte blocks costs more than it saves.
+#if defined(__AVX2__) || defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+#define VECTOR_BLOCKS 1
+#else
+#define VECTOR_BLOCKS 0
+#endif
+
+/**************** local functions ****************/
+static inline bool isLetter(const char c);
+static size_t skipToWordOrTag(const char* doc, size_t pos, const size_t len);
+static size_t skipWord(const char* doc, size_t pos, const size_t len);
+static void blockMasks(const char* block, uint64_t* letters, uint64_t* opens);
+
+/**************** tokenizer_init ****************/
+/* see tokenizer.h for description */
+void tokenizer_init(tokenizer_t* tok, const char* doc, const size_t len)
+{
+  if (tok == NULL) {
+    return;
+  }
+
+  // webpage_getNextWord treats the html as a C string, so do likewise
+  const char* nul = doc == NULL ? NULL : memchr(doc, '\0', len);
+  tok->doc = doc;
+  tok->len = doc == NULL ? 0 : (nul != NULL ? (size_t) (nul - doc) : len);
+  tok->pos = 0;
+}
+
+/**************** tokenizer_next ****************/
+/* see tokenizer.h for description.
+ * Follows webpage_getNextWord step for step, with the end of the
+ * buffer standing in for the terminating null.
+ */
+bool tokenizer_next(tokenizer_t* tok, const char** word, size_t* wordLen)
+{
+  if (tok == NULL || word == NULL || wordLen == NULL) {
+    return false;
+  }
+
+  const char* doc = tok->doc;
+  const size_t len = tok->len;
+  size_t pos = tok->pos;
+
+  // consume any non-alphabetic characters; whenever that stops at a
+  // tag, i.e., <...tag...>, skip the tag and carry on
+  while ((pos = skipToWordOrTag(doc, pos, len)) < len && doc[pos] == '<') {
+    const char* close = memchr(&doc[pos], '>', len - pos);
+    if (close == NULL || close + 1 == doc + len) {
+      tok->pos = len;          // ran out of html
+      return false;
+    }
+    pos = close + 1 - doc;
+  }
+
+  if (pos == len) {
+    tok->pos = len;
+    return false;
+  }
+
+  // doc[pos] is the first letter of a word; consume the word
+  size_t beg = pos;
+  pos = skipWord(doc, pos, len);
+
+  *word = &doc[beg];
+  *wordLen = pos - beg;
+  tok->pos = pos;
+  return true;
+}
+
+/**************** tokenizer_nextMany ****************/
+/* see tokenizer.h for description */
+size_t tokenizer_nextMany(tokenizer_t* tok, tokenizer_span_t spans[], const size_t max)
+{
+  if (tok == NULL || spans == NULL) {
+    return 0;
+  }
+
+  const char* doc = tok->doc;
+  const size_t len = tok->len;
+  size_t n = 0;
+
+  while (n < max) {
+    size_t pos = tok->pos;
+    if (VECTOR_BLOCKS && pos + 64 <= len) {
+      // Classify the next 64 bytes at once, then peel the words that lie
+      // wholly before the first '<' straight out of the letter mask.
+      // tok->pos is never inside a word, so bit 0 starts one if set.
+      uint64_t letters, opens;
+      blockMasks(&doc[pos], &letters, &opens);
+      const int limit = (opens == 0) ? 64 : __builtin_ctzll(opens);
+      uint64_t rest = letters;
+      while (n < max && rest != 0) {
+        int start = __builtin_ctzll(rest);
+        if (start >= limit) {
+          break;
+        }
+        uint64_t after = ~letters >> start;     // non-letters from start on
+        if (after == 0) {
+          break;                      // the word runs past this block
+        }
+        int end = start + __builtin_ctzll(after);
+        spans[n].word = &doc[pos + start];
+        spans[n].len = end - start;
+        n++;
+        tok->pos = pos + end;
+        rest = (end == 64) ? 0 : rest & (~(uint64_t) 0 << end);
+      }
+      if (n == max) {
+        break;
+      }
+      if (rest == 0 && limit == 64) {
+        tok->pos = pos + 64;          // nothing else in this block
+        continue;
+      }
+      // a tag, or a word that crosses into the next block: go one step
+      // at a time from the end of the last word taken
+    }
+    if (!tokenizer_next(tok, &spans[n].word, &spans[n].len)) {
+      break;
+    }
+    n++;
+  }
+  return n;
+}
+
+/* ASCII letters only, as isalpha() in the "C" locale the TSE runs in */
+static inline bool isLetter(const char c)
+{
+  return (unsigned) ((c | 0x20) - 'a') < 26;
+}
+
+/* Returns the offset of the first letter or '<' at or after pos, or len */
+static size_t skipToWordOrTag(const char* doc, size_t pos, const size_t len)
+{
+#if defined(__AVX2__)
+  const __m256i shift = _mm256_set1_epi8((char) (128 - 'a'));
+  const __m256i limit = _mm256_set1_epi8((char) (-128 + 26));
+  const __m256i fold = _mm256_set1_epi8(0x20);
+  const __m256i open = _mm256_set1_epi8('<');
+  for (; pos + 32 <= len; pos += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) &doc[pos]);
+    __m256i letter = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(_mm256_or_si256(v, fold), shift));
+    uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(letter, _mm256_cmpeq_epi8(v, open)));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i shift = _mm_set1_epi8((char) (128 - 'a'));
+  const __m128i limit = _mm_set1_epi8((char) (-128 + 26));
+  const __m128i fold = _mm_set1_epi8(0x20);
+  const __m128i open = _mm_set1_epi8('<');
+  for (; pos + 16 <= len; pos += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) &doc[pos]);
+    __m128i letter = _mm_cmplt_epi8(_mm_add_epi8(_mm_or_si128(v, fold), shift), limit);
+    unsigned mask = _mm_movemask_epi8(_mm_or_si128(letter, _mm_cmpeq_epi8(v, open)));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; pos + 16 <= len; pos += 16) {
+    uint8x16_t v = vld1q_u8((const uint8_t*) &doc[pos]);
+    uint8x16_t letter = vcltq_u8(vsubq_u8(vorrq_u8(v, vdupq_n_u8(0x20)), vdupq_n_u8('a')),
+                                 vdupq_n_u8(26));
+    uint8x16_t hit = vorrq_u8(letter, vceqq_u8(v, vdupq_n_u8('<')));
+    // narrow each byte to 4 bits so the 16 results fit in 64 bits
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+                      vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+    if (mask != 0) {
+      return pos + __builtin_ctzll(mask) / 4;
+    }
+  }
+#endif
+  while (pos < len && !isLetter(doc[pos]) && doc[pos] != '<') {
+    pos++;
+  }
+  return pos;
+}
+
+/* Returns the offset of the first non-letter at or after pos, or len */
+static size_t skipWord(const char* doc, size_t pos, const size_t len)
+{
+#if defined(__AVX2__)
+  const __m256i shift = _mm256_set1_epi8((char) (128 - 'a'));
+  const __m256i limit = _mm256_set1_epi8((char) (-128 + 26));
+  const __m256i fold = _mm256_set1_epi8(0x20);
+  for (; pos + 32 <= len; pos += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) &doc[pos]);
+    __m256i letter = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(_mm256_or_si256(v, fold), shift));
+    uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(letter);
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i shift = _mm_set1_epi8((char) (128 - 'a'));
+  const __m128i limit = _mm_set1_epi8((char) (-128 + 26));
+  const __m128i fold = _mm_set1_epi8(0x20);
+  for (; pos + 16 <= len; pos += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) &doc[pos]);
+    __m128i letter = _mm_cmplt_epi8(_mm_add_epi8(_mm_or_si128(v, fold), shift), limit);
+    unsigned mask = ~_mm_movemask_epi8(letter) & 0xFFFF;
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; pos + 16 <= len; pos += 16) {
+    uint8x16_t v = vld1q_u8((const uint8_t*) &doc[pos]);
+    uint8x16_t other = vcgeq_u8(vsubq_u8(vorrq_u8(v, vdupq_n_u8(0x20)), vdupq_n_u8('a')),
+                                vdupq_n_u8(26));
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+                      vshrn_n_u16(vreinterpretq_u16_u8(other), 4)), 0);
+    if (mask != 0) {
+      return pos + __builtin_ctzll(mask) / 4;
+    }
+  }
+#endif
+  while (pos < len && isLetter(doc[pos])) {
+    pos++;
+  }
+  return pos;
+}
+
+/* Sets bit i of *letters iff block[i] is a letter, and of *opens iff
+ * block[i] is '<', for the 64 bytes of block.
+ */
+static void blockMasks(const char* block, uint64_t* letters, uint64_t* opens)
+{
+#if defined(__AVX2__)
+  const __m256i shift = _mm256_set1_epi8((char) (128 - 'a'));
+  const __m256i limit = _mm256_set1_epi8((char) (-128 + 26));
+  const __m256i fold = _mm256_set1_epi8(0x20);
+  const __m256i open = _mm256_set1_epi8('<');
+  uint64_t l = 0, o = 0;
+  for (int i = 0; i < 64; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) &block[i]);
+    __m256i letter = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(_mm256_or_si256(v, fold), shift));
+    l |= (uint64_t) (uint32_t) _mm256_movemask_epi8(letter) << i;
+    o |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, open)) << i;
+  }
+  *letters = l;
+  *opens = o;
+#elif defined(__SSE2__)
+  const __m128i shift = _mm_set1_epi8((char) (128 - 'a'));
+  const __m128i limit = _mm_set1_epi8((char) (-128 + 26));
+  const __m128i fold = _mm_set1_epi8(0x20);
+  const __m128i open = _mm_set1_epi8('<');
+  uint64_t l = 0, o = 0;
+  for (int i = 0; i < 64; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) &block[i]);
+    __m128i letter = _mm_cmplt_epi8(_mm_add_epi8(_mm_or_si128(v, fold), shift), limit);
+    l |= (uint64_t) _mm_movemask_epi8(letter) << i;
+    o |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v, open)) << i;
+  }
+  *letters = l;
+  *opens = o;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  // weight each lane by its bit, then add across each half
+  static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                    1, 2, 4, 8, 16, 32, 64, 128 };
+  const uint8x16_t weights = vld1q_u8(bits);
+  uint64_t l = 0, o = 0;
+  for (int i = 0; i < 64; i += 16) {
+    uint8x16_t v = vld1q_u8((const uint8_t*) &block[i]);
+    uint8x16_t letter = vandq_u8(weights,
+        vcltq_u8(vsubq_u8(vorrq_u8(v, vdupq_n_u8(0x20)), vdupq_n_u8('a')), vdupq_n_u8(26)));
+    uint8x16_t open = vandq_u8(weights, vceqq_u8(v, vdupq_n_u8('<')));
+    l |= ((uint64_t) vaddv_u8(vget_low_u8(letter))
+          | (uint64_t) vaddv_u8(vget_high_u8(letter)) << 8) << i;
+    o |= ((uint64_t) vaddv_u8(vget_low_u8(open))
+          | (uint64_t) vaddv_u8(vget_high_u8(open)) << 8) << i;
+  }
+  *letters = l;
+  *opens = o;
+#else
+  // not used (see VECTOR_BLOCKS), but kept correct
+  uint64_t l = 0, o = 0;
+  for (int i = 0; i < 64; i++) {
+    l |= (uint64_t) isLetter(block[i]) << i;
+    o |= (uint64_t) (block[i] == '<') << i;
+  }
+  *letters = l;
+  *opens = o;
+#endif
+}
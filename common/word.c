@@ -1,7 +1,8 @@
 /*
 * word.c - CS50 Tiny Search Engine (TSE) Word Module
 *
-* Implements a function to normalize words by converting them to lowercase.
+* Implements functions to normalize words by converting them to lowercase,
+* either into a new string or into a caller's reusable buffer.
 * This ensures consistency in indexing and searching operations.
 *
 * Author: Atziri Enriquez
@@ -49,3 +50,40 @@ char* normalizeWord(const char* word)
 
   return normalized;
 }
+
+/**************** normalizeWordInto ****************/
+/*
+* Converts a length-delimited word to lowercase in a reusable buffer.
+* See word.h for details.
+*/
+char* normalizeWordInto(const char* word, const size_t len, char** buf, size_t* bufSize)
+{
+  if (word == NULL || buf == NULL || bufSize == NULL) {
+    return NULL;  // Defensive check for NULL input
+  }
+
+  // Grow the buffer only when this word (plus its null) does not fit
+  if (*buf == NULL || *bufSize < len + 1) {
+    size_t size = (*bufSize == 0) ? 64 : *bufSize;
+    while (size < len + 1) {
+      size *= 2;
+    }
+    char* bigger = mem_malloc(size);
+    if (bigger == NULL) {
+      return NULL;  // Return NULL if allocation fails
+    }
+    if (*buf != NULL) {
+      mem_free(*buf);
+    }
+    *buf = bigger;
+    *bufSize = size;
+  }
+
+  char* normalized = *buf;
+  for (size_t i = 0; i < len; i++) {
+    normalized[i] = tolower((unsigned char) word[i]);  // Ensure safe casting
+  }
+  normalized[len] = '\0';  // Null-terminate the string
+
+  return normalized;
+}
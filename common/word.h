@@ -12,6 +12,7 @@
  #define __WORD_H
  
  #include <ctype.h>
+ #include <stddef.h>
  
  /**************** normalizeWord ****************/
  /*
@@ -31,5 +32,27 @@
   */
  char* normalizeWord(const char* word);
  
+ /**************** normalizeWordInto ****************/
+ /*
+  * Converts a length-delimited word to lowercase in a reusable buffer.
+  *
+  * Like normalizeWord, but the word need not be null-terminated (it may be
+  * a span inside a page) and nothing is allocated unless the buffer is too
+  * small, in which case it is grown (doubling) and *buf and *bufSize updated.
+  * Passing the same buffer on every call therefore allocates only a few
+  * times in total, however many words are normalized.
+  *
+  * Parameters:
+  *   - word: the first character of the word.
+  *   - len: the number of characters in the word.
+  *   - buf, bufSize: the caller's buffer and its size; *buf may start NULL
+  *     with *bufSize 0. The caller must eventually mem_free(*buf).
+  *
+  * Returns:
+  *   - *buf, holding the lowercase word and a terminating null.
+  *   - NULL if an argument is NULL or memory allocation fails.
+  */
+ char* normalizeWordInto(const char* word, const size_t len, char** buf, size_t* bufSize);
+ 
  #endif // __WORD_H
  
\ No newline at end of file
@@ -0,0 +1,402 @@
+/*
+ * checkpoint.c - CS50 TSE Crawler checkpoints
+ *
+ * see checkpoint.h for more information.
+ *
+ * A checkpoint is built in memory, then written with a single fwrite;
+ * it is read back whole and checked against its hash before anything is
+ * decoded, and decoding checks every length against the bytes left.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // fileno, fsync
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "checkpoint.h"
+#include "../libcs50/mem.h"
+#include "../libcs50/file.h"
+
+/**************** constants ****************/
+static const char MAGIC[8] = { 'T', 'S', 'E', 'C', 'K', 'P', 'T', '2' };
+static const char OLD_VERSION = '1';   // written before -d; read as -d off
+static const char* FILENAME = ".checkpoint";
+static const char* TMP_FILENAME = ".checkpoint.tmp";
+
+/**************** local types ****************/
+/* a growable byte buffer being encoded */
+typedef struct buffer {
+  unsigned char* data;
+  size_t len;
+  size_t cap;
+} buffer_t;
+
+/* a buffer being decoded */
+typedef struct reader {
+  const unsigned char* data;
+  size_t len;
+  size_t pos;
+} reader_t;
+
+/* 'arg' for the fingerprint-collecting callback */
+typedef struct fingerprints {
+  uint64_t* fps;
+  size_t count;
+  size_t cap;
+} fingerprints_t;
+
+/**************** local functions ****************/
+static char* checkpointPath(const char* pageDirectory, const char* filename);
+static void collectFingerprint(void* arg, const uint64_t fp);
+static void encodeQueued(void* arg, const char* url, const int depth, const int priority);
+static void putFingerprints(buffer_t* buf, fingerprints_t* set);
+static int compareFingerprints(const void* a, const void* b);
+static void buffer_reserve(buffer_t* buf, const size_t more);
+static void putBytes(buffer_t* buf, const void* bytes, const size_t len);
+static void putVarint(buffer_t* buf, uint64_t value);
+static bool getVarint(reader_t* in, uint64_t* value);
+static bool getInt(reader_t* in, int* value);
+static uint64_t fnv1a(const unsigned char* data, const size_t len);
+
+/**************** checkpoint_save ****************/
+/* see checkpoint.h for description */
+bool checkpoint_save(const char* pageDirectory, const checkpoint_t* info,
+                     urlset_t* seen, frontier_t* frontier, simindex_t* near)
+{
+  if (pageDirectory == NULL || info == NULL || info->seedURL == NULL
+      || seen == NULL || frontier == NULL || (near == NULL) != (info->nearDistance < 0)) {
+    return false;
+  }
+
+  buffer_t buf = { NULL, 0, 0 };
+  putBytes(&buf, MAGIC, sizeof(MAGIC));
+  size_t seedLen = strlen(info->seedURL);
+  putVarint(&buf, seedLen);
+  putBytes(&buf, info->seedURL, seedLen);
+  putVarint(&buf, info->maxDepth);
+  putVarint(&buf, info->policy);
+  putVarint(&buf, info->compress);
+  putVarint(&buf, info->numDocs);
+  putVarint(&buf, info->nearDistance + 1);
+
+  // the seen set, then the pages' fingerprints, if any
+  fingerprints_t set = { NULL, 0, urlset_count(seen) };
+  set.fps = mem_malloc_assert((set.cap + 1) * sizeof(uint64_t), "checkpoint fingerprints");   // never 0 bytes
+  urlset_iterate(seen, &set, collectFingerprint);
+  putFingerprints(&buf, &set);
+  mem_free(set.fps);
+  if (near != NULL) {
+    fingerprints_t pages = { NULL, 0, simindex_count(near) };
+    pages.fps = mem_malloc_assert((pages.cap + 1) * sizeof(uint64_t), "checkpoint fingerprints");
+    simindex_iterate(near, &pages, collectFingerprint);
+    putFingerprints(&buf, &pages);
+    mem_free(pages.fps);
+  }
+
+  // the frontier
+  putVarint(&buf, frontier_size(frontier));
+  frontier_iterate(frontier, &buf, encodeQueued);
+
+  unsigned char hash[8];
+  uint64_t h = fnv1a(buf.data, buf.len);
+  for (int i = 0; i < 8; i++) {
+    hash[i] = h >> (8 * i);
+  }
+  putBytes(&buf, hash, sizeof(hash));
+
+  // write the temporary file durably, then put it in place in one step
+  char* tmpPath = checkpointPath(pageDirectory, TMP_FILENAME);
+  char* path = checkpointPath(pageDirectory, FILENAME);
+  FILE* fp = fopen(tmpPath, "wb");
+  bool ok = fp != NULL
+    && fwrite(buf.data, 1, buf.len, fp) == buf.len
+    && fflush(fp) == 0
+    && fsync(fileno(fp)) == 0;
+  if (fp != NULL && fclose(fp) != 0) {
+    ok = false;
+  }
+  ok = ok && rename(tmpPath, path) == 0;
+  if (ok) {
+    int dirFd = open(pageDirectory, O_RDONLY);   // make the rename durable too
+    if (dirFd >= 0) {
+      fsync(dirFd);
+      close(dirFd);
+    }
+  } else {
+    remove(tmpPath);
+  }
+
+  mem_free(tmpPath);
+  mem_free(path);
+  mem_free(buf.data);
+  return ok;
+}
+
+/**************** checkpoint_load ****************/
+/* see checkpoint.h for description */
+bool checkpoint_load(const char* pageDirectory, checkpoint_t* info,
+                     urlset_t** seen, frontier_t** frontier, simindex_t** near)
+{
+  if (pageDirectory == NULL || info == NULL || seen == NULL || frontier == NULL || near == NULL) {
+    return false;
+  }
+
+  char* path = checkpointPath(pageDirectory, FILENAME);
+  FILE* file = fopen(path, "rb");
+  mem_free(path);
+  if (file == NULL) {
+    return false;
+  }
+  size_t len;
+  unsigned char* data = (unsigned char*) file_readFileLen(file, &len);
+  fclose(file);
+  if (data == NULL) {
+    return false;
+  }
+
+  // check the magic and the hash before trusting any of it
+  uint64_t h = 0;
+  if (len >= sizeof(MAGIC) + 8) {
+    for (int i = 0; i < 8; i++) {
+      h |= (uint64_t) data[len - 8 + i] << (8 * i);
+    }
+  }
+  if (len < sizeof(MAGIC) + 8 || memcmp(data, MAGIC, sizeof(MAGIC) - 1) != 0
+      || (data[sizeof(MAGIC) - 1] != MAGIC[sizeof(MAGIC) - 1] && data[sizeof(MAGIC) - 1] != OLD_VERSION)
+      || h != fnv1a(data, len - 8)) {
+    free(data);
+    return false;
+  }
+  reader_t in = { data, len - 8, sizeof(MAGIC) };
+
+  // the parameters
+  bool old = data[sizeof(MAGIC) - 1] == OLD_VERSION;
+  uint64_t seedLen, policy, compress, nearDistance = 0;
+  bool ok = getVarint(&in, &seedLen) && seedLen <= in.len - in.pos;
+  info->seedURL = NULL;
+  if (ok) {
+    info->seedURL = mem_malloc_assert(seedLen + 1, "checkpoint seedURL");
+    memcpy(info->seedURL, in.data + in.pos, seedLen);
+    info->seedURL[seedLen] = '\0';
+    in.pos += seedLen;
+  }
+  ok = ok && getInt(&in, &info->maxDepth)
+    && getVarint(&in, &policy) && policy <= FRONTIER_PRIORITY
+    && getVarint(&in, &compress) && compress <= 1
+    && getInt(&in, &info->numDocs)
+    && (old || (getVarint(&in, &nearDistance) && nearDistance <= SIMHASH_MAX_DISTANCE + 1));
+  if (ok) {
+    info->policy = policy;
+    info->compress = compress;
+    info->nearDistance = (int) nearDistance - 1;
+  }
+
+  // the seen set, the pages' fingerprints and the frontier
+  urlset_t* set = urlset_new();
+  frontier_t* queued = ok ? frontier_new(info->policy) : NULL;
+  simindex_t* pages = ok && info->nearDistance >= 0 ? simindex_new(info->nearDistance) : NULL;
+  mem_assert(set, "Out of memory: Failed to create seen-URL set.");
+  uint64_t count = 0, fp = 0;
+  ok = ok && queued != NULL && getVarint(&in, &count);
+  for (uint64_t i = 0; ok && i < count; i++) {
+    uint64_t delta;
+    ok = getVarint(&in, &delta) && delta != 0;
+    fp += delta;
+    ok = ok && urlset_insertFingerprint(set, fp);
+  }
+  if (ok && info->nearDistance >= 0) {
+    ok = pages != NULL && getVarint(&in, &count);
+    fp = 0;
+    for (uint64_t i = 0; ok && i < count; i++) {
+      uint64_t delta;
+      ok = getVarint(&in, &delta) && (delta != 0 || i == 0);
+      fp += delta;
+      ok = ok && simindex_insert(pages, fp);
+    }
+  }
+  ok = ok && getVarint(&in, &count);
+  for (uint64_t i = 0; ok && i < count; i++) {
+    int depth, priority;
+    uint64_t urlLen;
+    ok = getInt(&in, &depth) && getInt(&in, &priority)
+      && getVarint(&in, &urlLen) && urlLen <= in.len - in.pos;
+    if (ok) {
+      char* url = mem_malloc_assert(urlLen + 1, "checkpoint URL");
+      memcpy(url, in.data + in.pos, urlLen);
+      url[urlLen] = '\0';
+      in.pos += urlLen;
+      ok = frontier_insert(queued, url, depth, priority);
+      if (!ok) {
+        mem_free(url);
+      }
+    }
+  }
+  ok = ok && in.pos == in.len;
+  free(data);
+
+  if (!ok) {
+    checkpoint_free(info);
+    urlset_delete(set);
+    frontier_delete(queued);
+    simindex_delete(pages);
+    return false;
+  }
+  *seen = set;
+  *frontier = queued;
+  *near = pages;
+  return true;
+}
+
+/**************** checkpoint_remove ****************/
+/* see checkpoint.h for description */
+void checkpoint_remove(const char* pageDirectory)
+{
+  if (pageDirectory == NULL) {
+    return;
+  }
+  char* path = checkpointPath(pageDirectory, FILENAME);
+  remove(path);
+  mem_free(path);
+}
+
+/**************** checkpoint_free ****************/
+/* see checkpoint.h for description */
+void checkpoint_free(checkpoint_t* info)
+{
+  if (info != NULL) {
+    mem_free(info->seedURL);
+    info->seedURL = NULL;
+  }
+}
+
+/* Returns the malloc'd path of a file in the page directory */
+static char* checkpointPath(const char* pageDirectory, const char* filename)
+{
+  char* path = mem_malloc_assert(strlen(pageDirectory) + strlen(filename) + 2, "checkpoint path");
+  sprintf(path, "%s/%s", pageDirectory, filename);
+  return path;
+}
+
+/* urlset_iterate and simindex_iterate callback: appends a fingerprint to
+ * a fingerprints_t */
+static void collectFingerprint(void* arg, const uint64_t fp)
+{
+  fingerprints_t* set = arg;
+  if (set->count < set->cap) {
+    set->fps[set->count++] = fp;
+  }
+}
+
+/* frontier_iterate callback: encodes a queued URL into a buffer_t */
+static void encodeQueued(void* arg, const char* url, const int depth, const int priority)
+{
+  buffer_t* buf = arg;
+  size_t len = strlen(url);
+  putVarint(buf, depth);
+  putVarint(buf, priority);
+  putVarint(buf, len);
+  putBytes(buf, url, len);
+}
+
+/* Sorts fingerprints and encodes them: their number, then each one minus
+ * the one before, which is small for a large set */
+static void putFingerprints(buffer_t* buf, fingerprints_t* set)
+{
+  qsort(set->fps, set->count, sizeof(uint64_t), compareFingerprints);
+  putVarint(buf, set->count);
+  uint64_t prev = 0;
+  for (size_t i = 0; i < set->count; i++) {
+    putVarint(buf, set->fps[i] - prev);
+    prev = set->fps[i];
+  }
+}
+
+/* qsort comparator for fingerprints */
+static int compareFingerprints(const void* a, const void* b)
+{
+  uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+  return (x > y) - (x < y);
+}
+
+/* Makes room for `more` bytes at the end of a buffer */
+static void buffer_reserve(buffer_t* buf, const size_t more)
+{
+  if (buf->cap - buf->len >= more) {
+    return;
+  }
+  size_t cap = buf->cap == 0 ? 4096 : 2 * buf->cap;
+  while (cap - buf->len < more) {
+    cap *= 2;
+  }
+  unsigned char* data = mem_malloc_assert(cap, "checkpoint buffer");
+  if (buf->len > 0) {
+    memcpy(data, buf->data, buf->len);
+  }
+  mem_free(buf->data);
+  buf->data = data;
+  buf->cap = cap;
+}
+
+/* Appends len bytes to a buffer */
+static void putBytes(buffer_t* buf, const void* bytes, const size_t len)
+{
+  buffer_reserve(buf, len);
+  memcpy(buf->data + buf->len, bytes, len);
+  buf->len += len;
+}
+
+/* Appends an unsigned LEB128 varint to a buffer */
+static void putVarint(buffer_t* buf, uint64_t value)
+{
+  buffer_reserve(buf, 10);
+  while (value >= 0x80) {
+    buf->data[buf->len++] = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+  buf->data[buf->len++] = value;
+}
+
+/* Reads an unsigned LEB128 varint; false if it runs past the end */
+static bool getVarint(reader_t* in, uint64_t* value)
+{
+  uint64_t v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (in->pos >= in->len) {
+      return false;
+    }
+    unsigned char b = in->data[in->pos++];
+    v |= (uint64_t) (b & 0x7f) << shift;
+    if ((b & 0x80) == 0) {
+      *value = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Reads a varint that must fit a non-negative int */
+static bool getInt(reader_t* in, int* value)
+{
+  uint64_t v;
+  if (!getVarint(in, &v) || v > INT_MAX) {
+    return false;
+  }
+  *value = v;
+  return true;
+}
+
+/* Returns the 64-bit FNV-1a hash of len bytes */
+static uint64_t fnv1a(const unsigned char* data, const size_t len)
+{
+  uint64_t h = 14695981039346656037u;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ data[i]) * 1099511628211u;
+  }
+  return h;
+}
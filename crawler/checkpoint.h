@@ -0,0 +1,105 @@
+/*
+ * checkpoint.h - CS50 TSE Crawler checkpoints
+ *
+ * A checkpoint is everything a crawl keeps only in memory, written to
+ * `pageDirectory/.checkpoint` next to the `.crawler` marker so that
+ * `crawler --resume` can carry on where a crawl stopped: the crawl's
+ * parameters, how many pages it had saved, the set of seen URLs (as
+ * sorted 64-bit fingerprints, delta-encoded), with -d the SimHash of
+ * every page saved (see simhash.h), and every queued URL with its depth
+ * and priority.
+ *
+ * A checkpoint describes a moment when no page was being fetched, so the
+ * pages saved, the URLs seen and the URLs queued agree with each other.
+ * It is written to a temporary file, synced and renamed over the old one;
+ * a crash while saving leaves the previous checkpoint intact.
+ *
+ * File format (integers are unsigned LEB128 varints unless noted):
+ *   "TSECKPT2"                      8-byte magic and version
+ *   seedURL length, seedURL bytes
+ *   maxDepth, policy, compress, numDocs, nearDistance + 1 (0 without -d)
+ *   number of fingerprints, then each one minus the one before, ascending
+ *   with -d, the pages' SimHashes, encoded the same way
+ *   number of queued URLs, then for each: depth, priority, length, bytes
+ *   FNV-1a hash of everything above  8 bytes, little-endian
+ *
+ * Version 1 checkpoints, which lack the SimHash fields, are still read,
+ * as crawls without -d.
+ *
+ * Functions:
+ *  - `checkpoint_save`: Writes a checkpoint of a crawl.
+ *  - `checkpoint_load`: Reads it back into a new set and frontier.
+ *  - `checkpoint_remove`: Removes the checkpoint of a finished crawl.
+ *  - `checkpoint_free`: Frees the strings of a loaded checkpoint.
+ *
+ * Assumptions:
+ *  - Neither the sets nor the frontier change while a checkpoint is saved.
+ *  - Queued URLs come back in their order for FRONTIER_BFS and per host
+ *    for FRONTIER_HOST; FRONTIER_PRIORITY may reorder URLs of equal priority.
+ *
+ * Error Handling:
+ *  - `checkpoint_save` and `checkpoint_load` return false on I/O errors
+ *    or (when loading) a missing, truncated or corrupt file.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __CHECKPOINT_H
+#define __CHECKPOINT_H
+
+#include <stdbool.h>
+#include "frontier.h"
+#include "simhash.h"
+#include "urlset.h"
+
+/* A crawl's parameters and progress; a plain struct */
+typedef struct checkpoint {
+  char* seedURL;              // malloc'd when loaded
+  int maxDepth;
+  frontier_policy_t policy;
+  bool compress;              // -z
+  int numDocs;                // pages saved so far, docIDs 1..numDocs
+  int nearDistance;           // -d, or -1 if near-duplicates are kept
+} checkpoint_t;
+
+/**
+ * Writes a checkpoint of a crawl, replacing any earlier one.
+ *
+ * @param pageDirectory The crawl's page directory.
+ * @param info The crawl's parameters and progress.
+ * @param seen The set of seen URLs.
+ * @param frontier The queued URLs.
+ * @param near The saved pages' fingerprints; NULL exactly when
+ *             info->nearDistance is -1.
+ * @return true once the checkpoint is on disk; false on error.
+ */
+bool checkpoint_save(const char* pageDirectory, const checkpoint_t* info,
+                     urlset_t* seen, frontier_t* frontier, simindex_t* near);
+
+/**
+ * Reads a crawl's checkpoint.
+ *
+ * @param pageDirectory The crawl's page directory.
+ * @param info Where to store the parameters and progress; free with
+ *             `checkpoint_free`.
+ * @param seen Where to store a new set of the seen URLs.
+ * @param frontier Where to store a new frontier of the queued URLs.
+ * @param near Where to store a new index of the saved pages'
+ *             fingerprints, or NULL if info->nearDistance is -1.
+ * @return true on success; false (having created nothing) on error.
+ */
+bool checkpoint_load(const char* pageDirectory, checkpoint_t* info,
+                     urlset_t** seen, frontier_t** frontier, simindex_t** near);
+
+/**
+ * Removes a page directory's checkpoint, if it has one.
+ */
+void checkpoint_remove(const char* pageDirectory);
+
+/**
+ * Frees the strings of a checkpoint filled in by `checkpoint_load`.
+ */
+void checkpoint_free(checkpoint_t* info);
+
+#endif // __CHECKPOINT_H
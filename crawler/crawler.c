@@ -2,28 +2,99 @@
  * crawler.c - CS50 TSE Crawler
  * 
  * A simple web crawler that starts at a given seed URL, follows links to a specified depth, 
- * and saves fetched pages into a directory. It maintains a bag of URLs to be processed 
- * and a hashtable of seen URLs to avoid duplicates.
+ * and saves fetched pages into a directory. It maintains a frontier of URLs to be processed 
+ * and a set of seen URLs to avoid duplicates. `-f policy` picks the order in which the
+ * frontier hands out URLs: breadth-first (the default), round-robin by host, or priority.
+ *
+ * With `-j N`, N worker threads share the frontier and the set. A per-host
+ * politeness scheduler keeps the one-second delay between requests to any
+ * single server, so pages on different servers are fetched in parallel.
+ *
+ * Every `-c N` pages (1000 by default), and when interrupted by SIGINT or
+ * SIGTERM, the crawler checkpoints its seen set and frontier into the page
+ * directory (see checkpoint.h); `--resume pageDirectory` carries on from
+ * the last checkpoint, keeping the pages saved before it.
+ *
+ * With `-d maxDistance`, a page whose SimHash (see simhash.h) is within
+ * maxDistance bits of a page already saved is a near-duplicate, such as a
+ * mirror or a parameter variant, and is neither saved nor scanned.
+ *
+ * With `--stats`, the crawler times its fetches, its waits for a host's
+ * turn and its page saves (see stats.h), and prints a summary of them to
+ * stderr when it exits.
  *
  * Author: Atziri Enriquez
  * Date: 2/7/25
  */
+ #define _POSIX_C_SOURCE 200809L  // pthreads, sigaction
  #include <stdio.h>
  #include <stdlib.h>
  #include <string.h>
  #include <stdbool.h>
- #include "../common/pagedir.h" // for pagedir_init and pagedir_save
- #include "../libcs50/bag.h"
- #include "../libcs50/hashtable.h"
+ #include <signal.h>
+ #include <pthread.h>
+ #include "checkpoint.h"
+ #include "frontier.h"
+ #include "politeness.h"
+ #include "simhash.h"
+ #include "urlset.h"
+ #include "../common/pagedir.h" // for pagedir_init and the segment writer
+ #include "../common/stats.h"
  #include "../libcs50/webpage.h"
  #include "../libcs50/mem.h" // Defensive programming helpers
+
+ /**************** constants ****************/
+ static const int MAX_WORKERS = 64;   // upper bound for -j
+ static const int DEFAULT_CHECKPOINT_PAGES = 1000;   // -c
+
+ /**************** local types ****************/
+ /* The command line, parsed */
+ typedef struct crawlerArgs {
+     char* seedURL;              // normalized; NULL with --resume
+     char* pageDirectory;
+     int maxDepth;
+     int numWorkers;             // -j
+     frontier_policy_t policy;   // -f
+     bool compress;              // -z
+     int checkpointPages;        // -c; 0 checkpoints only when interrupted
+     int nearDistance;           // -d; -1 keeps near-duplicates
+     bool resume;                // --resume
+     bool stats;                 // --stats
+ } crawlerArgs_t;
+
+ /* State shared by all crawler worker threads */
+ typedef struct crawler {
+     frontier_t* pagesToCrawl;   // URLs waiting to be fetched
+     urlset_t* pagesSeen;        // every URL ever added to pagesToCrawl (has its own locks)
+     simindex_t* pagesKept;      // with -d, the SimHash of every page saved (has its own lock); else NULL
+     pthread_mutex_t lock;       // protects pagesToCrawl, active, checkpointDue, storeFailed and nearSkipped
+     pthread_cond_t changed;     // signalled when pages are added or a worker goes idle
+     int active;                 // number of workers holding a page
+     politeness_t* politeness;   // per-host request spacing
+     pagewriter_t* store;        // appends fetched pages to the segments; hands out docIDs
+     const char* pageDirectory;
+     checkpoint_t info;          // seed URL, maxDepth (do not scan pages at that depth), -f, -z, -d
+     int checkpointPages;        // checkpoint after every this many pages; 0 never
+     bool checkpointDue;         // take a checkpoint once no worker holds a page
+     bool storeFailed;           // a page could not be saved; the crawl stops
+     int nearSkipped;            // pages skipped as near-duplicates by this run
+ } crawler_t;
  
+ /**************** file-local global variables ****************/
+ static volatile sig_atomic_t stopping = 0;  // set by SIGINT, SIGTERM or a failed save
+
  /**************** function prototypes ****************/
- static void parseArgs(const int argc, char* argv[], char** seedURL, char** pageDirectory, int* maxDepth);
- static void crawl(char* seedURL, char* pageDirectory, const int maxDepth);
- static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen);
+ static void parseArgs(const int argc, char* argv[], crawlerArgs_t* args);
+ static bool crawl(const crawlerArgs_t* args);
+ static void onSignal(int sig);
+ static void* crawlWorker(void* arg);
+ static webpage_t* nextPage(crawler_t* crawler);
+ static void takeCheckpoint(crawler_t* crawler);
+ static bool isNearDuplicate(webpage_t* page, crawler_t* crawler);
+ static void pageScan(webpage_t* page, crawler_t* crawler);
+ static int pagePriority(const char* url, const int depth);
  
- /**************** main() ****************/
+/**************** main() ****************/
  /*
   * main - Entry point for the crawler program.
   * 
@@ -34,22 +105,19 @@
   *   argv - array of command-line arguments
   *
   * Returns:
-  *   0 if execution is successful.
+  *   0 if execution is successful, 1 if a page could not be saved.
   *   Exits with error codes if command-line arguments are invalid.
   */
 int main(const int argc, char* argv[]) {
-  // Variables to hold user inputs
-  char* seedURL;
-  char* pageDirectory;
-  int maxDepth;
-
   // Parse and validate arguments
-  parseArgs(argc, argv, &seedURL, &pageDirectory, &maxDepth);
-
-  // Start crawling
-  crawl(seedURL, pageDirectory, maxDepth);
+  crawlerArgs_t args;
+  parseArgs(argc, argv, &args);
+  if (args.stats && !stats_enable()) {
+    fprintf(stderr, "Warning: --stats reports nothing; the crawler was built with -DNOSTATS.\n");
+  }
 
-  return 0;
+  // Start (or resume) crawling
+  return crawl(&args) ? 0 : 1;
 }
 
 /**************** parseArgs() ****************/
@@ -59,48 +127,143 @@ int main(const int argc, char* argv[]) {
   * Parameters:
   *   argc - the number of command-line arguments
   *   argv - array of command-line arguments
-  *   seedURL - pointer to store the validated seed URL
-  *   pageDirectory - pointer to store the validated directory
-  *   maxDepth - pointer to store the parsed max depth
+  *   args - where to store the validated arguments
   *
   * Returns:
   *   None. Exits with an error message if arguments are invalid.
   *
   * Assumptions:
-  *   - The user provides exactly three arguments: seed URL, directory, and max depth.
+  *   - The user provides three arguments: seed URL, directory, and max depth,
+  *     optionally preceded by `-j numWorkers` (default 1),
+  *     `-f bfs|host|priority` (default bfs), `-z` (compress pages),
+  *     `-c checkpointPages` (default 1000; 0 checkpoints only when interrupted)
+  *     `-d maxDistance` (0 to 7; skip near-duplicate pages) and `--stats`
+  *     (time the crawl's steps).
+  *   - Or, with `--resume`, just the directory of a stopped crawl; its seed
+  *     URL, depth, policy, compression and near-duplicate distance come
+  *     from its checkpoint, so only -j, -c and --stats may be given.
   *   - The seed URL is normalized and must be an internal URL.
   *   - The directory is writable and prepared for storing crawled pages.
   *   - The depth must be between 0 and 10.
   */
-static void parseArgs(const int argc, char* argv[], char** seedURL, char** pageDirectory, int* maxDepth) {
+static void parseArgs(const int argc, char* argv[], crawlerArgs_t* args) {
+    const char* usage = "Usage: ./crawler [-j numWorkers] [-f bfs|host|priority] [-z] [-c checkpointPages] [-d maxDistance] [--stats]"
+                        " seedURL pageDirectory maxDepth\n"
+                        "       ./crawler [-j numWorkers] [-c checkpointPages] [--stats] --resume pageDirectory\n";
+    int arg = 1;
+    bool policyGiven = false;
+    args->seedURL = NULL;
+    args->maxDepth = 0;
+    args->numWorkers = 1;
+    args->policy = FRONTIER_BFS;
+    args->compress = false;
+    args->checkpointPages = DEFAULT_CHECKPOINT_PAGES;
+    args->nearDistance = -1;
+    args->resume = false;
+    args->stats = false;
+
+    // Parse options; each but -z, --resume and --stats takes one value
+    while (arg < argc && argv[arg][0] == '-') {
+        if (strcmp(argv[arg], "-z") == 0) {
+            args->compress = true;
+            arg++;
+            continue;
+        }
+        if (strcmp(argv[arg], "--resume") == 0) {
+            args->resume = true;
+            arg++;
+            continue;
+        }
+        if (strcmp(argv[arg], "--stats") == 0) {
+            args->stats = true;
+            arg++;
+            continue;
+        }
+        if (arg + 1 >= argc) {
+            fprintf(stderr, "%s", usage);
+            exit(1);
+        }
+        if (strcmp(argv[arg], "-j") == 0) {
+            args->numWorkers = atoi(argv[arg + 1]);
+            if (args->numWorkers < 1 || args->numWorkers > MAX_WORKERS) {
+                fprintf(stderr, "Error: numWorkers must be between 1 and %d.\n", MAX_WORKERS);
+                exit(1);
+            }
+        } else if (strcmp(argv[arg], "-f") == 0) {
+            if (!frontier_parsePolicy(argv[arg + 1], &args->policy)) {
+                fprintf(stderr, "Error: frontier policy must be bfs, host or priority.\n");
+                exit(1);
+            }
+            policyGiven = true;
+        } else if (strcmp(argv[arg], "-c") == 0) {
+            char* end;
+            long pages = strtol(argv[arg + 1], &end, 10);
+            if (end == argv[arg + 1] || *end != '\0' || pages < 0 || pages > 1000000000) {
+                fprintf(stderr, "Error: checkpointPages must be a number of pages, or 0.\n");
+                exit(1);
+            }
+            args->checkpointPages = pages;
+        } else if (strcmp(argv[arg], "-d") == 0) {
+            char* end;
+            long distance = strtol(argv[arg + 1], &end, 10);
+            if (end == argv[arg + 1] || *end != '\0' || distance < 0 || distance > SIMHASH_MAX_DISTANCE) {
+                fprintf(stderr, "Error: maxDistance must be between 0 and %d bits.\n", SIMHASH_MAX_DISTANCE);
+                exit(1);
+            }
+            args->nearDistance = distance;
+        } else {
+            fprintf(stderr, "%s", usage);
+            exit(1);
+        }
+        arg += 2;
+    }
+
+    // A resumed crawl takes everything else from its checkpoint
+    if (args->resume) {
+        if (argc - arg != 1) {
+            fprintf(stderr, "%s", usage);
+            exit(1);
+        }
+        if (policyGiven || args->compress || args->nearDistance >= 0) {
+            fprintf(stderr, "Error: a resumed crawl keeps its own -f, -z and -d.\n");
+            exit(1);
+        }
+        args->pageDirectory = argv[arg];
+        if (!pagedir_validate(args->pageDirectory)) {
+            fprintf(stderr, "Error: %s is not a crawler directory.\n", args->pageDirectory);
+            exit(1);
+        }
+        return;
+    }
+
     // Check argument count
-    if (argc != 4) {
-        fprintf(stderr, "Usage: ./crawler seedURL pageDirectory maxDepth\n");
+    if (argc - arg != 3) {
+        fprintf(stderr, "%s", usage);
         exit(1);
     }
 
     // Assign arguments
-    *seedURL = argv[1];
-    *pageDirectory = argv[2];
-    *maxDepth = atoi(argv[3]); // Convert depth to integer
+    args->seedURL = argv[arg];
+    args->pageDirectory = argv[arg + 1];
+    args->maxDepth = atoi(argv[arg + 2]); // Convert depth to integer
 
     // Validate seedURL
-    *seedURL = normalizeURL(*seedURL);
-    mem_assert(*seedURL, "Error: Invalid seedURL.");
+    args->seedURL = normalizeURL(args->seedURL);
+    mem_assert(args->seedURL, "Error: Invalid seedURL.");
 
-    if (!isInternalURL(*seedURL)) {
+    if (!isInternalURL(args->seedURL)) {
         fprintf(stderr, "Error: seedURL must be an internal URL.\n");
         exit(1);
     }
 
     // Make sure you can initialize pageDirectory
-    if (!pagedir_init(*pageDirectory)) {
+    if (!pagedir_init(args->pageDirectory)) {
         fprintf(stderr, "Error: Cannot initialize pageDirectory.\n");
         exit(1);
     }
 
     // Validate maxDepth
-    if (*maxDepth < 0 || *maxDepth > 10) {
+    if (args->maxDepth < 0 || args->maxDepth > 10) {
         fprintf(stderr, "Error: maxDepth must be between 0 and 10.\n");
         exit(1);
     }
@@ -111,62 +274,340 @@ static void parseArgs(const int argc, char* argv[], char** seedURL, char** pageD
   * crawl - Main crawling function that follows links up to a given depth.
   *
   * Parameters:
-  *   seedURL - the starting webpage URL
-  *   pageDirectory - directory to store fetched pages
-  *   maxDepth - the maximum depth to crawl
+  *   args - the seed URL, page directory and depth, and the options: the
+  *          number of worker threads, the frontier policy, whether to
+  *          compress each saved page's HTML, how often to checkpoint and
+  *          how close a page may come to a saved one before it is skipped;
+  *          or the directory of a crawl to resume
   *
   * Returns:
   *   None.
   *
   * Assumptions:
   *   - The function starts with the seed URL and processes each discovered URL.
-  *   - Pages are saved sequentially in the directory.
-  *   - The crawler stops when the max depth is reached.
+  *   - Pages are saved with docIDs 1, 2, 3, ... in the order their fetches complete,
+  *     packed into segment files with an offset index (see pagedir.h), and
+  *     with -z their HTML compressed.
+  *   - A resumed crawl restores the seen set, frontier and page fingerprints
+  *     of its last checkpoint, drops any pages saved after it, and goes on numbering
+  *     from there.
+  *   - The crawler stops when the frontier is empty and no worker can add to it,
+  *     and then removes its checkpoint; on SIGINT or SIGTERM it lets the
+  *     workers finish the pages they hold, checkpoints and stops.
+  *   - It also stops as soon as a page cannot be saved: a write error fails
+  *     every later append too, so fetching on would only throw pages away.
+  *     The last checkpoint is then kept, since it records only pages that
+  *     were saved, and the crawl can be resumed from it.
   *   - Memory is properly allocated and freed.
+  *
+  * Returns:
+  *   true if every fetched page was saved.
   */
-static void crawl(char* seedURL, char* pageDirectory, const int maxDepth) {
-    hashtable_t* pagesSeen = hashtable_new(200);
-    mem_assert(pagesSeen, "Out of memory: Failed to create hashtable.");
-    hashtable_insert(pagesSeen, seedURL, ""); // Add seed URL to hashtable
+static bool crawl(const crawlerArgs_t* args) {
+    crawler_t crawler;
+    crawler.pageDirectory = args->pageDirectory;
+    crawler.checkpointPages = args->checkpointPages;
+    crawler.checkpointDue = false;
+    crawler.storeFailed = false;
+    crawler.nearSkipped = 0;
 
-    bag_t* pagesToCrawl = bag_new();
-    mem_assert(pagesToCrawl, "Out of memory: Failed to create bag.");
+    if (args->resume) {
+        // Pick up the seen set and frontier where the last checkpoint left them
+        if (!checkpoint_load(args->pageDirectory, &crawler.info, &crawler.pagesSeen, &crawler.pagesToCrawl,
+                             &crawler.pagesKept)) {
+            fprintf(stderr, "Error: %s has no usable checkpoint to resume from.\n", args->pageDirectory);
+            exit(1);
+        }
+        crawler.store = pagedir_resumeWriter(args->pageDirectory, crawler.info.compress, crawler.info.numDocs);
+        fprintf(stderr, "Resuming the crawl of %s after %d pages, with %zu URLs queued\n",
+                crawler.info.seedURL, crawler.info.numDocs, frontier_size(crawler.pagesToCrawl));
+    } else {
+        crawler.info.seedURL = mem_malloc_assert(strlen(args->seedURL) + 1, "crawler seedURL");
+        strcpy(crawler.info.seedURL, args->seedURL); // the frontier owns args->seedURL
+        crawler.info.maxDepth = args->maxDepth;
+        crawler.info.policy = args->policy;
+        crawler.info.compress = args->compress;
+        crawler.info.numDocs = 0;
+        crawler.info.nearDistance = args->nearDistance;
 
-    webpage_t* seedPage = webpage_new(seedURL, 0, NULL);
-    mem_assert(seedPage, "Out of memory: Failed to allocate webpage.");
-    bag_insert(pagesToCrawl, seedPage); // initialize the bag and add a webpage representing the seedURL at depth 0
+        crawler.pagesSeen = urlset_new();
+        mem_assert(crawler.pagesSeen, "Out of memory: Failed to create seen-URL set.");
+        urlset_insert(crawler.pagesSeen, args->seedURL); // Add seed URL to the set
 
-    int docID = 1; //docID starts at one
+        crawler.pagesToCrawl = frontier_new(args->policy);
+        mem_assert(crawler.pagesToCrawl, "Out of memory: Failed to create frontier.");
+        frontier_insert(crawler.pagesToCrawl, args->seedURL, 0, pagePriority(args->seedURL, 0)); // the seedURL, at depth 0
+
+        crawler.pagesKept = NULL;
+        if (args->nearDistance >= 0) {
+            crawler.pagesKept = simindex_new(args->nearDistance);
+            mem_assert(crawler.pagesKept, "Out of memory: Failed to create page fingerprint index.");
+        }
+
+        checkpoint_remove(args->pageDirectory); // any stale one describes pages about to be overwritten
+        crawler.store = pagedir_openWriter(args->pageDirectory, args->compress); // docIDs start at one
+    }
+    if (crawler.store == NULL) {
+        fprintf(stderr, "Error: cannot write pages to %s.\n", args->pageDirectory);
+        exit(1);
+    }
+
+#ifndef NOSLEEP
+    crawler.politeness = politeness_new(1.0); // one second between fetches from any one host
+#else
+    crawler.politeness = politeness_new(0.0);
+#endif
+    mem_assert(crawler.politeness, "Out of memory: Failed to create politeness scheduler.");
+
+    pthread_mutex_init(&crawler.lock, NULL);
+    pthread_cond_init(&crawler.changed, NULL);
+    crawler.active = 0;
+
+    // Stop cleanly on SIGINT or SIGTERM. The workers block both, so the
+    // signal interrupts only this thread's wait for them, never a fetch.
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigset_t signals, previous;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, &previous);
+
+    // Process webpages until the frontier is empty and every worker is idle
+    pthread_t* workers = mem_malloc_assert(args->numWorkers * sizeof(pthread_t), "crawler threads");
+    for (int i = 0; i < args->numWorkers; i++) {
+        if (pthread_create(&workers[i], NULL, crawlWorker, &crawler) != 0) {
+            fprintf(stderr, "Error: cannot create crawler thread.\n");
+            exit(1);
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    for (int i = 0; i < args->numWorkers; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    mem_free(workers);
+
+    if (crawler.pagesKept != NULL) {
+        fprintf(stderr, "Near-duplicates: %d pages skipped; %zu page fingerprints in %zu bytes\n",
+                crawler.nearSkipped, simindex_count(crawler.pagesKept), simindex_bytes(crawler.pagesKept));
+    }
+
+    // Keep a checkpoint only if the crawl was cut short. After a failed save
+    // the last one is left as it is: a new one would count the lost page.
+    if (stopping && !crawler.storeFailed) {
+        takeCheckpoint(&crawler);
+        fprintf(stderr, "Crawl stopped; continue it with: ./crawler --resume %s\n", args->pageDirectory);
+    }
+
+    // Clean up data structures
+    bool saved = pagedir_closeWriter(crawler.store) && !crawler.storeFailed;
+    if (!saved) {
+        fprintf(stderr, "Error: some pages could not be saved to %s; the crawl was stopped.\n", args->pageDirectory);
+    } else if (!stopping) {
+        checkpoint_remove(args->pageDirectory);
+    }
+    webpage_closeConnections();
+    pthread_cond_destroy(&crawler.changed);
+    pthread_mutex_destroy(&crawler.lock);
+    politeness_delete(crawler.politeness);
+    urlset_delete(crawler.pagesSeen);
+    simindex_delete(crawler.pagesKept);
+    frontier_delete(crawler.pagesToCrawl);
+    checkpoint_free(&crawler.info);
+    return saved;
+}
+
+/**************** onSignal() ****************/
+/*
+  * onSignal - SIGINT and SIGTERM handler: asks the crawl to stop.
+  *
+  * A second signal is not caught, so it ends the program at once.
+  */
+static void onSignal(int sig) {
+    stopping = 1;
+    signal(sig, SIG_DFL);
+}
+
+/**************** crawlWorker() ****************/
+/*
+  * crawlWorker - Body of one crawler thread.
+  *
+  * Repeatedly takes a page from the frontier, waits for its host's turn,
+  * fetches and saves it, and scans it for more links. With -d, a fetched
+  * page that is a near-duplicate of a saved one is dropped instead.
+  *
+  * Parameters:
+  *   arg - the shared crawler_t
+  *
+  * Returns:
+  *   NULL, once there is no more work for any worker.
+  */
+static void* crawlWorker(void* arg) {
+    crawler_t* crawler = arg;
     webpage_t* page;
-    // Process webpages until the bag is empty
-    while ((page = bag_extract(pagesToCrawl)) != NULL) {
+
+    while ((page = nextPage(crawler)) != NULL) {
         int depth = webpage_getDepth(page);
-        // Fetch the webpage content
-        if (webpage_fetch(page)) {
+        int docID = -1;
+        bool skipped = false;
+        bool saved = true;
+        // Fetch the webpage content, no sooner than its host allows,
+        // reusing an open connection to that host if there is one
+        STATS_START(waitStart);
+        politeness_wait(crawler->politeness, webpage_getURL(page));
+        STATS_STOP(STATS_POLITENESS_WAIT, waitStart);
+        STATS_START(fetchStart);
+        bool fetched = webpage_fetchPooled(page);
+        STATS_STOP(STATS_WEBPAGE_FETCH, fetchStart);
+        STATS_COUNT(fetched ? STATS_FETCH_BYTES : STATS_FETCH_FAILURES,
+                    fetched ? strlen(webpage_getHTML(page)) : 1);
+        if (fetched) {
             printf("%d   Fetched: %s\n", depth, webpage_getURL(page));
-            // Save the fetched webpage to the directory
-            pagedir_save(page, pageDirectory, docID++);
+
+            if (isNearDuplicate(page, crawler)) {
+                printf("%d    IgnNear: %s\n", depth, webpage_getURL(page));
+                skipped = true;
+            } else {
+                // Save the fetched webpage; the store hands out the next docID
+                docID = pagedir_append(crawler->store, page);
+                saved = docID > 0;
+            }
+
             // If not at max depth, scan the page for more links
-            if (depth < maxDepth) {
+            if (!skipped && saved && depth < crawler->info.maxDepth) {
                 printf("%d  Scanning: %s\n", depth, webpage_getURL(page));
-                pageScan(page, pagesToCrawl, pagesSeen);
+                pageScan(page, crawler);
             }
         }
         // Free the webpage memory
         webpage_delete(page);
+
+        // This worker is idle again; wake anyone waiting to see whether we
+        // are done, or for a quiet moment to checkpoint in
+        pthread_mutex_lock(&crawler->lock);
+        crawler->active--;
+        if (!saved) {
+            crawler->storeFailed = true;
+            stopping = 1;
+        }
+        if (skipped) {
+            crawler->nearSkipped++;
+        }
+        if (crawler->checkpointPages > 0 && docID > 0 && docID % crawler->checkpointPages == 0) {
+            crawler->checkpointDue = true;
+        }
+        pthread_cond_broadcast(&crawler->changed);
+        pthread_mutex_unlock(&crawler->lock);
     }
-    // Clean up data structures
-    hashtable_delete(pagesSeen, NULL);
-    bag_delete(pagesToCrawl, webpage_delete);
+    return NULL;
 }
+
+/**************** nextPage() ****************/
+/*
+  * nextPage - Takes the next page to crawl from the frontier.
+  *
+  * Blocks while the frontier is empty but another worker may still add to it.
+  * When a checkpoint is due, blocks until no worker holds a page, so that
+  * no URL is half-crawled, and the first worker to get there takes it.
+  *
+  * Parameters:
+  *   crawler - the shared crawler state
+  *
+  * Returns:
+  *   a page, which the caller must later webpage_delete(), having
+  *   counted itself as active; or NULL when the crawl is finished or stopping.
+  */
+static webpage_t* nextPage(crawler_t* crawler) {
+    pthread_mutex_lock(&crawler->lock);
+    char* url = NULL;
+    int depth;
+    while (!stopping) {
+        if (crawler->checkpointDue && crawler->active == 0) {
+            takeCheckpoint(crawler);
+            crawler->checkpointDue = false;
+            pthread_cond_broadcast(&crawler->changed);
+        }
+        if (!crawler->checkpointDue
+            && ((url = frontier_extract(crawler->pagesToCrawl, &depth)) != NULL || crawler->active == 0)) {
+            break;
+        }
+        pthread_cond_wait(&crawler->changed, &crawler->lock);
+    }
+    if (url != NULL) {
+        crawler->active++;
+    }
+    pthread_mutex_unlock(&crawler->lock);
+
+    if (url == NULL) {
+        return NULL;
+    }
+    webpage_t* page = webpage_new(url, depth, NULL);
+    mem_assert(page, "Out of memory: Failed to allocate webpage.");
+    return page;
+}
+
+/**************** takeCheckpoint() ****************/
+/*
+  * takeCheckpoint - Saves the crawl's state to its page directory.
+  *
+  * The saved pages are synced first, so that the checkpoint never counts
+  * a page that is not on disk.
+  *
+  * Parameters:
+  *   crawler - the shared crawler state; no worker may hold a page, and
+  *             the caller holds the lock or is the only thread left
+  */
+static void takeCheckpoint(crawler_t* crawler) {
+    crawler->info.numDocs = pagedir_writtenDocs(crawler->store);
+    if (pagedir_flushWriter(crawler->store)
+        && checkpoint_save(crawler->pageDirectory, &crawler->info, crawler->pagesSeen, crawler->pagesToCrawl,
+                           crawler->pagesKept)) {
+        fprintf(stderr, "Checkpoint: %d pages saved, %zu URLs queued\n",
+                crawler->info.numDocs, frontier_size(crawler->pagesToCrawl));
+    } else {
+        fprintf(stderr, "Error: cannot write a checkpoint to %s.\n", crawler->pageDirectory);
+    }
+}
+
+/**************** isNearDuplicate() ****************/
+/*
+  * isNearDuplicate - Checks a fetched page against the pages already saved.
+  *
+  * Parameters:
+  *   page - a page just fetched
+  *   crawler - the shared crawler state
+  *
+  * Returns:
+  *   true if the crawl was given -d and the page's SimHash is within
+  *   maxDistance bits of a saved page's; otherwise false, having added
+  *   the page's SimHash, so the caller must save the page.
+  *
+  * Assumptions:
+  *   - Pages with no words are never near-duplicates.
+  *   - The check and the insert are one step, so of two near pages
+  *     fetched at once by different workers, exactly one is kept.
+  */
+static bool isNearDuplicate(webpage_t* page, crawler_t* crawler) {
+    uint64_t fp;
+    char* html = webpage_getHTML(page);
+    if (crawler->pagesKept == NULL || html == NULL || !simhash_page(html, strlen(html), &fp)) {
+        return false;
+    }
+    return !simindex_insert(crawler->pagesKept, fp);
+}
+
 /**************** pageScan() ****************/
 /*
   * pageScan - Extracts links from a given webpage and adds them to the crawl list.
   *
   * Parameters:
   *   page - the current webpage being processed
-  *   pagesToCrawl - bag to store new URLs to be visited
-  *   pagesSeen - hashtable to track already visited URLs
+  *   crawler - the shared crawler state, holding the frontier of URLs to be
+  *             visited and the set of already-seen URLs
   *
   * Returns:
   *   None.
@@ -175,9 +616,9 @@ static void crawl(char* seedURL, char* pageDirectory, const int maxDepth) {
   *   - The given webpage has already been fetched successfully.
   *   - Only internal URLs are considered.
   *   - URLs are normalized before being stored.
-  *   - URLs are added to the bag only if they haven't been seen before.
+  *   - URLs are added to the frontier only if they haven't been seen before.
   */
-static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen) {
+static void pageScan(webpage_t* page, crawler_t* crawler) {
     int pos = 0;
     char* nURL;
     char* nextURL;
@@ -192,12 +633,14 @@ static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSee
         
         // Only proceed if the URL is internal
         if (isInternalURL(nextURL)) {
-            // If URL not seen before, add it
-            if (hashtable_insert(pagesSeen, nextURL, "")) {
-                webpage_t* newPage = webpage_new(nextURL, depth + 1, NULL);
-                mem_assert(newPage, "Out of memory: Failed to allocate webpage.");
-                bag_insert(pagesToCrawl, newPage);
+            // If URL not seen before, add it; the set needs no crawler lock
+            if (urlset_insert(crawler->pagesSeen, nextURL)) {
                 printf("%d     Added: %s\n", depth, nextURL);
+                int priority = pagePriority(nextURL, depth + 1);
+                pthread_mutex_lock(&crawler->lock);
+                frontier_insert(crawler->pagesToCrawl, nextURL, depth + 1, priority);
+                pthread_cond_signal(&crawler->changed);
+                pthread_mutex_unlock(&crawler->lock);
             } else {
                 printf("%d    IgnDupl: %s\n", depth, nextURL);
                 mem_free(nextURL); // Free memory for ignored duplicate
@@ -207,4 +650,31 @@ static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSee
             mem_free(nextURL); // Free memory for ignored external URL
         }
     }
-}
\ No newline at end of file
+}
+
+/**************** pagePriority() ****************/
+/*
+  * pagePriority - Ranks a URL for the priority frontier (smaller goes first).
+  *
+  * Shallower pages come first; among pages at one depth, those with
+  * fewer path segments (closer to the site root, usually the more
+  * general "hub" pages) come first.
+  *
+  * Parameters:
+  *   url - a normalized URL
+  *   depth - its crawl depth
+  *
+  * Returns:
+  *   the priority.
+  */
+static int pagePriority(const char* url, const int depth) {
+    int segments = 0;
+    const char* path = strstr(url, "://");
+    path = (path == NULL) ? url : path + 3;
+    for (; *path != '\0'; path++) {
+        if (*path == '/' && segments < 255) {
+            segments++;
+        }
+    }
+    return depth * 256 + segments;
+}
@@ -0,0 +1,206 @@
+/*
+* fetchtest.c     Atziri Enriquez     October 14, 2026
+*
+* This program tests the crawler's keep-alive fetching (webpage_fetchPooled
+* in libcs50/webpage.c) against a small web server of its own, run in a
+* child process on a free port of 127.0.0.1. The server answers each
+* request on a connection in turn, so the program checks that:
+*
+*   - a body delimited by Content-Length is read whole;
+*   - a chunked body, in several chunks and with a trailer, is reassembled;
+*   - the connection is pooled and reused for the next fetch;
+*   - a body delimited by the server closing the connection is read whole,
+*     and the next fetch opens a new connection;
+*   - a 404 fails the fetch without breaking the pooled connection;
+*   - a chunk size that does not parse, that would wrap the buffer size,
+*     or that exceeds the body limit, and a Content-Length over the limit,
+*     each fail the fetch at once, without a retry or a large allocation.
+*
+* Usage:
+*     ./fetchtest
+*
+* Functions:
+*     serve(listener)
+*         Runs the test server until it is killed.
+*     check(port, path, expect)
+*         Fetches a path from the test server and compares its HTML.
+*
+* Exit Codes:
+*     0 - Every test passed.
+*     1 - A test failed, or the test server could not be started.
+*
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "../libcs50/webpage.h"
+#include "../libcs50/file.h"
+
+/**************** function prototypes ****************/
+static void serve(const int listener);
+static bool check(const int port, const char* path, const char* expect);
+
+/**************** main ****************/
+/**
+ * Main function: Starts the test server, fetches its pages, and reports each test.
+ *
+ * Returns: 0 if every test passed, 1 otherwise.
+ */
+int main(void)
+{
+  // Listen on a free port of the loopback interface
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrlen = sizeof(addr);
+  if (listener < 0 || bind(listener, (struct sockaddr*) &addr, sizeof(addr)) != 0
+      || listen(listener, 4) != 0 || getsockname(listener, (struct sockaddr*) &addr, &addrlen) != 0) {
+    fprintf(stderr, "Error: Unable to start the test server.\n");
+    exit(1);
+  }
+  int port = ntohs(addr.sin_port);
+
+  fflush(stdout);
+  pid_t server = fork();
+  if (server < 0) {
+    fprintf(stderr, "Error: Unable to start the test server.\n");
+    exit(1);
+  }
+  if (server == 0) {
+    serve(listener);
+    exit(0);
+  }
+  close(listener);
+
+  // Each check both tests a way of delimiting a body and, by /conn,
+  // which connection of the server's the fetch arrived on
+  bool ok = true;
+  ok &= check(port, "/length", "a body of known length");
+  ok &= check(port, "/chunked", "a body in three chunks");
+  ok &= check(port, "/conn", "connection 1");
+  ok &= check(port, "/missing", NULL);
+  ok &= check(port, "/conn", "connection 1");
+  ok &= check(port, "/close", "a body ended by closing");
+  ok &= check(port, "/conn", "connection 2");
+  ok &= check(port, "/badchunk", NULL);
+  ok &= check(port, "/wrapchunk", NULL);
+  ok &= check(port, "/bigchunk", NULL);
+  ok &= check(port, "/biglength", NULL);
+  ok &= check(port, "/conn", "connection 6");
+
+  webpage_closeConnections();
+  kill(server, SIGTERM);
+  waitpid(server, NULL, 0);
+
+  printf("%s\n", ok ? "All fetch tests passed." : "Some fetch tests FAILED.");
+  exit(ok ? 0 : 1);
+}
+
+/**************** serve ****************/
+/**
+ * Runs the test server: accepts one connection at a time, and answers
+ * each request on it, by its path, until the client closes it.
+ *
+ * @param listener The listening socket.
+ */
+static void serve(const int listener)
+{
+  for (int connections = 1; ; connections++) {
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) {
+      return;
+    }
+    FILE* in = fdopen(fd, "r");
+    FILE* out = fdopen(dup(fd), "w");
+    if (in == NULL || out == NULL) {
+      return;
+    }
+
+    bool open = true;
+    char* request;
+    while (open && (request = file_readLine(in)) != NULL) {
+      // skip the headers, up to a blank line
+      char* line;
+      while ((line = file_readLine(in)) != NULL && strcmp(line, "\r") != 0 && line[0] != '\0') {
+        free(line);
+      }
+      free(line);
+
+      char path[64] = "";
+      sscanf(request, "GET %63s", path);
+      free(request);
+
+      if (strcmp(path, "/length") == 0) {
+        const char* body = "a body of known length";
+        fprintf(out, "HTTP/1.1 200 OK\r\nContent-Length: %zu\r\n\r\n%s", strlen(body), body);
+      } else if (strcmp(path, "/chunked") == 0) {
+        fprintf(out, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                     "7\r\na body \r\n3\r\nin \r\nc\r\nthree chunks\r\n0\r\nX-Trailer: yes\r\n\r\n");
+      } else if (strcmp(path, "/badchunk") == 0) {
+        fprintf(out, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                     "zz\r\nnot a size\r\n0\r\n\r\n");
+      } else if (strcmp(path, "/wrapchunk") == 0) {
+        fprintf(out, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                     "4\r\nwrap\r\nfffffffffffffffa\r\nmore than was allocated\r\n0\r\n\r\n");
+      } else if (strcmp(path, "/bigchunk") == 0) {
+        fprintf(out, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                     "4000001\r\none byte past 64 MB\r\n0\r\n\r\n");
+      } else if (strcmp(path, "/biglength") == 0) {
+        fprintf(out, "HTTP/1.1 200 OK\r\nContent-Length: 1099511627776\r\n\r\na terabyte, allegedly");
+      } else if (strcmp(path, "/conn") == 0) {
+        char body[32];
+        int len = snprintf(body, sizeof(body), "connection %d", connections);
+        fprintf(out, "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n%s", len, body);
+      } else if (strcmp(path, "/close") == 0) {
+        fprintf(out, "HTTP/1.1 200 OK\r\nConnection: close\r\n\r\na body ended by closing");
+        open = false;
+      } else {
+        fprintf(out, "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nnot found");
+      }
+      fflush(out);
+    }
+    fclose(out);
+    fclose(in);
+  }
+}
+
+/**************** check ****************/
+/**
+ * Fetches a page of the test server with webpage_fetchPooled, and prints
+ * whether its HTML is as expected.
+ *
+ * @param port The test server's port.
+ * @param path The page's path.
+ * @param expect Its expected HTML, or NULL if the fetch should fail.
+ *
+ * Returns: whether the test passed.
+ */
+static bool check(const int port, const char* path, const char* expect)
+{
+  char* url = malloc(strlen(path) + 32);
+  if (url == NULL) {
+    fprintf(stderr, "Error: Out of memory.\n");
+    exit(1);
+  }
+  sprintf(url, "http://127.0.0.1:%d%s", port, path);
+  webpage_t* page = webpage_new(url, 0, NULL);
+
+  bool fetched = webpage_fetchPooled(page);
+  char* html = fetched ? webpage_getHTML(page) : NULL;
+  bool ok = (expect == NULL) ? !fetched : (html != NULL && strcmp(html, expect) == 0);
+  printf("%s %-10s %s\n", ok ? "PASS" : "FAIL", path, html != NULL ? html : "(not fetched)");
+
+  webpage_delete(page);
+  return ok;
+}
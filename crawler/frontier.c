@@ -0,0 +1,443 @@
+/*
+ * frontier.c - CS50 TSE Crawler frontier
+ *
+ * see frontier.h for more information.
+ *
+ * Every policy is built from one small piece: a growable ring buffer of
+ * entries (queue_t), each entry being the URL pointer plus its depth,
+ * priority and insertion sequence number.
+ *
+ *   FRONTIER_BFS       levels[d] is the FIFO for depth d; we extract from
+ *                      the lowest non-empty level.
+ *   FRONTIER_HOST      a hashtable maps host -> that host's FIFO; a ring
+ *                      holds the hosts that have queued URLs, and we take
+ *                      one URL from the host at its head, then move that
+ *                      host to the back if it has more.
+ *   FRONTIER_PRIORITY  a binary min-heap on (priority, sequence number).
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "frontier.h"
+#include "politeness.h"   // politeness_hostOf
+#include "../libcs50/hashtable.h"
+#include "../libcs50/mem.h"
+
+/**************** constants ****************/
+static const size_t INITIAL_CAPACITY = 16;
+static const size_t MAX_HOST = 256;      // longest host[:port] we distinguish
+
+/**************** local types ****************/
+typedef struct entry {
+  char* url;                // owned by the frontier until extracted
+  int depth;                // crawl depth
+  int priority;             // for FRONTIER_PRIORITY
+  unsigned long seq;        // insertion order; breaks priority ties
+} entry_t;
+
+typedef struct queue {
+  entry_t* items;           // ring buffer of cap items
+  size_t head;              // index of the oldest item
+  size_t count;             // number of items
+  size_t cap;               // allocated size of items[]
+} queue_t;
+
+typedef struct hostq {
+  queue_t q;                // this host's URLs, oldest first
+  bool inRing;              // is this host in the round-robin ring?
+} hostq_t;
+
+typedef struct frontier {
+  frontier_policy_t policy;
+  size_t size;              // total entries across all structures
+  unsigned long seq;        // next insertion sequence number
+
+  // FRONTIER_BFS
+  queue_t* levels;          // levels[d] holds the URLs at depth d
+  int numLevels;            // allocated size of levels[]
+  int lowest;               // no URL is queued at a depth below this
+
+  // FRONTIER_HOST
+  hashtable_t* hosts;       // host -> hostq_t*
+  hostq_t** ring;           // ring buffer of hosts with queued URLs
+  size_t ringHead, ringCount, ringCap;
+
+  // FRONTIER_PRIORITY
+  entry_t* heap;            // binary min-heap
+  size_t heapLen, heapCap;
+} frontier_t;
+
+/* 'arg' for frontier_iterate's hashtable callback */
+typedef struct iterateArgs {
+  void* arg;
+  void (*itemfunc)(void* arg, const char* url, const int depth, const int priority);
+} iterateArgs_t;
+
+/**************** local functions ****************/
+static void queue_push(queue_t* q, const entry_t e);
+static entry_t queue_pop(queue_t* q);
+static void queue_iterate(queue_t* q, iterateArgs_t* args);
+static void queue_free(queue_t* q);
+static void ring_push(frontier_t* f, hostq_t* hq);
+static hostq_t* ring_pop(frontier_t* f);
+static bool heap_less(const entry_t* a, const entry_t* b);
+static void heap_push(frontier_t* f, const entry_t e);
+static entry_t heap_pop(frontier_t* f);
+static void iterate_host(void* arg, const char* key, void* item);
+static void delete_host(void* item);
+
+/**************** frontier_new ****************/
+/* see frontier.h for description */
+frontier_t* frontier_new(const frontier_policy_t policy)
+{
+  frontier_t* f = mem_calloc(1, sizeof(frontier_t));
+  if (f == NULL) {
+    return NULL;
+  }
+  f->policy = policy;
+
+  if (policy == FRONTIER_HOST) {
+    f->hosts = hashtable_new(50);
+    if (f->hosts == NULL) {
+      mem_free(f);
+      return NULL;
+    }
+  }
+  return f;
+}
+
+/**************** frontier_parsePolicy ****************/
+/* see frontier.h for description */
+bool frontier_parsePolicy(const char* name, frontier_policy_t* policy)
+{
+  if (name == NULL || policy == NULL) {
+    return false;
+  }
+  if (strcmp(name, "bfs") == 0) {
+    *policy = FRONTIER_BFS;
+  } else if (strcmp(name, "host") == 0) {
+    *policy = FRONTIER_HOST;
+  } else if (strcmp(name, "priority") == 0) {
+    *policy = FRONTIER_PRIORITY;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**************** frontier_insert ****************/
+/* see frontier.h for description */
+bool frontier_insert(frontier_t* f, char* url, const int depth, const int priority)
+{
+  if (f == NULL || url == NULL || depth < 0) {
+    return false;
+  }
+
+  entry_t e = { url, depth, priority, f->seq++ };
+
+  switch (f->policy) {
+  case FRONTIER_BFS:
+    if (depth >= f->numLevels) {
+      // grow levels[] to cover this depth
+      int numLevels = f->numLevels == 0 ? 4 : f->numLevels;
+      while (numLevels <= depth) {
+        numLevels *= 2;
+      }
+      queue_t* levels = mem_calloc_assert(numLevels, sizeof(queue_t), "frontier levels");
+      if (f->levels != NULL) {
+        memcpy(levels, f->levels, f->numLevels * sizeof(queue_t));
+        mem_free(f->levels);
+      }
+      f->levels = levels;
+      f->numLevels = numLevels;
+    }
+    queue_push(&f->levels[depth], e);
+    if (f->size == 0 || depth < f->lowest) {
+      f->lowest = depth;
+    }
+    break;
+
+  case FRONTIER_HOST: {
+    char host[MAX_HOST];
+    politeness_hostOf(url, host, sizeof(host));
+    hostq_t* hq = hashtable_find(f->hosts, host);
+    if (hq == NULL) {
+      hq = mem_calloc_assert(1, sizeof(hostq_t), "frontier host");
+      hashtable_insert(f->hosts, host, hq);
+    }
+    queue_push(&hq->q, e);
+    if (!hq->inRing) {
+      ring_push(f, hq);
+    }
+    break;
+  }
+
+  case FRONTIER_PRIORITY:
+    heap_push(f, e);
+    break;
+  }
+
+  f->size++;
+  return true;
+}
+
+/**************** frontier_extract ****************/
+/* see frontier.h for description */
+char* frontier_extract(frontier_t* f, int* depth)
+{
+  if (f == NULL || f->size == 0) {
+    return NULL;
+  }
+
+  entry_t e;
+  switch (f->policy) {
+  case FRONTIER_BFS:
+    while (f->levels[f->lowest].count == 0) {
+      f->lowest++;          // size > 0, so some level is non-empty
+    }
+    e = queue_pop(&f->levels[f->lowest]);
+    break;
+
+  case FRONTIER_HOST: {
+    hostq_t* hq = ring_pop(f);
+    e = queue_pop(&hq->q);
+    if (hq->q.count > 0) {
+      ring_push(f, hq);     // more from this host, after the others
+    }
+    break;
+  }
+
+  case FRONTIER_PRIORITY:
+  default:
+    e = heap_pop(f);
+    break;
+  }
+
+  f->size--;
+  if (depth != NULL) {
+    *depth = e.depth;
+  }
+  return e.url;
+}
+
+/**************** frontier_size ****************/
+/* see frontier.h for description */
+size_t frontier_size(frontier_t* f)
+{
+  return f == NULL ? 0 : f->size;
+}
+
+/**************** frontier_iterate ****************/
+/* see frontier.h for description */
+void frontier_iterate(frontier_t* f, void* arg,
+                      void (*itemfunc)(void* arg, const char* url,
+                                       const int depth, const int priority))
+{
+  if (f == NULL || itemfunc == NULL) {
+    return;
+  }
+
+  iterateArgs_t args = { arg, itemfunc };
+  for (int d = 0; d < f->numLevels; d++) {
+    queue_iterate(&f->levels[d], &args);
+  }
+  hashtable_iterate(f->hosts, &args, iterate_host);
+  for (size_t i = 0; i < f->heapLen; i++) {
+    (*itemfunc)(arg, f->heap[i].url, f->heap[i].depth, f->heap[i].priority);
+  }
+}
+
+/**************** frontier_delete ****************/
+/* see frontier.h for description */
+void frontier_delete(frontier_t* f)
+{
+  if (f != NULL) {
+    for (int d = 0; d < f->numLevels; d++) {
+      queue_free(&f->levels[d]);
+    }
+    if (f->levels != NULL) {
+      mem_free(f->levels);
+    }
+    hashtable_delete(f->hosts, delete_host);
+    if (f->ring != NULL) {
+      mem_free(f->ring);
+    }
+    for (size_t i = 0; i < f->heapLen; i++) {
+      mem_free(f->heap[i].url);
+    }
+    if (f->heap != NULL) {
+      mem_free(f->heap);
+    }
+    mem_free(f);
+  }
+}
+
+/**************** queue functions ****************/
+
+/* Appends e to the back of q, growing q if needed */
+static void queue_push(queue_t* q, const entry_t e)
+{
+  if (q->count == q->cap) {
+    size_t cap = q->cap == 0 ? INITIAL_CAPACITY : 2 * q->cap;
+    entry_t* items = mem_malloc_assert(cap * sizeof(entry_t), "frontier queue");
+    // unwrap the ring into the new array
+    for (size_t i = 0; i < q->count; i++) {
+      items[i] = q->items[(q->head + i) % q->cap];
+    }
+    if (q->items != NULL) {
+      mem_free(q->items);
+    }
+    q->items = items;
+    q->head = 0;
+    q->cap = cap;
+  }
+  q->items[(q->head + q->count) % q->cap] = e;
+  q->count++;
+}
+
+/* Removes and returns the front of q, which must not be empty */
+static entry_t queue_pop(queue_t* q)
+{
+  entry_t e = q->items[q->head];
+  q->head = (q->head + 1) % q->cap;
+  q->count--;
+  return e;
+}
+
+/* Calls the iterate callback on every entry in q */
+static void queue_iterate(queue_t* q, iterateArgs_t* args)
+{
+  for (size_t i = 0; i < q->count; i++) {
+    entry_t* e = &q->items[(q->head + i) % q->cap];
+    (*args->itemfunc)(args->arg, e->url, e->depth, e->priority);
+  }
+}
+
+/* Frees every URL in q, and q's array */
+static void queue_free(queue_t* q)
+{
+  while (q->count > 0) {
+    mem_free(queue_pop(q).url);
+  }
+  if (q->items != NULL) {
+    mem_free(q->items);
+  }
+}
+
+/**************** host ring functions ****************/
+
+/* Adds a host to the back of the round-robin ring */
+static void ring_push(frontier_t* f, hostq_t* hq)
+{
+  if (f->ringCount == f->ringCap) {
+    size_t cap = f->ringCap == 0 ? INITIAL_CAPACITY : 2 * f->ringCap;
+    hostq_t** ring = mem_malloc_assert(cap * sizeof(hostq_t*), "frontier host ring");
+    for (size_t i = 0; i < f->ringCount; i++) {
+      ring[i] = f->ring[(f->ringHead + i) % f->ringCap];
+    }
+    if (f->ring != NULL) {
+      mem_free(f->ring);
+    }
+    f->ring = ring;
+    f->ringHead = 0;
+    f->ringCap = cap;
+  }
+  f->ring[(f->ringHead + f->ringCount) % f->ringCap] = hq;
+  f->ringCount++;
+  hq->inRing = true;
+}
+
+/* Removes and returns the host at the front of the ring, which must not be empty */
+static hostq_t* ring_pop(frontier_t* f)
+{
+  hostq_t* hq = f->ring[f->ringHead];
+  f->ringHead = (f->ringHead + 1) % f->ringCap;
+  f->ringCount--;
+  hq->inRing = false;
+  return hq;
+}
+
+/* hashtable_iterate callback: visit one host's queue */
+static void iterate_host(void* arg, const char* key, void* item)
+{
+  hostq_t* hq = item;
+  queue_iterate(&hq->q, arg);
+}
+
+/* hashtable_delete callback: free one host's queue */
+static void delete_host(void* item)
+{
+  hostq_t* hq = item;
+  queue_free(&hq->q);
+  mem_free(hq);
+}
+
+/**************** heap functions ****************/
+
+/* Orders entries by priority, then by insertion order */
+static bool heap_less(const entry_t* a, const entry_t* b)
+{
+  if (a->priority != b->priority) {
+    return a->priority < b->priority;
+  }
+  return a->seq < b->seq;
+}
+
+/* Adds e to the heap */
+static void heap_push(frontier_t* f, const entry_t e)
+{
+  if (f->heapLen == f->heapCap) {
+    size_t cap = f->heapCap == 0 ? INITIAL_CAPACITY : 2 * f->heapCap;
+    entry_t* heap = mem_malloc_assert(cap * sizeof(entry_t), "frontier heap");
+    if (f->heap != NULL) {
+      memcpy(heap, f->heap, f->heapLen * sizeof(entry_t));
+      mem_free(f->heap);
+    }
+    f->heap = heap;
+    f->heapCap = cap;
+  }
+
+  // sift up
+  size_t i = f->heapLen++;
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (!heap_less(&e, &f->heap[parent])) {
+      break;
+    }
+    f->heap[i] = f->heap[parent];
+    i = parent;
+  }
+  f->heap[i] = e;
+}
+
+/* Removes and returns the smallest entry; the heap must not be empty */
+static entry_t heap_pop(frontier_t* f)
+{
+  entry_t top = f->heap[0];
+  entry_t last = f->heap[--f->heapLen];
+
+  // sift the last entry down from the root
+  size_t i = 0;
+  for (;;) {
+    size_t child = 2 * i + 1;
+    if (child >= f->heapLen) {
+      break;
+    }
+    if (child + 1 < f->heapLen && heap_less(&f->heap[child + 1], &f->heap[child])) {
+      child++;
+    }
+    if (!heap_less(&f->heap[child], &last)) {
+      break;
+    }
+    f->heap[i] = f->heap[child];
+    i = child;
+  }
+  if (f->heapLen > 0) {
+    f->heap[i] = last;
+  }
+  return top;
+}
@@ -0,0 +1,113 @@
+/*
+ * frontier.h - CS50 TSE Crawler frontier (the pages waiting to be crawled)
+ *
+ * The frontier replaces the crawler's unordered `bag_t`. It decides which
+ * queued URL the crawler fetches next, according to one of three policies:
+ *
+ *   FRONTIER_BFS       strict breadth-first: every page at depth d is handed
+ *                      out before any page at depth d+1, FIFO within a depth.
+ *   FRONTIER_HOST      one FIFO queue per host, served round-robin, so that
+ *                      consecutive fetches go to different servers.
+ *   FRONTIER_PRIORITY  a min-heap on a caller-supplied priority (FIFO among
+ *                      equal priorities).
+ *
+ * Entries are stored compactly: the frontier keeps the caller's malloc'd
+ * URL string plus a few integers, packed in growable arrays -- no
+ * `webpage_t` or list node per queued URL.
+ *
+ * Functions:
+ *  - `frontier_new`: Creates an empty frontier with the given policy.
+ *  - `frontier_parsePolicy`: Converts "bfs", "host" or "priority" to a policy.
+ *  - `frontier_insert`: Queues a URL.
+ *  - `frontier_extract`: Removes and returns the next URL per the policy.
+ *  - `frontier_size`: Returns the number of queued URLs.
+ *  - `frontier_iterate`: Calls a function on every queued URL.
+ *  - `frontier_delete`: Frees the frontier and every queued URL.
+ *
+ * Error Handling:
+ *  - `frontier_new` returns NULL on allocation failure; running out of
+ *    memory while growing terminates the program via `mem_assert`.
+ *  - The frontier is NOT thread-safe; the crawler serializes access to it.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __FRONTIER_H
+#define __FRONTIER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* The frontier; opaque to users of the module */
+typedef struct frontier frontier_t;
+
+/* Which URL comes out next */
+typedef enum {
+  FRONTIER_BFS,
+  FRONTIER_HOST,
+  FRONTIER_PRIORITY
+} frontier_policy_t;
+
+/**
+ * Creates a new, empty frontier.
+ *
+ * @param policy The extraction policy.
+ * @return Pointer to a new `frontier_t`, or NULL on failure.
+ */
+frontier_t* frontier_new(const frontier_policy_t policy);
+
+/**
+ * Parses a policy name ("bfs", "host" or "priority").
+ *
+ * @param name The name to parse.
+ * @param policy Where to store the policy.
+ * @return true on success; false (leaving *policy alone) if unknown.
+ */
+bool frontier_parsePolicy(const char* name, frontier_policy_t* policy);
+
+/**
+ * Adds a URL to the frontier.
+ *
+ * @param frontier The frontier.
+ * @param url A malloc'd URL; the frontier takes ownership of it.
+ * @param depth Crawl depth of the page (must be >= 0).
+ * @param priority Smaller is fetched sooner; used only by FRONTIER_PRIORITY.
+ * @return true on success; false (and `url` is untouched) on NULL args or bad depth.
+ */
+bool frontier_insert(frontier_t* frontier, char* url, const int depth, const int priority);
+
+/**
+ * Removes the next URL from the frontier, according to its policy.
+ *
+ * @param frontier The frontier.
+ * @param depth Where to store the URL's depth (may be NULL).
+ * @return The malloc'd URL, which the caller now owns; NULL if empty.
+ */
+char* frontier_extract(frontier_t* frontier, int* depth);
+
+/**
+ * Returns the number of URLs in the frontier (0 if NULL).
+ */
+size_t frontier_size(frontier_t* frontier);
+
+/**
+ * Calls itemfunc(arg, url, depth, priority) once for each queued URL, in
+ * undefined order. The frontier is unchanged.
+ *
+ * @param frontier The frontier; NULL does nothing.
+ * @param arg Arbitrary pointer passed along to itemfunc.
+ * @param itemfunc Function to call; NULL does nothing.
+ */
+void frontier_iterate(frontier_t* frontier, void* arg,
+                      void (*itemfunc)(void* arg, const char* url,
+                                       const int depth, const int priority));
+
+/**
+ * Deletes the frontier, freeing every URL still queued.
+ *
+ * @param frontier The frontier; NULL is ignored.
+ */
+void frontier_delete(frontier_t* frontier);
+
+#endif // __FRONTIER_H
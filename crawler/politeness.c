@@ -0,0 +1,144 @@
+/*
+ * politeness.c - CS50 TSE Crawler per-host politeness scheduler
+ *
+ * see politeness.h for more information.
+ *
+ * Each host maps (in a hashtable) to the earliest time at which it may
+ * next be contacted. `politeness_wait` claims that slot under a mutex,
+ * pushes it `delay` seconds into the future, and then sleeps outside the
+ * lock -- so threads waiting on one busy host never hold up threads that
+ * are about to fetch from another.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime(), nanosleep()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "politeness.h"
+#include "../libcs50/hashtable.h"
+#include "../libcs50/mem.h"
+
+/**************** local types ****************/
+typedef struct politeness {
+  hashtable_t* hosts;       // host -> double* (next allowed time, seconds)
+  double delay;             // seconds between requests to one host
+  pthread_mutex_t lock;     // protects hosts
+} politeness_t;
+
+/**************** local functions ****************/
+static double now(void);
+static void sleepUntil(const double when);
+static void delete_slot(void* item);
+
+/**************** politeness_new ****************/
+/* see politeness.h for description */
+politeness_t* politeness_new(const double delay)
+{
+  politeness_t* sched = mem_malloc(sizeof(politeness_t));
+  if (sched == NULL) {
+    return NULL;
+  }
+
+  sched->hosts = hashtable_new(50);
+  if (sched->hosts == NULL) {
+    mem_free(sched);
+    return NULL;
+  }
+  sched->delay = delay < 0 ? 0 : delay;
+  pthread_mutex_init(&sched->lock, NULL);
+  return sched;
+}
+
+/**************** politeness_wait ****************/
+/* see politeness.h for description */
+void politeness_wait(politeness_t* sched, const char* url)
+{
+  if (sched == NULL || url == NULL) {
+    return;
+  }
+
+  char host[256];
+  politeness_hostOf(url, host, sizeof(host));
+
+  pthread_mutex_lock(&sched->lock);
+  double t = now();
+  double* next = hashtable_find(sched->hosts, host);
+  if (next == NULL) {
+    // first visit to this host: go right away
+    next = mem_malloc_assert(sizeof(double), "politeness slot");
+    *next = t;
+    hashtable_insert(sched->hosts, host, next);
+  }
+  double slot = (*next > t) ? *next : t;   // our turn
+  *next = slot + sched->delay;             // the turn after ours
+  pthread_mutex_unlock(&sched->lock);
+
+  sleepUntil(slot);
+}
+
+/**************** politeness_hostOf ****************/
+/* see politeness.h for description */
+void politeness_hostOf(const char* url, char* host, const size_t size)
+{
+  if (host == NULL || size == 0) {
+    return;
+  }
+  host[0] = '\0';
+  if (url == NULL) {
+    return;
+  }
+
+  // skip "scheme://", then copy up to the next '/'
+  const char* start = strstr(url, "://");
+  start = (start == NULL) ? url : start + 3;
+  size_t len = strcspn(start, "/");
+  if (len >= size) {
+    len = size - 1;
+  }
+  memcpy(host, start, len);
+  host[len] = '\0';
+}
+
+/**************** politeness_delete ****************/
+/* see politeness.h for description */
+void politeness_delete(politeness_t* sched)
+{
+  if (sched != NULL) {
+    hashtable_delete(sched->hosts, delete_slot);
+    pthread_mutex_destroy(&sched->lock);
+    mem_free(sched);
+  }
+}
+
+/* Returns the current monotonic time, in seconds */
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Sleeps until the monotonic clock reaches `when` */
+static void sleepUntil(const double when)
+{
+  double wait = when - now();
+  if (wait > 0) {
+    struct timespec ts;
+    ts.tv_sec = (time_t) wait;
+    ts.tv_nsec = (long) ((wait - ts.tv_sec) * 1e9);
+    while (nanosleep(&ts, &ts) != 0) {
+      // interrupted by a signal: keep sleeping for the remainder
+    }
+  }
+}
+
+/* Frees one host's slot */
+static void delete_slot(void* item)
+{
+  mem_free(item);
+}
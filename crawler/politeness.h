@@ -0,0 +1,69 @@
+/*
+ * politeness.h - CS50 TSE Crawler per-host politeness scheduler
+ *
+ * The crawler must not hit any one web server more often than once per
+ * `delay` seconds. Rather than sleeping after every fetch (which caps the
+ * whole crawl at one page per second), the scheduler remembers when each
+ * host may next be contacted, so workers fetching from different hosts
+ * never wait on each other.
+ *
+ * Functions:
+ *  - `politeness_new`: Creates a scheduler with the given per-host delay.
+ *  - `politeness_wait`: Blocks until the URL's host may be contacted again.
+ *  - `politeness_hostOf`: Copies the host[:port] part of a URL into a buffer.
+ *  - `politeness_delete`: Frees the scheduler.
+ *
+ * Assumptions:
+ *  - URLs are normalized, of the form http://host[:port][/path].
+ *
+ * Error Handling:
+ *  - `politeness_new` returns NULL on allocation failure.
+ *  - All functions are safe to call concurrently from crawler threads.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __POLITENESS_H
+#define __POLITENESS_H
+
+#include <stddef.h>
+
+/* The politeness scheduler; opaque to users of the module */
+typedef struct politeness politeness_t;
+
+/**
+ * Creates a new scheduler.
+ *
+ * @param delay Minimum number of seconds between two requests to one host.
+ * @return Pointer to a new `politeness_t`, or NULL on failure.
+ */
+politeness_t* politeness_new(const double delay);
+
+/**
+ * Reserves the next free time slot for the host of `url` and sleeps until
+ * it arrives. Slots are handed out in call order, so N callers waiting on
+ * the same host are released `delay` seconds apart.
+ *
+ * @param sched The scheduler.
+ * @param url A normalized URL; NULL is ignored.
+ */
+void politeness_wait(politeness_t* sched, const char* url);
+
+/**
+ * Copies the host (and port, if any) of `url` into `host`.
+ *
+ * @param url A normalized URL.
+ * @param host Buffer to hold the result.
+ * @param size Size of that buffer; the result is truncated to fit.
+ */
+void politeness_hostOf(const char* url, char* host, const size_t size);
+
+/**
+ * Deletes the scheduler and frees all associated memory.
+ *
+ * @param sched The scheduler; NULL is ignored.
+ */
+void politeness_delete(politeness_t* sched);
+
+#endif // __POLITENESS_H
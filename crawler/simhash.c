@@ -0,0 +1,322 @@
+/*
+ * simhash.c - CS50 TSE Crawler near-duplicate page detection
+ *
+ * see simhash.h for more information.
+ *
+ * The index keeps its fingerprints in one array, in the order they were
+ * added. Each block has a chained hash table over the block's bits: the
+ * heads hold a fingerprint's position plus one (0 ends a chain), and the
+ * links, numBlocks per fingerprint, sit next to each other in one array.
+ * The arrays double when full and the heads are rebuilt once there are
+ * as many fingerprints as heads, so chains stay about one long.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // pthreads
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include "simhash.h"
+#include "../common/tokenizer.h"
+#include "../libcs50/mem.h"
+
+/**************** constants ****************/
+#define MAX_BLOCKS (SIMHASH_MAX_DISTANCE + 1)
+static const size_t INITIAL_SIZE = 64;   // fingerprints and heads; a power of two
+static const int INITIAL_HEAD_BITS = 6;  // log2(INITIAL_SIZE)
+
+/**************** local types ****************/
+typedef struct simindex {
+  pthread_mutex_t lock;           // protects the fields below
+  int maxDistance;
+  int numBlocks;                  // maxDistance + 1
+  int shift[MAX_BLOCKS];          // where each block's bits start
+  uint64_t mask[MAX_BLOCKS];      // and which they are, once shifted
+  uint64_t* fps;                  // the fingerprints, in insertion order
+  uint32_t* links;                // links[i * numBlocks + b]: next in i's chain for b
+  size_t count;                   // fingerprints in fps
+  size_t cap;                     // room in fps and links
+  uint32_t* heads[MAX_BLOCKS];    // per block, numHeads chain heads
+  size_t numHeads;                // a power of two
+  int headBits;                   // log2(numHeads)
+} simindex_t;
+
+/**************** local functions ****************/
+static uint64_t wordHash(const char* word, const size_t len);
+static uint64_t mix(uint64_t h);
+static void vote(int votes[64], const uint64_t h);
+static bool findNear(simindex_t* index, const uint64_t fp);
+static size_t bucketOf(const simindex_t* index, const int b, const uint64_t fp);
+static void grow(simindex_t* index);
+static void rehash(simindex_t* index);
+
+/**************** simhash_page ****************/
+/* see simhash.h for description */
+bool simhash_page(const char* html, const size_t len, uint64_t* fp)
+{
+  if (html == NULL || fp == NULL) {
+    return false;
+  }
+
+  // Vote with each shingle of three words, or with all of a shorter page
+  int votes[64] = { 0 };
+  uint64_t window[3] = { 0, 0, 0 };
+  size_t numWords = 0;
+  tokenizer_t tok;
+  const char* word;
+  size_t wordLen;
+  tokenizer_init(&tok, html, len);
+  while (tokenizer_next(&tok, &word, &wordLen)) {
+    window[0] = window[1];
+    window[1] = window[2];
+    window[2] = wordHash(word, wordLen);
+    if (++numWords >= 3) {
+      vote(votes, mix((window[0] * 0x100000001b3u + window[1]) * 0x100000001b3u + window[2]));
+    }
+  }
+  if (numWords == 0) {
+    return false;
+  }
+  if (numWords < 3) {
+    vote(votes, mix((window[0] * 0x100000001b3u + window[1]) * 0x100000001b3u + window[2]));
+  }
+
+  uint64_t h = 0;
+  for (int bit = 0; bit < 64; bit++) {
+    if (votes[bit] > 0) {
+      h |= (uint64_t) 1 << bit;
+    }
+  }
+  *fp = h;
+  return true;
+}
+
+/**************** simhash_distance ****************/
+/* see simhash.h for description */
+int simhash_distance(const uint64_t a, const uint64_t b)
+{
+  return __builtin_popcountll(a ^ b);
+}
+
+/**************** simindex_new ****************/
+/* see simhash.h for description */
+simindex_t* simindex_new(const int maxDistance)
+{
+  if (maxDistance < 0 || maxDistance > SIMHASH_MAX_DISTANCE) {
+    return NULL;
+  }
+  simindex_t* index = mem_calloc(1, sizeof(simindex_t));
+  if (index == NULL) {
+    return NULL;
+  }
+  pthread_mutex_init(&index->lock, NULL);
+  index->maxDistance = maxDistance;
+  index->numBlocks = maxDistance + 1;
+  for (int b = 0; b < index->numBlocks; b++) {
+    int start = b * 64 / index->numBlocks;
+    int width = (b + 1) * 64 / index->numBlocks - start;
+    index->shift[b] = start;
+    index->mask[b] = width == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << width) - 1;
+  }
+
+  index->cap = INITIAL_SIZE;
+  index->numHeads = INITIAL_SIZE;
+  index->headBits = INITIAL_HEAD_BITS;
+  index->fps = mem_malloc(index->cap * sizeof(uint64_t));
+  index->links = mem_malloc(index->cap * index->numBlocks * sizeof(uint32_t));
+  bool ok = index->fps != NULL && index->links != NULL;
+  for (int b = 0; b < index->numBlocks; b++) {
+    index->heads[b] = mem_calloc(index->numHeads, sizeof(uint32_t));
+    ok = ok && index->heads[b] != NULL;
+  }
+  if (!ok) {
+    simindex_delete(index);
+    return NULL;
+  }
+  return index;
+}
+
+/**************** simindex_insert ****************/
+/* see simhash.h for description */
+bool simindex_insert(simindex_t* index, const uint64_t fp)
+{
+  if (index == NULL) {
+    return false;
+  }
+
+  pthread_mutex_lock(&index->lock);
+  bool added = !findNear(index, fp);
+  if (added) {
+    if (index->count == index->cap) {
+      grow(index);
+    }
+    size_t i = index->count++;
+    index->fps[i] = fp;
+    for (int b = 0; b < index->numBlocks; b++) {
+      size_t bucket = bucketOf(index, b, fp);
+      index->links[i * index->numBlocks + b] = index->heads[b][bucket];
+      index->heads[b][bucket] = i + 1;
+    }
+    if (index->count > index->numHeads) {
+      rehash(index);
+    }
+  }
+  pthread_mutex_unlock(&index->lock);
+  return added;
+}
+
+/**************** simindex_count ****************/
+/* see simhash.h for description */
+size_t simindex_count(simindex_t* index)
+{
+  if (index == NULL) {
+    return 0;
+  }
+  pthread_mutex_lock(&index->lock);
+  size_t count = index->count;
+  pthread_mutex_unlock(&index->lock);
+  return count;
+}
+
+/**************** simindex_bytes ****************/
+/* see simhash.h for description */
+size_t simindex_bytes(simindex_t* index)
+{
+  if (index == NULL) {
+    return 0;
+  }
+  pthread_mutex_lock(&index->lock);
+  size_t bytes = sizeof(simindex_t)
+    + index->cap * (sizeof(uint64_t) + index->numBlocks * sizeof(uint32_t))
+    + index->numBlocks * index->numHeads * sizeof(uint32_t);
+  pthread_mutex_unlock(&index->lock);
+  return bytes;
+}
+
+/**************** simindex_maxDistance ****************/
+/* see simhash.h for description */
+int simindex_maxDistance(simindex_t* index)
+{
+  return index == NULL ? -1 : index->maxDistance;
+}
+
+/**************** simindex_iterate ****************/
+/* see simhash.h for description */
+void simindex_iterate(simindex_t* index, void* arg,
+                      void (*itemfunc)(void* arg, const uint64_t fp))
+{
+  if (index == NULL || itemfunc == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&index->lock);
+  for (size_t i = 0; i < index->count; i++) {
+    (*itemfunc)(arg, index->fps[i]);
+  }
+  pthread_mutex_unlock(&index->lock);
+}
+
+/**************** simindex_delete ****************/
+/* see simhash.h for description */
+void simindex_delete(simindex_t* index)
+{
+  if (index == NULL) {
+    return;
+  }
+  for (int b = 0; b < index->numBlocks; b++) {
+    mem_free(index->heads[b]);
+  }
+  pthread_mutex_destroy(&index->lock);
+  mem_free(index->fps);
+  mem_free(index->links);
+  mem_free(index);
+}
+
+/* Returns the 64-bit FNV-1a hash of a word, ignoring case */
+static uint64_t wordHash(const char* word, const size_t len)
+{
+  uint64_t h = 14695981039346656037u;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ (unsigned char) tolower((unsigned char) word[i])) * 1099511628211u;
+  }
+  return h;
+}
+
+/* Spreads every input bit over the whole hash (the splitmix64 finalizer) */
+static uint64_t mix(uint64_t h)
+{
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9u;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebu;
+  return h ^ (h >> 31);
+}
+
+/* Adds a shingle's votes: one for each of its hash's bits that is set,
+ * one against for each that is clear */
+static void vote(int votes[64], const uint64_t h)
+{
+  for (int bit = 0; bit < 64; bit++) {
+    votes[bit] += ((h >> bit) & 1) ? 1 : -1;
+  }
+}
+
+/* Returns true if a fingerprint within maxDistance of fp is present: it
+ * shares a block with fp, so is in one of fp's chains. Caller holds the lock. */
+static bool findNear(simindex_t* index, const uint64_t fp)
+{
+  for (int b = 0; b < index->numBlocks; b++) {
+    uint64_t key = (fp >> index->shift[b]) & index->mask[b];
+    for (uint32_t j = index->heads[b][bucketOf(index, b, fp)]; j != 0;
+         j = index->links[(j - 1) * index->numBlocks + b]) {
+      uint64_t other = index->fps[j - 1];
+      if (((other >> index->shift[b]) & index->mask[b]) == key
+          && simhash_distance(other, fp) <= index->maxDistance) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* Returns the head of block b's table that fp's chain starts at */
+static size_t bucketOf(const simindex_t* index, const int b, const uint64_t fp)
+{
+  uint64_t key = (fp >> index->shift[b]) & index->mask[b];
+  return ((key + b) * 0x9e3779b97f4a7c15u) >> (64 - index->headBits);
+}
+
+/* Doubles the room for fingerprints and their links */
+static void grow(simindex_t* index)
+{
+  size_t cap = 2 * index->cap;
+  uint64_t* fps = mem_malloc_assert(cap * sizeof(uint64_t), "simindex fingerprints");
+  uint32_t* links = mem_malloc_assert(cap * index->numBlocks * sizeof(uint32_t), "simindex links");
+  memcpy(fps, index->fps, index->count * sizeof(uint64_t));
+  memcpy(links, index->links, index->count * index->numBlocks * sizeof(uint32_t));
+  mem_free(index->fps);
+  mem_free(index->links);
+  index->fps = fps;
+  index->links = links;
+  index->cap = cap;
+}
+
+/* Doubles every block's heads and rebuilds the chains */
+static void rehash(simindex_t* index)
+{
+  index->numHeads *= 2;
+  index->headBits++;
+  for (int b = 0; b < index->numBlocks; b++) {
+    mem_free(index->heads[b]);
+    index->heads[b] = mem_calloc(index->numHeads, sizeof(uint32_t));
+    mem_assert(index->heads[b], "Out of memory: Failed to grow simindex.");
+  }
+  for (size_t i = 0; i < index->count; i++) {
+    for (int b = 0; b < index->numBlocks; b++) {
+      size_t bucket = bucketOf(index, b, index->fps[i]);
+      index->links[i * index->numBlocks + b] = index->heads[b][bucket];
+      index->heads[b][bucket] = i + 1;
+    }
+  }
+}
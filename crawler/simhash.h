@@ -0,0 +1,126 @@
+/*
+ * simhash.h - CS50 TSE Crawler near-duplicate page detection
+ *
+ * A page's SimHash is a 64-bit fingerprint of its words: every run of
+ * three consecutive words (a shingle) is hashed, each of the 64 bits is
+ * voted for by the shingles whose hash has it set and against by those
+ * whose hash has it clear, and the fingerprint keeps the bits that won.
+ * Pages sharing most of their shingles, such as a mirror of a page or the
+ * same page under a different query string, get fingerprints a few bits
+ * apart; unrelated pages differ in about 32 bits.
+ *
+ * A simindex holds the fingerprints of the pages a crawl has kept and
+ * answers "is any of them within maxDistance bits of this one?". The
+ * fingerprint is cut into maxDistance + 1 blocks of bits; two fingerprints
+ * that close must agree on at least one whole block, so the index keeps a
+ * hash table per block and compares only the fingerprints that share a
+ * block with the one looked up.
+ *
+ * Functions:
+ *  - `simhash_page`: Computes the fingerprint of a page's HTML.
+ *  - `simhash_distance`: Returns the number of bits two fingerprints differ in.
+ *  - `simindex_new`: Creates an empty index for a given distance.
+ *  - `simindex_insert`: Adds a fingerprint unless a near one is present.
+ *  - `simindex_count`: Returns the number of fingerprints.
+ *  - `simindex_bytes`: Returns the memory the index uses.
+ *  - `simindex_maxDistance`: Returns the index's distance.
+ *  - `simindex_iterate`: Calls a function on every fingerprint.
+ *  - `simindex_delete`: Frees the index.
+ *
+ * Assumptions:
+ *  - Words are those of the tokenizer (see common/tokenizer.h), compared
+ *    without regard to case; markup is ignored, so pages that differ only
+ *    in their links or tags look the same.
+ *
+ * Error Handling:
+ *  - `simindex_new` returns NULL on a bad distance or allocation failure;
+ *    running out of memory while growing the index terminates the program
+ *    via `mem_assert`.
+ *  - All functions except `simindex_delete` are safe to call concurrently.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __SIMHASH_H
+#define __SIMHASH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The largest distance an index supports; it then has 8 blocks of 8 bits */
+#define SIMHASH_MAX_DISTANCE 7
+
+/* An index of page fingerprints; opaque to users of the module */
+typedef struct simindex simindex_t;
+
+/**
+ * Computes the SimHash of a page.
+ *
+ * @param html The page's HTML.
+ * @param len Its length.
+ * @param fp Where to store the fingerprint.
+ * @return true if the page has any words; false (leaving *fp) if not,
+ *         since such pages cannot be told apart by their text.
+ */
+bool simhash_page(const char* html, const size_t len, uint64_t* fp);
+
+/**
+ * Returns the Hamming distance between two fingerprints, 0 to 64.
+ */
+int simhash_distance(const uint64_t a, const uint64_t b);
+
+/**
+ * Creates a new, empty index.
+ *
+ * @param maxDistance Fingerprints at most this many bits apart are near;
+ *                    0 to SIMHASH_MAX_DISTANCE.
+ * @return Pointer to a new `simindex_t`, or NULL on failure.
+ */
+simindex_t* simindex_new(const int maxDistance);
+
+/**
+ * Adds a fingerprint unless the index has one within its distance.
+ *
+ * @param index The index.
+ * @param fp The fingerprint.
+ * @return true iff the fingerprint was added; false if a near one was
+ *         already present, or index is NULL.
+ */
+bool simindex_insert(simindex_t* index, const uint64_t fp);
+
+/**
+ * Returns the number of fingerprints in the index.
+ */
+size_t simindex_count(simindex_t* index);
+
+/**
+ * Returns the bytes of memory the index holds.
+ */
+size_t simindex_bytes(simindex_t* index);
+
+/**
+ * Returns the distance the index was created with (-1 if index is NULL).
+ */
+int simindex_maxDistance(simindex_t* index);
+
+/**
+ * Calls itemfunc(arg, fp) once for each fingerprint, in the order they
+ * were added. The index is locked while it is visited.
+ *
+ * @param index The index; NULL does nothing.
+ * @param arg Arbitrary pointer passed along to itemfunc.
+ * @param itemfunc Function to call; NULL does nothing.
+ */
+void simindex_iterate(simindex_t* index, void* arg,
+                      void (*itemfunc)(void* arg, const uint64_t fp));
+
+/**
+ * Deletes the index and frees all associated memory.
+ *
+ * @param index The index; NULL is ignored.
+ */
+void simindex_delete(simindex_t* index);
+
+#endif // __SIMHASH_H
@@ -33,16 +33,67 @@ mkdir -p $TEST_DIR/toscrape-0
 mkdir -p $TEST_DIR/toscrape-1
 mkdir -p $TEST_DIR/wikipedia-0
 mkdir -p $TEST_DIR/wikipedia-1
+mkdir -p $TEST_DIR/letters-10-j4
 
 # Run tests
 echo -e "\nRunning tests...\n"
 
+echo -e "\n===== Keep-alive fetching against a local server (Content-Length, chunked, reuse, close, bad sizes) =====\n"
+valgrind ./fetchtest
+
 echo -e "\n===== Crawling letters site at depth 0 =====\n"
 valgrind ./crawler http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-0 0
 
 echo -e "\n===== Crawling letters site at max depth 10 =====\n"
 valgrind ./crawler http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10 10
 
+echo -e "\n===== Crawling letters site at max depth 10 with 4 workers =====\n"
+valgrind ./crawler -j 4 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-j4 10
+
+echo -e "\n===== Checking the page segments of the depth-10 crawl (9 pages, 16 bytes each in the index) =====\n"
+ls $TEST_DIR/letters-10
+echo "index entries: $(( ($(stat -c %s $TEST_DIR/letters-10/pages.idx) - 16) / 16 ))"
+
+echo -e "\n===== Crawling letters site at depth 10 with compressed pages (smaller segment) =====\n"
+mkdir -p $TEST_DIR/letters-10-z
+./crawler -z http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-z 10 > /dev/null
+ls -l $TEST_DIR/letters-10/pages.0000.seg $TEST_DIR/letters-10-z/pages.0000.seg
+
+echo -e "\n===== Stopping a crawl of the letters site with SIGTERM, then resuming it (9 pages in all) =====\n"
+mkdir -p $TEST_DIR/letters-10-resume
+./crawler -c 2 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-resume 10 > /dev/null &
+sleep 4; kill -TERM $!; wait
+ls -a $TEST_DIR/letters-10-resume
+./crawler --resume $TEST_DIR/letters-10-resume > /dev/null
+ls -a $TEST_DIR/letters-10-resume
+echo "index entries: $(( ($(stat -c %s $TEST_DIR/letters-10-resume/pages.idx) - 16) / 16 ))"
+
+echo -e "\n===== Resuming a crawl that has no checkpoint, and with -z (should fail) =====\n"
+./crawler --resume $TEST_DIR/letters-10
+./crawler -z --resume $TEST_DIR/letters-10
+
+echo -e "\n===== Crawling letters site at depth 10 skipping near-duplicates (no two letters are near; 9 pages) =====\n"
+mkdir -p $TEST_DIR/letters-10-d
+valgrind ./crawler -j 2 -d 3 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-d 10
+echo "index entries: $(( ($(stat -c %s $TEST_DIR/letters-10-d/pages.idx) - 16) / 16 ))"
+
+echo -e "\n===== Crawling with a bad near-duplicate distance, and resuming with -d (should fail) =====\n"
+./crawler -d 8 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-d 10
+./crawler -d 3 --resume $TEST_DIR/letters-10-resume
+
+echo -e "\n===== Crawling letters site at depth 10 with the host and priority frontiers =====\n"
+./crawler -f host http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-j4 10
+./crawler -j 2 -f priority http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-j4 10
+
+echo -e "\n===== Crawling with an unknown frontier policy (should fail) =====\n"
+./crawler -f lifo http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-j4 10
+
+echo -e "\n===== Crawling letters site at depth 1 with --stats (a timing summary on stderr) =====\n"
+./crawler --stats http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-j4 1
+
+echo -e "\n===== Crawling with a bad worker count (should fail) =====\n"
+./crawler -j 0 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $TEST_DIR/letters-10-j4 10
+
 echo -e "\n===== Crawling toscrape site at depth 0 =====\n"
 valgrind ./crawler http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $TEST_DIR/toscrape-0 0
 
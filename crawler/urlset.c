@@ -0,0 +1,249 @@
+/*
+ * urlset.c - CS50 TSE Crawler concurrent "pages seen" set
+ *
+ * see urlset.h for more information.
+ *
+ * The top bits of a fingerprint pick one of NUM_SHARDS shards; the low
+ * bits pick the starting slot in that shard's table, and we probe
+ * linearly from there. A zero slot is empty, which is why fingerprints
+ * are never zero. A shard doubles its table once it is half full, so
+ * probe sequences stay short however many URLs the crawl discovers.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // pthreads
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "urlset.h"
+#include "../libcs50/mem.h"
+
+/**************** constants ****************/
+#define NUM_SHARDS 64            // must be a power of two
+#define SHARD_BITS 6             // log2(NUM_SHARDS)
+static const size_t INITIAL_SLOTS = 64;  // per shard; must be a power of two
+
+/**************** local types ****************/
+typedef struct shard {
+  pthread_mutex_t lock;     // protects the fields below
+  uint64_t* slots;          // open-addressing table; 0 means empty
+  size_t numSlots;          // size of slots[], a power of two
+  size_t count;             // number of non-empty slots
+} shard_t;
+
+typedef struct urlset {
+  shard_t shards[NUM_SHARDS];
+  atomic_size_t count;      // total over all shards
+} urlset_t;
+
+/**************** local functions ****************/
+static shard_t* shardOf(urlset_t* set, const uint64_t fp);
+static bool shardInsert(shard_t* shard, const uint64_t fp);
+static bool shardContains(shard_t* shard, const uint64_t fp);
+static void shardGrow(shard_t* shard);
+
+/**************** urlset_new ****************/
+/* see urlset.h for description */
+urlset_t* urlset_new(void)
+{
+  urlset_t* set = mem_malloc(sizeof(urlset_t));
+  if (set == NULL) {
+    return NULL;
+  }
+
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    shard_t* shard = &set->shards[i];
+    shard->slots = mem_calloc(INITIAL_SLOTS, sizeof(uint64_t));
+    if (shard->slots == NULL) {
+      // unwind the shards we already made
+      while (--i >= 0) {
+        mem_free(set->shards[i].slots);
+        pthread_mutex_destroy(&set->shards[i].lock);
+      }
+      mem_free(set);
+      return NULL;
+    }
+    shard->numSlots = INITIAL_SLOTS;
+    shard->count = 0;
+    pthread_mutex_init(&shard->lock, NULL);
+  }
+  atomic_init(&set->count, 0);
+  return set;
+}
+
+/**************** urlset_insert ****************/
+/* see urlset.h for description */
+bool urlset_insert(urlset_t* set, const char* url)
+{
+  if (set == NULL || url == NULL) {
+    return false;
+  }
+  return urlset_insertFingerprint(set, urlset_fingerprint(url));
+}
+
+/**************** urlset_insertFingerprint ****************/
+/* see urlset.h for description */
+bool urlset_insertFingerprint(urlset_t* set, const uint64_t fp)
+{
+  if (set == NULL || fp == 0) {
+    return false;
+  }
+
+  shard_t* shard = shardOf(set, fp);
+  pthread_mutex_lock(&shard->lock);
+  bool inserted = shardInsert(shard, fp);
+  pthread_mutex_unlock(&shard->lock);
+
+  if (inserted) {
+    atomic_fetch_add(&set->count, 1);
+  }
+  return inserted;
+}
+
+/**************** urlset_contains ****************/
+/* see urlset.h for description */
+bool urlset_contains(urlset_t* set, const char* url)
+{
+  if (set == NULL || url == NULL) {
+    return false;
+  }
+
+  uint64_t fp = urlset_fingerprint(url);
+  shard_t* shard = shardOf(set, fp);
+  pthread_mutex_lock(&shard->lock);
+  bool found = shardContains(shard, fp);
+  pthread_mutex_unlock(&shard->lock);
+  return found;
+}
+
+/**************** urlset_fingerprint ****************/
+/* see urlset.h for description.
+ * 64-bit FNV-1a over the URL, finished with the splitmix64 mixer
+ * so that both the high (shard) and low (slot) bits are well spread.
+ */
+uint64_t urlset_fingerprint(const char* url)
+{
+  if (url == NULL) {
+    return 0;
+  }
+
+  uint64_t h = 0xcbf29ce484222325ULL;       // FNV offset basis
+  for (const unsigned char* p = (const unsigned char*) url; *p != '\0'; p++) {
+    h ^= *p;
+    h *= 0x100000001b3ULL;                  // FNV prime
+  }
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+
+  return h == 0 ? 1 : h;                    // 0 marks an empty slot
+}
+
+/**************** urlset_count ****************/
+/* see urlset.h for description */
+size_t urlset_count(urlset_t* set)
+{
+  return set == NULL ? 0 : atomic_load(&set->count);
+}
+
+/**************** urlset_iterate ****************/
+/* see urlset.h for description */
+void urlset_iterate(urlset_t* set, void* arg,
+                    void (*itemfunc)(void* arg, const uint64_t fp))
+{
+  if (set == NULL || itemfunc == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    shard_t* shard = &set->shards[i];
+    pthread_mutex_lock(&shard->lock);
+    for (size_t slot = 0; slot < shard->numSlots; slot++) {
+      if (shard->slots[slot] != 0) {
+        (*itemfunc)(arg, shard->slots[slot]);
+      }
+    }
+    pthread_mutex_unlock(&shard->lock);
+  }
+}
+
+/**************** urlset_delete ****************/
+/* see urlset.h for description */
+void urlset_delete(urlset_t* set)
+{
+  if (set != NULL) {
+    for (int i = 0; i < NUM_SHARDS; i++) {
+      mem_free(set->shards[i].slots);
+      pthread_mutex_destroy(&set->shards[i].lock);
+    }
+    mem_free(set);
+  }
+}
+
+/* Returns the shard responsible for a fingerprint (from its top bits) */
+static shard_t* shardOf(urlset_t* set, const uint64_t fp)
+{
+  return &set->shards[fp >> (64 - SHARD_BITS)];
+}
+
+/* Inserts fp into the shard, which the caller has locked.
+ * Returns true iff it was not already there.
+ */
+static bool shardInsert(shard_t* shard, const uint64_t fp)
+{
+  size_t mask = shard->numSlots - 1;
+  size_t slot = fp & mask;
+  while (shard->slots[slot] != 0) {
+    if (shard->slots[slot] == fp) {
+      return false;                 // already seen
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  shard->slots[slot] = fp;
+  shard->count++;
+  if (2 * shard->count > shard->numSlots) {
+    shardGrow(shard);               // keep the table at most half full
+  }
+  return true;
+}
+
+/* Returns true iff fp is in the shard, which the caller has locked */
+static bool shardContains(shard_t* shard, const uint64_t fp)
+{
+  size_t mask = shard->numSlots - 1;
+  for (size_t slot = fp & mask; shard->slots[slot] != 0; slot = (slot + 1) & mask) {
+    if (shard->slots[slot] == fp) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Doubles the shard's table and re-inserts every fingerprint */
+static void shardGrow(shard_t* shard)
+{
+  size_t oldSlots = shard->numSlots;
+  uint64_t* old = shard->slots;
+
+  shard->numSlots = 2 * oldSlots;
+  shard->slots = mem_calloc_assert(shard->numSlots, sizeof(uint64_t), "urlset shard");
+  size_t mask = shard->numSlots - 1;
+
+  for (size_t i = 0; i < oldSlots; i++) {
+    if (old[i] != 0) {
+      size_t slot = old[i] & mask;
+      while (shard->slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+      }
+      shard->slots[slot] = old[i];
+    }
+  }
+  mem_free(old);
+}
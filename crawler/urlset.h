@@ -0,0 +1,108 @@
+/*
+ * urlset.h - CS50 TSE Crawler concurrent "pages seen" set
+ *
+ * A urlset remembers which URLs the crawler has already queued. Each URL
+ * is reduced to a 64-bit fingerprint, so the set costs eight bytes per
+ * URL no matter how long the URL is. The set is split into shards, each
+ * with its own lock and its own open-addressing table that doubles when
+ * it becomes half full; crawler threads inserting different URLs almost
+ * never contend for the same lock.
+ *
+ * Functions:
+ *  - `urlset_new`: Creates an empty set.
+ *  - `urlset_insert`: Adds a URL unless already present (insert-if-absent).
+ *  - `urlset_contains`: Checks whether a URL is present.
+ *  - `urlset_fingerprint`: Returns the 64-bit fingerprint of a URL.
+ *  - `urlset_insertFingerprint`: Adds a fingerprint directly.
+ *  - `urlset_count`: Returns the number of URLs in the set.
+ *  - `urlset_iterate`: Calls a function on every fingerprint.
+ *  - `urlset_delete`: Frees the set.
+ *
+ * Assumptions:
+ *  - Two distinct URLs may (with probability about n^2 / 2^65 for n URLs)
+ *    share a fingerprint; the crawler accepts skipping such a page.
+ *
+ * Error Handling:
+ *  - `urlset_new` returns NULL on allocation failure; running out of
+ *    memory while growing a shard terminates the program via `mem_assert`.
+ *  - All functions except `urlset_delete` are safe to call concurrently.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __URLSET_H
+#define __URLSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The concurrent set of seen URLs; opaque to users of the module */
+typedef struct urlset urlset_t;
+
+/**
+ * Creates a new, empty set.
+ *
+ * @return Pointer to a new `urlset_t`, or NULL on failure.
+ */
+urlset_t* urlset_new(void);
+
+/**
+ * Adds a URL to the set if it is not already there.
+ *
+ * @param set The set.
+ * @param url The (normalized) URL; it is not retained.
+ * @return true iff the URL was newly added; false if already present or NULL args.
+ */
+bool urlset_insert(urlset_t* set, const char* url);
+
+/**
+ * Checks whether a URL is in the set.
+ *
+ * @param set The set.
+ * @param url The URL to look for.
+ * @return true iff present.
+ */
+bool urlset_contains(urlset_t* set, const char* url);
+
+/**
+ * Returns the 64-bit fingerprint the set uses for a URL (never 0).
+ *
+ * @param url The URL; NULL gives 0.
+ */
+uint64_t urlset_fingerprint(const char* url);
+
+/**
+ * Adds a fingerprint, as returned by `urlset_fingerprint`, to the set.
+ *
+ * @param set The set.
+ * @param fp The fingerprint; 0 is ignored.
+ * @return true iff the fingerprint was newly added.
+ */
+bool urlset_insertFingerprint(urlset_t* set, const uint64_t fp);
+
+/**
+ * Returns the number of URLs in the set.
+ */
+size_t urlset_count(urlset_t* set);
+
+/**
+ * Calls itemfunc(arg, fp) once for each fingerprint, in undefined order.
+ * Each shard is locked while it is visited.
+ *
+ * @param set The set; NULL does nothing.
+ * @param arg Arbitrary pointer passed along to itemfunc.
+ * @param itemfunc Function to call; NULL does nothing.
+ */
+void urlset_iterate(urlset_t* set, void* arg,
+                    void (*itemfunc)(void* arg, const uint64_t fp));
+
+/**
+ * Deletes the set and frees all associated memory.
+ *
+ * @param set The set; NULL is ignored.
+ */
+void urlset_delete(urlset_t* set);
+
+#endif // __URLSET_H
@@ -8,17 +8,58 @@
 *
 * Functions in this file:
 *
-*     parseArgs(argc, argv, pageDirectory, indexFilename)
+*     parseArgs(argc, argv, pageDirectory, indexFilename, numThreads, binary, mode, numShards, hashShards)
 *         Parses and validates command-line arguments. Ensures the page directory 
-*         exists and the index file can be written to.
+*         exists and the index file can be written to. With -b, the index is
+*         saved in the binary format (see index.h) instead of as text.
+*         With -u or -m, the index file must already exist.
 *
-*     indexBuild(pageDirectory, index)
-*         Reads webpages from the page directory, extracts words, and inserts 
-*         them into an index.
+*     updateIndex(pageDirectory, indexFilename, numThreads)
+*         With -u: indexes only the pages after the index's high-water mark
+*         into a new index segment (see indexset.h).
 *
-*     indexPage(page, docID, index)
-*         Extracts words from a single webpage, normalizes them, and inserts 
-*         them into the index.
+*     indexBuild(pageDirectory, firstDoc, index, docs, numThreads)
+*         Reads webpages from the page directory, from firstDoc on, extracts words, and inserts 
+*         them into an index, recording each document's URL, depth, and length
+*         in a document table. With more than one thread, each thread indexes
+*         a range of documents into a private partial index and table
+*         (indexWorker), and the partials are then merged.
+*
+*     indexRange(pageDirectory, firstDoc, lastDoc, index, docs)
+*         Indexes documents firstDoc..lastDoc, stopping early at a missing one.
+*
+*     indexPage(map, docID, index)
+*         Extracts words from a single memory-mapped webpage, normalizes them, 
+*         and inserts them into the index; returns how many it inserted.
+*
+*     saveShards(index, docs, indexFilename, numShards, hashShards, binary)
+*         With -s: splits the index into shards by document and saves each
+*         as an index of its own.
+*
+* Alongside the index, the indexer saves the document table to
+* indexFilename.docs (see doctable.h), so the querier can print results
+* without opening the page files, and every posting's BM25 impact score to
+* indexFilename.impacts (see impacts.h), for the querier's -r bm25.
+*
+* With -u, pages added by the crawler since the index was built (say, by
+* `crawler --resume`) are indexed into segment indexFilename.1, then .2,
+* and so on, which the querier searches along with the index; only the
+* new pages are read. With -m, the segments are compacted: merged into
+* indexFilename, which keeps its format, and removed.
+*
+* With -s numShards, the documents are split into that many shards, by
+* docID range (-p range, the default: shard i has the i-th numShards-th
+* of the docIDs) or by a hash of the docID (-p hash, which spreads runs
+* of related pages), and shard i is saved as a complete index,
+* indexFilename.s<i>, with its own document table and impacts; there is
+* no indexFilename. Each shard can be served by its own `querier --serve`
+* and searched as one by `querier --shards` (see querier.c). A shard's
+* impacts are scored for the whole collection, so BM25 ranks the same
+* across shards as in one index.
+*
+* With --stats, the indexer times the reading of each page, the indexing
+* of its words, and each word's insertion (see stats.h), and prints a
+* summary of them to stderr when it exits.
 *
 * The indexer assumes that the input directory was created by the TSE Crawler 
 * and contains valid webpage data. It also assumes the index file location is 
@@ -34,16 +75,75 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <pthread.h>
 #include "../common/index.h"
+#include "../common/impacts.h"
+#include "../common/indexset.h"
+#include "../common/doctable.h"
 #include "../common/pagedir.h"
+#include "../common/pagestream.h"
+#include "../common/stats.h"
+#include "../common/tokenizer.h"
 #include "../common/word.h"
 #include "../libcs50/webpage.h"
 #include "../libcs50/mem.h"  // Include CS50's memory functions
 
+/**************** constants ****************/
+#define MAX_THREADS 64        // upper bound for -j
+#define MAX_SHARDS 64         // upper bound for -s
+
+/**************** local types ****************/
+/* What the indexer was asked to do */
+typedef enum {
+  INDEX_BUILD,                // index every page into indexFilename
+  INDEX_UPDATE,               // -u: index the new pages into a segment
+  INDEX_COMPACT               // -m: merge the segments into indexFilename
+} indexMode_t;
+
+/* The shards an index is being split into (-s) */
+typedef struct shardsplit {
+  int numShards;
+  bool hash;                  // -p hash, else by docID range
+  int firstDoc;               // the documents being split: firstDoc..endDoc-1
+  int endDoc;
+  index_t** indexes;          // one per shard
+  doctable_t** docs;          // one per shard
+  char* word;                 // a null-terminated copy of the word being split
+  size_t wordRoom;
+} shardsplit_t;
+
+/* 'arg' for shardOtherDocs: a shard, and the index it is part of */
+typedef struct shardcontext {
+  index_t* whole;
+  index_t* shard;
+} shardcontext_t;
+
+/* One indexing thread's share of the work */
+typedef struct indexjob {
+  const char* pageDirectory;
+  int firstDoc;               // documents firstDoc..lastDoc
+  int lastDoc;
+  index_t* partial;           // private index for this range
+  doctable_t* docs;           // private document table for this range
+} indexjob_t;
+
 /**************** function prototypes ****************/
-static void parseArgs(int argc, char* argv[], char** pageDirectory, char** indexFilename);
-static void indexBuild(const char *pageDirectory, index_t *index);
-static void indexPage(webpage_t *page, const int docID, index_t *index);
+static void parseArgs(int argc, char* argv[], char** pageDirectory, char** indexFilename, int* numThreads, bool* binary, indexMode_t* mode,
+                      int* numShards, bool* hashShards);
+static void updateIndex(const char *pageDirectory, const char *indexFilename, const int numThreads);
+static void indexBuild(const char *pageDirectory, const int firstDoc, index_t *index, doctable_t *docs, const int numThreads);
+static void* indexWorker(void* arg);
+static void indexRange(const char *pageDirectory, const int firstDoc, const int lastDoc, index_t *index, doctable_t *docs);
+static int indexPage(const pagemap_t *map, const int docID, index_t *index);
+static void saveDocTable(doctable_t *docs, const char *indexFilename);
+static void saveImpacts(index_t *index, doctable_t *docs, const impacts_stats_t *stats, const char *indexFilename);
+static void saveIndex(index_t *index, const char *indexFilename, const bool binary);
+static void saveShards(index_t *index, doctable_t *docs, const char *indexFilename, const int numShards,
+                       const bool hashShards, const bool binary);
+static int shardOf(const shardsplit_t *split, const int docID);
+static void splitWord(void *arg, const char *word, const size_t len, const postings_t *postings);
+static int shardOtherDocs(void *arg, const char *word);
 
 /**************** main ****************/
 /**
@@ -58,30 +158,57 @@ int main(int argc, char* argv[])
 {
   char* pageDirectory;
   char* indexFilename;
+  int numThreads;
+  bool binary;
+  indexMode_t mode;
+  int numShards;
+  bool hashShards;
 
   // Parse and validate command-line arguments
-  parseArgs(argc, argv, &pageDirectory, &indexFilename);
+  parseArgs(argc, argv, &pageDirectory, &indexFilename, &numThreads, &binary, &mode, &numShards, &hashShards);
+
+  // Updating and compacting work on the index's segments instead
+  if (mode == INDEX_UPDATE) {
+    updateIndex(pageDirectory, indexFilename, numThreads);
+    exit(0);
+  }
+  if (mode == INDEX_COMPACT) {
+    int merged = indexset_compact(indexFilename);
+    if (merged < 0) {
+      fprintf(stderr, "Error: Failed to compact index file '%s'.\n", indexFilename);
+      exit(1);
+    }
+    printf("Merged %d segment%s into %s\n", merged, merged == 1 ? "" : "s", indexFilename);
+    exit(0);
+  }
 
-  // Create an index with a reasonable size
+  // Create an index; it grows with the vocabulary
   index_t* index = index_new(500);
   if (index == NULL) {
     fprintf(stderr, "Error: Could not allocate memory for index.\n");
     exit(1);
   }
 
-  // Build the index from the page directory
-  indexBuild(pageDirectory, index);
+  // Create the document table; it grows with the documents
+  doctable_t* docs = doctable_new();
 
-  // Open the index file for writing
-  FILE* indexFile = fopen(indexFilename, "w");
-  // Do not need to check again, already did in parseArgs
+  // Build the index and document table from the page directory
+  indexBuild(pageDirectory, 1, index, docs, numThreads);
 
-  // Save the index to the file
-  index_save(index, indexFile);
-  fclose(indexFile);
+  // Save the index to the file, in the requested format, or its shards
+  if (numShards > 0) {
+    saveShards(index, docs, indexFilename, numShards, hashShards, binary);
+  } else {
+    saveIndex(index, indexFilename, binary);
+
+    // Save the document table and the impacts next to the index
+    saveDocTable(docs, indexFilename);
+    saveImpacts(index, docs, NULL, indexFilename);
+  }
 
   // Free memory before exiting
   index_delete(index);
+  doctable_delete(docs);
 
   // Exit successfully
   exit(0);
@@ -96,19 +223,107 @@ int main(int argc, char* argv[])
  * @param argv Array of command-line argument strings.
  * @param pageDirectory Pointer to store the validated page directory.
  * @param indexFilename Pointer to store the validated index filename.
+ * @param numThreads Pointer to store the number of indexing threads (-j, default 1).
+ * @param binary Pointer to store whether to save the index in binary (-b).
+ * @param mode Pointer to store whether to build, update (-u) or compact (-m) the index.
+ * @param numShards Pointer to store the number of shards to split the index into (-s), or 0.
+ * @param hashShards Pointer to store whether to split it by docID hash (-p hash) instead of range.
  * 
  * Assumptions: The caller provides `argc` and `argv` from `main()`.
  * Exits if arguments are invalid or if the index file cannot be written.
+ * With -m there is no pageDirectory (it is set to NULL). With -s the
+ * shard files are checked when they are written. --stats starts the
+ * stats timers (see stats.h) at once.
  */
-static void parseArgs(int argc, char* argv[], char** pageDirectory, char** indexFilename)
+static void parseArgs(int argc, char* argv[], char** pageDirectory, char** indexFilename, int* numThreads, bool* binary, indexMode_t* mode,
+                      int* numShards, bool* hashShards)
 {
-  if (argc != 3) {
-    fprintf(stderr, "Usage: ./indexer pageDirectory indexFilename\n");
+  const char* usage = "Usage: ./indexer [-j numThreads] [-b] [-u | -s numShards [-p range|hash]] [--stats] pageDirectory indexFilename\n"
+                      "       ./indexer [--stats] -m indexFilename\n";
+  int arg = 1;
+  bool partitionGiven = false;
+  *numThreads = 1;
+  *binary = false;
+  *mode = INDEX_BUILD;
+  *numShards = 0;
+  *hashShards = false;
+
+  // Parse options; -j, -s and -p take one value
+  while (arg < argc && argv[arg][0] == '-') {
+    if (strcmp(argv[arg], "--stats") == 0) {
+      if (!stats_enable()) {
+        fprintf(stderr, "Warning: --stats reports nothing; the indexer was built with -DNOSTATS.\n");
+      }
+      arg++;
+      continue;
+    }
+    if (strcmp(argv[arg], "-b") == 0) {
+      *binary = true;
+      arg++;
+      continue;
+    }
+    if (strcmp(argv[arg], "-u") == 0 || strcmp(argv[arg], "-m") == 0) {
+      if (*mode != INDEX_BUILD) {
+        fprintf(stderr, "%s", usage);   // -u and -m exclude each other
+        exit(1);
+      }
+      *mode = argv[arg][1] == 'u' ? INDEX_UPDATE : INDEX_COMPACT;
+      arg++;
+      continue;
+    }
+    if (arg + 1 < argc && strcmp(argv[arg], "-s") == 0) {
+      *numShards = atoi(argv[arg + 1]);
+      if (*numShards < 2 || *numShards > MAX_SHARDS) {
+        fprintf(stderr, "Error: numShards must be between 2 and %d.\n", MAX_SHARDS);
+        exit(1);
+      }
+      arg += 2;
+      continue;
+    }
+    if (arg + 1 < argc && strcmp(argv[arg], "-p") == 0) {
+      if (strcmp(argv[arg + 1], "range") != 0 && strcmp(argv[arg + 1], "hash") != 0) {
+        fprintf(stderr, "Error: partition must be range or hash.\n");
+        exit(1);
+      }
+      *hashShards = strcmp(argv[arg + 1], "hash") == 0;
+      partitionGiven = true;
+      arg += 2;
+      continue;
+    }
+    if (arg + 1 >= argc || strcmp(argv[arg], "-j") != 0) {
+      fprintf(stderr, "%s", usage);
+      exit(1);
+    }
+    *numThreads = atoi(argv[arg + 1]);
+    if (*numThreads < 1 || *numThreads > MAX_THREADS) {
+      fprintf(stderr, "Error: numThreads must be between 1 and %d.\n", MAX_THREADS);
+      exit(1);
+    }
+    arg += 2;
+  }
+  if ((*numShards > 0 && *mode != INDEX_BUILD) || (partitionGiven && *numShards == 0)) {
+    fprintf(stderr, "%s", usage);   // -s only builds, and -p only goes with it
     exit(1);
   }
 
-  *pageDirectory = argv[1];
-  *indexFilename = argv[2];
+  // Compacting needs just the index
+  if (*mode == INDEX_COMPACT) {
+    if (argc - arg != 1) {
+      fprintf(stderr, "%s", usage);
+      exit(1);
+    }
+    *pageDirectory = NULL;
+    *indexFilename = argv[arg];
+    return;
+  }
+
+  if (argc - arg != 2) {
+    fprintf(stderr, "%s", usage);
+    exit(1);
+  }
+
+  *pageDirectory = argv[arg];
+  *indexFilename = argv[arg + 1];
 
   // Validate page directory
   if (!pagedir_validate(*pageDirectory)) {
@@ -116,6 +331,12 @@ static void parseArgs(int argc, char* argv[], char** pageDirectory, char** index
     exit(1);
   }
 
+  // Updating adds a segment next to the index, which must be left as it is;
+  // sharding writes no indexFilename at all
+  if (*mode == INDEX_UPDATE || *numShards > 0) {
+    return;
+  }
+
   // Try opening the index file to ensure it's writable
   FILE* file = fopen(*indexFilename, "w");
   if (file == NULL) {
@@ -125,73 +346,455 @@ static void parseArgs(int argc, char* argv[], char** pageDirectory, char** index
   fclose(file);  // Close file after checking
 }
 
+/**************** updateIndex ****************/
+/**
+ * Indexes the pages added since the index was built or last updated into
+ * a new segment of it.
+ *
+ * @param pageDirectory The path to the directory containing crawler-produced pages.
+ * @param indexFilename The index to add a segment to.
+ * @param numThreads The number of threads to index with.
+ * 
+ * The pages indexed are those after the high-water mark, the largest
+ * docID in the document tables of the index and its segments; the crawler
+ * only ever adds pages after its last one. Exits with an error message if
+ * the index cannot be loaded, has no document table, or covers more pages
+ * than the directory has (it was then built from another crawl).
+ */
+static void updateIndex(const char* pageDirectory, const char* indexFilename, const int numThreads)
+{
+  indexset_t* set = indexset_open(indexFilename);
+  if (set == NULL) {
+    fprintf(stderr, "Error: Could not load index file '%s' to update.\n", indexFilename);
+    exit(1);
+  }
+  int lastDoc = indexset_lastDoc(set);
+  indexset_delete(set);
+  if (lastDoc < 0) {
+    fprintf(stderr, "Error: Index file '%s' has no document table; rebuild it without -u.\n", indexFilename);
+    exit(1);
+  }
+  int numDocs = pagedir_numDocs(pageDirectory);
+  if (numDocs < lastDoc) {
+    fprintf(stderr, "Error: '%s' has %d pages but the index covers %d; rebuild it without -u.\n",
+            pageDirectory, numDocs, lastDoc);
+    exit(1);
+  }
+
+  // Index just the new pages
+  index_t* index = index_new(500);
+  doctable_t* docs = doctable_new();
+  if (index == NULL) {
+    fprintf(stderr, "Error: Could not allocate memory for index.\n");
+    exit(1);
+  }
+  indexBuild(pageDirectory, lastDoc + 1, index, docs, numThreads);
+
+  int firstDoc = doctable_firstDoc(docs);
+  if (firstDoc == doctable_size(docs)) {
+    printf("No pages after document %d; %s is up to date\n", lastDoc, indexFilename);
+  } else {
+    int segment = indexset_addSegment(indexFilename, index, docs);
+    if (segment == 0) {
+      fprintf(stderr, "Error: Failed to write a segment of index file '%s'.\n", indexFilename);
+      exit(1);
+    }
+    printf("Indexed documents %d to %d into segment %s.%d\n",
+           firstDoc, doctable_size(docs) - 1, indexFilename, segment);
+  }
+  index_delete(index);
+  doctable_delete(docs);
+}
+
 /**************** indexBuild ****************/
 /**
  * Reads pages from the page directory, processes each document, and builds the index.
  *
  * @param pageDirectory The path to the directory containing crawler-produced pages.
+ * @param firstDoc The first document ID to index (1 for all of them).
  * @param index The index structure to store word-document frequency mappings.
+ * @param docs The document table to record each document in.
+ * @param numThreads The number of threads to index with.
  * 
- * Assumptions: `index` is allocated before calling this function.
- * The function will read all pages sequentially until an invalid document ID is encountered.
+ * Assumptions: `index` and `docs` are allocated before calling this function.
+ * The function will read all pages from firstDoc on sequentially until an invalid document ID is encountered.
+ * With several threads, the documents firstDoc..N (N from pagedir_numDocs) are split into
+ * contiguous ranges, one per thread; each thread fills its own partial index, since
+ * an index_t cannot be written concurrently. The ranges are disjoint, so merging the
+ * partials in order just appends each word's documents.
  */
-void indexBuild(const char* pageDirectory, index_t* index)
+static void indexBuild(const char* pageDirectory, const int firstDoc, index_t* index, doctable_t* docs, const int numThreads)
 {
-  int docID = 1;
-  char* filepath = mem_malloc(strlen(pageDirectory) + 12); // Allocate space for directory + docID
-  if (filepath == NULL) {
-    fprintf(stderr, "Error: Could not allocate memory for filepath.\n");
-    exit(1);
+  if (numThreads == 1) {
+    indexRange(pageDirectory, firstDoc, INT_MAX, index, docs);
+    return;
   }
 
-  // Loop through document files in pageDirectory
-  while (1) {
-    snprintf(filepath, strlen(pageDirectory) + 12, "%s/%d", pageDirectory, docID);
-    FILE* fp = fopen(filepath, "r");
-    if (fp == NULL) {
-      break;  // Stop when we reach a missing document ID
-    }
+  int numDocs = pagedir_numDocs(pageDirectory) - firstDoc + 1;
+  int numJobs = numDocs < numThreads ? numDocs : numThreads;
+  if (numJobs <= 0) {
+    return;  // Nothing to index
+  }
 
-    // Load the webpage from the open file
-    webpage_t* page = pagedir_load(fp);
-    fclose(fp);  // Close the file immediately after reading
+  indexjob_t* jobs = mem_calloc_assert(numJobs, sizeof(indexjob_t), "indexer jobs");
+  pthread_t* threads = mem_calloc_assert(numJobs, sizeof(pthread_t), "indexer threads");
 
-    if (page != NULL) {
-      indexPage(page, docID, index);
-      webpage_delete(page); // Free memory after use
+  // Divide the numDocs documents from firstDoc on as evenly as possible
+  int nextDoc = firstDoc;
+  for (int i = 0; i < numJobs; i++) {
+    int count = numDocs / numJobs + (i < numDocs % numJobs ? 1 : 0);
+    jobs[i].pageDirectory = pageDirectory;
+    jobs[i].firstDoc = nextDoc;
+    jobs[i].lastDoc = nextDoc + count - 1;
+    jobs[i].partial = index_new(500);
+    jobs[i].docs = doctable_new();
+    if (jobs[i].partial == NULL || jobs[i].docs == NULL) {
+      fprintf(stderr, "Error: Could not allocate memory for index.\n");
+      exit(1);
+    }
+    nextDoc += count;
+    if (pthread_create(&threads[i], NULL, indexWorker, &jobs[i]) != 0) {
+      fprintf(stderr, "Error: Could not create indexer thread.\n");
+      exit(1);
     }
+  }
 
-    docID++;
+  // Wait for each range in turn and merge it, keeping documents in order
+  for (int i = 0; i < numJobs; i++) {
+    pthread_join(threads[i], NULL);
+    index_merge(index, jobs[i].partial);
+    index_delete(jobs[i].partial);
+    doctable_merge(docs, jobs[i].docs);
+    doctable_delete(jobs[i].docs);
   }
 
-  free(filepath);  // Free allocated memory
+  mem_free(threads);
+  mem_free(jobs);
+}
+
+/**************** indexWorker ****************/
+/**
+ * Thread body: indexes one job's range of documents into its partial index
+ * and document table.
+ *
+ * @param arg The thread's `indexjob_t`.
+ * @return NULL.
+ */
+static void* indexWorker(void* arg)
+{
+  indexjob_t* job = arg;
+  indexRange(job->pageDirectory, job->firstDoc, job->lastDoc, job->partial, job->docs);
+  return NULL;
+}
+
+/**************** indexRange ****************/
+/**
+ * Indexes the documents firstDoc..lastDoc of the page directory.
+ *
+ * @param pageDirectory The path to the directory containing crawler-produced pages.
+ * @param firstDoc The first document ID to index.
+ * @param lastDoc The last document ID to index (INT_MAX for "all").
+ * @param index The index to insert into.
+ * @param docs The document table to record each indexed document in.
+ * 
+ * Reads the pages through a `pagecursor_t`, so page files and segments
+ * alike are read in docID order. Stops early at the first missing
+ * document ID; unreadable or malformed documents are skipped.
+ */
+static void indexRange(const char* pageDirectory, const int firstDoc, const int lastDoc, index_t* index, doctable_t* docs)
+{
+  pagecursor_t* cursor = pagedir_openCursor(pageDirectory, firstDoc);
+  if (cursor == NULL) {
+    return;
+  }
+
+  // Walk the pages in docID order; their html is tokenized in place, never copied
+  int docID;
+  pagemap_t map;
+  while (pagedir_next(cursor, &docID, &map) && docID <= lastDoc) {
+    STATS_START(start);
+    int length = indexPage(&map, docID, index);
+    STATS_STOP(STATS_INDEX_PAGE, start);
+    doctable_set(docs, docID, map.url, map.urlLen, map.depth, length);
+  }
+
+  pagedir_closeCursor(cursor);
 }
 
 /**************** indexPage ****************/
 /**
  * Processes a webpage by extracting words, normalizing them, and adding them to the index.
  *
- * @param page A pointer to the webpage structure.
+ * @param map A webpage mapped by `pagedir_map` or read by `pagedir_next`.
  * @param docID The document ID associated with the webpage.
  * @param index The index structure where words will be stored.
+ * @return The number of words inserted: the document's length.
  * 
  * Assumptions: The `index` structure is initialized and allocated.
  * The function ignores words shorter than three characters.
+ * Words are the same ones `webpage_getNextWord` would find in the html.
  */
-static void indexPage(webpage_t *page, const int docID, index_t *index)
+static int indexPage(const pagemap_t *map, const int docID, index_t *index)
 {
-  int pos = 0;
-  char *word;
-
-  // Extract each word from the webpage content
-  while ((word = webpage_getNextWord(page, &pos)) != NULL) {
-    if (strlen(word) >= 3) {  // Ignore short words (less than 3 characters)
-      char* normalizedWord = normalizeWord(word);
-      if (normalizedWord != NULL) {  // Ensure memory allocation was successful
-        index_insert(index, normalizedWord, docID);
-        free(normalizedWord);  // Free after inserting into the index
+  int length = 0;
+  pagestream_t stream;
+  tokenizer_span_t spans[64];   // words are scanned a batch at a time
+  size_t n;
+  char* buf = NULL;       // reusable buffer for the lowercase word
+  size_t bufSize = 0;
+
+  // Extract each word from the mapped webpage content, decompressing it
+  // a block at a time if need be; nothing is allocated per word, and
+  // short words are dropped before any copy
+  pagestream_open(&stream, map);
+  while ((n = pagestream_nextMany(&stream, spans, 64)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      if (spans[i].len >= 3) {  // Ignore short words (less than 3 characters)
+        char* normalizedWord = normalizeWordInto(spans[i].word, spans[i].len, &buf, &bufSize);
+        if (normalizedWord != NULL) {  // Ensure memory allocation was successful
+          index_insertn(index, normalizedWord, spans[i].len, docID);
+          length++;
+        }
       }
     }
-    free(word);
   }
+  if (!pagestream_close(&stream)) {
+    fprintf(stderr, "Error: corrupt compressed HTML in document %d; indexed up to the corruption\n", docID);
+  }
+  if (buf != NULL) {
+    mem_free(buf);
+  }
+  return length;
+}
+
+/**************** saveDocTable ****************/
+/**
+ * Saves the document table to indexFilename.docs.
+ *
+ * @param docs The document table.
+ * @param indexFilename The index filename the table belongs with.
+ * 
+ * Exits with an error message if the table cannot be written.
+ */
+static void saveDocTable(doctable_t *docs, const char *indexFilename)
+{
+  char* docsFilename = doctable_filename(indexFilename);
+  FILE* docsFile = fopen(docsFilename, "wb");
+  bool ok = docsFile != NULL && doctable_save(docs, docsFile);
+  if (docsFile != NULL && fclose(docsFile) != 0) {
+    ok = false;
+  }
+  if (!ok) {
+    fprintf(stderr, "Error: Failed to write document table '%s'.\n", docsFilename);
+    exit(1);
+  }
+  mem_free(docsFilename);
+}
+
+/**************** saveImpacts ****************/
+/**
+ * Scores every posting of the index and saves the impacts to
+ * indexFilename.impacts.
+ *
+ * @param index The index.
+ * @param docs The index's document table, for the documents' lengths.
+ * @param stats The statistics of the collection the index is part of, or
+ *              NULL if it is the whole collection.
+ * @param indexFilename The index filename the impacts belong with.
+ * 
+ * A collection of no documents has nothing to score, and gets no impacts.
+ * Exits with an error message if the impacts cannot be written.
+ */
+static void saveImpacts(index_t *index, doctable_t *docs, const impacts_stats_t *stats, const char *indexFilename)
+{
+  impacts_stats_t whole = { 0, 0, 0, NULL, NULL };
+  if (stats == NULL) {
+    impacts_addDocs(&whole, docs);
+    stats = &whole;
+  }
+  char* impactsFilename = impacts_filename(indexFilename);
+  if (stats->totalLength == 0) {
+    remove(impactsFilename);      // one left from an earlier index would not match
+    mem_free(impactsFilename);
+    return;
+  }
+  FILE* impactsFile = fopen(impactsFilename, "wb");
+  bool ok = impactsFile != NULL && impacts_save(index, docs, stats, impactsFile);
+  if (impactsFile != NULL && fclose(impactsFile) != 0) {
+    ok = false;
+  }
+  if (!ok) {
+    fprintf(stderr, "Error: Failed to write impacts '%s'.\n", impactsFilename);
+    exit(1);
+  }
+  mem_free(impactsFilename);
+}
+
+/**************** saveIndex ****************/
+/**
+ * Saves an index to a file, in the requested format.
+ *
+ * @param index The index.
+ * @param indexFilename The file to write.
+ * @param binary Whether to use the binary format (-b) instead of text.
+ * 
+ * Exits with an error message if the file cannot be written.
+ */
+static void saveIndex(index_t *index, const char *indexFilename, const bool binary)
+{
+  FILE* indexFile = fopen(indexFilename, binary ? "wb" : "w");
+  bool ok = indexFile != NULL;
+  if (ok && binary) {
+    ok = index_save_binary(index, indexFile);
+  } else if (ok) {
+    index_save(index, indexFile);
+  }
+  if (indexFile != NULL && fclose(indexFile) != 0) {
+    ok = false;
+  }
+  if (!ok) {
+    fprintf(stderr, "Error: Failed to write index file '%s'.\n", indexFilename);
+    exit(1);
+  }
+}
+
+/**************** saveShards ****************/
+/**
+ * Splits an index and its document table into shards by document, and
+ * saves shard i as indexFilename.s<i>, with its document table and impacts.
+ *
+ * @param index The index of every document.
+ * @param docs Its document table.
+ * @param indexFilename The base name of the shards' files.
+ * @param numShards The number of shards.
+ * @param hashShards Whether to assign documents by a hash of their docID
+ *                   instead of by docID range.
+ * @param binary Whether to save the shards in the binary format.
+ * 
+ * Every shard's impacts are scored with the statistics of the whole
+ * collection (its document count and lengths, and each word's document
+ * frequency over all shards) and with the scale the whole index would
+ * get, so each posting has the impact it would have in one index. A shard
+ * may have no documents (more shards than documents); it is still saved.
+ * Exits with an error message if a file cannot be written.
+ */
+static void saveShards(index_t *index, doctable_t *docs, const char *indexFilename, const int numShards,
+                       const bool hashShards, const bool binary)
+{
+  shardsplit_t split = { numShards, hashShards, doctable_firstDoc(docs), doctable_size(docs),
+                         NULL, NULL, NULL, 0 };
+  split.indexes = mem_calloc_assert(numShards, sizeof(index_t*), "indexer shards");
+  split.docs = mem_calloc_assert(numShards, sizeof(doctable_t*), "indexer shards");
+  for (int i = 0; i < numShards; i++) {
+    split.indexes[i] = index_new(500);
+    split.docs[i] = doctable_new();
+    if (split.indexes[i] == NULL || split.docs[i] == NULL) {
+      fprintf(stderr, "Error: Could not allocate memory for index.\n");
+      exit(1);
+    }
+  }
+
+  // Step 1: Deal out the documents, then each word's postings
+  docinfo_t info;
+  for (int docID = split.firstDoc; docID < split.endDoc; docID++) {
+    if (doctable_get(docs, docID, &info)) {
+      doctable_set(split.docs[shardOf(&split, docID)], docID, info.url, info.urlLen, info.depth, info.length);
+    }
+  }
+  index_iterate(index, &split, splitWord);
+
+  // Step 2: Score for the whole collection, at the whole index's scale
+  impacts_stats_t stats = { 0, 0, 0, NULL, NULL };
+  impacts_addDocs(&stats, docs);
+  double max = impacts_maxScore(index, docs, &stats);
+  stats.scale = max > 0 ? max / 255 : 1;
+  stats.otherDocs = shardOtherDocs;
+
+  // Step 3: Save each shard as an index of its own
+  char* shardFilename = mem_malloc_assert(strlen(indexFilename) + 16, "indexer shard filename");
+  for (int i = 0; i < numShards; i++) {
+    sprintf(shardFilename, "%s.s%d", indexFilename, i);
+    shardcontext_t context = { index, split.indexes[i] };
+    stats.arg = &context;
+    saveIndex(split.indexes[i], shardFilename, binary);
+    saveDocTable(split.docs[i], shardFilename);
+    saveImpacts(split.indexes[i], split.docs[i], &stats, shardFilename);
+  }
+  printf("Split %d documents into %d shards by docID %s: %s.s0 to %s.s%d\n", stats.numDocs, numShards,
+         hashShards ? "hash" : "range", indexFilename, indexFilename, numShards - 1);
+
+  for (int i = 0; i < numShards; i++) {
+    index_delete(split.indexes[i]);
+    doctable_delete(split.docs[i]);
+  }
+  mem_free(shardFilename);
+  mem_free(split.indexes);
+  mem_free(split.docs);
+  if (split.word != NULL) {
+    mem_free(split.word);
+  }
+}
+
+/**************** shardOf ****************/
+/**
+ * Returns the shard a document goes to.
+ *
+ * @param split The shards.
+ * @param docID The document, between split->firstDoc and split->endDoc - 1.
+ * @return By range, the shard whose equal share of the docIDs holds it;
+ *         by hash, its docID's (Fibonacci) hash modulo the number of shards.
+ */
+static int shardOf(const shardsplit_t *split, const int docID)
+{
+  if (split->hash) {
+    return (((uint32_t) docID * 2654435761u) >> 8) % split->numShards;
+  }
+  return (long long) (docID - split->firstDoc) * split->numShards / (split->endDoc - split->firstDoc);
+}
+
+/**************** splitWord ****************/
+/**
+ * index_iterate callback: copies a word's postings into the shards of
+ * their documents.
+ *
+ * @param arg The `shardsplit_t`.
+ * @param word The word; not null-terminated.
+ * @param len Its length.
+ * @param postings Its (docID, count) pairs, in docID order, so each
+ *                 shard's list stays in order too.
+ */
+static void splitWord(void *arg, const char *word, const size_t len, const postings_t *postings)
+{
+  shardsplit_t* split = arg;
+  if (len + 1 > split->wordRoom) {
+    if (split->word != NULL) {
+      mem_free(split->word);
+    }
+    split->wordRoom = 2 * (len + 1);
+    split->word = mem_malloc_assert(split->wordRoom, "indexer shard word");
+  }
+  memcpy(split->word, word, len);
+  split->word[len] = '\0';
+
+  const posting_t* entries = postings_entries(postings);
+  for (size_t i = 0; i < postings_size(postings); i++) {
+    index_set(split->indexes[shardOf(split, entries[i].docID)], split->word, entries[i].docID, entries[i].count);
+  }
+}
+
+/**************** shardOtherDocs ****************/
+/**
+ * impacts_stats_t otherDocs callback: the documents of the other shards
+ * that contain a word.
+ *
+ * @param arg The `shardcontext_t`.
+ * @param word The word.
+ * @return Its document frequency in the whole index minus that in the shard.
+ */
+static int shardOtherDocs(void *arg, const char *word)
+{
+  shardcontext_t* context = arg;
+  postings_t* whole = index_find(context->whole, word);
+  postings_t* shard = index_find(context->shard, word);
+  return (whole == NULL ? 0 : postings_size(whole)) - (shard == NULL ? 0 : postings_size(shard));
 }
@@ -4,17 +4,22 @@
 * This program tests the correctness of the Tiny Search Engine (TSE) indexer.
 * It reads an existing index file into an index data structure, then writes
 * it back to a new index file. The output should be identical to the input
-* if the indexer functions correctly.
+* (up to ordering) if the indexer functions correctly.
+*
+* The old index may be in either the text or the binary format; the new one
+* is written as text, or in binary with -b. So indextest also converts an
+* index between the two formats.
 *
 * Usage:
-*     ./indextest oldIndexFilename newIndexFilename
+*     ./indextest [-b] oldIndexFilename newIndexFilename
 *
 * Parameters:
+*     -b               - Write the new index in the binary format.
 *     oldIndexFilename - The path to the existing index file to read.
 *     newIndexFilename - The path to the new index file where data is written.
 *
 * Functions:
-*     parseArgs(argc, argv, oldIndexFilename, newIndexFilename)
+*     parseArgs(argc, argv, oldIndexFilename, newIndexFilename, binary)
 *         Parses and validates command-line arguments, ensuring correct usage.
 *
 * Exit Codes:
@@ -25,11 +30,13 @@
 
  #include <stdio.h>
  #include <stdlib.h>
+ #include <string.h>
+ #include <stdbool.h>
  #include "../common/index.h"
  #include "../libcs50/mem.h"
  
  /**************** function prototypes ****************/
- static void parseArgs(int argc, char* argv[], char** oldIndexFilename, char** newIndexFilename);
+ static void parseArgs(int argc, char* argv[], char** oldIndexFilename, char** newIndexFilename, bool* binary);
  
  /**************** main ****************/
  /**
@@ -44,12 +51,13 @@
 {
   char* oldIndexFilename;
   char* newIndexFilename;
+  bool binary;
 
   // Parse and validate command-line arguments
-  parseArgs(argc, argv, &oldIndexFilename, &newIndexFilename);
+  parseArgs(argc, argv, &oldIndexFilename, &newIndexFilename, &binary);
 
-  // Open the old index file for reading
-  FILE* oldIndexFile = fopen(oldIndexFilename, "r");
+  // Open the old index file for reading (either format)
+  FILE* oldIndexFile = fopen(oldIndexFilename, "rb");
   if (oldIndexFile == NULL) {
     fprintf(stderr, "Error: Unable to open index file '%s' for reading.\n", oldIndexFilename);
     exit(1);
@@ -65,16 +73,26 @@
   }
 
   // Open the new index file for writing
-  FILE* newIndexFile = fopen(newIndexFilename, "w");
+  FILE* newIndexFile = fopen(newIndexFilename, binary ? "wb" : "w");
   if (newIndexFile == NULL) {
     fprintf(stderr, "Error: Unable to write to index file '%s'.\n", newIndexFilename);
     index_delete(index);
     exit(1);
   }
 
-  // Save the index to the new index file
-  index_save(index, newIndexFile);
+  // Save the index to the new index file, in the requested format
+  bool ok = true;
+  if (binary) {
+    ok = index_save_binary(index, newIndexFile);
+  } else {
+    index_save(index, newIndexFile);
+  }
   fclose(newIndexFile);
+  if (!ok) {
+    fprintf(stderr, "Error: Unable to write to index file '%s'.\n", newIndexFilename);
+    index_delete(index);
+    exit(1);
+  }
 
   // Free the index memory
   index_delete(index);
@@ -87,24 +105,33 @@
   /**
  * Parses and validates command-line arguments.
  * 
- * Ensures exactly two arguments are provided: an old index filename and a new index filename.
+ * Ensures exactly two arguments are provided: an old index filename and a new index filename,
+ * optionally preceded by -b.
  *
  * @param argc Number of command-line arguments.
  * @param argv Array of command-line argument strings.
  * @param oldIndexFilename Pointer to store the validated old index filename.
  * @param newIndexFilename Pointer to store the validated new index filename.
+ * @param binary Pointer to store whether to write the new index in binary.
  * 
  * Assumptions: The caller provides `argc` and `argv` from `main()`.
  * Exits if arguments are invalid.
  */
- static void parseArgs(int argc, char* argv[], char** oldIndexFilename, char** newIndexFilename)
+ static void parseArgs(int argc, char* argv[], char** oldIndexFilename, char** newIndexFilename, bool* binary)
  {
-  if (argc != 3) {
-    fprintf(stderr, "Usage: ./indextest oldIndexFilename newIndexFilename\n");
+  int arg = 1;
+  *binary = false;
+  if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+    *binary = true;
+    arg++;
+  }
+
+  if (argc - arg != 2) {
+    fprintf(stderr, "Usage: ./indextest [-b] oldIndexFilename newIndexFilename\n");
     exit(1);
   }
 
-  *oldIndexFilename = argv[1];
-  *newIndexFilename = argv[2];
+  *oldIndexFilename = argv[arg];
+  *newIndexFilename = argv[arg + 1];
  }
  
\ No newline at end of file
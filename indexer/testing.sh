@@ -20,6 +20,8 @@
 # - **Special Cases:**
 #   - Running indexer on a valid non-crawler directory (should fail).
 #   - Running indexer on an empty crawler directory (should handle gracefully).
+# - **Tokenizer Test:** tokentest checks that the vectorized tokenizer finds exactly the
+#   words webpage_getNextWord finds, on adversarial, block-boundary and random HTML.
 # - **Memory Leak Testing:** Uses Valgrind to check for memory leaks in both indexer
 #   and indextest.
 
@@ -33,6 +35,9 @@ mkdir -p $TESTDIR
 # 1. Valid Indexer and Indextest Tests
 # ------------------------------------
 
+echo "Running tokentest (the tokenizer should find the same words as webpage_getNextWord)..."
+./tokentest
+
 echo "Running indexer on $SHAREDDIR/letters-2..."
 ./indexer $SHAREDDIR/letters-2 $TESTDIR/letters-2.index
 
@@ -51,6 +56,57 @@ echo "Running indextest on $TESTDIR/letters-3.index..."
 echo "Comparing index files with indexcmp..."
 $INDEXCMP $TESTDIR/letters-3.index $TESTDIR/new-letters-3.index
 
+echo "Comparing the letters-2 and letters-3 indexes with the reference indexes (should match)..."
+$INDEXCMP $SHAREDDIR/letters-2.index $TESTDIR/letters-2.index
+$INDEXCMP $SHAREDDIR/letters-3.index $TESTDIR/letters-3.index
+
+echo "Running indexer -j 4 on $SHAREDDIR/letters-3 (should match the single-threaded index)..."
+./indexer -j 4 $SHAREDDIR/letters-3 $TESTDIR/letters-3-j4.index
+$INDEXCMP $TESTDIR/letters-3.index $TESTDIR/letters-3-j4.index
+
+echo "Running indexer -b on $SHAREDDIR/letters-3, and converting back to text (should match)..."
+./indexer -b $SHAREDDIR/letters-3 $TESTDIR/letters-3.bindex
+./indextest $TESTDIR/letters-3.bindex $TESTDIR/letters-3-fromb.index
+$INDEXCMP $TESTDIR/letters-3.index $TESTDIR/letters-3-fromb.index
+
+echo "Converting the text index to binary with indextest -b (should match indexer -b)..."
+./indextest -b $TESTDIR/letters-3.index $TESTDIR/new-letters-3.bindex
+cmp $TESTDIR/letters-3.bindex $TESTDIR/new-letters-3.bindex
+
+echo "Comparing the document tables of the text, binary and -j 4 runs (should match)..."
+cmp $TESTDIR/letters-3.index.docs $TESTDIR/letters-3.bindex.docs
+cmp $TESTDIR/letters-3.index.docs $TESTDIR/letters-3-j4.index.docs
+
+echo "Indexing half of $SHAREDDIR/letters-3, then the rest with -u, then merging with -m (should match)..."
+rm -rf $TESTDIR/letters-3-grow && mkdir -p $TESTDIR/letters-3-grow
+touch $TESTDIR/letters-3-grow/.crawler
+NUMDOCS=$(ls $SHAREDDIR/letters-3 | grep -c '^[0-9]*$')
+for ((d = 1; d <= NUMDOCS / 2; d++)); do cp $SHAREDDIR/letters-3/$d $TESTDIR/letters-3-grow/; done
+./indexer $TESTDIR/letters-3-grow $TESTDIR/letters-3-grow.index
+./indexer -u $TESTDIR/letters-3-grow $TESTDIR/letters-3-grow.index
+for ((d = NUMDOCS / 2 + 1; d <= NUMDOCS; d++)); do cp $SHAREDDIR/letters-3/$d $TESTDIR/letters-3-grow/; done
+./indexer -u $TESTDIR/letters-3-grow $TESTDIR/letters-3-grow.index
+./indexer -m $TESTDIR/letters-3-grow.index
+$INDEXCMP $TESTDIR/letters-3.index $TESTDIR/letters-3-grow.index
+cmp $TESTDIR/letters-3.index.docs $TESTDIR/letters-3-grow.index.docs
+cmp $TESTDIR/letters-3.index.impacts $TESTDIR/letters-3-grow.index.impacts
+
+echo "Comparing the impacts of the text, binary and -j 4 runs (should match)..."
+cmp $TESTDIR/letters-3.index.impacts $TESTDIR/letters-3.bindex.impacts
+cmp $TESTDIR/letters-3.index.impacts $TESTDIR/letters-3-j4.index.impacts
+
+echo "Splitting $SHAREDDIR/letters-3 into 3 shards by range and by hash (every shard should load)..."
+./indexer -s 3 $SHAREDDIR/letters-3 $TESTDIR/letters-3-shard.index
+./indexer -s 3 -p hash -b $SHAREDDIR/letters-3 $TESTDIR/letters-3-hash.index
+for ((s = 0; s < 3; s++)); do
+  ./indextest $TESTDIR/letters-3-shard.index.s$s $TESTDIR/new-letters-3-shard.index.s$s
+  ./indextest $TESTDIR/letters-3-hash.index.s$s $TESTDIR/new-letters-3-hash.index.s$s
+done
+
+echo "Running indextest on a truncated binary index (should fail)..."
+head -c 100 $TESTDIR/letters-3.bindex > $TESTDIR/truncated.bindex
+./indextest $TESTDIR/truncated.bindex $TESTDIR/bad.index
+
 # ------------------------------------
 # 2. Invalid Argument Tests
 # ------------------------------------
@@ -64,6 +120,22 @@ echo "TEST 2: One argument (should fail)"
 echo "TEST 3: Three or more arguments (should fail)"
 ./indexer arg1 arg2 arg3
 
+echo "TEST 3b: Bad thread count (should fail)"
+./indexer -j 0 $SHAREDDIR/letters-2 $TESTDIR/bad.index
+
+echo "TEST 3c: Updating an index that does not exist, and -m with a pageDirectory (should fail)"
+./indexer -u $SHAREDDIR/letters-2 $TESTDIR/missing.index
+./indexer -m $SHAREDDIR/letters-2 $TESTDIR/letters-3.index
+
+echo "TEST 3d: Bad shard count, bad partition, -p without -s, and -s with -u (should fail)"
+./indexer -s 1 $SHAREDDIR/letters-2 $TESTDIR/bad.index
+./indexer -s 2 -p random $SHAREDDIR/letters-2 $TESTDIR/bad.index
+./indexer -p hash $SHAREDDIR/letters-2 $TESTDIR/bad.index
+./indexer -s 2 -u $SHAREDDIR/letters-2 $TESTDIR/letters-3.index
+
+echo "TEST 3e: Indexing with --stats (a timing summary on stderr)"
+./indexer --stats $SHAREDDIR/letters-2 $TESTDIR/letters-2s.index
+
 # ------------------------------------
 # 3. Invalid pageDirectory (Non-existent path)
 # ------------------------------------
@@ -127,4 +199,7 @@ valgrind --leak-check=full --show-leak-kinds=all ./indexer $SHAREDDIR/toscrape-1
 echo "Running Valgrind on indextest..."
 valgrind --leak-check=full --show-leak-kinds=all ./indextest $TESTDIR/toscrape-1.index $TESTDIR/new-toscrape-1.index
 
+echo "Running Valgrind on tokentest (buffers end exactly at each document, so overreads show)..."
+valgrind --leak-check=full --show-leak-kinds=all ./tokentest 1000
+
 echo "All tests completed!"
@@ -0,0 +1,283 @@
+/*
+* tokentest.c     Atziri Enriquez     October 15, 2026
+*
+* This program tests that the indexer's vectorized tokenizer (common/tokenizer.c)
+* finds exactly the words the original scalar webpage_getNextWord (libcs50/webpage.c)
+* finds. It tokenizes each test document both ways and compares the two lists of
+* words, using tokenizer_next and tokenizer_nextMany with several batch sizes.
+*
+* The documents are:
+*   - adversarial HTML: unclosed '<', '<' or '>' at either end, empty tags,
+*     non-ASCII bytes, and an embedded null byte;
+*   - a word, and a tag, starting at every offset from 0 to 79 and of every
+*     length from 1 to 79, so that they start, end and cross the 16-, 32- and
+*     64-byte blocks the vector scanners work in;
+*   - random documents over letters, '<', '>', blanks, digits, punctuation,
+*     non-ASCII bytes and the occasional null byte.
+* Each document is tokenized in a buffer of exactly its length (no null after
+* it), at each of several alignments, so an overread shows under valgrind.
+*
+* The tokenizer's vector path is chosen when common is compiled; build with
+* `make FLAGS=-mavx2` (on an AVX2 machine) to test the 32-byte AVX2 path
+* instead of the default SSE2 or NEON one.
+*
+* Usage:
+*     ./tokentest [numRandom [seed]]
+*
+* Parameters:
+*     numRandom - How many random documents to test (default 20000).
+*     seed      - The seed for the random documents (default 1).
+*
+* Functions:
+*     checkDoc(doc, len)
+*         Tokenizes a document both ways and compares the words.
+*
+* Exit Codes:
+*     0 - Every document gave the same words both ways.
+*     1 - Invalid arguments, or some document did not.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../common/tokenizer.h"
+#include "../libcs50/webpage.h"
+#include "../libcs50/mem.h"
+
+/**************** function prototypes ****************/
+static bool checkDoc(const char* doc, const size_t len);
+static bool compareWords(const char* doc, const size_t len, const char* how,
+                         char** expect, const size_t numExpect,
+                         const char** words, const size_t* lens, const size_t numWords);
+static size_t randomDoc(char* doc, const size_t maxLen);
+
+/**************** global constants ****************/
+static const size_t MAX_DOC = 512;     // longest test document
+static const size_t ALIGNS[] = { 0, 1, 3, 8, 15, 17, 31, 63 };  // buffer offsets tried
+static int failures = 0;               // documents that did not match
+static const int MAX_REPORTS = 10;     // mismatches printed in full
+
+/**************** main ****************/
+/**
+ * Main function: Tokenizes every test document both ways and reports the result.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line argument strings.
+ *
+ * Returns: 0 if every document matched, 1 otherwise.
+ */
+int main(int argc, char* argv[])
+{
+  long numRandom = 20000;
+  unsigned long seed = 1;
+  char extra;
+  if (argc > 3
+      || (argc > 1 && (sscanf(argv[1], "%ld%c", &numRandom, &extra) != 1 || numRandom < 0))
+      || (argc > 2 && sscanf(argv[2], "%lu%c", &seed, &extra) != 1)) {
+    fprintf(stderr, "Usage: ./tokentest [numRandom [seed]]\n");
+    exit(1);
+  }
+  srand(seed);
+
+  int numDocs = 0;
+
+  // Adversarial HTML
+  static const char* const adversarial[] = {
+    "", "a", "<", ">", "<>", "<a", "a<", "a>", "<a>", "<a>b", "b<a>", "<<>>",
+    "word <unclosed tag and words after it",
+    "word <tag>", "word <tag>x", "<tag>word", ">word<", "x<y>z<w",
+    "one two  three\tfour\nfive", "123abc456def", "a-b_c.d,e;f",
+    "caf\xc3\xa9 na\xc3\xafve \xe2\x80\x94 r\xc3\xa9sum\xc3\xa9", "\xff\xfe" "abc" "\x80\x81",
+    "<\xc3\xa9>text</\xc3\xa9>", "<!-- comment <nested> -->after",
+    "<script>if (a < b) { c > d }</script>tail",
+  };
+  for (size_t i = 0; i < sizeof(adversarial) / sizeof(adversarial[0]); i++) {
+    checkDoc(adversarial[i], strlen(adversarial[i]));
+    numDocs++;
+  }
+  static const char nulDoc[] = "before the null\0after the null";
+  checkDoc(nulDoc, sizeof(nulDoc) - 1);
+  numDocs++;
+
+  // Words and tags at every offset and length around the vector blocks
+  char doc[MAX_DOC];
+  for (size_t offset = 0; offset < 80; offset++) {
+    for (size_t len = 1; len < 80; len++) {
+      memset(doc, ' ', offset);
+      memset(doc + offset, 'w', len);
+      doc[offset + len] = '.';
+      checkDoc(doc, offset + len + 1);   // a word, then a stop
+      checkDoc(doc, offset + len);       // a word that runs to the end
+
+      memset(doc + offset, 'x', len);
+      doc[offset] = '<';
+      doc[offset + len] = '>';
+      memcpy(doc + offset + len + 1, "yz", 2);
+      checkDoc(doc, offset + len + 3);   // a tag, then a word
+      checkDoc(doc, offset + len + 1);   // a tag at the very end
+      checkDoc(doc, offset + len);       // an unclosed tag
+      numDocs += 5;
+    }
+  }
+
+  // Random documents
+  for (long i = 0; i < numRandom; i++) {
+    size_t len = randomDoc(doc, MAX_DOC);
+    checkDoc(doc, len);
+    numDocs++;
+  }
+
+  if (failures == 0) {
+    printf("All %d documents gave the same words from the tokenizer and webpage_getNextWord.\n", numDocs);
+  } else {
+    printf("%d of %d documents gave different words.\n", failures, numDocs);
+  }
+  exit(failures == 0 ? 0 : 1);
+}
+
+/**************** checkDoc ****************/
+/**
+ * Tokenizes a document with webpage_getNextWord, then with tokenizer_next and
+ * tokenizer_nextMany at each alignment, and compares the words.
+ *
+ * @param doc The document; it need not be null-terminated.
+ * @param len Its length in bytes.
+ *
+ * Returns: whether every way gave the same words.
+ */
+static bool checkDoc(const char* doc, const size_t len)
+{
+  // The scalar words; webpage_getNextWord needs a null-terminated copy
+  // (webpage_delete frees url and html with free, so they come from malloc)
+  char* html = mem_assert(malloc(len + 1), "tokentest: html");
+  memcpy(html, doc, len);
+  html[len] = '\0';
+  char* url = mem_assert(malloc(sizeof("http://test/")), "tokentest: url");
+  strcpy(url, "http://test/");
+  webpage_t* page = mem_assert(webpage_new(url, 0, html), "tokentest: webpage");
+
+  size_t numExpect = 0;
+  char** expect = mem_malloc_assert((len / 2 + 1) * sizeof(char*), "tokentest: words");
+  int pos = 0;
+  char* word;
+  while ((word = webpage_getNextWord(page, &pos)) != NULL) {
+    expect[numExpect++] = word;
+  }
+
+  // The tokenizer's words, in a buffer of exactly len bytes at each alignment
+  const char** words = mem_malloc_assert((len / 2 + 1) * sizeof(char*), "tokentest: spans");
+  size_t* lens = mem_malloc_assert((len / 2 + 1) * sizeof(size_t), "tokentest: lens");
+  tokenizer_span_t spans[7];
+  static const size_t batches[] = { 1, 3, 7 };
+  bool ok = true;
+  for (size_t a = 0; ok && a < sizeof(ALIGNS) / sizeof(ALIGNS[0]); a++) {
+    char* block = mem_malloc_assert(ALIGNS[a] + (len > 0 ? len : 1), "tokentest: block");
+    char* buf = block + ALIGNS[a];
+    memcpy(buf, doc, len);
+
+    tokenizer_t tok;
+    tokenizer_init(&tok, buf, len);
+    size_t numWords = 0;
+    while (numWords <= len / 2 && tokenizer_next(&tok, &words[numWords], &lens[numWords])) {
+      numWords++;
+    }
+    ok = compareWords(doc, len, "tokenizer_next", expect, numExpect, words, lens, numWords);
+
+    for (size_t b = 0; ok && b < sizeof(batches) / sizeof(batches[0]); b++) {
+      tokenizer_init(&tok, buf, len);
+      numWords = 0;
+      size_t n;
+      do {
+        n = tokenizer_nextMany(&tok, spans, batches[b]);
+        for (size_t i = 0; i < n && numWords <= len / 2; i++) {
+          words[numWords] = spans[i].word;
+          lens[numWords++] = spans[i].len;
+        }
+      } while (n == batches[b] && numWords <= len / 2);
+      ok = compareWords(doc, len, "tokenizer_nextMany", expect, numExpect, words, lens, numWords);
+    }
+    mem_free(block);
+  }
+
+  for (size_t i = 0; i < numExpect; i++) {
+    free(expect[i]);
+  }
+  mem_free(expect);
+  mem_free(words);
+  mem_free(lens);
+  webpage_delete(page);
+
+  if (!ok) {
+    failures++;
+  }
+  return ok;
+}
+
+/**************** compareWords ****************/
+/**
+ * Compares the words one way of tokenizing found with webpage_getNextWord's,
+ * and prints the first difference, for the first few documents that differ.
+ *
+ * Returns: whether they are the same words in the same order.
+ */
+static bool compareWords(const char* doc, const size_t len, const char* how,
+                         char** expect, const size_t numExpect,
+                         const char** words, const size_t* lens, const size_t numWords)
+{
+  size_t i = 0;
+  while (i < numExpect && i < numWords
+         && strlen(expect[i]) == lens[i] && memcmp(expect[i], words[i], lens[i]) == 0) {
+    i++;
+  }
+  if (i == numExpect && i == numWords) {
+    return true;
+  }
+
+  if (failures < MAX_REPORTS) {
+    printf("FAIL %s, word %zu: expected '%s', got '%.*s', in the %zu-byte document:\n  ",
+           how, i, i < numExpect ? expect[i] : "(end)",
+           (int) (i < numWords ? lens[i] : 5), i < numWords ? words[i] : "(end)", len);
+    for (size_t j = 0; j < len; j++) {
+      unsigned char c = doc[j];
+      printf(c >= ' ' && c < 0x7f && c != '\\' ? "%c" : "\\x%02x", c);
+    }
+    printf("\n");
+  }
+  return false;
+}
+
+/**************** randomDoc ****************/
+/**
+ * Fills doc with a random document of random length, mostly letters and
+ * blanks, with tags, digits, punctuation, non-ASCII bytes and rare nulls.
+ *
+ * Returns: its length, at most maxLen.
+ */
+static size_t randomDoc(char* doc, const size_t maxLen)
+{
+  size_t len = rand() % (maxLen + 1);
+  for (size_t i = 0; i < len; i++) {
+    int r = rand() % 100;
+    if (r < 50) {
+      doc[i] = (rand() % 2 ? 'a' : 'A') + rand() % 26;
+    } else if (r < 65) {
+      doc[i] = ' ';
+    } else if (r < 71) {
+      doc[i] = '<';
+    } else if (r < 77) {
+      doc[i] = '>';
+    } else if (r < 83) {
+      doc[i] = '0' + rand() % 10;
+    } else if (r < 90) {
+      static const char punct[] = "!\"#$%&'()*+,-./:;=?@[\\]^_`{|}~\t\n\r";
+      doc[i] = punct[rand() % (sizeof(punct) - 1)];
+    } else if (r < 99) {
+      doc[i] = (char) (0x80 + rand() % 128);
+    } else {
+      doc[i] = (rand() % 10 == 0) ? '\0' : (char) (1 + rand() % 127);
+    }
+  }
+  return len;
+}
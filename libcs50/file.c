@@ -6,11 +6,16 @@
  * David Kotz - 2016, 2017, 2019, 2021
  */
 
+#define _POSIX_C_SOURCE 200809L  // getline, getc_unlocked, fileno
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
+#include <sys/stat.h>
 #include "file.h"
 
+/**************** local constants ****************/
+static const size_t CHUNK = 4096;   // initial buffer, and the unit we fread
 
 /**************** file_numLines ****************/
 int
@@ -22,10 +27,12 @@ file_numLines(FILE* fp)
 
   rewind(fp);
 
+  // count newlines a buffer at a time
   int nlines = 0;
-  char c = '\0';
-  while ( (c = fgetc(fp)) != EOF) {
-    if (c == '\n') {
+  char buf[CHUNK];
+  size_t n;
+  while ( (n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+    for (const char* p = buf; (p = memchr(p, '\n', buf + n - p)) != NULL; p++) {
       nlines++;
     }
   }
@@ -42,11 +49,11 @@ static int isnewline(int c) { return (c == '\n'); }
 
 /**************** file_readFile ****************/
 /* See file.h for documentation. */
-char* file_readFile(FILE* fp) { return file_readUntil(fp, never); }
+char* file_readFile(FILE* fp) { return file_readFileLen(fp, NULL); }
 
 /**************** file_readLine ****************/
 /* See file.h for documentation. */
-char* file_readLine(FILE* fp) { return file_readUntil(fp, isnewline); }
+char* file_readLine(FILE* fp) { return file_readLineLen(fp, NULL); }
 
 /**************** readword ****************/
 /* See file.h for documentation. */
@@ -57,36 +64,136 @@ char* file_readWord(FILE* fp) { return file_readUntil(fp, isspace); }
 char* 
 file_readUntil(FILE* fp, int (*stopfunc)(int c))
 {
-  if (stopfunc == NULL) {
-    stopfunc = never;
+  return file_readUntilLen(fp, stopfunc, NULL);
+}
+
+/**************** file_readFileLen ****************/
+/* See file.h for documentation.
+ * Reads with fread into a buffer that doubles as it fills; for a
+ * regular file we size the buffer from the bytes remaining, plus one
+ * spare byte for the read that finds EOF, so the whole read is one
+ * allocation and two freads unless the file grows meanwhile.
+ */
+char*
+file_readFileLen(FILE* fp, size_t* lenp)
+{
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  size_t cap = CHUNK;
+  struct stat st;
+  long here = ftell(fp);
+  if (here >= 0 && fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode)
+      && st.st_size > here) {
+    cap = (size_t) (st.st_size - here) + 2;   // +1 for the null, +1 so the EOF read is not a full buffer
+  }
+
+  char* buf = malloc(cap);
+  if (buf == NULL) {
+    return NULL;
+  }
+
+  size_t len = 0;
+  size_t n;
+  while ( (n = fread(buf + len, 1, cap - len - 1, fp)) > 0) {
+    len += n;
+    if (len + 1 == cap) {
+      // full: double the buffer and keep reading
+      char* newbuf = realloc(buf, 2 * cap);
+      if (newbuf == NULL) {
+        free(buf);
+        return NULL;
+      }
+      buf = newbuf;
+      cap *= 2;
+    }
+  }
+
+  if (len == 0 || ferror(fp)) {
+    // nothing read before EOF, or an error
+    free(buf);
+    return NULL;
+  }
+  buf[len] = '\0';
+  if (lenp != NULL) {
+    *lenp = len;
+  }
+  return buf;
+}
+
+/**************** file_readLineLen ****************/
+/* See file.h for documentation. */
+char*
+file_readLineLen(FILE* fp, size_t* lenp)
+{
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  char* buf = NULL;
+  size_t cap = 0;
+  ssize_t len = getline(&buf, &cap, fp);
+  if (len < 0) {
+    // EOF without reading a line, or error
+    free(buf);
+    return NULL;
+  }
+  if (len > 0 && buf[len - 1] == '\n') {
+    buf[--len] = '\0';       // discard the newline
+  }
+  if (lenp != NULL) {
+    *lenp = len;
+  }
+  return buf;
+}
+
+/**************** file_readUntilLen ****************/
+/* See file.h for documentation. */
+char* 
+file_readUntilLen(FILE* fp, int (*stopfunc)(int c), size_t* lenp)
+{
+  if (fp == NULL) {
+    return NULL;
+  }
+  if (stopfunc == NULL || stopfunc == never) {
+    return file_readFileLen(fp, lenp);
+  }
+  if (stopfunc == isnewline) {
+    return file_readLineLen(fp, lenp);
   }
 
   // allocate buffer big enough for "typical" words/lines
-  int len = 81;
+  size_t len = 81;
   char* buf = malloc(len * sizeof(char));
   if (buf == NULL) {
     return NULL;
   }
 
   // Read characters from file until stop-character or EOF, 
-  // expanding the buffer when needed to hold more.
-  int pos;
-  char c;
-  for (pos = 0; (c = fgetc(fp)) != EOF && !(*stopfunc)(c); pos++) {
+  // doubling the buffer when needed to hold more.
+  // We lock the stream once and use getc_unlocked for the loop.
+  flockfile(fp);
+  size_t pos;
+  int c;
+  for (pos = 0; (c = getc_unlocked(fp)) != EOF && !(*stopfunc)(c); pos++) {
     // We need to save buf[pos+1] for the terminating null
     // and buf[len-1] is the last usable slot, 
     // so if pos+1 is past that slot, we need to grow the buffer.
     if (pos+1 > len-1) {
-      char* newbuf = realloc(buf, ++len * sizeof(char));
+      char* newbuf = realloc(buf, 2 * len * sizeof(char));
       if (newbuf == NULL) {
+        funlockfile(fp);
         free(buf);
         return NULL;
       } else {
         buf = newbuf;
+        len *= 2;
       }
     }
     buf[pos] = c;
   }
+  funlockfile(fp);
 
   if (pos == 0 && c == EOF) {
     // no characters were read and we reached EOF
@@ -95,6 +202,9 @@ file_readUntil(FILE* fp, int (*stopfunc)(int c))
   } else {
     // pos characters were read into buf[0]..buf[pos-1].
     buf[pos] = '\0'; // terminate string
+    if (lenp != NULL) {
+      *lenp = pos;
+    }
     return buf;
   }
 }
@@ -8,6 +8,7 @@
 #define __FILE_H
 
 #include <stdio.h>
+#include <stddef.h>
 
 /**************** file_numLines ****************/
 /* Returns the number of lines in the given file,
@@ -60,4 +61,23 @@ char* file_readLine(FILE* fp);
  */
 char* file_readWord(FILE* fp);
 
+/**************** lengthed variants ****************/
+/* 
+ * Exactly like file_readUntil, file_readFile and file_readLine, but
+ * also store the length of the returned string (excluding the null)
+ * in *lenp, unless lenp is NULL.
+ *
+ * All the readers above are built on these. They read in bulk and grow
+ * their buffer geometrically instead of byte by byte:
+ *   file_readFileLen  freads the rest of the file, sizing the buffer
+ *                     from the file size when the file is a regular file;
+ *   file_readLineLen  uses getline;
+ *   file_readUntilLen reads a character at a time (with the stream
+ *                     locked once) only for other stopfuncs.
+ * So reading a file of n bytes takes O(n) time, not O(n^2).
+ */
+char* file_readUntilLen(FILE* fp, int (*stopfunc)(int c), size_t* lenp);
+char* file_readFileLen(FILE* fp, size_t* lenp);
+char* file_readLineLen(FILE* fp, size_t* lenp);
+
 #endif // __FILE_H
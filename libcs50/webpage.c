@@ -19,8 +19,14 @@
 #include <unistd.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <netdb.h>
+#include <strings.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include "file.h"
 #include "webpage.h"
 #include "mem.h"
@@ -36,6 +42,18 @@ struct URL {
   char* fragment;             // #top
 };
 
+/* conn_t: an open connection to a web server.
+ * Requests are written straight to the socket; responses are read
+ * through a stdio stream so we can read them line by line.
+ */
+typedef struct conn {
+  char* host;                 // hostname we connected to
+  int port;                   // and port
+  int fd;                     // the socket
+  FILE* in;                   // stdio stream reading from fd
+  struct conn* next;          // next idle connection in the pool
+} conn_t;
+
 /* webpage_t: structure to represent a web page, and its contents.
  * The innards should not be visible to users of the webpage module.
  */
@@ -49,7 +67,18 @@ typedef struct webpage {
 /* *********************************************************************** */
 /* Private function prototypes */
 
-static FILE* connectToHost(const char* hostname, const int port);
+static bool fetchPage(webpage_t* page, const bool delay);
+static int connectToHost(const char* hostname, const int port);
+static conn_t* connOpen(const char* hostname, const int port);
+static void connClose(conn_t* conn);
+static conn_t* poolGet(const char* hostname, const int port);
+static void poolPut(conn_t* conn);
+static bool sendRequest(conn_t* conn, const char* hostname, 
+                        const char* pathname, const bool keepAlive);
+static int readResponse(conn_t* conn, char** body, bool* reusable);
+static char* readBody(FILE* fp, const size_t length);
+static char* readChunkedBody(FILE* fp, bool* malformed);
+static bool parseBodySize(const char* str, const int base, size_t* size);
 static inline bool isBlankLine(const char* line);
 static char* removeDotSegments(char* input);
 static void removeWhitespace(char* str);
@@ -67,6 +96,14 @@ static void printURL(struct URL url);
 
 static const int MAX_TRY = 3;    // maximum attempts to fetch
 static const int HTTP_PORT = 80; // default web server port
+static const int MAX_IDLE = 16;  // most idle keep-alive connections we keep
+static const int IO_TIMEOUT = 30; // seconds a server may stall a send or receive
+static const size_t MAX_BODY = 64 * 1024 * 1024; // largest response body we accept
+
+// the pool of idle keep-alive connections, shared by all threads
+static conn_t* idleConns = NULL;
+static int numIdle = 0;
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
 
 static const char* EXTS[] = {  // valid extensions
   "html",
@@ -132,6 +169,104 @@ webpage_delete(void* data)
  *   * can only handle http (not https or other schemes)
  *   * can only handle URLs of form http://host[:port][/pathname]
  *   * cannot handle redirects (HTTP 301 or 302 response codes)
+ */
+bool 
+webpage_fetch(webpage_t* page)
+{
+  return fetchPage(page, true);
+}
+
+/* ************* webpage_fetchNoDelay ******************** */
+/* see webpage.h for usage documentation. */
+bool 
+webpage_fetchNoDelay(webpage_t* page)
+{
+  return fetchPage(page, false);
+}
+
+/* ************* webpage_fetchPooled ******************** */
+/* see webpage.h for usage documentation.
+ *
+ * Pseudocode:
+ *     1. parse url into hostname, port, and filename
+ *     2. take an idle connection to that host from the pool, or open one
+ *     3. send a keep-alive request and read the response
+ *     4. if a reused connection turned out to be dead, or it timed out,
+ *        retry on a new one
+ *     5. return the connection to the pool if the server allows it
+ */
+bool
+webpage_fetchPooled(webpage_t* page)
+{
+  // check webpage structure - must have URL and not yet have HTML
+  if (page == NULL || page->url == NULL || page->html != NULL) {
+    return false;
+  }
+
+  char* hostname; // will be initialized by burstURL
+  int port;       // will be initialized by burstURL
+  char* pathname; // will be initialized by burstURL
+  if (!burstURL(page->url, &hostname, &port, &pathname)) {
+    return false;
+  }
+
+  int code = -1;
+  char* body = NULL;
+  for (int try = 0; code < 0 && try < MAX_TRY; try++) {
+    // an idle server may have closed a pooled connection, so only
+    // the first try uses the pool
+    conn_t* conn = (try == 0) ? poolGet(hostname, port) : NULL;
+    if (conn == NULL) {
+      conn = connOpen(hostname, port);
+    }
+    if (conn == NULL) {
+      continue;
+    }
+
+    bool reusable = false;
+    if (sendRequest(conn, hostname, pathname, true)) {
+      code = readResponse(conn, &body, &reusable);
+    }
+    if (reusable) {
+      poolPut(conn);
+    } else {
+      connClose(conn);
+    }
+  }
+
+  free(hostname);
+  free(pathname);
+
+  if (code == 200 && body != NULL) {
+    page->html = body;
+    page->html_len = strlen(body);
+    return true;
+  }
+  free(body);
+  return false;
+}
+
+/* ************* webpage_closeConnections ******************** */
+/* see webpage.h for usage documentation. */
+void
+webpage_closeConnections(void)
+{
+  pthread_mutex_lock(&poolLock);
+  conn_t* conn = idleConns;
+  idleConns = NULL;
+  numIdle = 0;
+  pthread_mutex_unlock(&poolLock);
+
+  while (conn != NULL) {
+    conn_t* next = conn->next;
+    connClose(conn);
+    conn = next;
+  }
+}
+
+/* ************* fetchPage ******************** */
+/* The body of webpage_fetch and webpage_fetchNoDelay; 
+ * 'delay' says whether to sleep after each connection attempt.
  * 
  * Pseudocode:
  *     1. check for valid page 
@@ -141,8 +276,8 @@ webpage_delete(void* data)
  *     5. fetch html response
  *     6. cleanup
  */
-bool 
-webpage_fetch(webpage_t* page)
+static bool 
+fetchPage(webpage_t* page, const bool delay)
 {
   // check webpage structure - must have URL and not yet have HTML
   if (page == NULL || page->url == NULL || page->html != NULL) {
@@ -159,69 +294,45 @@ webpage_fetch(webpage_t* page)
   }
 
   // attempt to connect to server 
-  FILE* http_fp = NULL; 
-  for (int try = 0;  http_fp == NULL && try < MAX_TRY; try++) {
+  conn_t* conn = NULL; 
+  for (int try = 0;  conn == NULL && try < MAX_TRY; try++) {
     // open connection - exit on error
-    http_fp = connectToHost(hostname, port);
+    conn = connOpen(hostname, port);
 
 #ifndef NOSLEEP // CS50 students: please don't turn off the sleep!
-    sleep(1);   // sleep one second between fetches, to lighten load on server
+    if (delay) {
+      sleep(1); // sleep one second between fetches, to lighten load on server
+    }
 #endif
   }
 
   // failed to connect?
-  if (http_fp == NULL) {
+  if (conn == NULL) {
+    free(hostname);
+    free(pathname);
     return false;
   }
 
-  // prepare and send HTTP request; receive response
-  char* httpResponse = NULL;
-  const char* httpFormat =
-    "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n";
-  if (fprintf(http_fp, httpFormat, pathname, hostname) >= 0) {
-    // ensure stdio buffer is flushed to socket
-    fflush(http_fp);
-    // read the server's response
-    httpResponse = file_readLine(http_fp);
+  // send HTTP request; receive response
+  int code = -1;
+  char* body = NULL;
+  bool reusable;
+  if (sendRequest(conn, hostname, pathname, false)) {
+    code = readResponse(conn, &body, &reusable);
   }
 
   free(hostname);
   free(pathname);
+  connClose(conn);
 
   // did we succeed? check the response
-  bool success = false;
-
-  if (httpResponse != NULL) {
-    // check response code to see whether we succeeded
-    int httpResponseCode = 0;
-    if (sscanf(httpResponse, "HTTP/1.1 %d", &httpResponseCode) == 1
-        && httpResponseCode == 200) {
-      // success! ignore the rest of the header, then grab the page
-      // read lines until we read a blank line or fail to read a line
-      char* line = file_readLine(http_fp);
-      while (line != NULL && !isBlankLine(line)) {
-        free(line);
-        line = file_readLine(http_fp);
-      }
-      // did we exit the loop because we read an empty line?
-      if (line != NULL) {
-        free(line); // the blank line
-
-        // then grab everything else - that should be the page content
-        char* html = file_readFile(http_fp);
-        if (html != NULL) {
-          page->html = html;
-          success = true;
-        } 
-      }
-    }
-    free(httpResponse);
+  if (code == 200 && body != NULL) {
+    page->html = body;
+    page->html_len = strlen(body);
+    return true;
   }
-
-  // clean up
-  fclose(http_fp);
-
-  return success;
+  free(body);
+  return false;
 }
 
 /**************** webpage_getNextWord ****************/
@@ -844,42 +955,373 @@ burstURL(const char* url, char** hostname, int* port, char** pathname)
 
 /* ********************* connectToHost ************************** */
 /* Connect to the given hostname and port, 
- * returning an open FILE* for the socket,
- * or NULL on failure.
+ * returning the connected socket, or -1 on failure.
+ * Uses getaddrinfo (rather than gethostbyname) so that it is safe
+ * to call from several threads at once.
  */
-static FILE* 
+static int 
 connectToHost(const char* hostname, const int port)
 {
   // Look up the hostname specified on command line
-  struct hostent *hostp = gethostbyname(hostname);
-  if (hostp == NULL) {
-    return NULL;
-  }
+  char service[16];
+  snprintf(service, sizeof(service), "%d", port);
 
-  // Initialize fields of the server address
-  struct sockaddr_in server;  // address of the server
-  server.sin_family = AF_INET;
-  bcopy(hostp->h_addr_list[0], &server.sin_addr, hostp->h_length);
-  server.sin_port = htons(port);
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  struct addrinfo* server = NULL;   // address(es) of the server
+  if (getaddrinfo(hostname, service, &hints, &server) != 0 || server == NULL) {
+    return -1;
+  }
 
   // Create socket (a file descriptor)
-  int comm_sock = socket(AF_INET, SOCK_STREAM, 0);
+  int comm_sock = socket(server->ai_family, server->ai_socktype, 
+                         server->ai_protocol);
   if (comm_sock < 0) {
-    return NULL;
+    freeaddrinfo(server);
+    return -1;
   }
 
   // And connect that socket to that server   
-  if (connect(comm_sock, (struct sockaddr *) &server, sizeof(server)) < 0) {
+  if (connect(comm_sock, server->ai_addr, server->ai_addrlen) < 0) {
+    freeaddrinfo(server);
+    close(comm_sock);
+    return -1;
+  }
+  freeaddrinfo(server);
+
+  return comm_sock;
+}
+
+/* ********************* connOpen ************************** */
+/* Open a new connection to hostname:port; return NULL on failure.
+ * A server that stops sending or receiving for IO_TIMEOUT seconds
+ * fails the read or send, rather than blocking its thread forever.
+ */
+static conn_t*
+connOpen(const char* hostname, const int port)
+{
+  int fd = connectToHost(hostname, port);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct timeval timeout = { IO_TIMEOUT, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  conn_t* conn = malloc(sizeof(conn_t));
+  char* host = strdup(hostname);
+  // to make it easier to read responses, switch to stdio
+  FILE* in = (conn && host) ? fdopen(fd, "r") : NULL;
+  if (in == NULL) {
+    free(conn);
+    free(host);
+    close(fd);
     return NULL;
   }
 
-  // to make it easier to work with, switch to stdio
-  FILE* http_fp = fdopen(comm_sock, "r+");
-  if (http_fp == NULL) {
+  conn->host = host;
+  conn->port = port;
+  conn->fd = fd;
+  conn->in = in;
+  conn->next = NULL;
+  return conn;
+}
+
+/* ********************* connClose ************************** */
+/* Close a connection (and its socket) and free it. */
+static void
+connClose(conn_t* conn)
+{
+  if (conn != NULL) {
+    fclose(conn->in);         // also closes conn->fd
+    free(conn->host);
+    free(conn);
+  }
+}
+
+/* ********************* poolGet ************************** */
+/* Remove and return an idle connection to hostname:port, or NULL. */
+static conn_t*
+poolGet(const char* hostname, const int port)
+{
+  pthread_mutex_lock(&poolLock);
+  conn_t** prevp = &idleConns;
+  conn_t* conn;
+  for (conn = idleConns; conn != NULL; prevp = &conn->next, conn = conn->next) {
+    if (conn->port == port && strcmp(conn->host, hostname) == 0) {
+      *prevp = conn->next;    // unlink it
+      conn->next = NULL;
+      numIdle--;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&poolLock);
+  return conn;
+}
+
+/* ********************* poolPut ************************** */
+/* Return a still-usable connection to the pool (or close it, if full). */
+static void
+poolPut(conn_t* conn)
+{
+  pthread_mutex_lock(&poolLock);
+  if (numIdle < MAX_IDLE) {
+    conn->next = idleConns;
+    idleConns = conn;
+    numIdle++;
+    conn = NULL;
+  }
+  pthread_mutex_unlock(&poolLock);
+  connClose(conn);            // NULL if pooled
+}
+
+/* ********************* sendRequest ************************** */
+/* Send a GET request for pathname on conn; return false on error. 
+ * MSG_NOSIGNAL keeps a peer that already closed the connection
+ * from killing us with SIGPIPE; we just see the error instead.
+ */
+static bool
+sendRequest(conn_t* conn, const char* hostname, const char* pathname, 
+            const bool keepAlive)
+{
+  const char* httpFormat =
+    "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n\r\n";
+  const char* connection = keepAlive ? "keep-alive" : "close";
+
+  int len = snprintf(NULL, 0, httpFormat, pathname, hostname, connection);
+  char* request = malloc(len + 1);
+  if (request == NULL) {
+    return false;
+  }
+  snprintf(request, len + 1, httpFormat, pathname, hostname, connection);
+
+  bool ok = true;
+  for (int sent = 0; ok && sent < len; ) {
+    ssize_t n = send(conn->fd, request + sent, len - sent, MSG_NOSIGNAL);
+    if (n <= 0) {
+      ok = false;
+    } else {
+      sent += n;
+    }
+  }
+  free(request);
+  return ok;
+}
+
+/* ********************* readResponse ************************** */
+/* Read one HTTP response from conn.
+ * Sets *body to the malloc'd response body (or NULL), and *reusable to
+ * whether another request may be sent on this connection afterward.
+ * Returns the HTTP status code, or -1 if no complete response could be
+ * read: the connection broke, or timed out, before the end of the body.
+ * Returns 0 if the server gave a Content-Length or chunk size that does
+ * not parse or exceeds MAX_BODY; no retry would fare better.
+ *
+ * The body is delimited by Content-Length or chunked transfer-encoding
+ * if the server gives either; otherwise it runs to end of file.
+ */
+static int
+readResponse(conn_t* conn, char** body, bool* reusable)
+{
+  *body = NULL;
+  *reusable = false;
+
+  // status line: HTTP/1.x code reason
+  char* status = file_readLine(conn->in);
+  if (status == NULL) {
+    return -1;
+  }
+  int minor = 0;
+  int code = 0;
+  if (sscanf(status, "HTTP/1.%d %d", &minor, &code) != 2) {
+    free(status);
+    return -1;
+  }
+  free(status);
+
+  // headers, up to a blank line
+  bool keepAlive = (minor >= 1);  // the HTTP/1.1 default
+  bool chunked = false;
+  bool hasLength = false;
+  bool malformed = false;
+  size_t contentLength = 0;
+  char* line;
+  while ((line = file_readLine(conn->in)) != NULL && !isBlankLine(line)) {
+    if (strncasecmp(line, "Content-Length:", 15) == 0) {
+      hasLength = true;
+      if (!parseBodySize(line + 15, 10, &contentLength) || contentLength > MAX_BODY) {
+        malformed = true;
+      }
+    } else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+      chunked = (strcasestr(line + 18, "chunked") != NULL);
+    } else if (strncasecmp(line, "Connection:", 11) == 0) {
+      if (strcasestr(line + 11, "close") != NULL) {
+        keepAlive = false;
+      } else if (strcasestr(line + 11, "keep-alive") != NULL) {
+        keepAlive = true;
+      }
+    }
+    free(line);
+  }
+  if (line == NULL) {
+    return -1;                // connection ended inside the header
+  }
+  free(line);                 // the blank line
+
+  // the body
+  if (code == 204 || code == 304 || (code >= 100 && code < 200)) {
+    *reusable = keepAlive;    // these responses never have a body
+  } else if (chunked || hasLength) {
+    if (!chunked && malformed) {
+      return 0;               // refuse the body before allocating for it
+    }
+    *body = chunked ? readChunkedBody(conn->in, &malformed) : readBody(conn->in, contentLength);
+    if (*body == NULL) {
+      return malformed ? 0 : -1;   // a bad chunk size, or the body broke off
+    }
+    *reusable = keepAlive;
+  } else {
+    *body = file_readFile(conn->in);   // delimited by the server closing
+    if (*body == NULL && ferror(conn->in)) {
+      return -1;                       // broke off, or timed out
+    }
+    if (*body == NULL) {
+      *body = calloc(1, 1);            // an empty page
+    }
+  }
+  return code;
+}
+
+/* ********************* readBody ************************** */
+/* Read exactly length bytes into a new null-terminated string;
+ * return NULL on error or early end of file.
+ */
+static char*
+readBody(FILE* fp, const size_t length)
+{
+  char* buf = malloc(length + 1);
+  if (buf == NULL) {
+    return NULL;
+  }
+  if (fread(buf, 1, length, fp) != length) {
+    free(buf);
     return NULL;
   }
+  buf[length] = '\0';
+  return buf;
+}
+
+/* ********************* readChunkedBody ************************** */
+/* Read a chunked transfer-encoded body into a new null-terminated
+ * string; return NULL on error.  Each chunk is a hex size line, that
+ * many bytes, and a CRLF; a zero-size chunk and optional trailer
+ * lines, ended by a blank line, finish the body.
+ * Sets *malformed if a size line does not parse or would take the
+ * body past MAX_BODY, as opposed to the body breaking off.
+ */
+static char*
+readChunkedBody(FILE* fp, bool* malformed)
+{
+  *malformed = false;
+  size_t len = 0;             // bytes in buf so far
+  size_t cap = 1024;          // allocated size of buf
+  char* buf = malloc(cap);
+  if (buf == NULL) {
+    return NULL;
+  }
+
+  for (;;) {
+    char* sizeLine = file_readLine(fp);
+    if (sizeLine == NULL) {
+      free(buf);
+      return NULL;
+    }
+    size_t chunk;
+    bool parsed = parseBodySize(sizeLine, 16, &chunk);
+    free(sizeLine);
+    if (!parsed || chunk > MAX_BODY - len) {
+      *malformed = true;      // len <= MAX_BODY, so this cannot wrap
+      free(buf);
+      return NULL;
+    }
+
+    if (chunk == 0) {
+      // skip trailer headers, through the final blank line
+      char* line;
+      while ((line = file_readLine(fp)) != NULL && !isBlankLine(line)) {
+        free(line);
+      }
+      if (line == NULL) {
+        free(buf);
+        return NULL;
+      }
+      free(line);
+      break;
+    }
+
+    if (len + chunk + 1 > cap) {
+      while (len + chunk + 1 > cap) {
+        cap *= 2;
+      }
+      char* newbuf = realloc(buf, cap);
+      if (newbuf == NULL) {
+        free(buf);
+        return NULL;
+      }
+      buf = newbuf;
+    }
+    if (fread(buf + len, 1, chunk, fp) != chunk) {
+      free(buf);
+      return NULL;
+    }
+    len += chunk;
+
+    // the CRLF after the chunk data
+    char* crlf = file_readLine(fp);
+    if (crlf == NULL) {
+      free(buf);
+      return NULL;
+    }
+    free(crlf);
+  }
 
-  return http_fp;
+  buf[len] = '\0';
+  return buf;
+}
+
+/* ********************* parseBodySize ************************** */
+/* Parse a body or chunk size in the given base: optional leading
+ * blanks, at least one digit, then nothing but blanks, a CR, or (for
+ * a chunk) ';' and chunk extensions.  Signs and prefixes are refused.
+ * Return false, leaving *size unset, if str is not such a size or
+ * does not fit in a size_t.
+ */
+static bool
+parseBodySize(const char* str, const int base, size_t* size)
+{
+  while (*str == ' ' || *str == '\t') {
+    str++;
+  }
+  if (!(base == 16 ? isxdigit((unsigned char) *str) : isdigit((unsigned char) *str))) {
+    return false;
+  }
+  errno = 0;
+  char* end;
+  unsigned long long value = strtoull(str, &end, base);
+  if (errno == ERANGE || value > SIZE_MAX) {
+    return false;
+  }
+  while (*end == ' ' || *end == '\t') {
+    end++;
+  }
+  if (*end != '\0' && *end != '\r' && !(base == 16 && *end == ';')) {
+    return false;
+  }
+  *size = (size_t) value;
+  return true;
 }
 
 
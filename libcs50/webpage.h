@@ -106,6 +106,41 @@ void webpage_delete(void* data);
  */
 bool webpage_fetch(webpage_t* page);
 
+/***************** webpage_fetchNoDelay ******************************/
+/* Exactly like webpage_fetch, but never sleeps between attempts.
+ *
+ * Caller is responsible for:
+ *   spacing out requests to each server, as webpage_fetch would;
+ *   the crawler does this with a per-host politeness scheduler,
+ *   so that pages on *different* hosts may be fetched concurrently.
+ *
+ * Note:
+ *   both fetch functions are safe to call from several threads at once.
+ */
+bool webpage_fetchNoDelay(webpage_t* page);
+
+/***************** webpage_fetchPooled ******************************/
+/* Like webpage_fetchNoDelay, but over a persistent HTTP/1.1 connection.
+ *
+ * We do:
+ *   reuse an idle keep-alive connection to the page's host:port if the
+ *   pool has one (else open a new one); read the body by Content-Length
+ *   or chunked encoding rather than waiting for the server to close;
+ *   and, if the server allows, put the connection back in the pool for
+ *   the next fetch from that host.  A pooled connection that the server
+ *   has since closed is detected and the fetch is retried on a new one,
+ *   as is one on which the server sends nothing for 30 seconds.
+ *
+ * Caller is responsible for:
+ *   spacing out requests to each server (no sleep here either);
+ *   calling webpage_closeConnections() when done fetching.
+ */
+bool webpage_fetchPooled(webpage_t* page);
+
+/***************** webpage_closeConnections ******************************/
+/* Close every idle connection held by the webpage_fetchPooled pool. */
+void webpage_closeConnections(void);
+
 
 /**************** webpage_getNextWord ***********************************/
 /* return the next word from page->html[pos]
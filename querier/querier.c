@@ -9,14 +9,80 @@
 *
 * The querier:
 * - Parses and validates command-line arguments.
-* - Loads the index file into memory.
+* - Loads the index file into memory, with the segments `indexer -u` added
+*   to it (indexFilename.1, .2, ...; see indexset.h), and searches them all.
 * - Reads queries from stdin, tokenizes and validates them.
 * - Evaluates the query using intersection (AND) and union (OR) logic.
-* - Sorts the matching documents by score in descending order.
-* - Prints the search results along with URLs.
+* - Ranks the matching documents by score in descending order.
+* - Prints the search results along with URLs, looked up in the document
+*   table the indexer saved next to the index (indexFilename.docs); only
+*   without one does it open each result's page file in pageDirectory.
 *
 * Usage:
-*   ./querier pageDirectory indexFilename
+*   ./querier [-k pageSize] [-c cacheMB] [-r count|bm25] [-f queryFile [-j numThreads] | --serve address]
+*             [--stats] pageDirectory indexFilename
+*   ./querier [-k pageSize] [-f queryFile [-j numThreads] | --serve address] [--stats] --shards address,...
+*
+* With -k, only the best pageSize documents of each query are ranked and
+* printed (using a bounded heap, so the cost grows with pageSize rather
+* than the number of matches); an empty query then prints the next page.
+*
+* With -r bm25, documents are scored by BM25 instead of by word counts: a
+* document's score in an AND sequence is the sum of its words' impact
+* scores, precomputed by the indexer (indexFilename.impacts; see
+* impacts.h), and OR adds the sequences' scores. The index must have been
+* built with them. With -k as well (and no cache), only the best pageSize
+* documents are looked for, skipping the postings that cannot be among
+* them (see blockmax.h); the number of matches is then not known, so the
+* header says "Top N documents" instead of "Matches N documents", and each
+* next page is found by searching again for the pages so far plus one.
+*
+* With -c, the complete rankings of up to cacheMB megabytes of queries are
+* cached (least recently used first out), keyed by the query's canonical
+* form, so a repeated query is answered without evaluating it. The index
+* file and its segments are checked before each query; if they have
+* changed (say, a segment was added), they are reloaded and the cache
+* starts over.
+*
+* With -f, the querier runs in batch mode instead: it reads every query of
+* queryFile, evaluates them on numThreads threads (-j, default 1) sharing
+* the one read-only index, prints each query's output in input order, and
+* then reports throughput and latency to stderr. With -k, each query
+* prints only its first page.
+*
+* With --serve, the querier becomes a server: it loads the index once and
+* answers requests on a TCP port ("PORT" or "HOST:PORT") or Unix socket
+* ("unix:PATH") until SIGINT or SIGTERM, one request per line (see
+* server.h). "QUERY words..." is answered in a line format for programs:
+*
+*   QUERY<TAB>the query's words     (or ERROR<TAB>invalid query, alone)
+*   MATCHES<TAB>number of matching documents
+*                                   (with -r bm25 and -k: TOP<TAB>number shown)
+*   DOC<TAB>score<TAB>docID<TAB>URL, best first; with -k, at most pageSize
+*   MORE<TAB>number of documents not shown (only if there are any;
+*                                   just MORE when TOP gave no total)
+*   END
+*
+* "TOP k words..." is answered the same way, but with a page size of k
+* (0 for every match) instead of -k. "HEALTH" and "STATS" (or HTTP
+* "GET /health" and "GET /stats") report the server's health and
+* latency, for load balancers. Like the interactive querier, the server
+* reloads a changed index file.
+*
+* With --shards, the querier is the coordinator of an index split into
+* shards (`indexer -s`), each served by its own `querier --serve` (with
+* its own -r): it loads no index, but sends each query to every shard
+* server as "TOP k" for the documents up to the end of the page asked
+* for, and merges their best documents into the collection's (see
+* shardset.h). Its output, interactive, batch or served, is the single
+* index's. If a shard does not answer, the query fails (a served one
+* prints ERROR<TAB>shard unavailable before END); the shards are checked
+* again by the next query.
+*
+* With --stats, the querier times the evaluation of each query and the
+* ranking and printing of its results, and reading any page files (see
+* stats.h), and prints a summary of them to stderr when it exits; a server
+* adds them to its STATS line.
 *
 * Example:
 *   ./querier data/toscrape-2 data/toscrape-2.index
@@ -24,53 +90,163 @@
 * Exit codes:
 * - 0: Success
 * - 1: Invalid arguments (wrong number of arguments, invalid page directory, etc.)
-* - 2: Index file could not be opened or loaded.
+* - 2: Index file could not be opened or loaded, or a shard could not be reached.
+* - 3: The server could not listen on its address.
 *
 * Dependencies:
-* - Requires counters, index, and memory management modules.
-* - Uses `qsort()` to rank search results.
+* - Requires postings, index, and memory management modules.
+* - Uses the ranking module's bounded heap to rank search results.
 * - Assumes the provided index file is well-formed.
 *
 */
 
-#define _POSIX_C_SOURCE 200809L  // Enables getline() and fileno() in a portable way
+#define _POSIX_C_SOURCE 200809L  // Enables getline(), fileno(), open_memstream() and clock_gettime() in a portable way
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <time.h>
 #include <unistd.h>
-#include "../libcs50/counters.h"
+#include <pthread.h>
+#include <sys/stat.h>
 #include "../libcs50/mem.h"
-#include "../libcs50/file.h"
+#include "../common/arena.h"
+#include "../common/blockmax.h"
+#include "../common/impacts.h"
 #include "../common/index.h"
+#include "../common/indexset.h"
+#include "../common/doctable.h"
+#include "../common/postings.h"
 #include "../common/pagedir.h"
+#include "../common/ranking.h"
+#include "../common/querycache.h"
+#include "../common/stats.h"
+#include "query.h"
+#include "server.h"
+#include "shardset.h"
+
+// The first block of each session arena; a query needing more grows it
+#define QUERY_ARENA_BYTES 65536
+
+// The last query's result, kept for paging through it with -k; either
+// the result itself and a cursor, or (from the cache) its full ranking.
+// Everything a query allocates comes from one of the session's arenas:
+// the query's own, kept while its result is paged through, and a spare
+// one for parsing the next query and printing pages, reset by every query
+typedef struct {
+  postings_t *result;     // NULL if there is nothing more to show
+  rankcursor_t *cursor;   // position in the ranked result
+  ranked_t *ranked;       // else the full ranking, best first
+  size_t next;            // position in the full ranking
+  int remaining;          // matching documents not yet printed
+  char **words;           // else, with -r bm25, the query to search again for
+  int numWords;           // the next page, and how many documents were shown
+  size_t shown;
+  bool firstPageOnly;     // batch and server modes: no empty query will ask for more
+  bool lines;             // server mode: print the line format for programs
+  arena_t *arena;         // the query's memory: its result, ranking, and temporaries
+  arena_t *spare;         // scratch memory for one call of processQuery
+} querySession_t;
+
+// Where the querier finds the URLs of the documents it prints
+typedef struct {
+  indexset_t *indexes;        // the index set, whose document tables have the URLs
+  const char *pageDirectory;  // page files, read only for documents not in the tables
+} docLookup_t;
+
+// The loaded index, and what the querier keeps alongside it
+typedef struct {
+  indexset_t *indexes;        // the index and its segments
+  uint64_t version;           // identifies the files loaded; see indexset_version
+  docLookup_t lookup;
+  querycache_t *cache;        // cached rankings, or NULL without -c
+  pthread_mutex_t cacheLock;  // the cache is shared by batch threads
+  bool bm25;                  // -r bm25: rank by impact scores
+  shardset_t *shards;         // --shards: the shard servers to ask instead, or NULL
+} queryEngine_t;
+
+// The command-line arguments
+typedef struct {
+  const char *pageDirectory;
+  const char *indexFilename;
+  int pageSize;               // -k, or 0 to print all results
+  size_t cacheBytes;          // -c, in bytes, or 0 for no cache
+  bool bm25;                  // -r bm25, else -r count (the default)
+  const char *queryFilename;  // -f, or NULL to read queries from stdin
+  int numThreads;             // -j, for batch mode
+  const char *serveAddress;   // --serve, or NULL
+  const char *shardAddresses; // --shards, or NULL
+  bool stats;                 // --stats
+} querierArgs_t;
+
+// One query of a batch, and its output once evaluated
+typedef struct {
+  char *query;
+  char *output;           // everything the query printed
+  size_t outputLen;
+  double latency;         // seconds to evaluate and print it
+  bool done;
+} batchQuery_t;
+
+// What the server's request handler works with
+typedef struct {
+  queryEngine_t *engine;
+  const char *indexFilename;  // checked for changes before each query
+  int pageSize;
+  unsigned long queries;      // QUERY requests answered
+  unsigned long rejected;     // requests answered with ERROR
+  querySession_t session;     // reused by every request
+} serveContext_t;
+
+// A batch of queries, shared by the threads evaluating them
+typedef struct {
+  queryEngine_t *engine;
+  batchQuery_t *queries;
+  int numQueries;
+  int next;               // the next query for a thread to take
+  int pageSize;
+  pthread_mutex_t lock;   // guards next and each query's done
+  pthread_cond_t finished; // signaled when a query is done
+} batch_t;
 
 // Function prototypes
 static void prompt(void);
-static void parseArgs(int argc, char *argv[], const char **pageDirectory, const char **indexFilename);
-static void matchMerge(counters_t **andSequence, counters_t **orSequence);
+static void parseArgs(int argc, char *argv[], querierArgs_t *args);
+static bool engineLoad(queryEngine_t *engine, const char *indexFilename);
+static void engineRefresh(queryEngine_t *engine, const char *indexFilename, querySession_t *session);
+static void engineUnload(queryEngine_t *engine);
+static void runBatch(queryEngine_t *engine, const querierArgs_t *args);
+static void* batchWorker(void *arg);
+static void serveRequest(void *arg, char *line, FILE *out);
+static void serveStats(void *arg, FILE *out);
+static double secondsSince(const struct timespec *start);
+static int compareDoubles(const void *a, const void *b);
+static void matchMerge(postings_t **andSequence, postings_t **orSequence, arena_t *arena);
 
 int queryTokenize(char *query, char *words[], int maxWords);
 bool isValidQuerySyntax(char **words, int n);
 bool isValidCharacters(const char *query);
-void processQuery(char *query, index_t *index, const char *pageDirectory);
-void intersectCounters(counters_t *acc, counters_t *wordCounters);
-void unionCounters(counters_t *result, counters_t *andResult);
-counters_t* queryEvaluate(char **words, int n, index_t *index);
-int compareScores(const void *a, const void *b);
-void printRankedResults(counters_t *result, const char *pageDirectory);
+bool processQuery(char *query, queryEngine_t *engine, querySession_t *session, int pageSize, FILE *out);
+char* queryCanonical(char **words, int n, arena_t *arena);
+int compareStrings(const void *a, const void *b);
+postings_t* intersectSequence(const postings_t **lists, int n, arena_t *arena);
+int compareDocFrequency(const void *a, const void *b);
+void unionPostings(postings_t **result, postings_t *andResult, arena_t *arena);
+int queryImpacts(char **words, int t, indexset_t *indexes, arena_t *arena, impactlist_t **lists, int **ends);
+void sessionKeepQuery(querySession_t *session, char **words, int t);
+void printTopPage(queryEngine_t *engine, querySession_t *session, int pageSize, FILE *out);
+void printShardPage(queryEngine_t *engine, querySession_t *session, int pageSize, FILE *out);
+void printRankedResults(postings_t *result, const docLookup_t *lookup, querySession_t *session, int pageSize, FILE *out);
+void printRankedList(ranked_t *ranked, size_t n, const docLookup_t *lookup, querySession_t *session, int pageSize, FILE *out);
+void printNextPage(querySession_t *session, const docLookup_t *lookup, int pageSize, FILE *out);
+void printDocument(const ranked_t *doc, const docLookup_t *lookup, bool lines, FILE *out);
+void sessionInit(querySession_t *session, bool firstPageOnly, bool lines);
+void sessionEnd(querySession_t *session);
+void sessionFree(querySession_t *session);
 
 // Callback functions
-void callbackSetMinimum(void *arg, const int key, const int count);
-void callbackAddCounts(void *arg, const int key, const int count);
 void callbackCountNonZero(void *arg, const int key, const int count);
-void callbackStoreDocScores(void *arg, const int key, const int count);
-
-// Struct to hold document ID and its score for sorting
-typedef struct {
-  int docID;
-  int score;
-} docScore_t;
 
 /* 
  * prompt - Prints "Query? " only if stdin is a terminal
@@ -111,37 +287,147 @@ static void prompt(void)
  * Parameters:
  * - argc: The number of command-line arguments.
  * - argv: The array of argument strings.
- * - pageDirectory: A pointer to store the validated page directory path.
- * - indexFilename: A pointer to store the validated index file path.
+ * - args: Where to store the validated arguments: the page directory and
+ *   index file, the page size (-k, else 0), the query cache size (-c, in
+ *   megabytes; else 0), the ranking (-r), the batch query file (-f, else NULL) and
+ *   number of threads (-j, else 1), the server address (--serve,
+ *   else NULL), and the shard servers' addresses (--shards, else NULL;
+ *   then there is no page directory or index file), and whether to
+ *   time the querier's steps (--stats).
  * 
  * Returns:
  * - None (exits on failure).
  */
-static void parseArgs(int argc, char *argv[], const char **pageDirectory, const char **indexFilename)
+static void parseArgs(int argc, char *argv[], querierArgs_t *args)
 {
-  // Step 1: Check that exactly 2 arguments are provided (excluding program name)
-  if (argc != 3) {
-    fprintf(stderr, "Usage: ./querier pageDirectory indexFilename\n");
+  const char *usage = "Usage: ./querier [-k pageSize] [-c cacheMB] [-r count|bm25] [-f queryFile [-j numThreads] | --serve address]"
+                      " [--stats] pageDirectory indexFilename\n"
+                      "       ./querier [-k pageSize] [-f queryFile [-j numThreads] | --serve address] [--stats]"
+                      " --shards address,...\n";
+  int arg = 1;
+  args->pageSize = 0;
+  args->cacheBytes = 0;
+  args->bm25 = false;
+  args->queryFilename = NULL;
+  args->numThreads = 1;
+  args->serveAddress = NULL;
+  args->shardAddresses = NULL;
+  args->stats = false;
+  bool rankingGiven = false;
+
+  // Step 1: Parse the options; each but --stats takes one value
+  while (arg < argc && argv[arg][0] == '-') {
+    const char *option = argv[arg];
+    if (strcmp(option, "--stats") == 0) {
+      args->stats = true;
+      arg++;
+      continue;
+    }
+    bool serve = strcmp(option, "--serve") == 0;
+    bool shards = strcmp(option, "--shards") == 0;
+    if (arg + 1 >= argc || (!serve && !shards && (strlen(option) != 2 || strchr("kcrfj", option[1]) == NULL))) {
+      fprintf(stderr, "%s", usage);
+      exit(1);
+    }
+    const char *value = argv[arg + 1];
+    arg += 2;
+    if (serve) {
+      args->serveAddress = value;
+      continue;
+    }
+    if (shards) {
+      args->shardAddresses = value;
+      continue;
+    }
+    if (option[1] == 'f') {
+      args->queryFilename = value;
+      continue;
+    }
+    if (option[1] == 'r') {
+      if (strcmp(value, "count") != 0 && strcmp(value, "bm25") != 0) {
+        fprintf(stderr, "Error: ranking must be count or bm25.\n");
+        exit(1);
+      }
+      args->bm25 = strcmp(value, "bm25") == 0;
+      rankingGiven = true;
+      continue;
+    }
+
+    char *end;
+    long number = strtol(value, &end, 10);
+    bool numeric = *value != '\0' && *end == '\0';
+    if (option[1] == 'k') {
+      if (!numeric || number < 1 || number > 1000000) {
+        fprintf(stderr, "Error: pageSize must be between 1 and 1000000.\n");
+        exit(1);
+      }
+      args->pageSize = number;
+    } else if (option[1] == 'c') {
+      if (!numeric || number < 1 || number > 4096) {
+        fprintf(stderr, "Error: cacheMB must be between 1 and 4096.\n");
+        exit(1);
+      }
+      args->cacheBytes = (size_t) number << 20;
+    } else {
+      if (!numeric || number < 1 || number > 64) {
+        fprintf(stderr, "Error: numThreads must be between 1 and 64.\n");
+        exit(1);
+      }
+      args->numThreads = number;
+    }
+  }
+
+  // Step 2: Check that exactly 2 arguments remain (excluding program name),
+  // or none for a coordinator, whose shards have the index and rank it
+  if (argc - arg != (args->shardAddresses != NULL ? 0 : 2)) {
+    fprintf(stderr, "%s", usage);
+    exit(1);
+  }
+  if (args->shardAddresses != NULL && (args->cacheBytes > 0 || rankingGiven)) {
+    fprintf(stderr, "Error: --shards cannot be combined with -c or -r (the shard servers rank).\n");
+    exit(1);
+  }
+  if (args->numThreads > 1 && args->queryFilename == NULL) {
+    fprintf(stderr, "Error: -j needs a query file (-f).\n");
+    exit(1);
+  }
+  if (args->serveAddress != NULL && args->queryFilename != NULL) {
+    fprintf(stderr, "Error: --serve cannot be combined with a query file (-f).\n");
     exit(1);
   }
+  if (args->shardAddresses != NULL) {
+    args->pageDirectory = NULL;
+    args->indexFilename = NULL;
+    return;             // the shards are connected to by main
+  }
 
-  // Step 2: Store arguments in the provided pointers
-  *pageDirectory = argv[1];
-  *indexFilename = argv[2];
+  // Step 3: Store arguments in the provided pointers
+  args->pageDirectory = argv[arg];
+  args->indexFilename = argv[arg + 1];
 
-  // Step 3: Validate that the provided page directory is valid
-  if (!pagedir_validate(*pageDirectory)) {
-    fprintf(stderr, "Error: Invalid page directory: %s\n", *pageDirectory);
+  // Step 4: Validate that the provided page directory is valid
+  if (!pagedir_validate(args->pageDirectory)) {
+    fprintf(stderr, "Error: Invalid page directory: %s\n", args->pageDirectory);
     exit(1);
   }
 
-  // Step 4: Attempt to open the index file for reading to check its validity
-  FILE *indexFp = fopen(*indexFilename, "r");
+  // Step 5: Attempt to open the index file for reading to check its validity
+  FILE *indexFp = fopen(args->indexFilename, "r");
   if (indexFp == NULL) {
-    fprintf(stderr, "Error: Could not open index file: %s\n", *indexFilename);
+    fprintf(stderr, "Error: Could not open index file: %s\n", args->indexFilename);
     exit(1);
   }
   fclose(indexFp); // Close file after successful validation
+
+  // Step 6: Check that the query file, if any, can be read
+  if (args->queryFilename != NULL) {
+    FILE *queryFp = fopen(args->queryFilename, "r");
+    if (queryFp == NULL) {
+      fprintf(stderr, "Error: Could not open query file: %s\n", args->queryFilename);
+      exit(1);
+    }
+    fclose(queryFp);
+  }
 }
 
 /* 
@@ -149,8 +435,11 @@ static void parseArgs(int argc, char *argv[], const char **pageDirectory, const
  * 
  * This function:
  * 1. Parses and validates command-line arguments.
- * 2. Loads the index file into memory.
- * 3. Reads user queries in a loop, processing each one.
+ * 2. Loads the index file into memory, and maps its document table; or,
+ *    with --shards, connects to the shard servers instead.
+ * 3. Reads user queries in a loop, processing each one; or, in batch
+ *    mode, evaluates the query file's queries with runBatch; or, in
+ *    server mode, answers requests on a socket with server_run.
  * 4. Cleans up memory before exiting.
  * 
  * Parameters:
@@ -163,35 +452,435 @@ static void parseArgs(int argc, char *argv[], const char **pageDirectory, const
 int main(int argc, char *argv[])
 {
   // Step 1: Parse and validate command-line arguments
-  const char *pageDirectory;
-  const char *indexFilename;
-  parseArgs(argc, argv, &pageDirectory, &indexFilename);
+  querierArgs_t args;
+  parseArgs(argc, argv, &args);
+  const char *indexFilename = args.indexFilename;
+  int pageSize = args.pageSize;
+  if (args.stats && !stats_enable()) {
+    fprintf(stderr, "Warning: --stats reports nothing; the querier was built with -DNOSTATS.\n");
+  }
 
-  // Step 2: Open the index file and load it into memory
-  FILE *indexFile = fopen(indexFilename, "r");
-  index_t *index = mem_assert(index_load(indexFile), "index_load failed"); 
-  // index_load reads the index file and allocates memory to store it
-  // technically, we already check for file failure in parseArgs, consider this a sanity check
+  // Step 2: Load the index and its document table, or connect to the shards
+  queryEngine_t engine = { NULL, 0, { NULL, args.pageDirectory }, querycache_new(args.cacheBytes),
+                           PTHREAD_MUTEX_INITIALIZER, args.bm25, NULL };
+  if (args.shardAddresses != NULL) {
+    engine.shards = shardset_new(args.shardAddresses);
+    if (engine.shards == NULL) {
+      exit(2);
+    }
+  } else if (!engineLoad(&engine, indexFilename)) {
+    fprintf(stderr, "Error: Could not load index file: %s\n", indexFilename);
+    if (args.bm25) {
+      fprintf(stderr, "(-r bm25 needs the impacts the indexer saves with the index and each of its segments;"
+                      " reindex to add them)\n");
+    }
+    exit(2);
+  }
 
-  fclose(indexFile); // Close the file after loading the index
+  // In batch mode, evaluate the whole query file, then clean up
+  if (args.queryFilename != NULL) {
+    runBatch(&engine, &args);
+    engineUnload(&engine);
+    querycache_delete(engine.cache);
+    return 0;
+  }
+
+  // In server mode, answer requests until stopped, then clean up
+  if (args.serveAddress != NULL) {
+    serveContext_t context = { &engine, indexFilename, pageSize, 0, 0 };
+    sessionInit(&context.session, true, true);
+    server_handlers_t handlers = { serveRequest, serveStats, &context };
+    bool served = server_run(args.serveAddress, &handlers);
+    sessionFree(&context.session);
+    engineUnload(&engine);
+    querycache_delete(engine.cache);
+    return served ? 0 : 3;
+  }
 
   // Step 3: Read user queries in a loop
   char *query = NULL;
   size_t len = 0;
   
-  // Continuously prompt the user for queries and process them
+  querySession_t session;
+  sessionInit(&session, false, false);
+  
+  // Continuously prompt the user for queries and process them,
+  // reloading the index first if its file has changed
   while (prompt(), getline(&query, &len, stdin) != -1) {
-    processQuery(query, index, pageDirectory);
+    engineRefresh(&engine, indexFilename, &session);
+    processQuery(query, &engine, &session, pageSize, stdout);
     printf("-----------------------------------------------\n");
   }
 
+  // Report how well the cache did, to an interactive user
+  if (engine.cache != NULL && isatty(fileno(stdin))) {
+    querycache_stats_t stats;
+    querycache_stats(engine.cache, &stats);
+    fprintf(stderr, "Query cache: %lu hits, %lu misses, %lu evictions, %zu queries in %zu bytes\n",
+            stats.hits, stats.misses, stats.evictions, stats.entries, stats.bytes);
+  }
+
   // Step 4: Free allocated memory before exiting
   free(query);         // Free dynamically allocated query buffer
-  index_delete(index); // Free allocated index structure
+  sessionFree(&session); // Free any result still being paged through, and the arenas
+  engineUnload(&engine); // Free the index and unmap the document table
+  querycache_delete(engine.cache);
 
   return 0; // Indicate successful execution
 }
 
+/* 
+ * engineLoad - Loads the index file, its segments and their document tables
+ * 
+ * A binary index is mapped, which is instant; a text index is loaded into
+ * memory. Segments are always binary. The document tables saved next to
+ * them are mapped if there are any; without them, URLs are read from the
+ * page files. Ranking by BM25 also needs every segment's impacts.
+ * 
+ * Parameters:
+ * - engine: Where to keep the index, document table, and index version.
+ * - indexFilename: The index file.
+ * 
+ * Returns:
+ * - true on success; false, leaving the engine unchanged, on failure.
+ */
+static bool engineLoad(queryEngine_t *engine, const char *indexFilename)
+{
+  uint64_t version = indexset_version(indexFilename);
+  indexset_t *indexes = indexset_open(indexFilename);
+  if (indexes == NULL) {
+    return false;
+  }
+  if (engine->bm25 && !indexset_hasImpacts(indexes)) {
+    indexset_delete(indexes);
+    return false;
+  }
+
+  engine->indexes = indexes;
+  engine->version = version;
+  engine->lookup.indexes = indexes;
+  return true;
+}
+
+/* 
+ * engineRefresh - Reloads the index if its file has changed
+ * 
+ * Any result being paged through belongs to the old index, so the session
+ * ends; cached rankings are dropped by the cache itself, the first time it
+ * is used with the new version. If the new file cannot be loaded (say, it
+ * is being written), the old index stays in use and is checked again
+ * before the next query.
+ * 
+ * Parameters:
+ * - engine: The loaded index.
+ * - indexFilename: The index file.
+ * - session: The session to end if the index is reloaded.
+ * 
+ * Returns:
+ * - None.
+ */
+static void engineRefresh(queryEngine_t *engine, const char *indexFilename, querySession_t *session)
+{
+  uint64_t version = indexset_version(indexFilename);
+  if (version == 0 || version == engine->version) {
+    return;
+  }
+
+  indexset_t *oldIndexes = engine->indexes;
+  if (engineLoad(engine, indexFilename)) {
+    sessionEnd(session);
+    indexset_delete(oldIndexes);
+  }
+}
+
+/* 
+ * engineUnload - Frees the index and its segments and unmaps their tables
+ * 
+ * A coordinator's connections to its shards are closed.
+ * 
+ * Parameters:
+ * - engine: The loaded index; the cache is left alone.
+ * 
+ * Returns:
+ * - None.
+ */
+static void engineUnload(queryEngine_t *engine)
+{
+  indexset_delete(engine->indexes);
+  shardset_delete(engine->shards);
+  engine->indexes = NULL;
+  engine->lookup.indexes = NULL;
+  engine->shards = NULL;
+}
+
+/* 
+ * runBatch - Evaluates a file of queries on a pool of threads
+ * 
+ * Every query is read first. Then numThreads threads take queries in
+ * turn and evaluate them against the shared index, each printing into
+ * the query's own memory buffer (open_memstream), while this thread
+ * writes the buffers to stdout in input order as they finish. Every query
+ * is evaluated on its own, as if it were the first: empty lines print
+ * nothing, and with a page size only the first page is printed. The
+ * index is not reloaded during a batch.
+ * 
+ * Afterwards, prints to stderr the batch's throughput and the median
+ * (p50) and 99th-percentile (p99) latency of its queries.
+ * 
+ * Parameters:
+ * - engine: The loaded index, document table, and query cache.
+ * - args: The command-line arguments (query file, threads, page size).
+ * 
+ * Returns:
+ * - None (exits if memory runs out).
+ */
+static void runBatch(queryEngine_t *engine, const querierArgs_t *args)
+{
+  // Step 1: Read every query
+  FILE *queryFile = fopen(args->queryFilename, "r");
+  if (queryFile == NULL) {
+    fprintf(stderr, "Error: Could not open query file: %s\n", args->queryFilename);
+    exit(1);
+  }
+  batch_t batch = { engine, NULL, 0, 0, args->pageSize, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+  int capacity = 0;
+  char *line = NULL;
+  size_t len = 0;
+  while (getline(&line, &len, queryFile) != -1) {
+    if (batch.numQueries == capacity) {
+      capacity = capacity == 0 ? 1024 : 2 * capacity;
+      batchQuery_t *bigger = mem_assert(mem_malloc(capacity * sizeof(batchQuery_t)), "runBatch: out of memory");
+      if (batch.queries != NULL) {
+        memcpy(bigger, batch.queries, batch.numQueries * sizeof(batchQuery_t));
+        mem_free(batch.queries);
+      }
+      batch.queries = bigger;
+    }
+    batchQuery_t *q = &batch.queries[batch.numQueries++];
+    q->query = line;      // getline's buffer becomes the query's
+    q->output = NULL;
+    q->outputLen = 0;
+    q->latency = 0;
+    q->done = false;
+    line = NULL;
+    len = 0;
+  }
+  free(line);
+  fclose(queryFile);
+
+  // Step 2: Start the threads, at most one per query
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int numThreads = args->numThreads < batch.numQueries ? args->numThreads : batch.numQueries;
+  pthread_t *threads = NULL;
+  if (numThreads > 0) {
+    threads = mem_assert(mem_malloc(numThreads * sizeof(pthread_t)), "runBatch: out of memory");
+  }
+  for (int i = 0; i < numThreads; i++) {
+    if (pthread_create(&threads[i], NULL, batchWorker, &batch) != 0) {
+      fprintf(stderr, "Error: Could not create querier thread.\n");
+      exit(1);
+    }
+  }
+
+  // Step 3: Write each query's output as soon as it and all before it are done
+  double *latencies = mem_assert(mem_malloc((batch.numQueries + 1) * sizeof(double)), "runBatch: out of memory");
+  for (int i = 0; i < batch.numQueries; i++) {
+    batchQuery_t *q = &batch.queries[i];
+    pthread_mutex_lock(&batch.lock);
+    while (!q->done) {
+      pthread_cond_wait(&batch.finished, &batch.lock);
+    }
+    pthread_mutex_unlock(&batch.lock);
+
+    fwrite(q->output, 1, q->outputLen, stdout);
+    free(q->output);      // allocated by open_memstream
+    free(q->query);       // allocated by getline
+    latencies[i] = q->latency;
+  }
+  fflush(stdout);
+  for (int i = 0; i < numThreads; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  double elapsed = secondsSince(&start);
+
+  // Step 4: Report throughput and latency percentiles
+  if (batch.numQueries > 0) {
+    qsort(latencies, batch.numQueries, sizeof(double), compareDoubles);
+    double p50 = latencies[(batch.numQueries - 1) * 50 / 100];
+    double p99 = latencies[(batch.numQueries - 1) * 99 / 100];
+    fprintf(stderr, "Batch: %d queries in %.3f s on %d threads: %.1f queries/sec, latency p50 %.3f ms, p99 %.3f ms\n",
+            batch.numQueries, elapsed, numThreads, elapsed > 0 ? batch.numQueries / elapsed : 0.0,
+            1000 * p50, 1000 * p99);
+  }
+
+  if (threads != NULL) {
+    mem_free(threads);
+  }
+  if (batch.queries != NULL) {
+    mem_free(batch.queries);
+  }
+  mem_free(latencies);
+  pthread_mutex_destroy(&batch.lock);
+  pthread_cond_destroy(&batch.finished);
+}
+
+/* 
+ * batchWorker - Thread body for runBatch
+ * 
+ * Repeatedly takes the batch's next query, evaluates it into the query's
+ * output buffer, times it, and marks it done, until none are left. The
+ * functions it calls keep all their state in their arguments, the index
+ * and document table are only read, and the cache is locked, so any
+ * number of workers can share one engine. Each worker has its own
+ * session, whose arenas every query it evaluates reuses.
+ * 
+ * Parameters:
+ * - arg: The `batch_t`.
+ * 
+ * Returns:
+ * - NULL.
+ */
+static void* batchWorker(void *arg)
+{
+  batch_t *batch = arg;
+  querySession_t session;  // one per thread, so its arenas are reused
+  sessionInit(&session, true, false);
+  for (;;) {
+    pthread_mutex_lock(&batch->lock);
+    int i = batch->next++;
+    pthread_mutex_unlock(&batch->lock);
+    if (i >= batch->numQueries) {
+      sessionFree(&session);
+      return NULL;
+    }
+
+    batchQuery_t *q = &batch->queries[i];
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    FILE *out = mem_assert(open_memstream(&q->output, &q->outputLen), "batchWorker: out of memory");
+    processQuery(q->query, batch->engine, &session, batch->pageSize, out);
+    sessionEnd(&session);
+    fprintf(out, "-----------------------------------------------\n");
+    fclose(out);
+    q->latency = secondsSince(&start);
+
+    pthread_mutex_lock(&batch->lock);
+    q->done = true;
+    pthread_cond_broadcast(&batch->finished);
+    pthread_mutex_unlock(&batch->lock);
+  }
+}
+
+/* 
+ * serveRequest - Answers one server request (the server's request handler)
+ * 
+ * A "QUERY words..." request is evaluated like an interactive query,
+ * after reloading the index if its file has changed, but on a session
+ * that ends with the request (its arenas are reused), printed in the line format for programs (see the top of this
+ * file), and ended by "END". "TOP k words..." is answered the same way,
+ * with a page size of k. Anything else, an empty query, or an invalid
+ * one is answered by a single ERROR line.
+ * 
+ * Parameters:
+ * - arg: The `serveContext_t`.
+ * - line: The request, without its line terminator.
+ * - out: Where to write the response.
+ * 
+ * Returns:
+ * - None.
+ */
+static void serveRequest(void *arg, char *line, FILE *out)
+{
+  serveContext_t *context = arg;
+  int pageSize = context->pageSize;
+  char *query;
+  if (strncmp(line, "QUERY", 5) == 0 && (line[5] == '\0' || isspace((unsigned char) line[5]))) {
+    query = line + 5;
+  } else if (strncmp(line, "TOP", 3) == 0 && isspace((unsigned char) line[3])) {
+    // A coordinator's request: its page size comes first
+    long k = strtol(line + 3, &query, 10);
+    if (query == line + 3 || k < 0 || k > 1000000000 || (*query != '\0' && !isspace((unsigned char) *query))) {
+      fprintf(out, "ERROR\tbad page size\n");
+      context->rejected++;
+      return;
+    }
+    pageSize = k;
+  } else {
+    fprintf(out, "ERROR\tunknown request\n");
+    context->rejected++;
+    return;
+  }
+  while (isspace((unsigned char) *query)) {
+    query++;
+  }
+  if (*query == '\0') {
+    fprintf(out, "ERROR\tempty query\n");
+    context->rejected++;
+    return;
+  }
+
+  querySession_t *session = &context->session;
+  engineRefresh(context->engine, context->indexFilename, session);
+  if (!processQuery(query, context->engine, session, pageSize, out)) {
+    fprintf(out, "ERROR\tinvalid query\n");
+    context->rejected++;
+    return;
+  }
+  sessionEnd(session);
+  fprintf(out, "END\n");
+  context->queries++;
+}
+
+/* 
+ * serveStats - Adds the querier's counters to the server's STATS line
+ * 
+ * With --stats, the stats timers' fields (see stats.h) are added too.
+ * 
+ * Parameters:
+ * - arg: The `serveContext_t`.
+ * - out: Where to write the "\tname=value" fields.
+ * 
+ * Returns:
+ * - None.
+ */
+static void serveStats(void *arg, FILE *out)
+{
+  serveContext_t *context = arg;
+  fprintf(out, "\tqueries=%lu\trejected=%lu", context->queries, context->rejected);
+  if (stats_recording) {
+    stats_fields(out);
+  }
+  if (context->engine->shards != NULL) {
+    fprintf(out, "\tshards=%d", shardset_size(context->engine->shards));
+  }
+  if (context->engine->cache != NULL) {
+    querycache_stats_t stats;
+    querycache_stats(context->engine->cache, &stats);
+    fprintf(out, "\tcache_hits=%lu\tcache_misses=%lu\tcache_entries=%zu\tcache_bytes=%zu",
+            stats.hits, stats.misses, stats.entries, stats.bytes);
+  }
+}
+
+/* 
+ * secondsSince - Returns the seconds elapsed since a CLOCK_MONOTONIC time
+ */
+static double secondsSince(const struct timespec *start)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* 
+ * compareDoubles - Orders doubles increasingly, for qsort
+ */
+static int compareDoubles(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
 /* 
  * processQuery - Parses, validates, and evaluates a query
  * 
@@ -200,57 +889,229 @@ int main(int argc, char *argv[])
  * 2. Tokenizing it into words.
  * 3. Validating its syntax.
  * 4. Evaluating the query using AND/OR logic.
- * 5. Printing the ranked results.
+ * 5. Printing the ranked results (the first page of them, with a page size).
+ * 
+ * An empty query, while the session still has results to page through,
+ * prints the next page instead. With a cache, a query whose canonical
+ * form was ranked before is printed from the cache without evaluation;
+ * otherwise its full ranking is computed and cached, unless too big.
+ * Ranking by BM25 with a page size and no cache looks for just the top
+ * documents (printTopPage). A coordinator asks its shards (printShardPage).
+ * 
+ * Everything the query allocates comes from the session's arenas, and is
+ * freed in one step once its results are printed, or, while the session
+ * pages through them, when the session ends. An empty or invalid query
+ * leaves the result being paged through alone.
  * 
  * Parameters:
  * - query: The input query string.
- * - index: A pointer to the index structure for word-document mappings.
- * - pageDirectory: The directory containing the crawled pages.
+ * - engine: The index, document table, and query cache.
+ * - session: The last query's result, for paging; replaced by a new query.
+ * - pageSize: Documents per page, or 0 to print all of them.
+ * - out: Where to print the results (errors go to stderr).
  * 
  * Returns:
- * - None (outputs query results or errors).
+ * - false if the query was rejected as invalid (nothing is printed to
+ *   out), else true.
  */
-void processQuery(char *query, index_t *index, const char *pageDirectory)
+bool processQuery(char *query, queryEngine_t *engine, querySession_t *session, int pageSize, FILE *out)
 {
   // Step 1: Validate that the query contains only valid characters (letters and spaces)
   if (!isValidCharacters(query)) {
-    return;  // If invalid, exit immediately
+    return false;  // If invalid, exit immediately
   }
 
   // Step 2: Estimate the maximum possible number of words in the query
   // A worst-case assumption is that every other character is a space, so max words = strlen(query) / 2 + 1
+  // The words go in the spare arena, which holds nothing the session still needs
   int maxWords = strlen(query) / 2 + 1;
-  char **words = mem_malloc(maxWords * sizeof(char*));       // Allocate memory for words array
-  mem_assert(words, "Memory allocation for words failed.");  // Ensure memory allocation was successful
+  char **words = arena_alloc(session->spare, maxWords * sizeof(char*));
 
   // Step 3: Tokenize the query into words and count the number of tokens
   int t = queryTokenize(query, words, maxWords);
   
-  // If no tokens were found, return without processing further
+  // If no tokens were found, show the next page if paging; else do nothing further
   if (t == 0) {
-    return;
+    if (session->words != NULL && engine->shards != NULL) {
+      printShardPage(engine, session, pageSize, out);
+    } else if (session->words != NULL) {
+      printTopPage(engine, session, pageSize, out);
+    } else if (session->remaining > 0) {
+      printNextPage(session, &engine->lookup, pageSize, out);
+    }
+    arena_reset(session->spare);
+    return true;
   }
 
   // Step 4: Validate query syntax (ensures proper use of "AND"/"OR")
   if (!isValidQuerySyntax(words, t)) {
-    return;
+    arena_reset(session->spare);
+    return false;
   }
 
   // Step 5: Print the formatted query for logging
-  printf("Query:");
+  fprintf(out, session->lines ? "QUERY\t" : "Query: ");
   for (int i = 0; i < t; i++) {
-    printf(" %s", words[i]);
+    fprintf(out, i == 0 ? "%s" : " %s", words[i]);
+  }
+  fprintf(out, "\n");
+
+  // A new query ends paging through the last one, freeing its arena;
+  // the spare arena, holding the new query's words, takes its place
+  sessionEnd(session);
+  arena_t *arena = session->spare;
+  session->spare = session->arena;
+  session->arena = arena;
+
+  // A coordinator's shards do the rest, given a copy of the query (its
+  // words are in the caller's buffer) to ask for more
+  if (engine->shards != NULL) {
+    sessionKeepQuery(session, words, t);
+    printShardPage(engine, session, pageSize, out);
+    arena_reset(session->spare);
+    return true;
   }
-  printf("\n");
 
-  // Step 6: Evaluate the query and retrieve matching documents
-  counters_t *result = queryEvaluate(words, t, index);
+  // Step 6: With a cache, print a query ranked before straight from it
+  char *key = NULL;
+  ranked_t *ranked;
+  size_t n;
+  bool hit = false;
+  if (engine->cache != NULL) {
+    key = queryCanonical(words, t, arena);
+    pthread_mutex_lock(&engine->cacheLock);
+    hit = querycache_get(engine->cache, key, engine->version, &ranked, &n, arena);
+    pthread_mutex_unlock(&engine->cacheLock);
+  }
 
-  // Step 7: Print the ranked results of the query
-  printRankedResults(result, pageDirectory);
+  if (hit) {
+    STATS_START(printStart);
+    printRankedList(ranked, n, &engine->lookup, session, pageSize, out);
+    STATS_STOP(STATS_PRINT_RESULTS, printStart);
+  } else if (engine->bm25 && pageSize > 0 && key == NULL) {
+    // By BM25, find only the top documents, keeping a copy of the query
+    // (its words are in the caller's buffer) for more
+    sessionKeepQuery(session, words, t);
+    printTopPage(engine, session, pageSize, out);
+  } else {
+    // Step 7: Evaluate the query and retrieve matching documents, scored
+    // by BM25 if asked for
+    STATS_START(evaluateStart);
+    postings_t *result;
+    if (engine->bm25) {
+      impactlist_t *lists;
+      int *ends;
+      int numSequences = queryImpacts(words, t, engine->indexes, arena, &lists, &ends);
+      result = blockmax_all(lists, ends, numSequences, arena);
+    } else {
+      result = queryEvaluate(words, t, engine->indexes, arena);
+    }
+    STATS_STOP(STATS_QUERY_EVALUATE, evaluateStart);
+
+    // Step 8: With a cache, rank every match and cache the ranking, if it fits;
+    // otherwise print the ranked results, keeping the result in the session
+    // for the next page
+    STATS_START(printStart);
+    int matchCount = 0;
+    if (key != NULL) {
+      postings_iterate(result, &matchCount, callbackCountNonZero);
+    }
+    if (key != NULL && querycache_fits(engine->cache, key, matchCount)) {
+      ranked = arena_alloc(arena, matchCount * sizeof(ranked_t));
+      n = ranking_topk(result, matchCount, ranked);
+      pthread_mutex_lock(&engine->cacheLock);
+      querycache_put(engine->cache, key, engine->version, ranked, n);
+      pthread_mutex_unlock(&engine->cacheLock);
+      printRankedList(ranked, n, &engine->lookup, session, pageSize, out);
+    } else {
+      printRankedResults(result, &engine->lookup, session, pageSize, out);
+    }
+    STATS_STOP(STATS_PRINT_RESULTS, printStart);
+  }
 
-  // Step 8: Free memory used by the result counters
-  counters_delete(result);
+  // Step 9: Free everything the query allocated, in one step, unless the
+  // session keeps it for the next page
+  if (session->remaining == 0 && session->words == NULL) {
+    sessionEnd(session);
+  }
+  arena_reset(session->spare);
+  return true;
+}
+
+/* 
+ * queryCanonical - Builds the canonical form of a valid query
+ * 
+ * Queries that differ only in ways that cannot change their results have
+ * the same canonical form, which is the query cache's key: "and" is
+ * dropped (it is implied), the words of each AND sequence are sorted
+ * (intersection takes the minimum count, in any order), and the AND
+ * sequences are sorted (union adds their scores, in any order). Repeated
+ * words and sequences are kept, since a repeated OR sequence counts twice.
+ * 
+ * Parameters:
+ * - words: The query's words, lowercased and of valid syntax.
+ * - n: The number of words.
+ * - arena: Where to allocate the key and temporaries.
+ * 
+ * Returns:
+ * - A new string in the arena, e.g. "cat dog or mouse".
+ */
+char* queryCanonical(char **words, int n, arena_t *arena)
+{
+  char **terms = arena_alloc(arena, (n + 1) * sizeof(char*));
+  char **sequences = arena_alloc(arena, (n + 1) * sizeof(char*));
+  size_t total = 0;
+  for (int i = 0; i < n; i++) {
+    total += strlen(words[i]) + 1;
+  }
+  int numSequences = 0, numTerms = 0;
+
+  // Step 1: Build each AND sequence's words, sorted and space-separated
+  for (int i = 0; i <= n; i++) {
+    if (i < n && strcmp(words[i], "or") != 0) {
+      if (strcmp(words[i], "and") != 0) {
+        terms[numTerms++] = words[i];
+      }
+      continue;
+    }
+    qsort(terms, numTerms, sizeof(char*), compareStrings);
+    char *sequence = arena_alloc(arena, total + 1);
+    sequence[0] = '\0';
+    for (int j = 0; j < numTerms; j++) {
+      if (j > 0) {
+        strcat(sequence, " ");
+      }
+      strcat(sequence, terms[j]);
+    }
+    sequences[numSequences++] = sequence;
+    numTerms = 0;
+  }
+
+  // Step 2: Join the sorted sequences with " or "
+  qsort(sequences, numSequences, sizeof(char*), compareStrings);
+  char *key = arena_alloc(arena, total + 3 * numSequences + 1);
+  key[0] = '\0';
+  for (int i = 0; i < numSequences; i++) {
+    if (i > 0) {
+      strcat(key, " or ");
+    }
+    strcat(key, sequences[i]);
+  }
+  return key;
+}
+
+/* 
+ * compareStrings - Orders string pointers alphabetically, for qsort
+ * 
+ * Parameters:
+ * - a, b: Pointers to two char* elements.
+ * 
+ * Returns:
+ * - Negative, 0, or positive, as strcmp.
+ */
+int compareStrings(const void *a, const void *b)
+{
+  return strcmp(*(char * const *)a, *(char * const *)b);
 }
 
 /* 
@@ -262,91 +1123,101 @@ void processQuery(char *query, index_t *index, const char *pageDirectory)
  * 
  * Behavior:
  * - If `andSequence` is NULL, nothing happens.
- * - If `orSequence` is NULL, it is initialized as a new counters set.
- * - The counts from `andSequence` are merged into `orSequence` using `unionCounters()`.
- * - `andSequence` is then deleted to free memory.
+ * - If `orSequence` is NULL, it simply takes over `andSequence`.
+ * - Otherwise the two are combined using `unionPostings()`.
+ * - `andSequence` is then set to NULL, since it has been consumed.
  * 
  * Parameters:
- * - andSequence: A pointer to the counters representing an AND sequence.
- * - orSequence: A pointer to the counters representing an OR sequence.
+ * - andSequence: A pointer to the postings representing an AND sequence.
+ * - orSequence: A pointer to the postings representing an OR sequence.
+ * - arena: Where to allocate the merged list.
  * 
  * Returns:
- * - None (modifies `orSequence` in place and frees `andSequence`).
+ * - None (modifies `orSequence` in place and consumes `andSequence`).
  */
-static void matchMerge(counters_t **andSequence, counters_t **orSequence)
+static void matchMerge(postings_t **andSequence, postings_t **orSequence, arena_t *arena)
 {
   // Check if andSequence exists before merging
   if (*andSequence != NULL) {
     
-    // If orSequence is NULL, create a new counters set
+    // If orSequence is NULL, the AND sequence becomes the OR sequence
     if (*orSequence == NULL) {
-      *orSequence = mem_assert(counters_new(), "matchMerge: Failed to allocate memory for orSequence");
+      *orSequence = *andSequence;
+    } else {
+      // Merge the counts from andSequence into orSequence using OR logic;
+      // andSequence's memory goes with the arena
+      unionPostings(orSequence, *andSequence, arena);
     }
-
-    // Merge the counts from andSequence into orSequence using OR logic
-    unionCounters(*orSequence, *andSequence);
-
-    // Free andSequence memory after merging, since it is no longer needed
-    counters_delete(*andSequence);
     *andSequence = NULL; // Prevent dangling pointer
   }
 }
 
 /* 
- * unionCounters - Combines two counters using OR logic
+ * unionPostings - Combines two posting lists using OR logic
  * 
- * This function merges the counts from `andResult` into `result`. 
+ * This function merges the counts from `andResult` into `*result`. 
  * It performs an "OR" operation, meaning:
- * - If a key exists in both counters, their counts are added.
- * - If a key exists only in `andResult`, it is added to `result` with its count.
- * - If a key exists only in `result`, it remains unchanged.
+ * - If a docID exists in both lists, their counts are added.
+ * - If a docID exists in only one list, it is kept with its count.
+ * Both lists are sorted, so this is a single linear merge.
  * 
  * Parameters:
- * - result: The accumulator counters where counts will be combined.
- * - andResult: The counters to merge into `result`.
+ * - result: Pointer to the accumulator list; replaced by the merged list.
+ * - andResult: The list to merge into `*result` (unchanged).
+ * - arena: Where to allocate the merged list; the old `*result` is
+ *   simply left there.
  * 
  * Returns:
- * - None (modifies `result` in place).
+ * - None (replaces `*result`).
  */
-void unionCounters(counters_t *result, counters_t *andResult)
+void unionPostings(postings_t **result, postings_t *andResult, arena_t *arena)
 {
-  // Ensure both counters are valid before proceeding
-  if (result == NULL || andResult == NULL) return;
+  // Ensure both lists are valid before proceeding
+  if (result == NULL || *result == NULL || andResult == NULL) return;
 
-  // Iterate through `andResult`, adding counts to `result`
-  counters_iterate(andResult, result, callbackAddCounts);
+  *result = postings_union(*result, andResult, arena);
 }
 
 /* 
- * intersectCounters - Combines two counters using AND logic
+ * intersectSequence - Combines the posting lists of an AND sequence
  * 
- * This function modifies `acc` (accumulator) to retain only the minimum 
- * count for each key that exists in both `acc` and `wordCounters`. 
- * This implements an "AND" operation in the sense that a key must be 
- * present in both counters to be kept, and its final count is the minimum 
- * of the two.
+ * This function intersects the posting lists of every word in one AND
+ * sequence at once, keeping for each docID the minimum of its counts.
+ * The lists are first sorted by document frequency, so that candidates
+ * come from the rarest word and each is checked against the next rarest
+ * first; the longer lists are only galloped through. The cost is close
+ * to linear in the length of the shortest list, not the longest.
  * 
  * Parameters:
- * - acc: The accumulator counters (updated in-place).
- * - wordCounters: The counters to compare with `acc`.
+ * - lists: The posting lists of the sequence's words (reordered in place).
+ * - n: The number of lists (at least 1).
+ * - arena: Where to allocate the result.
  * 
  * Returns:
- * - None (modifies `acc` in place).
+ * - A new postings_t* with the documents in every list.
  */
-void intersectCounters(counters_t *acc, counters_t *wordCounters)
+postings_t* intersectSequence(const postings_t **lists, int n, arena_t *arena)
 {
-  // Ensure valid memory before proceeding
-  mem_assert(acc, "intersectCounters: acc is NULL");
-  mem_assert(wordCounters, "intersectCounters: wordCounters is NULL");
-  
-  // Create a struct to pass both counters as arguments to the callback function
-  struct {
-    counters_t *acc;          // The accumulator to be updated
-    counters_t *wordCounters; // The second set of counters for comparison
-  } args = {acc, wordCounters};
+  // Rarest word first
+  qsort(lists, n, sizeof(lists[0]), compareDocFrequency);
 
-  // Iterate over `acc` and update values based on `wordCounters`
-  counters_iterate(acc, &args, callbackSetMinimum);
+  return postings_intersectAll(lists, n, arena);
+}
+
+/* 
+ * compareDocFrequency - Orders posting lists by increasing length
+ * 
+ * Parameters:
+ * - a, b: Pointers to two postings_t* elements.
+ * 
+ * Returns:
+ * - Negative if a has fewer documents than b, positive if more, 0 if equal.
+ */
+int compareDocFrequency(const void *a, const void *b)
+{
+  size_t sizeA = postings_size(*(const postings_t **)a);
+  size_t sizeB = postings_size(*(const postings_t **)b);
+  return (sizeA > sizeB) - (sizeA < sizeB);
 }
 
 /* 
@@ -357,29 +1228,40 @@ void intersectCounters(counters_t *acc, counters_t *wordCounters)
  * the index and determines the final set of matching documents.
  * 
  * Logic:
- * - Words separated by "AND" are intersected (documents must match all).
+ * - The posting lists of the words in an AND sequence (the words between
+ *   two "OR"s) are gathered, then intersected together by intersectSequence.
+ * - If a word is not found in the index, the AND sequence is invalidated,
+ *   and its remaining words are not even looked up.
  * - Groups of "AND" sequences are combined with "OR" (documents can match any).
- * - If a word is not found in the index, the AND sequence is invalidated.
- * - At the end, the function returns a counters_t structure with the final results.
+ * - At the end, the function returns a postings_t list with the final results.
  * 
  * Parameters:
  * - words: Array of words representing the query.
  * - t: The number of words in the query.
- * - index: The index structure storing word-document mappings.
+ * - indexes: The index and its segments, storing word-document mappings.
+ * - arena: Where to allocate the result and every intermediate list,
+ *   including a word's list combined from several segments.
  * 
  * Returns:
- * - A counters_t* containing the merged document matches.
+ * - A postings_t* in the arena containing the merged document matches.
  */
-counters_t* queryEvaluate(char **words, int t, index_t *index)
+postings_t* queryEvaluate(char **words, int t, indexset_t *indexes, arena_t *arena)
 {
-  counters_t *andSequence = NULL;  // Holds the result of consecutive "AND" operations
-  counters_t *orSequence = NULL;   // Holds the result of merging multiple "AND" sequences with "OR"
+  postings_t *orSequence = NULL;   // Holds the result of merging multiple "AND" sequences with "OR"
   bool andSequenceInvalid = false; // Tracks if a word results in an empty intersection, meaning no match
 
-  for (int i = 0; i < t; i++) {
-    // If the word is "or", merge the current AND sequence into OR sequence
-    if (strcmp(words[i], "or") == 0) {
-      matchMerge(&andSequence, &orSequence);
+  // The posting lists of the current AND sequence's words
+  const postings_t **andLists = arena_alloc(arena, t * sizeof(postings_t*));
+  int n = 0;
+
+  for (int i = 0; i <= t; i++) {
+    // At an "or" or the end of the query, merge the current AND sequence into the OR sequence
+    if (i == t || strcmp(words[i], "or") == 0) {
+      if (!andSequenceInvalid && n > 0) {
+        postings_t *andSequence = intersectSequence(andLists, n, arena);
+        matchMerge(&andSequence, &orSequence, arena);
+      }
+      n = 0;
       andSequenceInvalid = false; // Reset since a new OR sequence is starting
       continue;
     }
@@ -394,35 +1276,75 @@ counters_t* queryEvaluate(char **words, int t, index_t *index)
       continue;
     }
 
-    // Find the counters structure for the current word in the index
-    counters_t *wordMatch = index_find(index, words[i]);
+    // Find the posting list for the current word in the index and its segments
+    postings_t *wordMatch = indexset_find(indexes, words[i], arena);
     // If the word is NOT found in the index, the entire AND sequence is invalid
     if (wordMatch == NULL) {
       andSequenceInvalid = true;
-      if (andSequence != NULL) { // Free any existing AND sequence since it's now irrelevant
-        counters_delete(andSequence);
-        andSequence = NULL;
-      }
     } else {
-      // If this is the first word of a new AND sequence, initialize a new counters structure
-      if (andSequence == NULL) {
-        andSequence = counters_new();
-        mem_assert(andSequence, "Error: Out of memory for andSequence counter.");
-        counters_iterate(wordMatch, andSequence, callbackAddCounts); // Copy counts from wordMatch
-      } else {
-        // Otherwise, perform an intersection between the existing AND sequence and the current word’s matches
-        intersectCounters(andSequence, wordMatch);
-      }
+      andLists[n++] = wordMatch;
     }
   }
 
-  // Merge any remaining AND sequence into the OR sequence before returning the result
-  matchMerge(&andSequence, &orSequence);
-
   // Return the final OR sequence containing all matched documents
   return orSequence; 
 }
 
+/* 
+ * queryImpacts - Gathers the impact lists of a query, for BM25 ranking
+ * 
+ * Like queryEvaluate, this splits the query into AND sequences and drops
+ * any sequence with a word not in the index, but evaluates nothing: the
+ * surviving sequences' impact lists are handed to blockmax_all or
+ * blockmax_topk, which intersect and score them in one pass.
+ * 
+ * Parameters:
+ * - words: Array of words representing the query.
+ * - t: The number of words in the query.
+ * - indexes: The index and its segments, with their impacts.
+ * - arena: Where to allocate the lists, including a word's list combined
+ *   from several segments.
+ * - lists: Where to store the sequences' lists, one sequence after another.
+ * - ends: Where to store, for each sequence, one past its last list.
+ * 
+ * Returns:
+ * - The number of sequences.
+ */
+int queryImpacts(char **words, int t, indexset_t *indexes, arena_t *arena, impactlist_t **lists, int **ends)
+{
+  *lists = arena_alloc(arena, (t + 1) * sizeof(impactlist_t));
+  *ends = arena_alloc(arena, (t + 1) * sizeof(int));
+  int numSequences = 0;
+  int n = 0;                    // lists so far, up to the current sequence's
+  int first = 0;                // the current sequence's first list
+  bool andSequenceInvalid = false;
+
+  for (int i = 0; i <= t; i++) {
+    // At an "or" or the end of the query, keep the current AND sequence
+    if (i == t || strcmp(words[i], "or") == 0) {
+      if (!andSequenceInvalid && n > first) {
+        (*ends)[numSequences++] = n;
+      } else {
+        n = first;              // drop its lists
+      }
+      first = n;
+      andSequenceInvalid = false;
+      continue;
+    }
+    if (andSequenceInvalid || strcmp(words[i], "and") == 0) {
+      continue;
+    }
+
+    // A word not in the index (or without impacts) invalidates its sequence
+    if (indexset_findImpacts(indexes, words[i], arena, &(*lists)[n])) {
+      n++;
+    } else {
+      andSequenceInvalid = true;
+    }
+  }
+  return numSequences;
+}
+
 /* 
  * queryTokenize - Tokenizes input query into words
  * 
@@ -558,182 +1480,412 @@ bool isValidQuerySyntax(char **words, int t)
 }
 
 /* 
- * compareScores - Comparison function for qsort (sorts in descending order)
+ * printRankedResults - Ranks and prints query results
  * 
- * This function is used by `qsort()` to sort an array of `docScore_t` structures 
- * in **descending order** based on their `score` values.
+ * This function:
+ * 1. Counts the documents with non-zero scores.
+ * 2. Ranks them by descending score, ties by increasing docID; with a
+ *    page size, only the best pageSize are ranked, using a bounded heap.
+ * 3. Prints each ranked document with its score and URL.
  * 
- * Sorting in descending order ensures that documents with the **highest relevance scores**
- * appear first in the ranked results.
+ * With a page size, the session keeps the result and a cursor so that
+ * printNextPage can show the following pages; otherwise every matching
+ * document is printed and the result is deleted.
  * 
  * Parameters:
- * - a: Pointer to the first `docScore_t` element.
- * - b: Pointer to the second `docScore_t` element.
+ * - result: The query result (postings of docID and score), in the
+ *   session's arena.
+ * - lookup: Where to find the URLs of matching documents.
+ * - session: Where to keep the result for paging.
+ * - pageSize: Documents per page, or 0 to print all of them.
+ * - out: Where to print the results.
  * 
  * Returns:
- * - A negative value if `b`'s score is greater (placing `b` before `a`).
- * - Zero if the scores are equal.
- * - A positive value if `a`'s score is greater (placing `a` before `b`).
+ * - None (outputs results to out).
  */
-int compareScores(const void *a, const void *b) {
-  return ((docScore_t *)b)->score - ((docScore_t *)a)->score;
+void printRankedResults(postings_t *result, const docLookup_t *lookup, querySession_t *session, int pageSize, FILE *out)
+{
+  int matchCount = 0;
+
+  // Step 1: Count the number of documents with non-zero scores
+  postings_iterate(result, &matchCount, callbackCountNonZero);
+
+  // Step 2: If no documents match, print message and return
+  if (matchCount == 0) {
+    fprintf(out, session->lines ? "MATCHES\t0\n" : "No documents match.\n");
+    return;
+  }
+
+  fprintf(out, session->lines ? "MATCHES\t%d\n" : "Matches %d documents (ranked):\n", matchCount);
+
+  // Step 3: With a page size, print the first page and keep the rest for later
+  if (pageSize > 0) {
+    session->result = result;
+    session->cursor = rankcursor_new(result);
+    session->remaining = matchCount;
+    printNextPage(session, lookup, pageSize, out);
+    return;
+  }
+
+  // Step 4: Otherwise rank and print every matching document
+  ranked_t *ranked = arena_alloc(session->arena, matchCount * sizeof(ranked_t));
+  size_t n = ranking_topk(result, matchCount, ranked);
+  for (size_t i = 0; i < n; i++) {
+    printDocument(&ranked[i], lookup, session->lines, out);
+  }
 }
 
 /* 
- * printRankedResults - Sorts and prints query results
+ * printRankedList - Prints a query's full ranking
  * 
- * This function:
- * - Counts the number of documents with nonzero scores.
- * - Stores the document scores in an array.
- * - Sorts the array in descending order based on score.
- * - Prints the ranked results, displaying document IDs and URLs.
+ * Like printRankedResults, but for a ranking already computed (by an
+ * earlier query, from the cache). With a page size, the session keeps the
+ * ranking so that printNextPage can show the following pages.
  * 
  * Parameters:
- * - result: A `counters_t` structure containing document scores.
- * - pageDirectory: The directory where crawled pages are stored.
+ * - ranked: The ranking, best first, in the session's arena.
+ * - n: The number of ranked documents.
+ * - lookup: Where to find the URLs of matching documents.
+ * - session: Where to keep the ranking for paging.
+ * - pageSize: Documents per page, or 0 to print all of them.
+ * - out: Where to print the results.
  * 
  * Returns:
- * - None (outputs results to stdout).
+ * - None (outputs results to out).
  */
-void printRankedResults(counters_t *result, const char *pageDirectory)
+void printRankedList(ranked_t *ranked, size_t n, const docLookup_t *lookup, querySession_t *session, int pageSize, FILE *out)
 {
-  int printedCount = 0;
-
-  // Step 1: Count the number of documents with non-zero scores
-  counters_iterate(result, &printedCount, callbackCountNonZero);
-
-  // Step 2: If no documents match, print message and return
-  if (printedCount == 0) {
-    printf("No documents match.\n");
+  if (n == 0) {
+    fprintf(out, session->lines ? "MATCHES\t0\n" : "No documents match.\n");
     return;
   }
 
-  printf("Matches %d documents (ranked):\n", printedCount);
-
-  // Step 3: Allocate memory for storing document scores
-  docScore_t *docScores = mem_assert(mem_malloc(printedCount * sizeof(docScore_t)), "Memory allocation for docScores failed.");
+  fprintf(out, session->lines ? "MATCHES\t%zu\n" : "Matches %zu documents (ranked):\n", n);
 
-  // Step 4: Create a structure to pass both docScores and count to callback
-  struct {
-    docScore_t *docScores;
-    int docCount;  // Tracks index of stored scores
-  } scoreList = {docScores, 0};
+  if (pageSize > 0) {
+    session->ranked = ranked;
+    session->next = 0;
+    session->remaining = n;
+    printNextPage(session, lookup, pageSize, out);
+    return;
+  }
 
-  // Step 5: Store document scores in the array using counters_iterate
-  counters_iterate(result, &scoreList, callbackStoreDocScores);
+  for (size_t i = 0; i < n; i++) {
+    printDocument(&ranked[i], lookup, session->lines, out);
+  }
+}
 
-  // Step 6: Sort documents by score in descending order
-  qsort(scoreList.docScores, printedCount, sizeof(docScore_t), compareScores);
+/* 
+ * printNextPage - Prints the next page of the session's ranked results
+ * 
+ * The session's cursor selects the best pageSize documents not yet
+ * printed, so each page costs O(n log pageSize) and nothing is sorted
+ * beyond what is shown; a cached ranking is simply printed a slice at a
+ * time. If documents remain, a note says how to see them.
+ * 
+ * Parameters:
+ * - session: The session holding the last query's result and cursor.
+ * - lookup: Where to find the URLs of matching documents.
+ * - pageSize: Documents per page (> 0).
+ * - out: Where to print the results.
+ * 
+ * Returns:
+ * - None (outputs results to out).
+ */
+void printNextPage(querySession_t *session, const docLookup_t *lookup, int pageSize, FILE *out)
+{
+  size_t n;
+  if (session->ranked != NULL) {
+    n = session->remaining < pageSize ? session->remaining : pageSize;
+    for (size_t i = 0; i < n; i++) {
+      printDocument(&session->ranked[session->next + i], lookup, session->lines, out);
+    }
+    session->next += n;
+  } else {
+    ranked_t *page = arena_alloc(session->spare, pageSize * sizeof(ranked_t));
+    n = rankcursor_next(session->cursor, pageSize, page);
+    for (size_t i = 0; i < n; i++) {
+      printDocument(&page[i], lookup, session->lines, out);
+    }
+  }
 
-  // Step 7: Print sorted results, retrieving URLs for each document
-  for (int i = 0; i < printedCount; i++) {
-    char filename[256];
+  session->remaining -= n;
+  if (session->remaining > 0 && session->firstPageOnly) {
+    fprintf(out, session->lines ? "MORE\t%d\n" : "(%d more not shown)\n", session->remaining);
+    sessionEnd(session);
+  } else if (session->remaining > 0) {
+    fprintf(out, "(%d more; enter an empty query for the next page)\n", session->remaining);
+  } else {
+    sessionEnd(session);  // nothing left to page through
+  }
+}
 
-    // Construct the filename based on pageDirectory and document ID
-    snprintf(filename, sizeof(filename), "%s/%d", pageDirectory, scoreList.docScores[i].docID);
+/* 
+ * printTopPage - Prints the next page of a query's top documents by BM25
+ * 
+ * The query is searched again for the documents already shown, the
+ * page, and one more, which tells whether there are more to show;
+ * blockmax_topk skips every posting that cannot rank that high, so a page
+ * costs about what the documents up to it cost, not every match. The
+ * first page is headed by the number of documents it shows.
+ * 
+ * Parameters:
+ * - engine: The index and its impacts.
+ * - session: The session holding the query (its words) and how many of
+ *   its documents were shown; ended once nothing more will be shown.
+ * - pageSize: Documents per page (> 0).
+ * - out: Where to print the results.
+ * 
+ * Returns:
+ * - None (outputs results to out).
+ */
+void printTopPage(queryEngine_t *engine, querySession_t *session, int pageSize, FILE *out)
+{
+  // Step 1: Find the documents up to the end of this page, and one more
+  STATS_START(evaluateStart);
+  impactlist_t *lists;
+  int *ends;
+  int numSequences = queryImpacts(session->words, session->numWords, engine->indexes, session->spare,
+                                  &lists, &ends);
+  size_t k = session->shown + pageSize + 1;
+  ranked_t *top = arena_alloc(session->spare, k * sizeof(ranked_t));
+  size_t n = blockmax_topk(lists, ends, numSequences, k, top, session->spare, NULL);
+  STATS_STOP(STATS_QUERY_EVALUATE, evaluateStart);
+
+  // Step 2: Print the page, with a header if it is the first
+  size_t end = n < k - 1 ? n : k - 1;
+  if (session->shown == 0 && n == 0) {
+    fprintf(out, session->lines ? "MATCHES\t0\n" : "No documents match.\n");
+  } else if (session->shown == 0) {
+    fprintf(out, session->lines ? "TOP\t%zu\n" : "Top %zu documents (ranked):\n", end);
+  }
+  for (size_t i = session->shown; i < end; i++) {
+    printDocument(&top[i], &engine->lookup, session->lines, out);
+  }
+  session->shown = end;
+
+  // Step 3: Say whether there are more, and keep the query if they can be asked for
+  if (n == k && session->firstPageOnly) {
+    fprintf(out, session->lines ? "MORE\n" : "(more not shown)\n");
+    sessionEnd(session);
+  } else if (n == k) {
+    fprintf(out, "(more; enter an empty query for the next page)\n");
+  } else {
+    sessionEnd(session);  // nothing left to page through
+  }
+}
 
-    // Open the file to read the URL
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) {
-      fprintf(stderr, "Error: could not open file %s\n", filename);
-      exit(1);
+/* 
+ * printShardPage - Prints the next page of a query's documents from the shards
+ * 
+ * The shards are asked for the documents up to the end of this page (all
+ * of them without a page size), and the page is the end of their merged
+ * ranking. The first page is headed by the number of matches, if every
+ * shard counted them, and otherwise, as in printTopPage, by the number of
+ * documents it shows.
+ * 
+ * Parameters:
+ * - engine: The shard servers.
+ * - session: The session holding the query (its words) and how many of
+ *   its documents were shown; ended once nothing more will be shown.
+ * - pageSize: Documents per page, or 0 to print all of them.
+ * - out: Where to print the results.
+ * 
+ * Returns:
+ * - None (outputs results to out; a shard's failure goes to stderr).
+ */
+void printShardPage(queryEngine_t *engine, querySession_t *session, int pageSize, FILE *out)
+{
+  // Step 1: Ask the shards for the documents up to the end of this page
+  size_t k = pageSize > 0 ? session->shown + pageSize : 0;
+  shardresult_t result;
+  STATS_START(evaluateStart);
+  bool answered = shardset_query(engine->shards, session->words, session->numWords, k, session->spare, &result);
+  STATS_STOP(STATS_QUERY_EVALUATE, evaluateStart);
+  if (!answered) {
+    if (session->lines) {
+      fprintf(out, "ERROR\tshard unavailable\n");
     }
-
-    // Read the first line, which contains the URL
-    char *url = file_readLine(file);
-    fclose(file);
-
-    // Print document score, ID, and URL
-    printf("score %d doc %d: %s\n", scoreList.docScores[i].score, scoreList.docScores[i].docID, url);
-    free(url);
+    sessionEnd(session);
+    return;
   }
 
-  // Step 8: Free allocated memory
-  free(scoreList.docScores);
+  // Step 2: Print the page, with a header if it is the first
+  if (session->shown == 0 && result.n == 0) {
+    fprintf(out, session->lines ? "MATCHES\t0\n" : "No documents match.\n");
+  } else if (session->shown == 0 && result.matches >= 0) {
+    fprintf(out, session->lines ? "MATCHES\t%ld\n" : "Matches %ld documents (ranked):\n", result.matches);
+  } else if (session->shown == 0) {
+    fprintf(out, session->lines ? "TOP\t%zu\n" : "Top %zu documents (ranked):\n", result.n);
+  }
+  for (size_t i = session->shown; i < result.n; i++) {
+    const shardhit_t *hit = &result.hits[i];
+    fprintf(out, session->lines ? "DOC\t%d\t%d\t%s\n" : "score %d doc %d: %s\n", hit->score, hit->docID, hit->url);
+  }
+  session->shown = result.n;
+
+  // Step 3: Say how many more there are, if known, and keep the query
+  // if they can be asked for
+  long remaining = result.matches - (long) result.n;
+  if (result.matches >= 0 && remaining > 0 && session->firstPageOnly) {
+    fprintf(out, session->lines ? "MORE\t%ld\n" : "(%ld more not shown)\n", remaining);
+    sessionEnd(session);
+  } else if (result.matches >= 0 && remaining > 0) {
+    fprintf(out, "(%ld more; enter an empty query for the next page)\n", remaining);
+  } else if (result.matches < 0 && result.more && session->firstPageOnly) {
+    fprintf(out, session->lines ? "MORE\n" : "(more not shown)\n");
+    sessionEnd(session);
+  } else if (result.matches < 0 && result.more) {
+    fprintf(out, "(more; enter an empty query for the next page)\n");
+  } else {
+    sessionEnd(session);  // nothing left to page through
+  }
 }
 
-/* Callback Functions */
 /* 
- * callbackSetMinimum - Sets the minimum count for matching keys in two counters
+ * printDocument - Prints one ranked document's score, docID and URL
  * 
- * This function is used as a callback in `counters_iterate()`. It compares the 
- * counts of a specific key in two `counters_t` structures: 
- * - `acc` (the accumulator, storing the results)
- * - `wordCounters` (the new set of counts to be merged)
- * 
- * The function ensures that for each key, the minimum count between `acc` and 
- * `wordCounters` is retained in `acc`. This effectively performs an "AND" 
- * operation, ensuring that a document's score is limited by the lowest 
- * matching count across all words in the query.
+ * The URL comes from the document tables, an array lookup with no file
+ * opened; a document missing from them (or an index without one) falls
+ * back to reading the document from pageDirectory, whether it is kept
+ * there as a file or in a segment.
  * 
  * Parameters:
- * - arg: A pointer to a struct containing `acc` and `wordCounters`.
- * - key: The document ID being processed.
- * - count: The count associated with this key in `acc`.
+ * - doc: The ranked document.
+ * - lookup: Where to find the document's URL.
+ * - lines: Whether to print the line format for programs instead.
+ * - out: Where to print the document.
  * 
  * Returns:
- * - None (modifies `acc` in place).
+ * - None (exits if the document cannot be read).
  */
-void callbackSetMinimum(void *arg, const int key, const int count)
+void printDocument(const ranked_t *doc, const docLookup_t *lookup, bool lines, FILE *out)
 {
-  // Step 1: Cast arg to a pointer to the struct containing both counters
-  struct { 
-    counters_t *acc;          // The accumulator storing final results
-    counters_t *wordCounters; // The new set of counters to compare with
-  } *args = arg;              // cast arg back into the struct type so you can access acc and wordCounters correctly
+  docinfo_t info;
 
-  // Step 2: Get the count for this key from wordCounters
-  int c = counters_get(args->wordCounters, key);
+  // Look the URL up in the document tables, when there are any
+  if (indexset_getDoc(lookup->indexes, doc->docID, &info)) {
+    fprintf(out, lines ? "DOC\t%d\t%d\t%.*s\n" : "score %d doc %d: %.*s\n",
+            doc->score, doc->docID, (int) info.urlLen, info.url);
+    return;
+  }
 
-  // Step 3: Update c to the minimum count between acc and wordCounters
-  if (count < c) {
-    c = count;
+  // Read the document itself; its URL comes first
+  pagecursor_t *cursor = pagedir_openCursor(lookup->pageDirectory, doc->docID);
+  int docID;
+  pagemap_t page;
+  if (cursor == NULL || !pagedir_next(cursor, &docID, &page) || docID != doc->docID) {
+    fprintf(stderr, "Error: could not read document %d in %s\n", doc->docID, lookup->pageDirectory);
+    exit(1);
   }
 
-  // Step 4: Set the minimum value in acc
-  counters_set(args->acc, key, c);
+  // Print document score, ID, and URL
+  fprintf(out, lines ? "DOC\t%d\t%d\t%.*s\n" : "score %d doc %d: %.*s\n",
+          doc->score, doc->docID, (int) page.urlLen, page.url);
+  pagedir_closeCursor(cursor);
 }
 
 /* 
- * callbackAddCounts - Adds counts from one counters_t to another 
+ * sessionInit - Starts a session with nothing to page through
+ * 
+ * Parameters:
+ * - session: The session; its arenas are created.
+ * - firstPageOnly: Whether only the first page of each query is printed.
+ * - lines: Whether to print the line format for programs.
  * 
- * This function is used as a callback in `counters_iterate()`. It adds the count 
- * of a given key from the source `counters_t` to the corresponding key in the 
- * destination `counters_t` (`result`). This is useful for performing an "OR" 
- * operation in query processing, where documents get the combined score from 
- * multiple matching words.
+ * Returns:
+ * - None.
+ */
+void sessionInit(querySession_t *session, bool firstPageOnly, bool lines)
+{
+  session->cursor = NULL;
+  session->result = NULL;
+  session->ranked = NULL;
+  session->next = 0;
+  session->remaining = 0;
+  session->words = NULL;
+  session->numWords = 0;
+  session->shown = 0;
+  session->firstPageOnly = firstPageOnly;
+  session->lines = lines;
+  session->arena = arena_new(QUERY_ARENA_BYTES);
+  session->spare = arena_new(QUERY_ARENA_BYTES);
+}
+
+/* 
+ * sessionKeepQuery - Keeps a copy of a query in the session, to search again
  * 
  * Parameters:
- * - arg: A pointer to the destination `counters_t` where counts should be updated.
- * - key: The document ID being processed.
- * - count: The count associated with this key in the source `counters_t`.
+ * - session: The session; the copy goes in its (query's) arena.
+ * - words: The query's words.
+ * - t: The number of words.
  * 
  * Returns:
- * - None (modifies `result` in place).
+ * - None.
  */
-void callbackAddCounts(void *arg, const int key, const int count)
+void sessionKeepQuery(querySession_t *session, char **words, int t)
 {
-  // Step 1: Cast the argument to a counters_t pointer (the destination counters)
-  counters_t *result = arg;
+  session->words = arena_alloc(session->arena, t * sizeof(char*));
+  for (int i = 0; i < t; i++) {
+    session->words[i] = strcpy(arena_alloc(session->arena, strlen(words[i]) + 1), words[i]);
+  }
+  session->numWords = t;
+}
 
-  // Step 2: Retrieve the existing count for this key in result
-  int existingCount = counters_get(result, key);
+/* 
+ * sessionEnd - Forgets the session's last result, cursor and ranking
+ * 
+ * Parameters:
+ * - session: The session; its cursor is freed, and its arena (holding
+ *   the result and ranking, or the query) is reset.
+ * 
+ * Returns:
+ * - None.
+ */
+void sessionEnd(querySession_t *session)
+{
+  rankcursor_delete(session->cursor);
+  arena_reset(session->arena);
+  session->cursor = NULL;
+  session->result = NULL;
+  session->ranked = NULL;
+  session->next = 0;
+  session->remaining = 0;
+  session->words = NULL;
+  session->numWords = 0;
+  session->shown = 0;
+}
 
-  // Step 3: Update the count by adding the new count
-  counters_set(result, key, existingCount + count);
+/* 
+ * sessionFree - Ends a session and frees its arenas
+ * 
+ * Parameters:
+ * - session: The session.
+ * 
+ * Returns:
+ * - None.
+ */
+void sessionFree(querySession_t *session)
+{
+  sessionEnd(session);
+  arena_delete(session->arena);
+  arena_delete(session->spare);
+  session->arena = NULL;
+  session->spare = NULL;
 }
 
+/* Callback Functions */
 /* 
- * callbackCountNonZero - Counts the number of non-zero entries in a counters_t
+ * callbackCountNonZero - Counts the number of non-zero entries in a postings_t
  * 
- * This function is used as a callback in `counters_iterate()`. It counts how 
+ * This function is used as a callback in `postings_iterate()`. It counts how 
  * many document IDs have a non-zero count, which helps determine how many 
  * documents match a query.
  * 
  * Parameters:
  * - arg: A pointer to an integer counter, which will be incremented.
  * - key: The document ID being checked.
- * - count: The count associated with this key in the counters_t.
+ * - count: The count associated with this key in the postings_t.
  * 
  * Returns:
  * - None (modifies the counter in `arg`).
@@ -747,40 +1899,3 @@ void callbackCountNonZero(void *arg, const int key, const int count)
     (*counter)++;
   }
 }
-
-/* 
- * callbackStoreDocScores - Stores nonzero document scores in an array
- * 
- * This function is used as a callback in `counters_iterate()`. It copies 
- * document scores from a `counters_t` structure into a `docScore_t` array 
- * for sorting and ranking purposes.
- * 
- * Only documents with a nonzero score are stored.
- * 
- * Parameters:
- * - arg: A pointer to a struct containing:
- *    - `docScores`: An array of `docScore_t` structures where scores are stored.
- *    - `docCount`: An integer tracking the number of stored entries.
- * - key: The document ID being processed.
- * - count: The count (score) associated with this document.
- * 
- * Returns:
- * - None (modifies `docScores` and updates `docCount`).
- */
-void callbackStoreDocScores(void *arg, const int key, const int count) {
-  // Step 1: Only process documents with nonzero scores
-  if (count > 0) {
-    // Step 2: Cast arg to a pointer to the struct containing docScores and docCount
-    struct {
-      docScore_t *docScores; // Array of document scores
-      int docCount;          // Number of stored scores
-    } *scoreList = arg;
-
-    // Step 3: Store document ID and its score in the array
-    scoreList->docScores[scoreList->docCount].docID = key;
-    scoreList->docScores[scoreList->docCount].score = count;
-
-    // Step 4: Move to the next available position in the array
-    scoreList->docCount++;
-  }
-}
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+ * query.h - CS50 TSE Querier query evaluation
+ *
+ * The querier's boolean evaluation of a parsed query, shared with the
+ * benchmark suite (bench/), which compiles querier.c in with its main
+ * renamed and times this function on its own.
+ *
+ * Functions:
+ *  - `queryEvaluate`: Evaluates a normalized query against a set of indexes.
+ *
+ * Error Handling:
+ *  - Running out of arena memory terminates the program via `mem_assert`.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __QUERY_H
+#define __QUERY_H
+
+#include "../common/arena.h"
+#include "../common/indexset.h"
+#include "../common/postings.h"
+
+/**************** queryEvaluate ****************/
+/*
+ * Evaluates a query of n words, already lowercased and validated ("and"
+ * and "or" are operators; "and" binds tighter), against the indexes.
+ *
+ * Returns the matching documents with their scores, as a postings list
+ * allocated in the arena, or NULL if nothing matches.
+ */
+postings_t* queryEvaluate(char **words, int n, indexset_t *indexes, arena_t *arena);
+
+#endif // __QUERY_H
@@ -0,0 +1,451 @@
+/*
+ * server.c - CS50 TSE Querier socket server (a line protocol over TCP or Unix sockets)
+ *
+ * see server.h for more information.
+ *
+ * Every socket is non-blocking. Each pass of the event loop polls the
+ * listening socket and every connection: for input, unless a response is
+ * still being sent (so a client that never reads cannot make the server
+ * buffer without bound), and for output while one is. Complete lines are
+ * answered as soon as they arrive, each into a memory stream whose
+ * contents are appended to the connection's output buffer.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // getaddrinfo, sigaction, open_memstream, clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "server.h"
+#include "../libcs50/mem.h"
+
+/**************** constants ****************/
+#define MAX_CONNECTIONS 1024     // more are refused (closed at once)
+#define READ_BYTES 16384         // read at most this much per recv
+
+/**************** local types ****************/
+typedef struct buffer {
+  char* data;
+  size_t len;
+  size_t cap;
+} buffer_t;
+
+typedef struct connection {
+  int fd;
+  buffer_t in;              // received bytes not yet part of a complete line
+  buffer_t out;             // response bytes not yet sent
+  size_t sent;              // bytes of out already sent
+  bool firstLine;           // no line has been read yet
+  bool http;                // answer as HTTP, then close
+  bool closing;             // close once out has been sent
+} connection_t;
+
+typedef struct server {
+  const server_handlers_t* handlers;
+  connection_t* conns[MAX_CONNECTIONS];
+  int numConns;
+  unsigned long requests;
+  double latencies[SERVER_LATENCIES];   // ring of the latest latencies
+  struct timespec started;
+} server_t;
+
+/**************** file-local global variables ****************/
+static volatile sig_atomic_t stopping = 0;  // set by SIGINT and SIGTERM
+
+/**************** local functions ****************/
+static int listenOn(const char* address);
+static void onSignal(int sig);
+static void acceptConnections(server_t* server, const int listenFd);
+static bool readConnection(server_t* server, connection_t* conn);
+static bool writeConnection(connection_t* conn);
+static void answerLine(server_t* server, connection_t* conn, char* line);
+static void writeStats(server_t* server, FILE* out);
+static void closeConnection(server_t* server, const int i);
+static void buffer_append(buffer_t* buf, const char* data, const size_t len);
+static double secondsSince(const struct timespec* start);
+static int compareDoubles(const void* a, const void* b);
+
+/**************** server_run ****************/
+/* see server.h for description */
+bool server_run(const char* address, const server_handlers_t* handlers)
+{
+  if (address == NULL || handlers == NULL || handlers->request == NULL) {
+    return false;
+  }
+  int listenFd = listenOn(address);
+  if (listenFd < 0) {
+    return false;
+  }
+
+  // Stop cleanly on SIGINT or SIGTERM; a client hanging up is not an error
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sigemptyset(&sa.sa_mask);
+  sa.sa_handler = onSignal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  sa.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &sa, NULL);
+
+  server_t* server = mem_calloc_assert(1, sizeof(server_t), "server_run");
+  server->handlers = handlers;
+  clock_gettime(CLOCK_MONOTONIC, &server->started);
+  struct pollfd* fds = mem_calloc_assert(MAX_CONNECTIONS + 1, sizeof(struct pollfd), "server poll set");
+  fprintf(stderr, "Serving on %s\n", address);
+
+  while (!stopping) {
+    // Poll the listening socket, then each connection for what it needs
+    fds[0].fd = listenFd;
+    fds[0].events = POLLIN;
+    for (int i = 0; i < server->numConns; i++) {
+      connection_t* conn = server->conns[i];
+      fds[i + 1].fd = conn->fd;
+      fds[i + 1].events = conn->sent < conn->out.len ? POLLOUT : POLLIN;
+      fds[i + 1].revents = 0;
+    }
+    int numFds = server->numConns + 1;
+    if (poll(fds, numFds, -1) < 0) {
+      if (errno == EINTR) {
+        continue;         // a signal; the loop condition decides
+      }
+      fprintf(stderr, "Error: poll failed: %s\n", strerror(errno));
+      break;
+    }
+
+    // Serve connections from the last, so closing one (which moves the
+    // last connection into its place) never skips another
+    for (int i = numFds - 2; i >= 0; i--) {
+      connection_t* conn = server->conns[i];
+      short revents = fds[i + 1].revents;
+      bool ok = true;
+      if (revents & (POLLERR | POLLNVAL)) {
+        ok = false;
+      } else if (revents & POLLOUT) {
+        ok = writeConnection(conn);
+      } else if (revents & (POLLIN | POLLHUP)) {
+        ok = readConnection(server, conn) && writeConnection(conn);
+      }
+      if (!ok || (conn->closing && conn->sent == conn->out.len)) {
+        closeConnection(server, i);
+      }
+    }
+    if (fds[0].revents & POLLIN) {
+      acceptConnections(server, listenFd);
+    }
+  }
+
+  // Shut down: close every connection and the listening socket
+  while (server->numConns > 0) {
+    closeConnection(server, server->numConns - 1);
+  }
+  close(listenFd);
+  if (strncmp(address, "unix:", 5) == 0) {
+    unlink(address + 5);
+  }
+  mem_free(fds);
+  mem_free(server);
+  stopping = 0;
+  fprintf(stderr, "Server stopped\n");
+  return true;
+}
+
+/* Opens a non-blocking listening socket on the address; returns -1
+ * (after printing why) on failure */
+static int listenOn(const char* address)
+{
+  int fd = -1;
+
+  if (strncmp(address, "unix:", 5) == 0) {
+    const char* path = address + 5;
+    struct sockaddr_un sun;
+    memset(&sun, 0, sizeof(sun));
+    sun.sun_family = AF_UNIX;
+    if (*path == '\0' || strlen(path) >= sizeof(sun.sun_path)) {
+      fprintf(stderr, "Error: Bad Unix socket path: %s\n", path);
+      return -1;
+    }
+    strcpy(sun.sun_path, path);
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+      unlink(path);       // a socket left behind by an earlier server
+    }
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*) &sun, sizeof(sun)) != 0) {
+      fprintf(stderr, "Error: Could not bind %s: %s\n", address, strerror(errno));
+      if (fd >= 0) {
+        close(fd);
+      }
+      return -1;
+    }
+  } else {
+    // "PORT" or "HOST:PORT"
+    char host[256] = "";
+    const char* port = address;
+    const char* colon = strrchr(address, ':');
+    if (colon != NULL) {
+      if ((size_t) (colon - address) >= sizeof(host)) {
+        fprintf(stderr, "Error: Bad server address: %s\n", address);
+        return -1;
+      }
+      memcpy(host, address, colon - address);
+      host[colon - address] = '\0';
+      port = colon + 1;
+    }
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    int err = getaddrinfo(*host != '\0' ? host : NULL, port, &hints, &res);
+    if (err != 0) {
+      fprintf(stderr, "Error: Bad server address %s: %s\n", address, gai_strerror(err));
+      return -1;
+    }
+    for (struct addrinfo* ai = res; ai != NULL && fd < 0; ai = ai->ai_next) {
+      fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd < 0) {
+        continue;
+      }
+      int on = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+      if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+      fprintf(stderr, "Error: Could not bind %s: %s\n", address, strerror(errno));
+      return -1;
+    }
+  }
+
+  if (listen(fd, 128) != 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+    fprintf(stderr, "Error: Could not listen on %s: %s\n", address, strerror(errno));
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/* Asks the event loop to stop */
+static void onSignal(int sig)
+{
+  (void) sig;
+  stopping = 1;
+}
+
+/* Accepts every pending connection, refusing those beyond MAX_CONNECTIONS */
+static void acceptConnections(server_t* server, const int listenFd)
+{
+  int fd;
+  while ((fd = accept(listenFd, NULL, NULL)) >= 0) {
+    if (server->numConns == MAX_CONNECTIONS
+        || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+      close(fd);
+      continue;
+    }
+    connection_t* conn = mem_calloc_assert(1, sizeof(connection_t), "server connection");
+    conn->fd = fd;
+    conn->firstLine = true;
+    server->conns[server->numConns++] = conn;
+  }
+}
+
+/* Reads what a connection has sent and answers each complete line;
+ * returns false if the connection failed */
+static bool readConnection(server_t* server, connection_t* conn)
+{
+  char data[READ_BYTES];
+  ssize_t n = recv(conn->fd, data, sizeof(data), 0);
+  if (n < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  if (n == 0) {
+    conn->closing = true;   // the client is done; finish sending, then close
+    return true;
+  }
+  buffer_append(&conn->in, data, n);
+
+  // Answer every complete line, then keep the partial one that remains
+  size_t start = 0;
+  char* newline;
+  while (!conn->closing
+         && (newline = memchr(conn->in.data + start, '\n', conn->in.len - start)) != NULL) {
+    *newline = '\0';
+    if (newline > conn->in.data + start && newline[-1] == '\r') {
+      newline[-1] = '\0';
+    }
+    answerLine(server, conn, conn->in.data + start);
+    start = newline + 1 - conn->in.data;
+  }
+  memmove(conn->in.data, conn->in.data + start, conn->in.len - start);
+  conn->in.len -= start;
+
+  if (conn->in.len > SERVER_MAX_LINE && !conn->closing) {
+    const char* tooLong = "ERROR\tline too long\n";
+    buffer_append(&conn->out, tooLong, strlen(tooLong));
+    conn->closing = true;
+  }
+  return true;
+}
+
+/* Sends as much of a connection's pending output as it will take;
+ * returns false if the connection failed */
+static bool writeConnection(connection_t* conn)
+{
+  while (conn->sent < conn->out.len) {
+    ssize_t n = send(conn->fd, conn->out.data + conn->sent, conn->out.len - conn->sent, 0);
+    if (n < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    conn->sent += n;
+  }
+  conn->out.len = conn->sent = 0;     // all sent; reuse the buffer
+  return true;
+}
+
+/* Answers one request line, appending the response to the connection's output */
+static void answerLine(server_t* server, connection_t* conn, char* line)
+{
+  // An HTTP request is answered once, after its headers are read
+  if (conn->firstLine && strncmp(line, "GET ", 4) == 0) {
+    conn->http = true;
+    conn->firstLine = false;
+    line += 4;
+    bool health = strncmp(line, "/health", 7) == 0 && (line[7] == ' ' || line[7] == '\0');
+    bool stats = strncmp(line, "/stats", 6) == 0 && (line[6] == ' ' || line[6] == '\0');
+    char* body = NULL;
+    size_t bodyLen = 0;
+    FILE* out = mem_assert(open_memstream(&body, &bodyLen), "server response");
+    if (health) {
+      fprintf(out, "OK\n");
+    } else if (stats) {
+      writeStats(server, out);
+    } else {
+      fprintf(out, "Not found\n");
+    }
+    fclose(out);
+    char* response = NULL;
+    size_t responseLen = 0;
+    out = mem_assert(open_memstream(&response, &responseLen), "server response");
+    fprintf(out, "HTTP/1.0 %s\r\nContent-Type: text/plain\r\nContent-Length: %zu\r\n\r\n%s",
+            health || stats ? "200 OK" : "404 Not Found", bodyLen, body);
+    fclose(out);
+    buffer_append(&conn->out, response, responseLen);
+    free(body);           // both allocated by open_memstream
+    free(response);
+    return;
+  }
+  if (conn->http) {
+    if (*line == '\0') {
+      conn->closing = true;   // end of the headers
+    }
+    return;
+  }
+  conn->firstLine = false;
+
+  // Answer HEALTH and STATS here and everything else with the handler
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  char* response = NULL;
+  size_t responseLen = 0;
+  FILE* out = mem_assert(open_memstream(&response, &responseLen), "server response");
+  if (strcmp(line, "HEALTH") == 0) {
+    fprintf(out, "OK\n");
+  } else if (strcmp(line, "STATS") == 0) {
+    writeStats(server, out);
+  } else {
+    server->handlers->request(server->handlers->arg, line, out);
+  }
+  fclose(out);
+  buffer_append(&conn->out, response, responseLen);
+  free(response);         // allocated by open_memstream
+
+  server->latencies[server->requests % SERVER_LATENCIES] = secondsSince(&start);
+  server->requests++;
+}
+
+/* Writes the STATS line: uptime, connections, requests, and latency
+ * percentiles over the latest SERVER_LATENCIES requests */
+static void writeStats(server_t* server, FILE* out)
+{
+  size_t n = server->requests < SERVER_LATENCIES ? server->requests : SERVER_LATENCIES;
+  double sorted[SERVER_LATENCIES];
+  memcpy(sorted, server->latencies, n * sizeof(double));
+  qsort(sorted, n, sizeof(double), compareDoubles);
+  double p50 = n > 0 ? sorted[(n - 1) * 50 / 100] : 0;
+  double p99 = n > 0 ? sorted[(n - 1) * 99 / 100] : 0;
+  double max = n > 0 ? sorted[n - 1] : 0;
+
+  fprintf(out, "STATS\tuptime_s=%.0f\tconnections=%d\trequests=%lu\tp50_ms=%.3f\tp99_ms=%.3f\tmax_ms=%.3f",
+          secondsSince(&server->started), server->numConns, server->requests,
+          1000 * p50, 1000 * p99, 1000 * max);
+  if (server->handlers->stats != NULL) {
+    server->handlers->stats(server->handlers->arg, out);
+  }
+  fprintf(out, "\n");
+}
+
+/* Closes connection i, moving the last connection into its place */
+static void closeConnection(server_t* server, const int i)
+{
+  connection_t* conn = server->conns[i];
+  close(conn->fd);
+  if (conn->in.data != NULL) {
+    mem_free(conn->in.data);
+  }
+  if (conn->out.data != NULL) {
+    mem_free(conn->out.data);
+  }
+  mem_free(conn);
+  server->conns[i] = server->conns[--server->numConns];
+}
+
+/* Appends len bytes to a buffer, doubling it as needed */
+static void buffer_append(buffer_t* buf, const char* data, const size_t len)
+{
+  if (buf->len + len > buf->cap) {
+    size_t cap = buf->cap == 0 ? 4096 : 2 * buf->cap;
+    while (cap < buf->len + len) {
+      cap *= 2;
+    }
+    char* bigger = mem_malloc_assert(cap, "server buffer");
+    if (buf->data != NULL) {
+      memcpy(bigger, buf->data, buf->len);
+      mem_free(buf->data);
+    }
+    buf->data = bigger;
+    buf->cap = cap;
+  }
+  memcpy(buf->data + buf->len, data, len);
+  buf->len += len;
+}
+
+/* Returns the seconds elapsed since a CLOCK_MONOTONIC time */
+static double secondsSince(const struct timespec* start)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* Orders doubles increasingly, for qsort */
+static int compareDoubles(const void* a, const void* b)
+{
+  double x = *(const double*) a, y = *(const double*) b;
+  return (x > y) - (x < y);
+}
@@ -0,0 +1,71 @@
+/*
+ * server.h - CS50 TSE Querier socket server (a line protocol over TCP or Unix sockets)
+ *
+ * The server accepts any number of connections on one listening socket
+ * and serves them from a single poll() event loop, so a querier can keep
+ * its index loaded (and its caches warm) across many clients. Each
+ * connection has its own input and output buffers; a request is one line,
+ * and its response is written back in full before the connection's next
+ * request is answered.
+ *
+ * Requests (one per line, terminated by LF or CRLF, at most
+ * SERVER_MAX_LINE bytes):
+ *
+ *   HEALTH     answered by the server itself: "OK"
+ *   STATS      answered by the server itself: one line of tab-separated
+ *              name=value fields -- uptime_s, connections, requests,
+ *              and the p50_ms, p99_ms and max_ms latency of the last
+ *              SERVER_LATENCIES requests -- followed by any fields the
+ *              handlers' stats function adds
+ *   (other)    passed to the handlers' request function, which writes
+ *              the complete response
+ *
+ * For load balancers, a connection whose first line is an HTTP request
+ * ("GET /health ..." or "GET /stats ...") is answered as HTTP/1.0, with
+ * the same body as HEALTH or STATS, and then closed.
+ *
+ * Functions:
+ *  - `server_run`: Listens on an address and serves requests until
+ *    SIGINT or SIGTERM.
+ *
+ * Error Handling:
+ *  - Setup failures (a bad address, or one that cannot be bound) are
+ *    reported on stderr and make `server_run` return false; a failing
+ *    connection is just closed. Running out of memory terminates the
+ *    program via `mem_assert`.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __SERVER_H
+#define __SERVER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define SERVER_MAX_LINE 65536     // longest request line accepted
+#define SERVER_LATENCIES 1024     // requests kept for the latency percentiles
+
+/* What the server calls to answer requests */
+typedef struct server_handlers {
+  /* Answers one request line (without its line terminator),
+   * writing the whole response, with its newlines, to out */
+  void (*request)(void* arg, char* line, FILE* out);
+  /* Writes extra "\tname=value" fields for STATS to out; may be NULL */
+  void (*stats)(void* arg, FILE* out);
+  void* arg;                      // passed to both
+} server_handlers_t;
+
+/**
+ * Listens on an address and serves requests until SIGINT or SIGTERM.
+ *
+ * @param address "PORT" (every interface), "HOST:PORT", or "unix:PATH"
+ *                (a Unix socket, replacing any socket already at PATH).
+ * @param handlers The functions that answer requests.
+ * @return true after a signal stops the server, false if it could not
+ *         start listening.
+ */
+bool server_run(const char* address, const server_handlers_t* handlers);
+
+#endif // __SERVER_H
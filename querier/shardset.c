@@ -0,0 +1,435 @@
+/*
+ * shardset.c - CS50 TSE Querier client of a set of shard servers
+ *
+ * see shardset.h for more information.
+ *
+ * A query is written to every shard before any answer is read, so the
+ * shards evaluate it at the same time and the query takes about as long
+ * as the slowest shard. Each connection reads through a stdio stream;
+ * requests are sent straight to its socket. Every shard's hits go into
+ * one array, which is sorted once all have answered.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#define _POSIX_C_SOURCE 200809L  // getaddrinfo, fdopen, getline
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "shardset.h"
+#include "../libcs50/mem.h"
+
+/**************** local types ****************/
+typedef struct connection {
+  int fd;
+  FILE* in;                         // reads the answers from fd
+  struct connection* next;          // in the shard's pool of idle connections
+} connection_t;
+
+typedef struct shard {
+  char* address;
+  pthread_mutex_t lock;             // protects idle
+  connection_t* idle;
+} shard_t;
+
+typedef struct shardset {
+  shard_t* shards;
+  int numShards;
+} shardset_t;
+
+/* The hits gathered from the shards so far */
+typedef struct gather {
+  shardhit_t* hits;
+  size_t n;
+  size_t cap;
+  long matches;                     // -1 once a shard did not count its matches
+  bool more;
+} gather_t;
+
+/* How a shard answered */
+typedef enum answer {
+  ANSWER_OK,                        // in full, up to END
+  ANSWER_ERROR,                     // with ERROR; the connection is still good
+  ANSWER_BROKEN                     // not at all: the connection failed first
+} answer_t;
+
+/**************** local functions ****************/
+static connection_t* openConnection(const char* address);
+static int connectTo(const char* address);
+static connection_t* takeConnection(shard_t* shard, bool* pooled);
+static void giveConnection(shard_t* shard, connection_t* conn);
+static void closeConnection(connection_t* conn);
+static bool sendRequest(connection_t* conn, const char* request, const size_t len);
+static answer_t readAnswer(shard_t* shard, connection_t* conn, arena_t* arena, gather_t* gather);
+static void addHit(gather_t* gather, const int score, const int docID, const char* url, arena_t* arena);
+static int compareHits(const void* a, const void* b);
+
+/**************** shardset_new ****************/
+/* see shardset.h for description */
+shardset_t* shardset_new(const char* addresses)
+{
+  if (addresses == NULL || *addresses == '\0') {
+    fprintf(stderr, "Error: No shard addresses.\n");
+    return NULL;
+  }
+  int numShards = 1;
+  for (const char* c = addresses; *c != '\0'; c++) {
+    numShards += *c == ',';
+  }
+
+  shardset_t* set = mem_calloc_assert(1, sizeof(shardset_t), "shardset");
+  set->shards = mem_calloc_assert(numShards, sizeof(shard_t), "shardset shards");
+  const char* start = addresses;
+  for (int s = 0; s < numShards; s++) {
+    const char* end = strchr(start, ',');
+    size_t len = end != NULL ? (size_t) (end - start) : strlen(start);
+    shard_t* shard = &set->shards[s];
+    shard->address = mem_malloc_assert(len + 1, "shardset address");
+    memcpy(shard->address, start, len);
+    shard->address[len] = '\0';
+    pthread_mutex_init(&shard->lock, NULL);
+    set->numShards++;
+    start += len + 1;
+
+    // Connect now, so an unreachable shard is reported before any query
+    if (len == 0) {
+      fprintf(stderr, "Error: Empty shard address in %s\n", addresses);
+      shardset_delete(set);
+      return NULL;
+    }
+    shard->idle = openConnection(shard->address);
+    if (shard->idle == NULL) {
+      fprintf(stderr, "Error: Could not connect to shard %s: %s\n", shard->address, strerror(errno));
+      shardset_delete(set);
+      return NULL;
+    }
+  }
+  return set;
+}
+
+/**************** shardset_size ****************/
+/* see shardset.h for description */
+int shardset_size(shardset_t* set)
+{
+  return set == NULL ? 0 : set->numShards;
+}
+
+/**************** shardset_query ****************/
+/* see shardset.h for description */
+bool shardset_query(shardset_t* set, char** words, const int numWords, const size_t k,
+                    arena_t* arena, shardresult_t* result)
+{
+  if (set == NULL || words == NULL || numWords <= 0 || arena == NULL || result == NULL) {
+    return false;
+  }
+
+  // Step 1: Write the request, "TOP k words...\n"
+  size_t len = 32;
+  for (int i = 0; i < numWords; i++) {
+    len += strlen(words[i]) + 1;
+  }
+  char* request = arena_alloc(arena, len);
+  len = sprintf(request, "TOP %zu", k);
+  for (int i = 0; i < numWords; i++) {
+    len += sprintf(request + len, " %s", words[i]);
+  }
+  request[len++] = '\n';
+
+  // Step 2: Send it to every shard
+  connection_t** conns = arena_alloc(arena, set->numShards * sizeof(connection_t*));
+  bool* pooled = arena_alloc(arena, set->numShards * sizeof(bool));
+  for (int s = 0; s < set->numShards; s++) {
+    conns[s] = takeConnection(&set->shards[s], &pooled[s]);
+    if (conns[s] != NULL && !sendRequest(conns[s], request, len)) {
+      closeConnection(conns[s]);
+      conns[s] = NULL;
+    }
+  }
+
+  // Step 3: Gather every answer, asking again on a new connection if a
+  // pooled one has gone stale (but not if the shard answered ERROR, which
+  // it would again); every shard is read, even after one fails, so that
+  // no answer is left on a pooled connection
+  gather_t gather = { NULL, 0, 0, 0, false };
+  bool ok = true;
+  for (int s = 0; s < set->numShards; s++) {
+    shard_t* shard = &set->shards[s];
+    answer_t answer = conns[s] != NULL ? readAnswer(shard, conns[s], arena, &gather) : ANSWER_BROKEN;
+    if (answer == ANSWER_BROKEN && pooled[s]) {
+      closeConnection(conns[s]);
+      conns[s] = openConnection(shard->address);
+      answer = conns[s] != NULL && sendRequest(conns[s], request, len)
+               ? readAnswer(shard, conns[s], arena, &gather) : ANSWER_BROKEN;
+    }
+    if (answer != ANSWER_BROKEN) {
+      giveConnection(shard, conns[s]);
+    } else {
+      closeConnection(conns[s]);
+      fprintf(stderr, "Error: shard %s did not answer\n", shard->address);
+    }
+    if (answer != ANSWER_OK) {
+      ok = false;
+    }
+  }
+  if (!ok) {
+    return false;
+  }
+
+  // Step 4: Merge: the best k of all the shards' best
+  if (gather.n > 0) {
+    qsort(gather.hits, gather.n, sizeof(shardhit_t), compareHits);
+  }
+  result->hits = gather.hits;
+  result->n = k > 0 && gather.n > k ? k : gather.n;
+  result->matches = gather.matches;
+  result->more = gather.more || gather.n > result->n;
+  return true;
+}
+
+/**************** shardset_delete ****************/
+/* see shardset.h for description */
+void shardset_delete(shardset_t* set)
+{
+  if (set == NULL) {
+    return;
+  }
+  for (int s = 0; s < set->numShards; s++) {
+    shard_t* shard = &set->shards[s];
+    while (shard->idle != NULL) {
+      connection_t* next = shard->idle->next;
+      closeConnection(shard->idle);
+      shard->idle = next;
+    }
+    pthread_mutex_destroy(&shard->lock);
+    mem_free(shard->address);
+  }
+  mem_free(set->shards);
+  mem_free(set);
+}
+
+/* Opens a connection to a shard; NULL (with errno set) if it cannot */
+static connection_t* openConnection(const char* address)
+{
+  int fd = connectTo(address);
+  if (fd < 0) {
+    return NULL;
+  }
+
+  // A shard that stops answering fails the query instead of hanging it
+  struct timeval timeout = { SHARDSET_TIMEOUT, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  FILE* in = fdopen(fd, "r");
+  if (in == NULL) {
+    close(fd);
+    return NULL;
+  }
+  connection_t* conn = mem_malloc_assert(sizeof(connection_t), "shardset connection");
+  conn->fd = fd;
+  conn->in = in;
+  conn->next = NULL;
+  return conn;
+}
+
+/* Connects a socket to "PORT", "HOST:PORT" or "unix:PATH"; returns
+ * the socket, or -1 (with errno set) */
+static int connectTo(const char* address)
+{
+  if (strncmp(address, "unix:", 5) == 0) {
+    struct sockaddr_un sun;
+    memset(&sun, 0, sizeof(sun));
+    sun.sun_family = AF_UNIX;
+    if (address[5] == '\0' || strlen(address + 5) >= sizeof(sun.sun_path)) {
+      errno = EINVAL;
+      return -1;
+    }
+    strcpy(sun.sun_path, address + 5);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*) &sun, sizeof(sun)) != 0) {
+      int err = errno;
+      close(fd);
+      errno = err;
+      fd = -1;
+    }
+    return fd;
+  }
+
+  // "PORT" (this host, since the lookup is not passive) or "HOST:PORT"
+  char host[256] = "";
+  const char* port = address;
+  const char* colon = strrchr(address, ':');
+  if (colon != NULL) {
+    if ((size_t) (colon - address) >= sizeof(host)) {
+      errno = EINVAL;
+      return -1;
+    }
+    memcpy(host, address, colon - address);
+    host[colon - address] = '\0';
+    port = colon + 1;
+  }
+  struct addrinfo hints, *res;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(*host != '\0' ? host : NULL, port, &hints, &res) != 0) {
+    errno = EHOSTUNREACH;
+    return -1;
+  }
+  int fd = -1;
+  int err = ECONNREFUSED;
+  for (struct addrinfo* ai = res; ai != NULL && fd < 0; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+      err = errno;
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(res);
+  if (fd < 0) {
+    errno = err;
+    return -1;
+  }
+  int on = 1;     // requests are single small writes; send them at once
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  return fd;
+}
+
+/* Takes an idle connection from a shard's pool, or opens a new one;
+ * *pooled tells which. NULL if a new one cannot be opened. */
+static connection_t* takeConnection(shard_t* shard, bool* pooled)
+{
+  pthread_mutex_lock(&shard->lock);
+  connection_t* conn = shard->idle;
+  if (conn != NULL) {
+    shard->idle = conn->next;
+  }
+  pthread_mutex_unlock(&shard->lock);
+
+  *pooled = conn != NULL;
+  return conn != NULL ? conn : openConnection(shard->address);
+}
+
+/* Returns a connection, its answer read in full, to its shard's pool */
+static void giveConnection(shard_t* shard, connection_t* conn)
+{
+  pthread_mutex_lock(&shard->lock);
+  conn->next = shard->idle;
+  shard->idle = conn;
+  pthread_mutex_unlock(&shard->lock);
+}
+
+/* Closes a connection; NULL is ignored */
+static void closeConnection(connection_t* conn)
+{
+  if (conn != NULL) {
+    fclose(conn->in);     // closes fd too
+    mem_free(conn);
+  }
+}
+
+/* Sends the whole request; false if the connection failed */
+static bool sendRequest(connection_t* conn, const char* request, const size_t len)
+{
+  size_t sent = 0;
+  while (sent < len) {
+    ssize_t n = send(conn->fd, request + sent, len - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno != EINTR) {
+      return false;
+    }
+    sent += n > 0 ? n : 0;
+  }
+  return true;
+}
+
+/* Reads a shard's answer, adding it to what was gathered if it is
+ * complete; otherwise the gather is left as it was. An ERROR alone is the
+ * whole answer, and one after QUERY is followed by END; either way the
+ * connection can be used again. */
+static answer_t readAnswer(shard_t* shard, connection_t* conn, arena_t* arena, gather_t* gather)
+{
+  gather_t before = *gather;
+  char* line = NULL;
+  size_t cap = 0;
+  ssize_t len;
+  bool started = false;             // QUERY was read
+  bool failed = false;              // ERROR was read
+  bool ended = false;
+  while (!ended && (len = getline(&line, &cap, conn->in)) > 0) {
+    if (line[len - 1] == '\n') {
+      line[--len] = '\0';
+    }
+    char* end;
+    if (strncmp(line, "DOC\t", 4) == 0) {
+      int score = strtol(line + 4, &end, 10);
+      int docID = *end == '\t' ? strtol(end + 1, &end, 10) : -1;
+      if (*end != '\t' || docID < 0) {
+        break;
+      }
+      addHit(gather, score, docID, end + 1, arena);
+    } else if (strncmp(line, "MATCHES\t", 8) == 0) {
+      long matches = strtol(line + 8, &end, 10);
+      gather->matches = gather->matches >= 0 ? gather->matches + matches : -1;
+    } else if (strncmp(line, "TOP\t", 4) == 0) {
+      gather->matches = -1;
+    } else if (strncmp(line, "MORE", 4) == 0) {
+      gather->more = true;
+    } else if (strcmp(line, "END") == 0) {
+      ended = true;
+    } else if (strncmp(line, "QUERY\t", 6) == 0) {
+      started = true;
+    } else if (strncmp(line, "ERROR", 5) == 0) {
+      fprintf(stderr, "Error: shard %s: %s\n", shard->address, line);
+      failed = true;
+      ended = !started;             // else read on through END
+    } else {
+      break;
+    }
+  }
+  free(line);     // allocated by getline
+
+  if (!ended || failed) {
+    *gather = before;
+  }
+  return !ended ? ANSWER_BROKEN : failed ? ANSWER_ERROR : ANSWER_OK;
+}
+
+/* Adds a hit to what was gathered, copying its URL into the arena */
+static void addHit(gather_t* gather, const int score, const int docID, const char* url, arena_t* arena)
+{
+  if (gather->n == gather->cap) {
+    size_t cap = gather->cap == 0 ? 64 : 2 * gather->cap;
+    shardhit_t* hits = arena_alloc(arena, cap * sizeof(shardhit_t));
+    if (gather->n > 0) {
+      memcpy(hits, gather->hits, gather->n * sizeof(shardhit_t));
+    }
+    gather->hits = hits;
+    gather->cap = cap;
+  }
+  shardhit_t* hit = &gather->hits[gather->n++];
+  hit->score = score;
+  hit->docID = docID;
+  hit->url = strcpy(arena_alloc(arena, strlen(url) + 1), url);
+}
+
+/* qsort comparator: hits by decreasing score, ties by increasing docID,
+ * the order a single index ranks them in (see ranking.h) */
+static int compareHits(const void* a, const void* b)
+{
+  const shardhit_t* x = a;
+  const shardhit_t* y = b;
+  if (x->score != y->score) {
+    return (x->score < y->score) - (x->score > y->score);
+  }
+  return (x->docID > y->docID) - (x->docID < y->docID);
+}
@@ -0,0 +1,103 @@
+/*
+ * shardset.h - CS50 TSE Querier client of a set of shard servers
+ *
+ * An index split into shards (`indexer -s`) is searched as one by a
+ * coordinator: each shard is served by its own `querier --serve` (see
+ * server.h), and a shardset sends every query to all of them at once,
+ * gathers each shard's best documents, and merges them into the best of
+ * the whole collection.
+ *
+ * A shard is asked "TOP k words..." and answers in the querier's line
+ * format: QUERY, then MATCHES (its number of matches) or TOP (when it
+ * ranks by BM25 without counting them), DOC lines best first, MORE if it
+ * has more than k, and END. Every shard ranks its documents as one index
+ * would (the indexer scores shards' BM25 impacts for the whole
+ * collection), so the best k of the whole collection are among the best k
+ * of each shard, and merging them gives exactly the single index's top k.
+ *
+ * Each shard has a pool of open connections, so queries reuse them and
+ * several threads can query at once, each on connections of its own.
+ *
+ * Functions:
+ *  - `shardset_new`: Connects to a list of shard servers.
+ *  - `shardset_size`: Returns the number of shards.
+ *  - `shardset_query`: Asks every shard for a query's top documents and merges them.
+ *  - `shardset_delete`: Closes every connection and frees the set.
+ *
+ * Error Handling:
+ *  - A shard that cannot be reached, or does not answer, is reported on
+ *    stderr; `shardset_new` then returns NULL and `shardset_query` false.
+ *    A pooled connection the shard has since closed is replaced once
+ *    before giving up. A shard that answers ERROR fails the query the
+ *    same way, but is not asked again, and its connection is kept. Running out of memory terminates the program via
+ *    `mem_assert`.
+ *
+ * Author: Atziri Enriquez
+ * Date: 10/14/26
+ */
+
+#ifndef __SHARDSET_H
+#define __SHARDSET_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "../common/arena.h"
+
+#define SHARDSET_TIMEOUT 30       // seconds to wait for a shard's answer
+
+/* A set of shard servers; opaque to users of the module */
+typedef struct shardset shardset_t;
+
+/* One document of a merged result */
+typedef struct shardhit {
+  int score;
+  int docID;
+  char* url;                // null-terminated, in the query's arena
+} shardhit_t;
+
+/* A query's merged result */
+typedef struct shardresult {
+  shardhit_t* hits;         // best first: by decreasing score, ties by increasing docID
+  size_t n;
+  long matches;             // documents matching in all shards, or -1 if a shard did not count them
+  bool more;                // whether there are matches beyond the hits
+} shardresult_t;
+
+/**
+ * Connects to every shard server of a list.
+ *
+ * @param addresses The servers' addresses, separated by commas; each is
+ *                  "PORT" (on this host), "HOST:PORT" or "unix:PATH".
+ * @return Pointer to a new `shardset_t`, or NULL (after printing why) if
+ *         the list is empty or malformed or a shard cannot be reached.
+ */
+shardset_t* shardset_new(const char* addresses);
+
+/**
+ * Returns the number of shards (0 if set is NULL).
+ */
+int shardset_size(shardset_t* set);
+
+/**
+ * Asks every shard for a query's best documents, and merges their answers.
+ *
+ * @param set The shards.
+ * @param words The query's words, valid and lowercased.
+ * @param numWords The number of words (> 0).
+ * @param k The most documents to return, or 0 for every match.
+ * @param arena Where to allocate the result.
+ * @param result Where to store the merged result.
+ * @return true on success; false (after printing which shard failed) if a
+ *         shard did not answer, or answered ERROR.
+ */
+bool shardset_query(shardset_t* set, char** words, const int numWords, const size_t k,
+                    arena_t* arena, shardresult_t* result);
+
+/**
+ * Closes every connection and frees the set.
+ *
+ * @param set The shards; NULL is ignored.
+ */
+void shardset_delete(shardset_t* set);
+
+#endif // __SHARDSET_H
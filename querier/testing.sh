@@ -83,6 +83,147 @@ bread bread bread
 rivers AND rivers
 EOF
 
+# 10. Paged results: two per page, then two empty queries for the next pages (toscrape-2)
+$QUERIER -k 2 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index <<EOF
+the or book
+
+
+EOF
+
+# 11. Bad page size (should fail)
+$QUERIER -k 0 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index
+
+# 12. Without a document table, URLs are read from the page files (same output as test 10)
+cp $SHARED_DIR/output/toscrape-2.index /tmp/nodocs.index
+$QUERIER -k 2 $SHARED_DIR/output/toscrape-2 /tmp/nodocs.index <<EOF
+the or book
+
+EOF
+rm -f /tmp/nodocs.index
+
+# 13. Cached rankings: repeated and reordered queries (same output as without -c)
+$QUERIER -c 1 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index <<EOF
+the and book or travel
+travel or book the
+the and book or travel
+EOF
+
+# 14. Cached ranking, paged
+$QUERIER -k 2 -c 1 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index <<EOF
+the or book
+the or book
+
+EOF
+
+# 15. Bad cache size (should fail)
+$QUERIER -c 0 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index
+
+# 16. Batch mode on 4 threads (same output as the interactive querier, in order)
+$FUZZQUERY $SHARED_DIR/output/toscrape-2.index 200 7 > /tmp/batch.queries
+$QUERIER $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index < /tmp/batch.queries > /tmp/batch.serial
+$QUERIER -f /tmp/batch.queries -j 4 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index > /tmp/batch.parallel
+cmp /tmp/batch.serial /tmp/batch.parallel
+rm -f /tmp/batch.queries /tmp/batch.serial /tmp/batch.parallel
+
+# 17. -j without a query file (should fail)
+$QUERIER -j 4 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index
+
+# 18. Server mode: health check, a query, an invalid query, and stats over TCP
+$QUERIER -k 3 -c 1 --serve 50123 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index &
+SERVER=$!
+sleep 1
+exec 3<>/dev/tcp/localhost/50123
+printf 'HEALTH\nQUERY the and book\nQUERY and\nSTATS\n' >&3
+while read -r line <&3; do
+  echo "$line"
+  [[ $line == STATS* ]] && break
+done
+exec 3>&-
+kill $SERVER
+wait $SERVER
+
+# 19. Server mode: HTTP health check on a Unix socket
+$QUERIER --serve unix:/tmp/querier.sock $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index &
+SERVER=$!
+sleep 1
+printf 'GET /health HTTP/1.0\r\n\r\n' | nc -U /tmp/querier.sock
+kill $SERVER
+wait $SERVER
+
+# 20. --serve with a query file (should fail)
+$QUERIER --serve 50123 -f /dev/null $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index
+
+# 21. BM25 ranking, every match, from an index built with its impacts (toscrape-2)
+../indexer/indexer $SHARED_DIR/output/toscrape-2 /tmp/bm25.index
+$QUERIER -r bm25 $SHARED_DIR/output/toscrape-2 /tmp/bm25.index <<EOF
+the and book or travel
+EOF
+
+# 22. BM25 top documents, paged: the same documents as the first pages of test 21
+$QUERIER -r bm25 -k 2 $SHARED_DIR/output/toscrape-2 /tmp/bm25.index <<EOF
+the and book or travel
+
+
+EOF
+
+# 23. BM25 top documents in batch mode (same output as without -j)
+$FUZZQUERY /tmp/bm25.index 200 7 > /tmp/batch.queries
+$QUERIER -r bm25 -k 5 -f /tmp/batch.queries $SHARED_DIR/output/toscrape-2 /tmp/bm25.index > /tmp/batch.serial
+$QUERIER -r bm25 -k 5 -f /tmp/batch.queries -j 4 $SHARED_DIR/output/toscrape-2 /tmp/bm25.index > /tmp/batch.parallel
+cmp /tmp/batch.serial /tmp/batch.parallel
+rm -f /tmp/batch.queries /tmp/batch.serial /tmp/batch.parallel /tmp/bm25.index*
+
+# 24. BM25 with an index saved without impacts, and a bad ranking (should fail)
+$QUERIER -r bm25 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index < /dev/null
+$QUERIER -r tfidf $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index < /dev/null
+
+# 25. Sharded index: a coordinator over 3 shard servers (same output as the whole index, by count and by BM25)
+../indexer/indexer $SHARED_DIR/output/toscrape-2 /tmp/whole.index
+../indexer/indexer -s 3 $SHARED_DIR/output/toscrape-2 /tmp/shard.index
+SHARDS=
+for s in 0 1 2; do
+  $QUERIER --serve unix:/tmp/shard$s.sock $SHARED_DIR/output/toscrape-2 /tmp/shard.index.s$s 2>/dev/null &
+  $QUERIER -r bm25 --serve unix:/tmp/shard$s-bm25.sock $SHARED_DIR/output/toscrape-2 /tmp/shard.index.s$s 2>/dev/null &
+  SHARDS="$SHARDS unix:/tmp/shard$s.sock"
+done
+sleep 1
+COUNTSHARDS=$(echo $SHARDS | tr ' ' ',')
+BM25SHARDS=$(echo $COUNTSHARDS | sed 's/\.sock/-bm25.sock/g')
+$FUZZQUERY /tmp/whole.index 200 7 > /tmp/batch.queries
+$QUERIER -k 5 -f /tmp/batch.queries $SHARED_DIR/output/toscrape-2 /tmp/whole.index > /tmp/batch.serial
+$QUERIER -k 5 -f /tmp/batch.queries -j 4 --shards $COUNTSHARDS > /tmp/batch.parallel
+cmp /tmp/batch.serial /tmp/batch.parallel
+$QUERIER -r bm25 -k 5 -f /tmp/batch.queries $SHARED_DIR/output/toscrape-2 /tmp/whole.index > /tmp/batch.serial
+$QUERIER -k 5 -f /tmp/batch.queries -j 4 --shards $BM25SHARDS > /tmp/batch.parallel
+cmp /tmp/batch.serial /tmp/batch.parallel
+$QUERIER -k 2 --shards $BM25SHARDS <<EOF
+the and book or travel
+
+EOF
+kill $(jobs -p)
+wait
+rm -f /tmp/batch.queries /tmp/batch.serial /tmp/batch.parallel /tmp/whole.index* /tmp/shard.index*
+
+# 26. --shards with an unreachable shard, and with -r (should fail)
+$QUERIER --shards unix:/tmp/noshard.sock < /dev/null
+$QUERIER -r bm25 --shards unix:/tmp/noshard.sock < /dev/null
+
+# 27. --stats: a timing summary on stderr, and the timers' fields in a server's STATS line
+$QUERIER --stats $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index <<EOF
+the and book
+EOF
+$QUERIER --stats --serve 50123 $SHARED_DIR/output/toscrape-2 $SHARED_DIR/output/toscrape-2.index &
+SERVER=$!
+sleep 1
+exec 3<>/dev/tcp/localhost/50123
+printf 'QUERY the and book\nSTATS\n' >&3
+while read -r line <&3; do
+  [[ $line == STATS* ]] && echo "$line" | tr '\t' '\n' | cut -d= -f1 && break
+done
+exec 3>&-
+kill $SERVER
+wait $SERVER
+
 # === FUZZ TESTING QUERIER ===
 
 echo "Running fuzzquery and piping directly into querier..."